@@ -47,6 +47,7 @@ static const QString AUDIO_BUFFER_GROUP_KEY = "audio_buffer";
 static const QString AUDIO_THREADING_GROUP_KEY = "audio_threading";
 
 int AudioMixer::_numStaticJitterFrames{ DISABLE_STATIC_JITTER_FRAMES };
+bool AudioMixer::_timeStretchJitterBuffers{ false };
 float AudioMixer::_noiseMutingThreshold{ DEFAULT_NOISE_MUTING_THRESHOLD };
 float AudioMixer::_attenuationPerDoublingInDistance{ DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE };
 std::map<QString, std::shared_ptr<CodecPlugin>> AudioMixer::_availableCodecs{ };
@@ -526,6 +527,7 @@ int AudioMixer::prepareFrame(const SharedNodePointer& node, unsigned int frame)
 
 void AudioMixer::clearDomainSettings() {
     _numStaticJitterFrames = DISABLE_STATIC_JITTER_FRAMES;
+    _timeStretchJitterBuffers = false;
     _attenuationPerDoublingInDistance = DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE;
     _noiseMutingThreshold = DEFAULT_NOISE_MUTING_THRESHOLD;
     _codecPreferenceOrder.clear();
@@ -572,6 +574,10 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
             _numStaticJitterFrames = DISABLE_STATIC_JITTER_FRAMES;
         }
 
+        const QString TIME_STRETCH_JITTER_BUFFER_JSON_KEY = "time_stretch_jitter_buffer";
+        _timeStretchJitterBuffers = audioBufferGroupObject[TIME_STRETCH_JITTER_BUFFER_JSON_KEY].toBool();
+        qCDebug(audio) << "Time-stretching jitter buffers:" << _timeStretchJitterBuffers;
+
         // check for deprecated audio settings
         auto deprecationNotice = [](const QString& setting, const QString& value) {
             qInfo().nospace() << "[DEPRECATION NOTICE] " << setting << "(" << value << ") has been deprecated, and has no effect";
@@ -753,12 +759,18 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
     }
 }
 
-AudioMixer::Timer::Timing::Timing(uint64_t& sum) : _sum(sum) {
-    _timing = p_high_resolution_clock::now();
+AudioMixer::Timer::Timing::Timing(uint64_t& sum, FrameTracer::PhaseID phase) : _sum(sum), _phase(phase) {
+    auto& tracer = FrameTracer::getInstance();
+    _timing = tracer.now();
+    tracer.record(_phase, FrameTracer::PhaseBegin, _timing, -1, QUuid());
 }
 
 AudioMixer::Timer::Timing::~Timing() {
-    _sum += std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now() - _timing).count();
+    auto& tracer = FrameTracer::getInstance();
+    auto now = tracer.now();
+    tracer.record(_phase, FrameTracer::PhaseEnd, now, -1, QUuid());
+    tracer.recordDuration(_phase, now - _timing);
+    _sum += now - _timing;
 }
 
 void AudioMixer::Timer::get(uint64_t& timing, uint64_t& trailing) {
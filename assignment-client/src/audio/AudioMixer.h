@@ -17,6 +17,7 @@
 #include <AudioRingBuffer.h>
 #include <ThreadedAssignment.h>
 #include <UUIDHasher.h>
+#include <shared/FrameTracer.h>
 
 #include "AudioMixerStats.h"
 #include "AudioMixerSlavePool.h"
@@ -44,6 +45,7 @@ public:
     };
 
     static int getStaticJitterFrames() { return _numStaticJitterFrames; }
+    static bool getTimeStretchJitterBuffers() { return _timeStretchJitterBuffers; }
     static bool shouldMute(float quietestFrame) { return quietestFrame > _noiseMutingThreshold; }
     static float getAttenuationPerDoublingInDistance() { return _attenuationPerDoublingInDistance; }
     static const QHash<QString, AABox>& getAudioZones() { return _audioZones; }
@@ -97,36 +99,42 @@ private:
 
     AudioMixerSlavePool _slavePool;
 
+    // sums a phase for the stats packet, and traces it through the FrameTracer
     class Timer {
     public:
+        Timer(const QString& phaseName) : _phase(FrameTracer::getInstance().registerPhase(phaseName)) {}
+
         class Timing{
         public:
-            Timing(uint64_t& sum);
+            Timing(uint64_t& sum, FrameTracer::PhaseID phase);
             ~Timing();
         private:
-            p_high_resolution_clock::time_point _timing;
+            uint64_t _timing;
             uint64_t& _sum;
+            FrameTracer::PhaseID _phase;
         };
 
-        Timing timer() { return Timing(_sum); }
+        Timing timer() { return Timing(_sum, _phase); }
         void get(uint64_t& timing, uint64_t& trailing);
     private:
         static const int TIMER_TRAILING_SECONDS = 10;
 
+        FrameTracer::PhaseID _phase;
         uint64_t _sum { 0 };
         uint64_t _trailing { 0 };
         uint64_t _history[TIMER_TRAILING_SECONDS] {};
         int _index { 0 };
     };
-    Timer _ticTiming;
-    Timer _sleepTiming;
-    Timer _frameTiming;
-    Timer _prepareTiming;
-    Timer _mixTiming;
-    Timer _eventsTiming;
-    Timer _packetsTiming;
+    Timer _ticTiming { "tic" };
+    Timer _sleepTiming { "sleep" };
+    Timer _frameTiming { "frame" };
+    Timer _prepareTiming { "prepare" };
+    Timer _mixTiming { "mix" };
+    Timer _eventsTiming { "events" };
+    Timer _packetsTiming { "packets" };
 
     static int _numStaticJitterFrames; // -1 denotes dynamic jitter buffering
+    static bool _timeStretchJitterBuffers;
     static float _noiseMutingThreshold;
     static float _attenuationPerDoublingInDistance;
     static std::map<QString, CodecPluginPointer> _availableCodecs;
@@ -284,6 +284,7 @@ int AudioMixerClientData::parseData(ReceivedMessage& message) {
                 bool isStereo = channelFlag == 1;
 
                 auto avatarAudioStream = new AvatarAudioStream(isStereo, AudioMixer::getStaticJitterFrames());
+                avatarAudioStream->setTimeStretchEnabled(AudioMixer::getTimeStretchJitterBuffers());
                 avatarAudioStream->setupCodec(_codec, _selectedCodecName, AudioConstants::MONO);
                 qCDebug(audio) << "creating new AvatarAudioStream... codec:" << _selectedCodecName;
 
@@ -485,6 +486,9 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() {
         upstreamStats["not_mixed"] = (double) streamStats._consecutiveNotMixedCount;
         upstreamStats["overflows"] = (double) streamStats._overflowCount;
         upstreamStats["silents_dropped"] = (double) streamStats._framesDropped;
+        upstreamStats["stretch_added_ms"] = avatarAudioStream->getTimeStretchAddedMsecs();
+        upstreamStats["stretch_removed_ms"] = avatarAudioStream->getTimeStretchRemovedMsecs();
+        upstreamStats["jitter_ms"] = avatarAudioStream->getInterArrivalJitterMsecs();
         upstreamStats["lost%"] = streamStats._packetStreamStats.getLostRate() * 100.0f;
         upstreamStats["lost%_30s"] = streamStats._packetStreamWindowStats.getLostRate() * 100.0f;
         upstreamStats["min_gap"] = formatUsecTime(streamStats._timeGapMin);
@@ -22,6 +22,7 @@
 #include <OctreeConstants.h>
 #include <plugins/PluginManager.h>
 #include <plugins/CodecPlugin.h>
+#include <shared/FrameTracer.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 #include <StDev.h>
@@ -45,6 +46,10 @@ void sendSilentPacket(const SharedNodePointer& node, AudioMixerClientData& data)
 void sendMutePacket(const SharedNodePointer& node, AudioMixerClientData&);
 void sendEnvironmentPacket(const SharedNodePointer& node, AudioMixerClientData& data);
 
+// per-node phases, as seen in the frame trace
+static const FrameTracer::PhaseID NODE_PACKETS_PHASE = FrameTracer::getInstance().registerPhase("node_packets");
+static const FrameTracer::PhaseID LISTENER_MIX_PHASE = FrameTracer::getInstance().registerPhase("listener_mix");
+
 // mix helpers
 inline float approximateGain(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd,
         const glm::vec3& relativePosition);
@@ -56,6 +61,7 @@ inline float computeAzimuth(const AvatarAudioStream& listeningNodeStream, const
 void AudioMixerSlave::processPackets(const SharedNodePointer& node) {
     AudioMixerClientData* data = (AudioMixerClientData*)node->getLinkedData();
     if (data) {
+        FrameTracer::Scope scope(NODE_PACKETS_PHASE, _slaveID, node->getUUID());
         data->processPackets();
     }
 }
@@ -91,6 +97,7 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
 
     // send audio packets, if necessary
     if (node->getType() == NodeType::Agent && node->getActiveSocket()) {
+        FrameTracer::Scope scope(LISTENER_MIX_PHASE, _slaveID, node->getUUID());
         ++stats.sumListeners;
 
         // mix the audio
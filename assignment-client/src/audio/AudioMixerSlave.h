@@ -30,6 +30,8 @@ class AudioMixerSlave {
 public:
     using ConstIter = NodeList::const_iterator;
 
+    AudioMixerSlave(int slaveID = 0) : _slaveID(slaveID) {}
+
     // process packets for a given node (requires no configuration)
     void processPackets(const SharedNodePointer& node);
 
@@ -57,6 +59,8 @@ private:
     float _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
     int16_t _bufferSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
 
+    int _slaveID;
+
     // frame state
     ConstIter _begin;
     ConstIter _end;
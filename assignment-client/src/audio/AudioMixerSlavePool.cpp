@@ -167,7 +167,9 @@ void AudioMixerSlavePool::resize(int numThreads) {
     if (numThreads > _numThreads) {
         // start new slaves
         for (int i = 0; i < numThreads - _numThreads; ++i) {
-            auto slave = new AudioMixerSlaveThread(*this);
+            int slaveID = (int)_slaves.size();
+            auto slave = new AudioMixerSlaveThread(*this, slaveID);
+            slave->setObjectName(QString("Audio Mixer Slave %1").arg(slaveID));
             slave->start();
             _slaves.emplace_back(slave);
         }
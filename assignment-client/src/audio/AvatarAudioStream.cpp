@@ -37,12 +37,7 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
         readBytes += sizeof(quint8);
 
         // if isStereo value has changed, restart the ring buffer with new frame size
-        if (isStereo != _isStereo) {
-            _ringBuffer.resizeForFrameSize(isStereo
-                                           ? AudioConstants::NETWORK_FRAME_SAMPLES_STEREO
-                                           : AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
-            _isStereo = isStereo;
-        }
+        setIsStereo(isStereo);
 
         // read the positional data
         readBytes += parsePositionalData(packetAfterSeqNum.mid(readBytes));
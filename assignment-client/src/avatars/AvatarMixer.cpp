@@ -27,6 +27,7 @@
 #include <LogHandler.h>
 #include <NodeList.h>
 #include <udt/PacketHeaders.h>
+#include <shared/FrameTracer.h>
 #include <SharedUtil.h>
 #include <UUID.h>
 #include <TryLocker.h>
@@ -61,6 +62,10 @@ AvatarMixer::AvatarMixer(ReceivedMessage& message) :
 
     packetReceiver.registerListener(PacketType::ReplicatedBulkAvatarData, this, "handleReplicatedBulkAvatarPacket");
 
+    packetReceiver.registerListener(PacketType::CrowdAvatarData, this, "handleCrowdAvatarDataPacket");
+    packetReceiver.registerListener(PacketType::CrowdAvatarIdentity, this, "handleCrowdAvatarIdentityPacket");
+    packetReceiver.registerListener(PacketType::CrowdKillAvatar, this, "handleCrowdKillAvatarPacket");
+
     auto nodeList = DependencyManager::get<NodeList>();
     connect(nodeList.data(), &NodeList::packetVersionMismatch, this, &AvatarMixer::handlePacketVersionMismatch);
     connect(nodeList.data(), &NodeList::nodeAdded, this, [this](const SharedNodePointer& node) {
@@ -137,6 +142,98 @@ void AvatarMixer::handleReplicatedBulkAvatarPacket(QSharedPointer<ReceivedMessag
     }
 }
 
+const int MAX_CROWD_MEMBERS_PER_AGENT = 256;
+
+SharedNodePointer AvatarMixer::addOrUpdateCrowdMember(const QUuid& memberID, const SharedNodePointer& ownerNode) {
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    // only scripted agents run by an assignment-client can play back a crowd
+    if (!ownerNode->getPermissions().isAssignment || memberID.isNull()) {
+        return SharedNodePointer();
+    }
+
+    auto ownerMatch = _crowdMemberOwners.find(memberID);
+    if (ownerMatch == _crowdMemberOwners.end()) {
+        auto& members = _crowdMembers[ownerNode->getUUID()];
+
+        // a new member can't take the ID of a node we already have
+        if (members.size() >= MAX_CROWD_MEMBERS_PER_AGENT || nodeList->nodeWithUUID(memberID)) {
+            return SharedNodePointer();
+        }
+
+        members.insert(memberID);
+        _crowdMemberOwners.insert(memberID, ownerNode->getUUID());
+    } else if (ownerMatch.value() != ownerNode->getUUID()) {
+        return SharedNodePointer();
+    }
+
+    // members are upstream so that we never try to send to them, and replicated if their owner is
+    auto memberNode = nodeList->addOrUpdateNode(memberID, NodeType::Agent,
+                                                ownerNode->getPublicSocket(), ownerNode->getLocalSocket(),
+                                                ownerNode->isReplicated(), true);
+    memberNode->setLastHeardMicrostamp(usecTimestampNow());
+
+    return memberNode;
+}
+
+void AvatarMixer::removeCrowdMember(const QUuid& memberID) {
+    auto ownerMatch = _crowdMemberOwners.find(memberID);
+    if (ownerMatch != _crowdMemberOwners.end()) {
+        auto membersMatch = _crowdMembers.find(ownerMatch.value());
+        if (membersMatch != _crowdMembers.end()) {
+            membersMatch->remove(memberID);
+            if (membersMatch->isEmpty()) {
+                _crowdMembers.erase(membersMatch);
+            }
+        }
+        _crowdMemberOwners.erase(ownerMatch);
+    }
+}
+
+void AvatarMixer::handleCrowdAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    // the same layout as replicated bulk avatar data: member ID, size, then the sequence number and avatar data
+    while (message->getBytesLeftToRead()) {
+        auto memberID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+
+        quint16 avatarByteArraySize;
+        message->readPrimitive(&avatarByteArraySize);
+
+        auto avatarByteArray = message->read(avatarByteArraySize);
+
+        auto memberNode = addOrUpdateCrowdMember(memberID, senderNode);
+        if (!memberNode) {
+            continue;
+        }
+
+        auto memberMessage = QSharedPointer<ReceivedMessage>::create(avatarByteArray, PacketType::AvatarData,
+                                                                     versionForPacketType(PacketType::AvatarData),
+                                                                     message->getSenderSockAddr(), memberID);
+
+        auto start = usecTimestampNow();
+        getOrCreateClientData(memberNode)->queuePacket(memberMessage, memberNode);
+        auto end = usecTimestampNow();
+        _queueIncomingPacketElapsedTime += (end - start);
+    }
+}
+
+void AvatarMixer::handleCrowdAvatarIdentityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    auto memberID = QUuid::fromRfc4122(message->peek(NUM_BYTES_RFC4122_UUID));
+
+    auto memberNode = addOrUpdateCrowdMember(memberID, senderNode);
+    if (memberNode) {
+        handleAvatarIdentityPacket(message, memberNode);
+    }
+}
+
+void AvatarMixer::handleCrowdKillAvatarPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
+    auto memberID = QUuid::fromRfc4122(message->peek(NUM_BYTES_RFC4122_UUID));
+
+    // an agent can only remove its own members, nodeKilled takes care of the bookkeeping
+    if (_crowdMemberOwners.value(memberID) == senderNode->getUUID()) {
+        DependencyManager::get<NodeList>()->killNodeWithUUID(memberID);
+    }
+}
+
 void AvatarMixer::optionallyReplicatePacket(ReceivedMessage& message, const Node& node) {
     // first, make sure that this is a packet from a node we are supposed to replicate
     if (node.isReplicated()) {
@@ -214,18 +311,33 @@ void AvatarMixer::start() {
 
     auto nodeList = DependencyManager::get<NodeList>();
 
+    auto& tracer = FrameTracer::getInstance();
+    const auto FRAME_PHASE = tracer.registerPhase("frame");
+    const auto SLEEP_PHASE = tracer.registerPhase("sleep");
+    const auto PACKETS_PHASE = tracer.registerPhase("packets");
+    const auto IDENTITY_PHASE = tracer.registerPhase("identity");
+    const auto BROADCAST_PHASE = tracer.registerPhase("broadcast");
+    const auto EVENTS_PHASE = tracer.registerPhase("events");
+
     unsigned int frame = 1;
     auto frameTimestamp = p_high_resolution_clock::now();
 
     while (!_isFinished) {
 
-        auto frameDuration = timeFrame(frameTimestamp); // calculates last frame duration and sleeps remainder of target amount
+        std::chrono::microseconds frameDuration;
+        {
+            FrameTracer::Scope sleepScope(SLEEP_PHASE);
+            frameDuration = timeFrame(frameTimestamp); // calculates last frame duration and sleeps remainder of target amount
+        }
         throttle(frameDuration, frame); // determines _throttlingRatio for upcoming mix frame
 
+        FrameTracer::Scope frameScope(FRAME_PHASE);
+
         int lockWait, nodeTransform, functor;
 
         // Allow nodes to process any pending/queued packets across our worker threads
         {
+            FrameTracer::Scope scope(PACKETS_PHASE);
             auto start = usecTimestampNow();
 
             nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
@@ -241,6 +353,7 @@ void AvatarMixer::start() {
         // process pending display names... this doesn't currently run on multiple threads, because it
         // side-effects the mixer's data, which is fine because it's a very low cost operation
         {
+            FrameTracer::Scope scope(IDENTITY_PHASE);
             auto start = usecTimestampNow();
             nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
                 std::for_each(cbegin, cend, [&](const SharedNodePointer& node) {
@@ -257,6 +370,7 @@ void AvatarMixer::start() {
 
         // this is where we need to put the real work...
         {
+            FrameTracer::Scope scope(BROADCAST_PHASE);
             auto start = usecTimestampNow();
             nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
                 auto start = usecTimestampNow();
@@ -279,6 +393,7 @@ void AvatarMixer::start() {
         // play nice with qt event-looping
         {
             // since we're a while loop we need to yield to qt's event processing
+            FrameTracer::Scope scope(EVENTS_PHASE);
             auto start = usecTimestampNow();
             QCoreApplication::processEvents();
             if (_isFinished) {
@@ -424,6 +539,15 @@ void AvatarMixer::throttle(std::chrono::microseconds duration, int frame) {
 }
 
 void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
+    removeCrowdMember(killedNode->getUUID());
+
+    // the members of a crowd leave with the agent playing them back
+    auto crowd = _crowdMembers.take(killedNode->getUUID());
+    for (const auto& memberID : crowd) {
+        _crowdMemberOwners.remove(memberID);
+        DependencyManager::get<NodeList>()->killNodeWithUUID(memberID);
+    }
+
     if (killedNode->getType() == NodeType::Agent
         && killedNode->getLinkedData()) {
         auto nodeList = DependencyManager::get<NodeList>();
@@ -54,6 +54,9 @@ private slots:
     void handleRequestsDomainListDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleReplicatedPacket(QSharedPointer<ReceivedMessage> message);
     void handleReplicatedBulkAvatarPacket(QSharedPointer<ReceivedMessage> message);
+    void handleCrowdAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleCrowdAvatarIdentityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void handleCrowdKillAvatarPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void domainSettingsRequestComplete();
     void handlePacketVersionMismatch(PacketType type, const HifiSockAddr& senderSockAddr, const QUuid& senderUUID);
     void start();
@@ -76,6 +79,14 @@ private:
 
     void optionallyReplicatePacket(ReceivedMessage& message, const Node& node);
 
+    SharedNodePointer addOrUpdateCrowdMember(const QUuid& memberID, const SharedNodePointer& ownerNode);
+    void removeCrowdMember(const QUuid& memberID);
+
+    // crowd members are avatars an assignment-client agent plays back on its own connection,
+    // they live in the node list as upstream agents that are killed along with the agent that owns them
+    QHash<QUuid, QSet<QUuid>> _crowdMembers; // agent ID to the IDs of its members
+    QHash<QUuid, QUuid> _crowdMemberOwners; // member ID to the ID of the agent that owns it
+
     p_high_resolution_clock::time_point _lastFrameTimestamp;
 
     // FIXME - new throttling - use these values somehow
@@ -24,6 +24,7 @@
 #include <OctreeConstants.h>
 #include <PrioritySortUtil.h>
 #include <udt/PacketHeaders.h>
+#include <shared/FrameTracer.h>
 #include <SharedUtil.h>
 #include <StDev.h>
 #include <UUID.h>
@@ -54,10 +55,15 @@ void AvatarMixerSlave::harvestStats(AvatarMixerSlaveStats& stats) {
 }
 
 
+// per-node phases, as seen in the frame trace
+static const FrameTracer::PhaseID NODE_PACKETS_PHASE = FrameTracer::getInstance().registerPhase("node_packets");
+static const FrameTracer::PhaseID NODE_BROADCAST_PHASE = FrameTracer::getInstance().registerPhase("node_broadcast");
+
 void AvatarMixerSlave::processIncomingPackets(const SharedNodePointer& node) {
     auto start = usecTimestampNow();
     auto nodeData = dynamic_cast<AvatarMixerClientData*>(node->getLinkedData());
     if (nodeData) {
+        FrameTracer::Scope scope(NODE_PACKETS_PHASE, _slaveID, node->getUUID());
         _stats.nodesProcessed++;
         _stats.packetsProcessed += nodeData->processPackets();
     }
@@ -99,8 +105,10 @@ void AvatarMixerSlave::broadcastAvatarData(const SharedNodePointer& node) {
     quint64 start = usecTimestampNow();
 
     if (node->getType() == NodeType::Agent && node->getLinkedData() && node->getActiveSocket() && !node->isUpstream()) {
+        FrameTracer::Scope scope(NODE_BROADCAST_PHASE, _slaveID, node->getUUID());
         broadcastAvatarDataToAgent(node);
     } else if (node->getType() == NodeType::DownstreamAvatarMixer) {
+        FrameTracer::Scope scope(NODE_BROADCAST_PHASE, _slaveID, node->getUUID());
         broadcastAvatarDataToDownstreamMixer(node);
     }
 
@@ -392,7 +400,7 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
         quint64 end = usecTimestampNow();
         _stats.toByteArrayElapsedTime += (end - start);
 
-        static const int MAX_ALLOWED_AVATAR_DATA = (1400 - NUM_BYTES_RFC4122_UUID);
+        static const int MAX_ALLOWED_AVATAR_DATA = (1400 - NUM_BYTES_RFC4122_UUID - (int)sizeof(quint16));
         if (bytes.size() > MAX_ALLOWED_AVATAR_DATA) {
             qCWarning(avatars) << "otherAvatar.toByteArray() resulted in very large buffer:" << bytes.size() << "... attempt to drop facial data";
 
@@ -413,7 +421,9 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
         }
 
         if (includeThisAvatar) {
+            // the length lets receivers skip or split up avatars without parsing them
             numAvatarDataBytes += avatarPacketList->write(otherNode->getUUID().toRfc4122());
+            numAvatarDataBytes += avatarPacketList->writePrimitive((quint16)bytes.size());
             numAvatarDataBytes += avatarPacketList->write(bytes);
 
             if (detail != AvatarData::NoData) {
@@ -83,6 +83,8 @@ class AvatarMixerSlave {
 public:
     using ConstIter = NodeList::const_iterator;
 
+    AvatarMixerSlave(int slaveID = 0) : _slaveID(slaveID) {}
+
     void configure(ConstIter begin, ConstIter end);
     void configureBroadcast(ConstIter begin, ConstIter end, 
                     p_high_resolution_clock::time_point lastFrameTimestamp, 
@@ -100,6 +102,8 @@ private:
     void broadcastAvatarDataToAgent(const SharedNodePointer& node);
     void broadcastAvatarDataToDownstreamMixer(const SharedNodePointer& node);
 
+    int _slaveID;
+
     // frame state
     ConstIter _begin;
     ConstIter _end;
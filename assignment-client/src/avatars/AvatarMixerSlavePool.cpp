@@ -168,7 +168,9 @@ void AvatarMixerSlavePool::resize(int numThreads) {
     if (numThreads > _numThreads) {
         // start new slaves
         for (int i = 0; i < numThreads - _numThreads; ++i) {
-            auto slave = new AvatarMixerSlaveThread(*this);
+            int slaveID = (int)_slaves.size();
+            auto slave = new AvatarMixerSlaveThread(*this, slaveID);
+            slave->setObjectName(QString("Avatar Mixer Slave %1").arg(slaveID));
             slave->start();
             _slaves.emplace_back(slave);
         }
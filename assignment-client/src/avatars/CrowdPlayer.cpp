@@ -0,0 +1,316 @@
+//
+//  CrowdPlayer.cpp
+//  assignment-client/src/avatars
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CrowdPlayer.h"
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+#include <QtCore/QThread>
+
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <RegisteredMetaTypes.h>
+#include <SharedUtil.h>
+#include <Transform.h>
+#include <recording/Clip.h>
+#include <shared/QtHelpers.h>
+
+using namespace recording;
+
+// the same rate as the agent's own avatar
+static const int CROWD_DATA_HZ = 45;
+static const int CROWD_DATA_IN_MSECS = MSECS_PER_SECOND / CROWD_DATA_HZ;
+
+CrowdPlayer::CrowdPlayer() {
+    _updateTimer.setSingleShot(false);
+    _updateTimer.setInterval(CROWD_DATA_IN_MSECS);
+    _updateTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_updateTimer, &QTimer::timeout, this, &CrowdPlayer::update);
+
+    _identityTimer.setInterval(AVATAR_IDENTITY_PACKET_SEND_INTERVAL_MSECS);
+    connect(&_identityTimer, &QTimer::timeout, this, &CrowdPlayer::sendIdentityPackets);
+}
+
+CrowdPlayer::~CrowdPlayer() {
+    // may run on any thread, the timers are gone with us so nothing else touches the members
+    for (const auto& member : _members) {
+        sendKillPacket(member.id);
+    }
+}
+
+bool CrowdPlayer::Track::load() {
+    if (loader->isFailed()) {
+        qWarning() << "CrowdPlayer failed to load recording" << url;
+        loader.reset();
+        loaded = true;
+        return false;
+    }
+
+    auto clip = loader->isLoaded() ? loader->getClip() : ClipPointer();
+    if (!clip) {
+        return false;
+    }
+
+    static const FrameType AVATAR_FRAME_TYPE = Frame::registerFrameType(AvatarData::FRAME_NAME);
+
+    // the clip belongs to the cache and may be playing on the deck, so put its playhead back where it was
+    auto position = clip->positionFrameTime();
+    clip->seekFrameTime(0);
+    for (auto frame = clip->nextFrame(); frame; frame = clip->nextFrame()) {
+        if (frame->type == AVATAR_FRAME_TYPE) {
+            times.push_back(frame->timeOffset);
+            frames.push_back(frame);
+        }
+    }
+    clip->seekFrameTime(position);
+
+    duration = Frame::secondsToFrameTime(clip->duration());
+    if (!times.empty()) {
+        duration = std::max(duration, times.back());
+    }
+
+    // the frames hold on to everything we need
+    loader.reset();
+    loaded = true;
+    return true;
+}
+
+CrowdPlayer::TrackPointer CrowdPlayer::getTrack(const QUrl& url) {
+    auto track = _tracks.value(url).lock();
+    if (!track) {
+        track = std::make_shared<Track>();
+        track->url = url;
+        track->loader = DependencyManager::get<ClipCache>()->getClipLoader(url);
+        _tracks[url] = track;
+    }
+    return track;
+}
+
+size_t CrowdPlayer::frameIndexForTime(const Track& track, Frame::Time time, size_t lastIndex) {
+    const auto& times = track.times;
+
+    // members play forwards, so the frame is nearly always the last one or just after it
+    if (lastIndex < times.size() && times[lastIndex] <= time) {
+        while (lastIndex + 1 < times.size() && times[lastIndex + 1] <= time) {
+            ++lastIndex;
+        }
+        return lastIndex;
+    }
+
+    auto next = std::upper_bound(times.begin(), times.end(), time);
+    return (next == times.begin()) ? 0 : (size_t)(next - times.begin()) - 1;
+}
+
+QUuid CrowdPlayer::addMember(const QString& url, const QVariantMap& options) {
+    if (QThread::currentThread() != thread()) {
+        QUuid result;
+        BLOCKING_INVOKE_METHOD(this, "addMember", Q_RETURN_ARG(QUuid, result),
+                               Q_ARG(const QString&, url), Q_ARG(const QVariantMap&, options));
+        return result;
+    }
+
+    if (_members.size() >= (size_t)MAX_MEMBERS) {
+        qWarning() << "CrowdPlayer cannot play more than" << MAX_MEMBERS << "members - not adding" << url;
+        return QUuid();
+    }
+
+    Member member;
+    member.id = QUuid::createUuid();
+    member.track = getTrack(url);
+    member.startTime = usecTimestampNow();
+    member.timeOffset = Frame::secondsToFrameTime(std::max(0.0f, options.value("timeOffset").toFloat()));
+    member.loop = options.value("loop", true).toBool();
+
+    // set up the avatar the same way the agent sets up its own
+    member.avatar = std::make_shared<ScriptableAvatar>();
+    member.avatar->setSessionUUID(member.id);
+    member.avatar->setForceFaceTrackerConnected(true);
+    member.avatar->setSkeletonModelURL(QUrl());
+    member.avatar->getHeadOrientation();
+
+    if (options.contains("displayName")) {
+        member.avatar->setDisplayName(options.value("displayName").toString());
+    }
+
+    if (options.contains("position") || options.contains("orientation")) {
+        auto basis = std::make_shared<Transform>();
+        basis->setTranslation(vec3FromVariant(options.value("position")));
+        basis->setRotation(options.contains("orientation") ? quatFromVariant(options.value("orientation")) : glm::quat());
+        member.avatar->setRecordingBasis(basis);
+    }
+
+    member.avatar->markIdentityDataChanged();
+    _members.push_back(member);
+    _memberCount = (int)_members.size();
+
+    if (!_updateTimer.isActive()) {
+        _updateTimer.start();
+        _identityTimer.start();
+    }
+
+    return member.id;
+}
+
+void CrowdPlayer::removeMember(const QUuid& memberID) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "removeMember", Q_ARG(const QUuid&, memberID));
+        return;
+    }
+
+    auto it = std::find_if(_members.begin(), _members.end(), [&](const Member& member) {
+        return member.id == memberID;
+    });
+    if (it == _members.end()) {
+        return;
+    }
+
+    auto url = it->track->url;
+    _members.erase(it);
+    _memberCount = (int)_members.size();
+    sendKillPacket(memberID);
+
+    // drop the track once nobody plays it
+    if (_tracks.value(url).expired()) {
+        _tracks.remove(url);
+    }
+
+    if (_members.empty()) {
+        _updateTimer.stop();
+        _identityTimer.stop();
+    }
+}
+
+void CrowdPlayer::removeAllMembers() {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "removeAllMembers");
+        return;
+    }
+
+    for (const auto& member : _members) {
+        sendKillPacket(member.id);
+    }
+    _members.clear();
+    _memberCount = (int)_members.size();
+    _tracks.clear();
+
+    _updateTimer.stop();
+    _identityTimer.stop();
+}
+
+int CrowdPlayer::getMemberCount() const {
+    return _memberCount;
+}
+
+void CrowdPlayer::update() {
+    auto nodeList = DependencyManager::get<NodeList>();
+    auto avatarMixer = nodeList->soloNodeOfType(NodeType::AvatarMixer);
+    bool canSend = avatarMixer && avatarMixer->getActiveSocket();
+
+    // every member goes in its own segment of one packet list, in the layout of replicated bulk avatar data
+    auto avatarPacketList = NLPacketList::create(PacketType::CrowdAvatarData);
+    int maximumByteArraySize = (int)avatarPacketList->getMaxSegmentSize() - NUM_BYTES_RFC4122_UUID
+        - sizeof(quint16) - sizeof(AvatarDataSequenceNumber);
+    int numMembersSent = 0;
+
+    auto now = usecTimestampNow();
+    for (auto& member : _members) {
+        auto& track = *member.track;
+        if (!track.loaded && !track.load()) {
+            continue;
+        }
+        if (track.frames.empty()) {
+            continue;
+        }
+
+        // pose the avatar from the frame under its playhead, if that moved on to a new frame
+        quint64 time = (now - member.startTime) / USECS_PER_MSEC + member.timeOffset;
+        if (member.loop && track.duration > 0) {
+            time %= track.duration;
+        }
+        auto frameIndex = frameIndexForTime(track, (Frame::Time)std::min<quint64>(time, Frame::INVALID_TIME - 1),
+                                            member.frameIndex);
+        if (frameIndex != member.frameIndex) {
+            member.frameIndex = frameIndex;
+            AvatarData::fromFrame(track.frames[frameIndex]->data, *member.avatar);
+        }
+
+        if (!canSend) {
+            continue;
+        }
+
+        if (member.avatar->getIdentityDataChanged()) {
+            sendIdentityPacket(member, avatarMixer);
+        }
+
+        auto& avatar = *member.avatar;
+        AvatarData::AvatarDataDetail dataDetail = (randFloat() < AVATAR_SEND_FULL_UPDATE_RATIO) ? AvatarData::SendAllData : AvatarData::CullSmallData;
+        QByteArray avatarByteArray = avatar.toByteArrayStateful(dataDetail);
+
+        if (avatarByteArray.size() > maximumByteArraySize) {
+            avatarByteArray = avatar.toByteArrayStateful(dataDetail, true);
+
+            if (avatarByteArray.size() > maximumByteArraySize) {
+                avatarByteArray = avatar.toByteArrayStateful(AvatarData::MinimumData, true);
+
+                if (avatarByteArray.size() > maximumByteArraySize) {
+                    qWarning() << "CrowdPlayer member" << member.id << "MinimumData resulted in very large buffer:"
+                        << avatarByteArray.size() << "... FAIL!!";
+                    continue;
+                }
+            }
+        }
+
+        avatar.doneEncoding(true);
+
+        avatarPacketList->startSegment();
+        avatarPacketList->write(member.id.toRfc4122());
+        avatarPacketList->writePrimitive((quint16)(avatarByteArray.size() + sizeof(AvatarDataSequenceNumber)));
+        avatarPacketList->writePrimitive(member.sequenceNumber++);
+        avatarPacketList->write(avatarByteArray);
+        avatarPacketList->endSegment();
+
+        ++numMembersSent;
+    }
+
+    if (numMembersSent > 0) {
+        nodeList->sendPacketList(std::move(avatarPacketList), *avatarMixer);
+    }
+}
+
+void CrowdPlayer::sendIdentityPacket(Member& member, const SharedNodePointer& avatarMixer) {
+    auto identityPackets = NLPacketList::create(PacketType::CrowdAvatarIdentity, QByteArray(), true, true);
+    identityPackets->write(member.avatar->takeIdentityByteArray());
+    DependencyManager::get<NodeList>()->sendPacketList(std::move(identityPackets), *avatarMixer);
+}
+
+void CrowdPlayer::sendIdentityPackets() {
+    auto avatarMixer = DependencyManager::get<NodeList>()->soloNodeOfType(NodeType::AvatarMixer);
+    if (!avatarMixer || !avatarMixer->getActiveSocket()) {
+        return;
+    }
+
+    for (auto& member : _members) {
+        sendIdentityPacket(member, avatarMixer);
+    }
+}
+
+void CrowdPlayer::sendKillPacket(const QUuid& memberID) {
+    auto nodeList = DependencyManager::get<NodeList>();
+    auto avatarMixer = nodeList->soloNodeOfType(NodeType::AvatarMixer);
+    if (!avatarMixer || !avatarMixer->getActiveSocket()) {
+        return;
+    }
+
+    auto packet = NLPacket::create(PacketType::CrowdKillAvatar, NUM_BYTES_RFC4122_UUID + sizeof(KillAvatarReason), true);
+    packet->write(memberID.toRfc4122());
+    packet->writePrimitive(KillAvatarReason::NoReason);
+    nodeList->sendPacket(std::move(packet), *avatarMixer);
+}
@@ -0,0 +1,98 @@
+//
+//  CrowdPlayer.h
+//  assignment-client/src/avatars
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CrowdPlayer_h
+#define hifi_CrowdPlayer_h
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
+#include <QtCore/QUuid>
+#include <QtCore/QVariantMap>
+
+#include <DependencyManager.h>
+#include <recording/ClipCache.h>
+#include <recording/Frame.h>
+
+#include "ScriptableAvatar.h"
+
+// Plays back recordings on many avatars from a single agent. Every recording is read once and its avatar frames are
+// shared by all the members playing it, each member keeps its own playhead and time offset. On every tick the members
+// are posed from their frames and their avatar data is sent to the avatar mixer in one packet list, which gives each
+// member a node of its own for as long as the agent is connected.
+class CrowdPlayer : public QObject, public Dependency {
+    Q_OBJECT
+    SINGLETON_DEPENDENCY
+
+public:
+    static const int MAX_MEMBERS = 256; // the most members the avatar mixer accepts from one agent
+
+    ~CrowdPlayer();
+
+public slots:
+    // options are timeOffset (seconds), loop (true by default), position, orientation and displayName.
+    // when a position or orientation is given the recording plays relative to it, otherwise where it was recorded.
+    // returns the ID of the new member, or a null ID if the crowd is full
+    QUuid addMember(const QString& url, const QVariantMap& options = QVariantMap());
+    void removeMember(const QUuid& memberID);
+    void removeAllMembers();
+    int getMemberCount() const;
+
+private slots:
+    void update();
+    void sendIdentityPackets();
+
+private:
+    CrowdPlayer();
+
+    static const size_t INVALID_FRAME_INDEX = (size_t)-1;
+
+    // the avatar frames of one recording, read once and shared by every member that plays it
+    struct Track {
+        QUrl url;
+        recording::NetworkClipLoaderPointer loader;
+        std::vector<recording::Frame::Time> times;
+        std::vector<recording::FrameConstPointer> frames;
+        recording::Frame::Time duration { 0 };
+        bool loaded { false };
+
+        bool load();
+    };
+    using TrackPointer = std::shared_ptr<Track>;
+
+    struct Member {
+        QUuid id;
+        std::shared_ptr<ScriptableAvatar> avatar;
+        TrackPointer track;
+        quint64 startTime { 0 }; // usecs
+        recording::Frame::Time timeOffset { 0 };
+        bool loop { true };
+        size_t frameIndex { INVALID_FRAME_INDEX };
+        AvatarDataSequenceNumber sequenceNumber { 0 };
+    };
+
+    TrackPointer getTrack(const QUrl& url);
+    static size_t frameIndexForTime(const Track& track, recording::Frame::Time time, size_t lastIndex);
+    void sendIdentityPacket(Member& member, const SharedNodePointer& avatarMixer);
+    void sendKillPacket(const QUuid& memberID);
+
+    std::vector<Member> _members;
+    std::atomic<int> _memberCount { 0 }; // the members are only touched on our thread, but counted from any
+    QHash<QUrl, std::weak_ptr<Track>> _tracks;
+    QTimer _updateTimer;
+    QTimer _identityTimer;
+};
+
+#endif // hifi_CrowdPlayer_h
@@ -24,6 +24,15 @@ QByteArray ScriptableAvatar::toByteArrayStateful(AvatarDataDetail dataDetail, bo
     return AvatarData::toByteArrayStateful(dataDetail);
 }
 
+QByteArray ScriptableAvatar::takeIdentityByteArray() {
+    if (_identityDataChanged) {
+        // if the identity data has changed, push the sequence number forwards
+        ++_identitySequenceNumber;
+        _identityDataChanged = false;
+    }
+    return identityByteArray();
+}
+
 
 // hold and priority unused but kept so that client side JS can run.
 void ScriptableAvatar::startAnimation(const QString& url, float fps, float priority,
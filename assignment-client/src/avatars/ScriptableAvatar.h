@@ -30,6 +30,9 @@ public:
 
     virtual QByteArray toByteArrayStateful(AvatarDataDetail dataDetail, bool dropFaceTracking = false) override;
 
+    // the identity data sendIdentityPacket would send, for avatars that are sent on behalf of another node
+    QByteArray takeIdentityByteArray();
+
     
 private slots:
     void update(float deltatime);
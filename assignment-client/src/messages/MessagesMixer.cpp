@@ -9,11 +9,14 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QJsonObject>
 #include <QBuffer>
 #include <LogHandler.h>
 #include <MessagesClient.h>
+#include <NumericalConstants.h>
 #include <NodeList.h>
 #include <udt/PacketHeaders.h>
 #include "MessagesMixer.h"
@@ -30,40 +33,132 @@ MessagesMixer::MessagesMixer(ReceivedMessage& message) : ThreadedAssignment(mess
 }
 
 void MessagesMixer::nodeKilled(SharedNodePointer killedNode) {
-    for (auto& channel : _channelSubscribers) {
-        channel.remove(killedNode->getUUID());
+    auto channelIDs = _nodeChannels.take(killedNode->getUUID());
+    for (ChannelID channelID : channelIDs) {
+        removeSubscriber(channelID, killedNode->getUUID());
+    }
+}
+
+MessagesMixer::ChannelID MessagesMixer::findChannel(const QString& name) const {
+    return _channelIDs.value(name, INVALID_CHANNEL_ID);
+}
+
+MessagesMixer::ChannelID MessagesMixer::findOrAddChannel(const QString& name) {
+    ChannelID channelID = findChannel(name);
+    if (channelID != INVALID_CHANNEL_ID) {
+        return channelID;
+    }
+
+    if (_freeChannelIDs.empty()) {
+        channelID = (ChannelID)_channels.size();
+        _channels.emplace_back();
+    } else {
+        channelID = _freeChannelIDs.back();
+        _freeChannelIDs.pop_back();
+        _channels[channelID] = Channel();
+    }
+    _channels[channelID].name = name;
+    _channelIDs.insert(name, channelID);
+    return channelID;
+}
+
+void MessagesMixer::removeSubscriber(ChannelID channelID, const QUuid& nodeID) {
+    auto& subscribers = _channels[channelID].subscribers;
+    auto it = std::find_if(subscribers.begin(), subscribers.end(), [&](const SharedNodePointer& node) {
+        return node->getUUID() == nodeID;
+    });
+    if (it != subscribers.end()) {
+        // order doesn't matter, so swap in the last one rather than shifting everything down
+        *it = subscribers.back();
+        subscribers.pop_back();
     }
 }
 
 void MessagesMixer::handleMessages(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
-    QString channel, message;
-    QByteArray data;
-    QUuid senderID;
-    bool isText;
-    MessagesClient::decodeMessagesPacket(receivedMessage, channel, isText, message, data, senderID);
+    // only the channel is needed here, the rest of the message goes back out exactly as it came in
+    quint16 channelLength;
+    receivedMessage->readPrimitive(&channelLength);
+    QString channel = QString::fromUtf8(receivedMessage->read(channelLength));
+
+    ChannelID channelID = findChannel(channel);
+    if (channelID == INVALID_CHANNEL_ID) {
+        return;
+    }
+
+    QByteArray payload = receivedMessage->getMessage();
+    auto& stats = _channels[channelID];
+    stats.messagesIn++;
+    stats.bytesIn += payload.size();
+
+    if (stats.subscribers.empty()) {
+        return;
+    }
+
+    if (_pendingMessages.empty()) {
+        QMetaObject::invokeMethod(this, "sendPendingMessages", Qt::QueuedConnection);
+    }
+    _pendingMessages.push_back({ channelID, payload });
+}
+
+void MessagesMixer::sendPendingMessages() {
+    if (_pendingMessages.empty()) {
+        return;
+    }
+
+    // gather what each destination gets, keeping the order the messages came in
+    QHash<QUuid, std::pair<SharedNodePointer, std::vector<const PendingMessage*>>> destinations;
+    for (const auto& pendingMessage : _pendingMessages) {
+        auto& channel = _channels[pendingMessage.channelID];
+        for (const auto& node : channel.subscribers) {
+            auto& destination = destinations[node->getUUID()];
+            if (!destination.first) {
+                destination.first = node;
+            }
+            destination.second.push_back(&pendingMessage);
+        }
+    }
 
     auto nodeList = DependencyManager::get<NodeList>();
+    for (const auto& destination : destinations) {
+        const auto& node = destination.first;
+        if (!node->getActiveSocket()) {
+            continue;
+        }
+        for (const PendingMessage* pendingMessage : destination.second) {
+            // each message still needs its own reliable list, since clients read one message per list
+            auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+            packetList->write(pendingMessage->payload);
+            nodeList->sendPacketList(std::move(packetList), *node);
 
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-        return node->getActiveSocket() && _channelSubscribers[channel].contains(node->getUUID());
-    },
-        [&](const SharedNodePointer& node) {
-        auto packetList = isText ? MessagesClient::encodeMessagesPacket(channel, message, senderID) :
-                                   MessagesClient::encodeMessagesDataPacket(channel, data, senderID);
-        nodeList->sendPacketList(std::move(packetList), *node);
-    });
+            auto& channel = _channels[pendingMessage->channelID];
+            channel.messagesOut++;
+            channel.bytesOut += pendingMessage->payload.size();
+        }
+    }
+
+    _pendingMessages.clear();
 }
 
 void MessagesMixer::handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     QString channel = QString::fromUtf8(message->getMessage());
-    _channelSubscribers[channel] << senderNode->getUUID();
+    ChannelID channelID = findOrAddChannel(channel);
+
+    auto& nodeChannels = _nodeChannels[senderNode->getUUID()];
+    if (!nodeChannels.contains(channelID)) {
+        nodeChannels << channelID;
+        _channels[channelID].subscribers.push_back(senderNode);
+    }
 }
 
 void MessagesMixer::handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
     QString channel = QString::fromUtf8(message->getMessage());
-    if (_channelSubscribers.contains(channel)) {
-        _channelSubscribers[channel].remove(senderNode->getUUID());
+    ChannelID channelID = findChannel(channel);
+    if (channelID != INVALID_CHANNEL_ID) {
+        removeSubscriber(channelID, senderNode->getUUID());
+        auto it = _nodeChannels.find(senderNode->getUUID());
+        if (it != _nodeChannels.end()) {
+            it.value().removeOne(channelID);
+        }
     }
 }
 
@@ -80,6 +175,42 @@ void MessagesMixer::sendStatsPacket() {
     });
 
     statsObject["messages"] = messagesMixerObject;
+
+    // add rates for each channel, and let go of the ones nobody is using anymore
+    quint64 now = usecTimestampNow();
+    float intervalSeconds = _lastStatsTime == 0 ? 0.0f : (float)(now - _lastStatsTime) / USECS_PER_SECOND;
+    _lastStatsTime = now;
+
+    QJsonObject channelsObject;
+    for (ChannelID channelID = 0; channelID < (ChannelID)_channels.size(); channelID++) {
+        auto& channel = _channels[channelID];
+        if (channel.name.isNull()) {
+            continue;
+        }
+        if (channel.subscribers.empty() && channel.messagesIn == 0) {
+            _channelIDs.remove(channel.name);
+            channel = Channel();
+            _freeChannelIDs.push_back(channelID);
+            continue;
+        }
+
+        QJsonObject channelStats;
+        channelStats["subscribers"] = (int)channel.subscribers.size();
+        if (intervalSeconds > 0.0f) {
+            channelStats["messages_in_per_second"] = channel.messagesIn / intervalSeconds;
+            channelStats["messages_out_per_second"] = channel.messagesOut / intervalSeconds;
+            channelStats["inbound_kbps"] = channel.bytesIn * BITS_IN_BYTE / (intervalSeconds * BYTES_PER_KILOBYTE);
+            channelStats["outbound_kbps"] = channel.bytesOut * BITS_IN_BYTE / (intervalSeconds * BYTES_PER_KILOBYTE);
+        }
+        channelsObject[channel.name] = channelStats;
+
+        channel.messagesIn = 0;
+        channel.bytesIn = 0;
+        channel.messagesOut = 0;
+        channel.bytesOut = 0;
+    }
+    statsObject["channels"] = channelsObject;
+
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
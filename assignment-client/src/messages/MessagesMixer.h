@@ -15,6 +15,8 @@
 #ifndef hifi_MessagesMixer_h
 #define hifi_MessagesMixer_h
 
+#include <vector>
+
 #include <ThreadedAssignment.h>
 
 /// Handles assignments of type MessagesMixer - distribution of avatar data to various clients
@@ -32,9 +34,42 @@ private slots:
     void handleMessages(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
     void handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
+    void sendPendingMessages();
 
 private:
-    QHash<QString,QSet<QUuid>> _channelSubscribers;
+    using ChannelID = int;
+    static const ChannelID INVALID_CHANNEL_ID = -1;
+
+    struct Channel {
+        QString name;
+        std::vector<SharedNodePointer> subscribers;
+
+        // since the last stats packet
+        quint64 messagesIn { 0 };
+        quint64 bytesIn { 0 };
+        quint64 messagesOut { 0 };
+        quint64 bytesOut { 0 };
+    };
+
+    // a received message, already encoded for sending back out as is
+    struct PendingMessage {
+        ChannelID channelID;
+        QByteArray payload;
+    };
+
+    ChannelID findChannel(const QString& name) const;
+    ChannelID findOrAddChannel(const QString& name);
+    void removeSubscriber(ChannelID channelID, const QUuid& nodeID);
+
+    QHash<QString, ChannelID> _channelIDs;
+    std::vector<Channel> _channels;
+    std::vector<ChannelID> _freeChannelIDs;
+    QHash<QUuid, QVector<ChannelID>> _nodeChannels;
+
+    // messages received during this pass of the event loop, sent out together once it is done
+    std::vector<PendingMessage> _pendingMessages;
+
+    quint64 _lastStatsTime { 0 };
 };
 
 #endif // hifi_MessagesMixer_h
@@ -9,8 +9,15 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+#include <functional>
 #include <limits>
 
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
 #include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <PerfStat.h>
@@ -22,6 +29,28 @@
 static QUuid DEFAULT_NODE_ID_REF;
 const quint64 TOO_LONG_SINCE_LAST_NACK = 1 * USECS_PER_SECOND;
 
+// Bounds how long one batch holds the tree's write lock, and so how long the send threads can wait for it
+static const size_t MAX_PACKETS_PER_EDIT_BATCH { 64 };
+
+// A batch is decoded on the processing thread alone unless it holds at least this many packets per thread
+static const size_t MIN_PACKETS_PER_DECODE_THREAD { 4 };
+
+class EditPacketDecoder : public QRunnable {
+public:
+    using Decode = std::function<void()>;
+
+    EditPacketDecoder(Decode decode, QSemaphore& done) : _decode(decode), _done(done) {}
+
+    void run() override {
+        _decode();
+        _done.release();
+    }
+
+private:
+    Decode _decode;
+    QSemaphore& _done;
+};
+
 OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServer) :
     _myServer(myServer),
     _receivedPacketCount(0),
@@ -30,9 +59,18 @@ OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServe
     _totalLockWaitTime(0),
     _totalElementsInPacket(0),
     _totalPackets(0),
+    _totalQueueDelay(0),
+    _lastEditsWindowAt(usecTimestampNow()),
+    _decodePool(new QThreadPool()),
     _lastNackTime(usecTimestampNow()),
     _shuttingDown(false)
 {
+    _decodePool->setObjectName("OctreeEditDecoder");
+    _decodePool->setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+}
+
+OctreeInboundPacketProcessor::~OctreeInboundPacketProcessor() {
+    _decodePool->waitForDone();
 }
 
 void OctreeInboundPacketProcessor::resetStats() {
@@ -41,6 +79,7 @@ void OctreeInboundPacketProcessor::resetStats() {
     _totalLockWaitTime = 0;
     _totalElementsInPacket = 0;
     _totalPackets = 0;
+    _totalQueueDelay = 0;
     _lastNackTime = usecTimestampNow();
 
     QWriteLocker locker(&_senderStatsLock);
@@ -64,6 +103,14 @@ void OctreeInboundPacketProcessor::preProcess() {
         _lastNackTime = now;
         sendNackPackets();
     }
+
+    quint64 sinceLastEditsWindow = now - _lastEditsWindowAt;
+    if (sinceLastEditsWindow > USECS_PER_SECOND) {
+        float secondsSinceLastEditsWindow = (float)sinceLastEditsWindow / USECS_PER_SECOND;
+        _editsPerSecond.updateAverage((float)_editsInWindow / secondsSinceLastEditsWindow);
+        _lastEditsWindowAt = now;
+        _editsInWindow = 0;
+    }
 }
 
 void OctreeInboundPacketProcessor::midProcess() {
@@ -218,16 +265,149 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
                 qDebug() << "sender has no known nodeUUID.";
             }
         }
-        trackInboundPacket(nodeUUID, sequence, transitTime, editsInPacket, processTime, lockWaitTime);
+        quint64 queueDelay = arrivedAt > _currentPacketQueuedAt ? arrivedAt - _currentPacketQueuedAt : 0;
+        trackInboundPacket(nodeUUID, sequence, transitTime, editsInPacket, processTime, lockWaitTime, queueDelay);
     } else {
         qDebug("unknown packet ignored... packetType=%hhu", (unsigned char)packetType);
     }
 }
 
+// Runs of edit packets are processed in batches: each packet is decoded whole on one of the decoding threads, and the
+// batch's edits are then applied under one write lock, in the order their packets arrived. Any other packet ends the
+// batch, and is processed on its own once the edits before it have been applied.
+void OctreeInboundPacketProcessor::processPackets(std::list<QueuedPacket>& packets) {
+    auto tree = _myServer->getOctree();
+    // verbose and receive debugging follow each edit packet through processPacket()
+    bool canBatchEdits = tree->canDecodeEditsConcurrently() && !_myServer->wantsVerboseDebug() &&
+        !_myServer->wantsDebugReceiving();
+
+    std::vector<DecodedEditPacket> batch;
+    for (auto& packet : packets) {
+        if (canBatchEdits && tree->handlesEditPacketType(packet.message->getType())) {
+            DecodedEditPacket decodedPacket;
+            decodedPacket.message = packet.message;
+            decodedPacket.sendingNode = packet.sendingNode;
+            decodedPacket.queuedAt = packet.queuedAt;
+            batch.push_back(std::move(decodedPacket));
+            if (batch.size() >= MAX_PACKETS_PER_EDIT_BATCH) {
+                processEditBatch(batch);
+            }
+        } else {
+            processEditBatch(batch);
+            _currentPacketQueuedAt = packet.queuedAt;
+            processPacket(packet.message, packet.sendingNode);
+            _lastWindowProcessedPackets++;
+            midProcess();
+        }
+    }
+    processEditBatch(batch);
+}
+
+void OctreeInboundPacketProcessor::decodeEditPacket(DecodedEditPacket& packet) {
+    auto tree = _myServer->getOctree();
+    ReceivedMessage& message = *packet.message;
+    PacketType packetType = message.getType();
+
+    message.readPrimitive(&packet.sequence);
+
+    quint64 sentAt;
+    message.readPrimitive(&sentAt);
+
+    quint64 arrivedAt = usecTimestampNow();
+    if (sentAt > arrivedAt) {
+        sentAt = arrivedAt;
+    }
+    packet.transitTime = arrivedAt - sentAt;
+
+    packet.editsInPacket = 0;
+    while (message.getBytesLeftToRead() > 0) {
+        const unsigned char* editData =
+            reinterpret_cast<const unsigned char*>(message.getRawMessage() + message.getPosition());
+        int maxSize = message.getBytesLeftToRead();
+
+        OctreeDecodedEditPointer edit;
+        int editDataBytesRead = tree->decodeEditPacketData(packetType, editData, maxSize, packet.sendingNode, edit);
+        if (edit) {
+            packet.edits.push_back(std::move(edit));
+        }
+        packet.editsInPacket++;
+
+        // an edit that can't be read leaves nothing else in the packet that can be
+        if (editDataBytesRead <= 0) {
+            break;
+        }
+        message.seek(message.getPosition() + editDataBytesRead);
+    }
+    packet.decodeTime = usecTimestampNow() - arrivedAt;
+}
+
+void OctreeInboundPacketProcessor::processEditBatch(std::vector<DecodedEditPacket>& batch) {
+    if (batch.empty()) {
+        return;
+    }
+    if (_shuttingDown) {
+        qDebug() << "OctreeInboundPacketProcessor::processEditBatch() while shutting down... ignoring incoming packets";
+        batch.clear();
+        return;
+    }
+
+    // the packets are split into contiguous ranges, and the first range is decoded on this thread
+    auto decodeRange = [this, &batch](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            decodeEditPacket(batch[i]);
+        }
+    };
+    size_t numThreads = std::max((size_t)1, std::min((size_t)_decodePool->maxThreadCount() + 1,
+                                                     batch.size() / MIN_PACKETS_PER_DECODE_THREAD));
+    size_t packetsPerThread = (batch.size() + numThreads - 1) / numThreads;
+
+    QSemaphore done;
+    int numStarted = 0;
+    for (size_t first = packetsPerThread; first < batch.size(); first += packetsPerThread) {
+        size_t last = std::min(first + packetsPerThread, batch.size());
+        _decodePool->start(new EditPacketDecoder([=] { decodeRange(first, last); }, done));
+        numStarted++;
+    }
+    decodeRange(0, std::min(packetsPerThread, batch.size()));
+    done.acquire(numStarted);
+
+    auto tree = _myServer->getOctree();
+    quint64 startLock = usecTimestampNow();
+    quint64 startApply = startLock;
+    tree->withWriteLock([&] {
+        startApply = usecTimestampNow();
+        quint64 startPacket = startApply;
+        for (auto& packet : batch) {
+            for (auto& edit : packet.edits) {
+                tree->applyDecodedEdit(*edit, packet.sendingNode);
+            }
+            quint64 endPacket = usecTimestampNow();
+            packet.applyTime = endPacket - startPacket;
+            startPacket = endPacket;
+        }
+    });
+
+    // the batch waited for the lock once, so each of its packets is charged an equal share of that wait
+    quint64 lockWaitTime = (startApply - startLock) / batch.size();
+    for (auto& packet : batch) {
+        QUuid nodeUUID = packet.sendingNode ? packet.sendingNode->getUUID() : DEFAULT_NODE_ID_REF;
+        quint64 queueDelay = startApply > packet.queuedAt ? startApply - packet.queuedAt : 0;
+        trackInboundPacket(nodeUUID, packet.sequence, packet.transitTime, packet.editsInPacket,
+                           packet.decodeTime + packet.applyTime, lockWaitTime, queueDelay);
+    }
+
+    _receivedPacketCount += (int)batch.size();
+    _lastWindowProcessedPackets += (int)batch.size();
+    batch.clear();
+    midProcess();
+}
+
 void OctreeInboundPacketProcessor::trackInboundPacket(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
-            int editsInPacket, quint64 processTime, quint64 lockWaitTime) {
+            int editsInPacket, quint64 processTime, quint64 lockWaitTime, quint64 queueDelay) {
 
     _totalTransitTime += transitTime;
+    _totalQueueDelay += queueDelay;
+    _editsInWindow += editsInPacket;
     _totalProcessTime += processTime;
     _totalLockWaitTime += lockWaitTime;
     _totalElementsInPacket += editsInPacket;
@@ -14,11 +14,16 @@
 #ifndef hifi_OctreeInboundPacketProcessor_h
 #define hifi_OctreeInboundPacketProcessor_h
 
+#include <memory>
+#include <vector>
+
+#include <Octree.h>
 #include <ReceivedPacketProcessor.h>
 
 #include "SequenceNumberStats.h"
 
 class OctreeServer;
+class QThreadPool;
 
 class SingleSenderStats {
 public:
@@ -59,6 +64,7 @@ class OctreeInboundPacketProcessor : public ReceivedPacketProcessor {
     Q_OBJECT
 public:
     OctreeInboundPacketProcessor(OctreeServer* myServer);
+    ~OctreeInboundPacketProcessor();
 
     quint64 getAverageTransitTimePerPacket() const { return _totalPackets == 0 ? 0 : _totalTransitTime / _totalPackets; }
     quint64 getAverageProcessTimePerPacket() const { return _totalPackets == 0 ? 0 : _totalProcessTime / _totalPackets; }
@@ -69,6 +75,8 @@ public:
                 { return _totalElementsInPacket == 0 ? 0 : _totalProcessTime / _totalElementsInPacket; }
     quint64 getAverageLockWaitTimePerElement() const
                 { return _totalElementsInPacket == 0 ? 0 : _totalLockWaitTime / _totalElementsInPacket; }
+    quint64 getAverageQueueDelayPerPacket() const { return _totalPackets == 0 ? 0 : _totalQueueDelay / _totalPackets; }
+    float getEditsPerSecond() const { return _editsPerSecond.getAverage(); }
 
     void resetStats();
 
@@ -79,6 +87,7 @@ public:
 protected:
 
     virtual void processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) override;
+    virtual void processPackets(std::list<QueuedPacket>& packets) override;
 
     virtual uint32_t getMaxWait() const override;
     virtual void preProcess() override;
@@ -88,8 +97,23 @@ private:
     int sendNackPackets();
 
 private:
+    struct DecodedEditPacket {
+        QSharedPointer<ReceivedMessage> message;
+        SharedNodePointer sendingNode;
+        quint64 queuedAt;
+        unsigned short int sequence;
+        quint64 transitTime;
+        int editsInPacket;
+        std::vector<OctreeDecodedEditPointer> edits;
+        quint64 decodeTime;
+        quint64 applyTime;
+    };
+
+    void decodeEditPacket(DecodedEditPacket& packet);
+    void processEditBatch(std::vector<DecodedEditPacket>& batch);
+
     void trackInboundPacket(const QUuid& nodeUUID, unsigned short int sequence, quint64 transitTime,
-            int elementsInPacket, quint64 processTime, quint64 lockWaitTime);
+            int elementsInPacket, quint64 processTime, quint64 lockWaitTime, quint64 queueDelay);
 
     OctreeServer* _myServer;
     int _receivedPacketCount;
@@ -99,7 +123,15 @@ private:
     std::atomic<uint64_t> _totalLockWaitTime;
     std::atomic<uint64_t> _totalElementsInPacket;
     std::atomic<uint64_t> _totalPackets;
-    
+    std::atomic<uint64_t> _totalQueueDelay;
+
+    quint64 _currentPacketQueuedAt { 0 };
+    quint64 _lastEditsWindowAt { 0 };
+    int _editsInWindow { 0 };
+    SimpleMovingAverage _editsPerSecond;
+
+    std::unique_ptr<QThreadPool> _decodePool;
+
     NodeToSenderStatsMap _singleSenderStats;
     QReadWriteLock _senderStatsLock;
 
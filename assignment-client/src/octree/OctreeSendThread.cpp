@@ -360,7 +360,8 @@ int OctreeSendThread::packetDistributor(SharedNodePointer node, OctreeQueryNode*
     int targetSize = MAX_OCTREE_PACKET_DATA_SIZE;
     targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE);
 
-    _packetData.changeSettings(true, targetSize); // FIXME - eventually support only compressed packets
+    _packetData.changeSettings(true, targetSize, nodeData->isPacketCompact()); // FIXME - eventually support only compressed packets
+    _packetData.setStringDictionary(nodeData->isPacketCompact() ? nodeData->getStringDictionary() : OctreeStringDictionaryPointer());
 
     // If the current view frustum has changed OR we have nothing to send, then search against
     // the current view frustum for things to send.
@@ -574,7 +575,8 @@ void OctreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, Octre
                 // little bit of padding.
                 targetSize = nodeData->getAvailable() - sizeof(OCTREE_PACKET_INTERNAL_SECTION_SIZE) - COMPRESS_PADDING;
             }
-            _packetData.changeSettings(true, targetSize); // will do reset - NOTE: Always compressed
+            _packetData.changeSettings(true, targetSize, nodeData->isPacketCompact()); // will do reset - NOTE: Always compressed
+            _packetData.setStringDictionary(nodeData->isPacketCompact() ? nodeData->getStringDictionary() : OctreeStringDictionaryPointer());
         }
         OctreeServer::trackCompressAndWriteTime(compressAndWriteElapsedUsec);
         OctreeServer::trackPacketSendingTime(packetSendingElapsedUsec);
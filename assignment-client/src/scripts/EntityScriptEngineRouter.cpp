@@ -0,0 +1,226 @@
+//
+//  EntityScriptEngineRouter.cpp
+//  assignment-client/src/scripts
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityScriptEngineRouter.h"
+
+#include <algorithm>
+
+using Lock = std::lock_guard<std::mutex>;
+
+// weight given to the latest measurement when smoothing a script's cost
+static const float COST_SMOOTHING = 0.25f;
+// costs that decay below this are forgotten
+static const float MIN_TRACKED_COST = 1.0f;
+
+void EntityScriptEngineRouter::setEngines(std::vector<ScriptEnginePointer> engines) {
+    Lock lock(_lock);
+    _engines.swap(engines);
+    _assignments.clear();
+}
+
+std::vector<ScriptEnginePointer> EntityScriptEngineRouter::getEngines() const {
+    Lock lock(_lock);
+    return _engines;
+}
+
+int EntityScriptEngineRouter::getNumEngines() const {
+    Lock lock(_lock);
+    return (int)_engines.size();
+}
+
+ScriptEnginePointer EntityScriptEngineRouter::getEngine(const EntityItemID& entityID) const {
+    Lock lock(_lock);
+    auto it = _assignments.constFind(entityID);
+    if (it == _assignments.constEnd()) {
+        return ScriptEnginePointer();
+    }
+    return _engines[it.value()];
+}
+
+ScriptEnginePointer EntityScriptEngineRouter::assignEngine(const EntityItemID& entityID) {
+    Lock lock(_lock);
+    if (_engines.empty()) {
+        return ScriptEnginePointer();
+    }
+
+    auto it = _assignments.constFind(entityID);
+    if (it != _assignments.constEnd()) {
+        return _engines[it.value()];
+    }
+
+    int engineIndex;
+    if (_costs.contains(entityID)) {
+        // we've seen this script run before, so put it wherever there is the most room for it
+        auto loads = computeEngineLoads();
+        auto lightest = std::min_element(loads.begin(), loads.end(), [](const EngineLoad& a, const EngineLoad& b) {
+            return a.usecsPerSecond < b.usecsPerSecond;
+        });
+        engineIndex = (int)(lightest - loads.begin());
+    } else {
+        engineIndex = (int)(qHash(entityID) % _engines.size());
+    }
+
+    _assignments.insert(entityID, engineIndex);
+    return _engines[engineIndex];
+}
+
+void EntityScriptEngineRouter::reassignEngine(const EntityItemID& entityID, int engineIndex) {
+    Lock lock(_lock);
+    if (engineIndex >= 0 && engineIndex < (int)_engines.size()) {
+        _assignments[entityID] = engineIndex;
+    }
+}
+
+void EntityScriptEngineRouter::unassignEngine(const EntityItemID& entityID) {
+    Lock lock(_lock);
+    _assignments.remove(entityID);
+    _costs.remove(entityID);
+}
+
+QList<EntityItemID> EntityScriptEngineRouter::getAssignedEntities() const {
+    Lock lock(_lock);
+    return _assignments.keys();
+}
+
+void EntityScriptEngineRouter::updateCosts(float intervalSeconds) {
+    if (intervalSeconds <= 0.0f) {
+        return;
+    }
+
+    // grab the samples before taking our lock, the engines have their own
+    auto engines = getEngines();
+    QHash<EntityItemID, quint64> samples;
+    for (auto& engine : engines) {
+        auto engineSamples = engine->takeEntityScriptCPUTimes();
+        for (auto it = engineSamples.constBegin(); it != engineSamples.constEnd(); ++it) {
+            samples[it.key()] += it.value();
+        }
+    }
+
+    Lock lock(_lock);
+    for (auto it = _costs.begin(); it != _costs.end();) {
+        float measured = (float)samples.take(it.key()) / intervalSeconds;
+        it.value() += COST_SMOOTHING * (measured - it.value());
+        if (it.value() < MIN_TRACKED_COST && !_assignments.contains(it.key())) {
+            it = _costs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = samples.constBegin(); it != samples.constEnd(); ++it) {
+        if (_assignments.contains(it.key())) {
+            _costs.insert(it.key(), COST_SMOOTHING * (float)it.value() / intervalSeconds);
+        }
+    }
+}
+
+std::vector<EntityScriptEngineRouter::Move> EntityScriptEngineRouter::findRebalanceMoves(float budgetUsecsPerSecond) const {
+    Lock lock(_lock);
+    std::vector<Move> moves;
+    if (_engines.size() < 2) {
+        return moves;
+    }
+
+    auto loads = computeEngineLoads();
+    for (int engineIndex = 0; engineIndex < (int)loads.size(); engineIndex++) {
+        const auto& load = loads[engineIndex];
+        if (load.usecsPerSecond <= budgetUsecsPerSecond || load.numScripts < 2) {
+            continue;
+        }
+
+        auto lightest = std::min_element(loads.begin(), loads.end(), [](const EngineLoad& a, const EngineLoad& b) {
+            return a.usecsPerSecond < b.usecsPerSecond;
+        });
+        int targetIndex = (int)(lightest - loads.begin());
+        float imbalance = load.usecsPerSecond - lightest->usecsPerSecond;
+
+        // move the most expensive script that still leaves the pair better balanced than it was,
+        // a script that costs more than the imbalance would just make the other engine the busy one
+        EntityItemID bestEntityID;
+        float bestCost = 0.0f;
+        for (auto it = _assignments.constBegin(); it != _assignments.constEnd(); ++it) {
+            if (it.value() != engineIndex) {
+                continue;
+            }
+            float cost = _costs.value(it.key(), 0.0f);
+            if (cost > bestCost && cost < imbalance) {
+                bestEntityID = it.key();
+                bestCost = cost;
+            }
+        }
+
+        if (bestCost > 0.0f) {
+            moves.push_back(Move(bestEntityID, targetIndex));
+            loads[engineIndex].usecsPerSecond -= bestCost;
+            loads[engineIndex].numScripts--;
+            loads[targetIndex].usecsPerSecond += bestCost;
+            loads[targetIndex].numScripts++;
+        }
+    }
+    return moves;
+}
+
+std::vector<EntityScriptEngineRouter::EngineLoad> EntityScriptEngineRouter::getEngineLoads() const {
+    Lock lock(_lock);
+    return computeEngineLoads();
+}
+
+std::vector<EntityScriptEngineRouter::EntityScriptCost> EntityScriptEngineRouter::getCostliestScripts(int maxScripts) const {
+    std::vector<EntityScriptCost> scripts;
+    {
+        Lock lock(_lock);
+        scripts.reserve(_assignments.size());
+        for (auto it = _assignments.constBegin(); it != _assignments.constEnd(); ++it) {
+            scripts.push_back({ it.key(), it.value(), _costs.value(it.key(), 0.0f) });
+        }
+    }
+
+    auto end = scripts.begin() + std::min((int)scripts.size(), std::max(maxScripts, 0));
+    std::partial_sort(scripts.begin(), end, scripts.end(), [](const EntityScriptCost& a, const EntityScriptCost& b) {
+        return a.usecsPerSecond > b.usecsPerSecond;
+    });
+    scripts.erase(end, scripts.end());
+    return scripts;
+}
+
+void EntityScriptEngineRouter::callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                                      const QStringList& params, const QUuid& remoteCallerID) {
+    auto engine = getEngineOrDefault(entityID);
+    if (engine) {
+        engine->callEntityScriptMethod(entityID, methodName, params, remoteCallerID);
+    }
+}
+
+QFuture<QVariant> EntityScriptEngineRouter::getLocalEntityScriptDetails(const EntityItemID& entityID) {
+    auto engine = getEngineOrDefault(entityID);
+    if (engine) {
+        return engine->getLocalEntityScriptDetails(entityID);
+    }
+    // never started, which callers report as the provider being unavailable
+    return QFuture<QVariant>();
+}
+
+ScriptEnginePointer EntityScriptEngineRouter::getEngineOrDefault(const EntityItemID& entityID) const {
+    Lock lock(_lock);
+    if (_engines.empty()) {
+        return ScriptEnginePointer();
+    }
+    return _engines[_assignments.value(entityID, 0)];
+}
+
+std::vector<EntityScriptEngineRouter::EngineLoad> EntityScriptEngineRouter::computeEngineLoads() const {
+    std::vector<EngineLoad> loads(_engines.size());
+    for (auto it = _assignments.constBegin(); it != _assignments.constEnd(); ++it) {
+        auto& load = loads[it.value()];
+        load.numScripts++;
+        load.usecsPerSecond += _costs.value(it.key(), 0.0f);
+    }
+    return loads;
+}
@@ -0,0 +1,82 @@
+//
+//  EntityScriptEngineRouter.h
+//  assignment-client/src/scripts
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityScriptEngineRouter_h
+#define hifi_EntityScriptEngineRouter_h
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <QtCore/QHash>
+
+#include <EntitiesScriptEngineProvider.h>
+#include <ScriptEngine.h>
+
+// Shards the entity server scripts across a set of script engines, each running on its own thread.
+//
+// Scripts are first placed by hashing their entity ID. The router then keeps a smoothed measure of the CPU time each
+// script uses, and can suggest moves off of engines that go over their budget. Calls coming from other scripts through
+// the EntityScriptingInterface are forwarded to whichever engine runs the target entity.
+class EntityScriptEngineRouter : public EntitiesScriptEngineProvider {
+public:
+    struct EntityScriptCost {
+        EntityItemID entityID;
+        int engineIndex;
+        float usecsPerSecond;
+    };
+
+    struct EngineLoad {
+        int numScripts { 0 };
+        float usecsPerSecond { 0.0f };
+    };
+
+    using Move = std::pair<EntityItemID, int>;
+
+    // replaces the engines and forgets every assignment, the measured costs are kept
+    void setEngines(std::vector<ScriptEnginePointer> engines);
+    std::vector<ScriptEnginePointer> getEngines() const;
+    int getNumEngines() const;
+
+    // the engine that runs the script for this entity, or nullptr if it has not been assigned one
+    ScriptEnginePointer getEngine(const EntityItemID& entityID) const;
+    // the engine that runs the script for this entity, assigning it one first if needed
+    ScriptEnginePointer assignEngine(const EntityItemID& entityID);
+    void reassignEngine(const EntityItemID& entityID, int engineIndex);
+    void unassignEngine(const EntityItemID& entityID);
+    QList<EntityItemID> getAssignedEntities() const;
+
+    // pulls the CPU time used by each script from the engines, given the time elapsed since the last update
+    void updateCosts(float intervalSeconds);
+
+    // picks at most one script to move off of each engine that uses more than its budget
+    std::vector<Move> findRebalanceMoves(float budgetUsecsPerSecond) const;
+
+    std::vector<EngineLoad> getEngineLoads() const;
+    std::vector<EntityScriptCost> getCostliestScripts(int maxScripts) const;
+
+    // EntitiesScriptEngineProvider
+    void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                const QStringList& params = QStringList(), const QUuid& remoteCallerID = QUuid()) override;
+    QFuture<QVariant> getLocalEntityScriptDetails(const EntityItemID& entityID) override;
+
+private:
+    ScriptEnginePointer getEngineOrDefault(const EntityItemID& entityID) const;
+    std::vector<EngineLoad> computeEngineLoads() const;
+
+    mutable std::mutex _lock;
+    std::vector<ScriptEnginePointer> _engines;
+    QHash<EntityItemID, int> _assignments;
+    QHash<EntityItemID, float> _costs; // smoothed usecs of CPU per second
+};
+
+using EntityScriptEngineRouterPointer = QSharedPointer<EntityScriptEngineRouter>;
+
+#endif // hifi_EntityScriptEngineRouter_h
@@ -52,7 +52,10 @@ void messageHandler(QtMsgType type, const QMessageLogContext& context, const QSt
 
 int EntityScriptServer::_entitiesScriptEngineCount = 0;
 
-EntityScriptServer::EntityScriptServer(ReceivedMessage& message) : ThreadedAssignment(message) {
+EntityScriptServer::EntityScriptServer(ReceivedMessage& message) :
+    ThreadedAssignment(message),
+    _entitiesScriptEngines(new EntityScriptEngineRouter())
+{
     qInstallMessageHandler(messageHandler);
 
     DependencyManager::get<EntityScriptingInterface>()->setPacketSender(&_entityEditSender);
@@ -113,7 +116,10 @@ void EntityScriptServer::handleReloadEntityServerScriptPacket(QSharedPointer<Rec
 
         if (_entityViewer.getTree() && !_shuttingDown) {
             qCDebug(entity_script_server) << "Reloading: " << entityID;
-            _entitiesScriptEngine->unloadEntityScript(entityID);
+            auto engine = _entitiesScriptEngines->getEngine(entityID);
+            if (engine) {
+                engine->unloadEntityScript(entityID);
+            }
             checkAndCallPreload(entityID, true);
         }
     }
@@ -131,7 +137,8 @@ void EntityScriptServer::handleEntityScriptGetStatusPacket(QSharedPointer<Receiv
         replyPacketList->writePrimitive(messageID);
 
         EntityScriptDetails details;
-        if (_entitiesScriptEngine->getEntityScriptDetails(entityID, details)) {
+        auto engine = _entitiesScriptEngines->getEngine(entityID);
+        if (engine && engine->getEntityScriptDetails(entityID, details)) {
             replyPacketList->writePrimitive(true);
             replyPacketList->writePrimitive(details.status);
             replyPacketList->writeString(details.errorInfo);
@@ -160,6 +167,26 @@ void EntityScriptServer::handleSettings() {
 
     auto entityScriptServerSettings = settingsObject[ENTITY_SCRIPT_SERVER_SETTINGS_KEY].toObject();
 
+    static const QString NUM_SCRIPT_ENGINES_OPTION = "num_script_engines";
+    static const QString SCRIPT_ENGINE_FRAME_BUDGET_OPTION = "script_engine_frame_budget";
+
+    if (entityScriptServerSettings.contains(SCRIPT_ENGINE_FRAME_BUDGET_OPTION)) {
+        // the setting is in milliseconds
+        auto frameBudget = entityScriptServerSettings[SCRIPT_ENGINE_FRAME_BUDGET_OPTION].toDouble() * USECS_PER_MSEC;
+        _entityScriptFrameBudget = std::max(1, (int)frameBudget);
+    }
+
+    if (entityScriptServerSettings.contains(NUM_SCRIPT_ENGINES_OPTION)) {
+        int numEngines = std::min(std::max(1, entityScriptServerSettings[NUM_SCRIPT_ENGINES_OPTION].toInt()),
+                                  MAX_NUM_ENTITY_SCRIPT_ENGINES);
+        if (numEngines != _numEntityScriptEngines) {
+            qCDebug(entity_script_server) << "Changing number of entity script engines from" << _numEntityScriptEngines
+                << "to" << numEngines;
+            _numEntityScriptEngines = numEngines;
+            reloadAllEntityScripts();
+        }
+    }
+
     static const QString MAX_ENTITY_PPS_OPTION = "max_total_entity_pps";
     static const QString ENTITY_PPS_PER_SCRIPT = "entity_pps_per_script";
 
@@ -176,7 +203,10 @@ void EntityScriptServer::handleSettings() {
 }
 
 void EntityScriptServer::updateEntityPPS() {
-    int numRunningScripts = _entitiesScriptEngine->getNumRunningEntityScripts();
+    int numRunningScripts = 0;
+    for (auto& engine : _entitiesScriptEngines->getEngines()) {
+        numRunningScripts += engine->getNumRunningEntityScripts();
+    }
     int pps;
     if (std::numeric_limits<int>::max() / _entityPPSPerScript < numRunningScripts) {
         qWarning() << QString("Integer multiplaction would overflow, clamping to maxint: %1 * %2").arg(numRunningScripts).arg(_entityPPSPerScript);
@@ -239,7 +269,7 @@ void EntityScriptServer::pushLogs() {
 
 void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
 
-    if (_entitiesScriptEngine && _entityViewer.getTree() && !_shuttingDown) {
+    if (_entitiesScriptEngines->getNumEngines() > 0 && _entityViewer.getTree() && !_shuttingDown) {
         auto entityID = QUuid::fromRfc4122(receivedMessage->read(NUM_BYTES_RFC4122_UUID));
 
         auto method = receivedMessage->readString();
@@ -253,7 +283,7 @@ void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<Recei
             params << paramString;
         }
 
-        _entitiesScriptEngine->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
+        _entitiesScriptEngines->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
     }
 }
 
@@ -280,8 +310,16 @@ void EntityScriptServer::run() {
         NodeType::EntityServer, NodeType::MessagesMixer, NodeType::AssetServer
     });
 
-    // Setup Script Engine
-    resetEntitiesScriptEngine();
+    // Setup Script Engines, entity scripts from elsewhere reach them through the router
+    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(_entitiesScriptEngines);
+    resetEntitiesScriptEngines();
+
+    static const int REBALANCE_INTERVAL = MSECS_PER_SECOND;
+    _lastRebalance = usecTimestampNow();
+    auto rebalanceTimer = new QTimer(this);
+    rebalanceTimer->setInterval(REBALANCE_INTERVAL);
+    connect(rebalanceTimer, &QTimer::timeout, this, &EntityScriptServer::rebalanceEntityScripts);
+    rebalanceTimer->start();
 
     // we need to make sure that init has been called for our EntityScriptingInterface
     // so that it actually has a jurisdiction listener when we ask it for it next
@@ -440,7 +478,7 @@ void EntityScriptServer::selectAudioFormat(const QString& selectedCodecName) {
     }
 }
 
-void EntityScriptServer::resetEntitiesScriptEngine() {
+ScriptEnginePointer EntityScriptServer::createEntitiesScriptEngine(bool isPrimary) {
     auto engineName = QString("about:Entities %1").arg(++_entitiesScriptEngineCount);
     auto newEngine = scriptEngineFactory(ScriptEngine::ENTITY_SERVER_SCRIPT, NO_SCRIPT, engineName);
 
@@ -456,43 +494,73 @@ void EntityScriptServer::resetEntitiesScriptEngine() {
     connect(newEngine.data(), &ScriptEngine::warningMessage, scriptEngines, &ScriptEngines::onWarningMessage);
     connect(newEngine.data(), &ScriptEngine::infoMessage, scriptEngines, &ScriptEngines::onInfoMessage);
 
-    connect(newEngine.data(), &ScriptEngine::update, this, [this] {
-        _entityViewer.queryOctree();
-        _entityViewer.getTree()->update();
-    });
-
+    // only one engine drives the tree, the others would just repeat the same queries and simulation
+    if (isPrimary) {
+        connect(newEngine.data(), &ScriptEngine::update, this, [this] {
+            _entityViewer.queryOctree();
+            _entityViewer.getTree()->update();
+        });
+    }
 
     newEngine->runInThread();
-    auto newEngineSP = qSharedPointerCast<EntitiesScriptEngineProvider>(newEngine);
-    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(newEngineSP);
-
-    disconnect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
-               this, &EntityScriptServer::updateEntityPPS);
-    _entitiesScriptEngine.swap(newEngine);
-    connect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
-            this, &EntityScriptServer::updateEntityPPS);
+    return newEngine;
 }
 
+void EntityScriptServer::resetEntitiesScriptEngines() {
+    for (auto& engine : _entitiesScriptEngines->getEngines()) {
+        disconnect(engine.data(), &ScriptEngine::entityScriptDetailsUpdated,
+                   this, &EntityScriptServer::updateEntityPPS);
+    }
+
+    std::vector<ScriptEnginePointer> newEngines;
+    for (int i = 0; i < _numEntityScriptEngines; i++) {
+        newEngines.push_back(createEntitiesScriptEngine(i == 0));
+    }
+    _entitiesScriptEngines->setEngines(newEngines);
+
+    for (auto& engine : newEngines) {
+        connect(engine.data(), &ScriptEngine::entityScriptDetailsUpdated,
+                this, &EntityScriptServer::updateEntityPPS);
+    }
+}
+
+void EntityScriptServer::reloadAllEntityScripts() {
+    if (_shuttingDown || _entitiesScriptEngines->getNumEngines() == 0) {
+        return;
+    }
+
+    auto entityIDs = _entitiesScriptEngines->getAssignedEntities();
+    for (auto& engine : _entitiesScriptEngines->getEngines()) {
+        engine->unloadAllEntityScripts();
+        engine->stop();
+    }
+
+    resetEntitiesScriptEngines();
+
+    for (auto& entityID : entityIDs) {
+        checkAndCallPreload(entityID);
+    }
+}
 
 void EntityScriptServer::clear() {
-    // unload and stop the engine
-    if (_entitiesScriptEngine) {
+    // unload and stop the engines
+    for (auto& engine : _entitiesScriptEngines->getEngines()) {
         // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
-        _entitiesScriptEngine->unloadAllEntityScripts();
-        _entitiesScriptEngine->stop();
+        engine->unloadAllEntityScripts();
+        engine->stop();
     }
 
     _entityViewer.clear();
 
-    // reset the engine
+    // reset the engines
     if (!_shuttingDown) {
-        resetEntitiesScriptEngine();
+        resetEntitiesScriptEngines();
     }
 }
 
 void EntityScriptServer::shutdownScriptEngine() {
-    if (_entitiesScriptEngine) {
-        _entitiesScriptEngine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
+    for (auto& engine : _entitiesScriptEngines->getEngines()) {
+        engine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
     }
     _shuttingDown = true;
 
@@ -504,37 +572,104 @@ void EntityScriptServer::addingEntity(const EntityItemID& entityID) {
 }
 
 void EntityScriptServer::deletingEntity(const EntityItemID& entityID) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
-        _entitiesScriptEngine->unloadEntityScript(entityID, true);
+    if (_entityViewer.getTree() && !_shuttingDown) {
+        auto engine = _entitiesScriptEngines->getEngine(entityID);
+        if (engine) {
+            engine->unloadEntityScript(entityID, true);
+        }
+        _entitiesScriptEngines->unassignEngine(entityID);
     }
 }
 
 void EntityScriptServer::entityServerScriptChanging(const EntityItemID& entityID, bool reload) {
     if (_entityViewer.getTree() && !_shuttingDown) {
-        _entitiesScriptEngine->unloadEntityScript(entityID, true);
+        auto engine = _entitiesScriptEngines->getEngine(entityID);
+        if (engine) {
+            engine->unloadEntityScript(entityID, true);
+        }
         checkAndCallPreload(entityID, reload);
     }
 }
 
 void EntityScriptServer::checkAndCallPreload(const EntityItemID& entityID, bool reload) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
+    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngines->getNumEngines() > 0) {
 
         EntityItemPointer entity = _entityViewer.getTree()->findEntityByEntityItemID(entityID);
+        auto engine = _entitiesScriptEngines->getEngine(entityID);
         EntityScriptDetails details;
-        bool notRunning = !_entitiesScriptEngine->getEntityScriptDetails(entityID, details);
+        bool notRunning = !engine || !engine->getEntityScriptDetails(entityID, details);
         if (entity && (reload || notRunning || details.scriptText != entity->getServerScripts())) {
             QString scriptUrl = entity->getServerScripts();
             if (!scriptUrl.isEmpty()) {
+                if (!engine) {
+                    engine = _entitiesScriptEngines->assignEngine(entityID);
+                }
                 scriptUrl = DependencyManager::get<ResourceManager>()->normalizeURL(scriptUrl);
                 qCDebug(entity_script_server) << "Loading entity server script" << scriptUrl << "for" << entityID;
-                _entitiesScriptEngine->loadEntityScript(entityID, scriptUrl, reload);
+                engine->loadEntityScript(entityID, scriptUrl, reload);
+            } else {
+                _entitiesScriptEngines->unassignEngine(entityID);
             }
         }
     }
 }
 
+void EntityScriptServer::rebalanceEntityScripts() {
+    auto now = usecTimestampNow();
+    float interval = (float)(now - _lastRebalance) / USECS_PER_SECOND;
+    _lastRebalance = now;
+
+    // keep the costs current even with a single engine, they are reported in the stats
+    _entitiesScriptEngines->updateCosts(interval);
+
+    if (!_entityViewer.getTree() || _shuttingDown) {
+        return;
+    }
+
+    // moving a script reloads it on the other engine, so this only happens when an engine is over budget
+    float budgetPerSecond = (float)_entityScriptFrameBudget * SCRIPT_FPS;
+    auto moves = _entitiesScriptEngines->findRebalanceMoves(budgetPerSecond);
+    for (auto& move : moves) {
+        auto& entityID = move.first;
+        auto oldEngine = _entitiesScriptEngines->getEngine(entityID);
+        if (!oldEngine) {
+            continue;
+        }
+
+        qCInfo(entity_script_server) << "Moving entity script for" << entityID << "to engine" << move.second
+            << "- its engine is over its budget of" << budgetPerSecond << "usecs per second";
+        oldEngine->unloadEntityScript(entityID, true);
+        _entitiesScriptEngines->reassignEngine(entityID, move.second);
+        checkAndCallPreload(entityID);
+    }
+}
+
 void EntityScriptServer::sendStatsPacket() {
+    static const int MAX_REPORTED_SCRIPTS = 10;
+
+    QJsonObject statsObject, scriptsObject, enginesObject, costliestObject;
+
+    auto loads = _entitiesScriptEngines->getEngineLoads();
+    for (int i = 0; i < (int)loads.size(); i++) {
+        QJsonObject engineStats;
+        engineStats["num_scripts"] = loads[i].numScripts;
+        engineStats["cpu_usecs_per_second"] = loads[i].usecsPerSecond;
+        enginesObject[QString("engine_%1").arg(i)] = engineStats;
+    }
+
+    for (auto& script : _entitiesScriptEngines->getCostliestScripts(MAX_REPORTED_SCRIPTS)) {
+        QJsonObject scriptStats;
+        scriptStats["engine"] = script.engineIndex;
+        scriptStats["cpu_usecs_per_second"] = script.usecsPerSecond;
+        costliestObject[uuidStringWithoutCurlyBraces(script.entityID)] = scriptStats;
+    }
+
+    scriptsObject["frame_budget_usecs"] = _entityScriptFrameBudget;
+    scriptsObject["engines"] = enginesObject;
+    scriptsObject["costliest_scripts"] = costliestObject;
+    statsObject["entity_scripts"] = scriptsObject;
 
+    ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
 void EntityScriptServer::handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -23,6 +23,11 @@
 #include <ScriptEngine.h>
 #include <ThreadedAssignment.h>
 #include "../entities/EntityTreeHeadlessViewer.h"
+#include "EntityScriptEngineRouter.h"
+
+static const int DEFAULT_NUM_ENTITY_SCRIPT_ENGINES = 1;
+static const int MAX_NUM_ENTITY_SCRIPT_ENGINES = 16;
+static const int DEFAULT_ENTITY_SCRIPT_FRAME_BUDGET_USECS = 8000;
 
 class EntityScriptServer : public ThreadedAssignment {
     Q_OBJECT
@@ -56,12 +61,15 @@ private slots:
 
     void handleEntityScriptCallMethodPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
+    void rebalanceEntityScripts();
 
 private:
     void negotiateAudioFormat();
     void selectAudioFormat(const QString& selectedCodecName);
 
-    void resetEntitiesScriptEngine();
+    ScriptEnginePointer createEntitiesScriptEngine(bool isPrimary);
+    void resetEntitiesScriptEngines();
+    void reloadAllEntityScripts();
     void clear();
     void shutdownScriptEngine();
 
@@ -75,7 +83,10 @@ private:
     bool _shuttingDown { false };
 
     static int _entitiesScriptEngineCount;
-    ScriptEnginePointer _entitiesScriptEngine;
+    EntityScriptEngineRouterPointer _entitiesScriptEngines;
+    int _numEntityScriptEngines { DEFAULT_NUM_ENTITY_SCRIPT_ENGINES };
+    int _entityScriptFrameBudget { DEFAULT_ENTITY_SCRIPT_FRAME_BUDGET_USECS };
+    quint64 _lastRebalance { 0 };
     EntityEditPacketSender _entityEditSender;
     EntityTreeHeadlessViewer _entityViewer;
 
@@ -669,6 +669,7 @@ void DomainServer::setupNodeListAndAssignments() {
     packetReceiver.registerListener(PacketType::DomainListRequest, this, "processListRequestPacket");
     packetReceiver.registerListener(PacketType::DomainServerPathQuery, this, "processPathQueryPacket");
     packetReceiver.registerListener(PacketType::NodeJsonStats, this, "processNodeJSONStatsPacket");
+    packetReceiver.registerListener(PacketType::NodeTraceReply, this, "processNodeTraceReplyPacket");
     packetReceiver.registerListener(PacketType::DomainDisconnectRequest, this, "processNodeDisconnectRequestPacket");
 
     // NodeList won't be available to the settings manager when it is created, so call registerListener here
@@ -1108,7 +1109,7 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
 }
 
 void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr) {
-    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2;
+    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2 + NUM_BYTES_RFC4122_UUID;
 
     // setup the extended header for the domain list packets
     // this data is at the beginning of each of the domain list packets
@@ -1121,13 +1122,14 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
     extendedHeaderStream << node->getUUID();
     extendedHeaderStream << node->getPermissions();
 
+    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+    extendedHeaderStream << nodeData->getDomainConnectionSecret();
+
     auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
 
     // always send the node their own UUID back
     QDataStream domainListStream(domainListPackets.get());
 
-    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
-
     // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
     auto& nodeInterestSet = nodeData->getNodeInterestSet();
 
@@ -1694,6 +1696,18 @@ void DomainServer::processNodeJSONStatsPacket(QSharedPointer<ReceivedMessage> pa
     }
 }
 
+void DomainServer::processNodeTraceReplyPacket(QSharedPointer<ReceivedMessage> packetList, SharedNodePointer sendingNode) {
+    QByteArray trace = qUncompress(packetList->getMessage());
+
+    // answer everyone who asked this node for a trace while we waited on it
+    for (auto& connection : _pendingFrameTraceConnections.values(sendingNode->getUUID())) {
+        if (connection) {
+            connection->respond(HTTPConnection::StatusCode200, trace, "application/json");
+        }
+    }
+    _pendingFrameTraceConnections.remove(sendingNode->getUUID());
+}
+
 QJsonObject DomainServer::jsonForSocket(const HifiSockAddr& socket) {
     QJsonObject socketJSON;
 
@@ -1998,6 +2012,38 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         } else if (url.path() == URI_API_PLACES) {
             return forwardMetaverseAPIRequest(connection, "/api/v1/user/places", "");
         } else {
+            // check if this is for the frame trace of a node, which we have to ask the node for
+            const QString NODE_TRACE_REGEX_STRING = QString("\\%1\\/(%2)\\/trace.json\\/?$").arg(URI_NODES).arg(UUID_REGEX_STRING);
+            QRegExp nodeTraceRegex(NODE_TRACE_REGEX_STRING);
+
+            if (nodeTraceRegex.indexIn(url.path()) != -1) {
+                QUuid matchingUUID = QUuid(nodeTraceRegex.cap(1));
+
+                SharedNodePointer matchingNode = nodeList->nodeWithUUID(matchingUUID);
+                if (!matchingNode || !matchingNode->getActiveSocket()) {
+                    return false;
+                }
+
+                // sign the request with the secret from the node's domain list, since it has no node entry for us
+                auto nodeData = static_cast<DomainServerNodeData*>(matchingNode->getLinkedData());
+                auto traceRequestPacket = NLPacket::create(PacketType::NodeTraceRequest, 0, true);
+                nodeList->sendPacket(std::move(traceRequestPacket), *matchingNode->getActiveSocket(),
+                                     nodeData->getDomainConnectionSecret());
+
+                // respond once the node sends the trace back, or give up if it never does
+                QPointer<HTTPConnection> pendingConnection { connection };
+                _pendingFrameTraceConnections.insert(matchingUUID, pendingConnection);
+
+                static const int FRAME_TRACE_TIMEOUT_MSECS = 10 * MSECS_PER_SECOND;
+                QTimer::singleShot(FRAME_TRACE_TIMEOUT_MSECS, this, [this, matchingUUID, pendingConnection] {
+                    if (_pendingFrameTraceConnections.remove(matchingUUID, pendingConnection) > 0 && pendingConnection) {
+                        pendingConnection->respond(HTTPConnection::StatusCode500, "Timed out waiting for the node's frame trace");
+                    }
+                });
+
+                return true;
+            }
+
             // check if this is for json stats for a node
             const QString NODE_JSON_REGEX_STRING = QString("\\%1\\/(%2).json\\/?$").arg(URI_NODES).arg(UUID_REGEX_STRING);
             QRegExp nodeShowRegex(NODE_JSON_REGEX_STRING);
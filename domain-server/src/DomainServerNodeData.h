@@ -48,6 +48,9 @@ public:
 
     QHash<QUuid, QUuid>& getSessionSecretHash() { return _sessionSecretHash; }
 
+    // the secret we sign sourced packets to this node with, the node gets it in each domain list
+    const QUuid& getDomainConnectionSecret() const { return _domainConnectionSecret; }
+
     const NodeSet& getNodeInterestSet() const { return _nodeInterestSet; }
     void setNodeInterestSet(const NodeSet& nodeInterestSet) { _nodeInterestSet = nodeInterestSet; }
     
@@ -74,6 +77,7 @@ private:
     QJsonArray overrideValuesIfNeeded(const QJsonArray& newStats);
     
     QHash<QUuid, QUuid> _sessionSecretHash;
+    QUuid _domainConnectionSecret { QUuid::createUuid() };
     QUuid _assignmentUUID;
     QUuid _walletUUID;
     QString _username;
@@ -0,0 +1,123 @@
+//
+//  HeartbeatLoadGenerator.cpp
+//  ice-server/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "HeartbeatLoadGenerator.h"
+
+#include <algorithm>
+
+#include <openssl/rsa.h>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QTimer>
+
+#include <NetworkPeer.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <udt/PacketHeaders.h>
+
+#include "IceServer.h"
+
+// heartbeats allowed to be waiting on a reply, anything unanswered after a second is counted as lost
+const int MAX_OUTSTANDING_HEARTBEATS = 512;
+const int LOG_RATE_INTERVAL_MSECS = 1000;
+
+HeartbeatLoadGenerator::HeartbeatLoadGenerator(IceServer* iceServer, int numDomains, QObject* parent) :
+    QObject(parent),
+    _socket(this),
+    _iceServerSockAddr(QHostAddress::LocalHost, ICE_SERVER_DEFAULT_PORT)
+{
+    // the same kind of key the domain-servers generate
+    const unsigned long RSA_KEY_EXPONENT = 65537;
+    const int RSA_KEY_BITS = 2048;
+    RSA* keyPair = RSA_new();
+    BIGNUM* exponent = BN_new();
+    BN_set_word(exponent, RSA_KEY_EXPONENT);
+    bool generated = RSA_generate_key_ex(keyPair, RSA_KEY_BITS, exponent, NULL);
+    BN_free(exponent);
+    if (!generated) {
+        qWarning() << "Heartbeat load generator could not generate a keypair";
+        RSA_free(keyPair);
+        return;
+    }
+    IceServer::RSAPointer publicKey(RSAPublicKey_dup(keyPair), RSA_free);
+
+    _socket.bind(QHostAddress::LocalHost);
+    HifiSockAddr localSocket(QHostAddress::LocalHost, _socket.localPort());
+
+    for (int i = 0; i < numDomains; i++) {
+        QUuid domainID = QUuid::createUuid();
+        iceServer->setDomainPublicKey(domainID, publicKey);
+
+        // the same layout DomainServer::sendHeartbeatToIceServer uses
+        auto heartbeat = NLPacket::create(PacketType::ICEServerHeartbeat);
+        QDataStream heartbeatStream(heartbeat.get());
+        heartbeatStream << domainID << localSocket << localSocket;
+
+        auto plaintext = QByteArray::fromRawData(heartbeat->getPayload(), heartbeat->getPayloadSize());
+        QByteArray hashedPlaintext = QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
+        QByteArray signature(RSA_size(keyPair), 0);
+        unsigned int signatureBytes = 0;
+        RSA_sign(NID_sha256, reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()), hashedPlaintext.size(),
+                 reinterpret_cast<unsigned char*>(signature.data()), &signatureBytes, keyPair);
+        heartbeatStream << signature;
+
+        _heartbeats.push_back(std::move(heartbeat));
+    }
+    RSA_free(keyPair);
+
+    _socket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) { processPacket(std::move(packet)); });
+
+    QTimer* logTimer = new QTimer(this);
+    connect(logTimer, &QTimer::timeout, this, &HeartbeatLoadGenerator::logRate);
+    logTimer->start(LOG_RATE_INTERVAL_MSECS);
+    _lastLogUsecs = usecTimestampNow();
+
+    qDebug() << "Sending heartbeats from" << numDomains << "simulated domains to" << _iceServerSockAddr;
+    QMetaObject::invokeMethod(this, "sendHeartbeats", Qt::QueuedConnection);
+}
+
+void HeartbeatLoadGenerator::sendHeartbeats() {
+    while (_numOutstanding < MAX_OUTSTANDING_HEARTBEATS && !_heartbeats.empty()) {
+        _socket.writePacket(*_heartbeats[_nextHeartbeat], _iceServerSockAddr);
+        _nextHeartbeat = (_nextHeartbeat + 1) % _heartbeats.size();
+        _numOutstanding++;
+    }
+}
+
+void HeartbeatLoadGenerator::processPacket(std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+    if (nlPacket->getType() == PacketType::ICEServerHeartbeatACK) {
+        _numAcked++;
+    } else if (nlPacket->getType() == PacketType::ICEServerHeartbeatDenied) {
+        _numDenied++;
+    } else {
+        return;
+    }
+
+    _numOutstanding = std::max(_numOutstanding - 1, 0);
+    sendHeartbeats();
+}
+
+void HeartbeatLoadGenerator::logRate() {
+    quint64 now = usecTimestampNow();
+    float intervalSeconds = (float)(now - _lastLogUsecs) / USECS_PER_SECOND;
+    _lastLogUsecs = now;
+
+    qDebug() << "heartbeats/sec acked:" << _numAcked / intervalSeconds
+             << "denied:" << _numDenied / intervalSeconds
+             << "lost:" << _numOutstanding;
+
+    // anything still outstanding was dropped somewhere, start a fresh window
+    _numAcked = 0;
+    _numDenied = 0;
+    _numOutstanding = 0;
+    sendHeartbeats();
+}
@@ -0,0 +1,50 @@
+//
+//  HeartbeatLoadGenerator.h
+//  ice-server/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_HeartbeatLoadGenerator_h
+#define hifi_HeartbeatLoadGenerator_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QObject>
+
+#include <NLPacket.h>
+#include <udt/Socket.h>
+
+class IceServer;
+
+// Sends signed heartbeats from a set of simulated domains to the local ice-server, as fast as it acknowledges them,
+// and logs how many heartbeats per second are getting through. The domains share one keypair, which is handed
+// straight to the ice-server instead of going through the metaverse API.
+class HeartbeatLoadGenerator : public QObject {
+    Q_OBJECT
+public:
+    HeartbeatLoadGenerator(IceServer* iceServer, int numDomains, QObject* parent = nullptr);
+
+private slots:
+    void sendHeartbeats();
+    void logRate();
+
+private:
+    void processPacket(std::unique_ptr<udt::Packet> packet);
+
+    udt::Socket _socket;
+    HifiSockAddr _iceServerSockAddr;
+    std::vector<std::unique_ptr<NLPacket>> _heartbeats;
+    size_t _nextHeartbeat { 0 };
+
+    int _numOutstanding { 0 };
+    int _numAcked { 0 };
+    int _numDenied { 0 };
+    quint64 _lastLogUsecs { 0 };
+};
+
+#endif // hifi_HeartbeatLoadGenerator_h
@@ -0,0 +1,58 @@
+//
+//  IcePeerMap.cpp
+//  ice-server/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "IcePeerMap.h"
+
+using Lock = std::lock_guard<std::mutex>;
+
+SharedNetworkPeer IcePeerMap::value(const QUuid& id) const {
+    const auto& shard = getShard(id);
+    Lock lock(shard.mutex);
+    return shard.peers.value(id);
+}
+
+SharedNetworkPeer IcePeerMap::findOrInsert(const QUuid& id, const std::function<SharedNetworkPeer()>& create,
+                                           bool& inserted) {
+    auto& shard = getShard(id);
+    Lock lock(shard.mutex);
+    auto it = shard.peers.find(id);
+    if (it != shard.peers.end()) {
+        inserted = false;
+        return it.value();
+    }
+
+    inserted = true;
+    return shard.peers.insert(id, create()).value();
+}
+
+QList<SharedNetworkPeer> IcePeerMap::removeIf(const PeerPredicate& predicate) {
+    QList<SharedNetworkPeer> removed;
+    for (auto& shard : _shards) {
+        Lock lock(shard.mutex);
+        for (auto it = shard.peers.begin(); it != shard.peers.end();) {
+            if (predicate(it.value())) {
+                removed << it.value();
+                it = shard.peers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    return removed;
+}
+
+int IcePeerMap::size() const {
+    int size = 0;
+    for (const auto& shard : _shards) {
+        Lock lock(shard.mutex);
+        size += shard.peers.size();
+    }
+    return size;
+}
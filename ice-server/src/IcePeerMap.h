@@ -0,0 +1,53 @@
+//
+//  IcePeerMap.h
+//  ice-server/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_IcePeerMap_h
+#define hifi_IcePeerMap_h
+
+#include <array>
+#include <functional>
+#include <mutex>
+
+#include <QtCore/QHash>
+
+#include <NetworkPeer.h>
+#include <UUIDHasher.h>
+
+// The heartbeating peers, split across shards that each have their own lock, so that lookups from different threads
+// rarely wait on each other and no single rehash or sweep has to touch every peer at once.
+class IcePeerMap {
+public:
+    using PeerPredicate = std::function<bool(const SharedNetworkPeer&)>;
+
+    SharedNetworkPeer value(const QUuid& id) const;
+
+    // returns the peer with this ID, adding the one made by create if there isn't one yet
+    SharedNetworkPeer findOrInsert(const QUuid& id, const std::function<SharedNetworkPeer()>& create, bool& inserted);
+
+    // removes and returns every peer the predicate is true for, the predicate is called with the shard locked
+    QList<SharedNetworkPeer> removeIf(const PeerPredicate& predicate);
+
+    int size() const;
+
+private:
+    static const int NUM_SHARDS = 16;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        QHash<QUuid, SharedNetworkPeer> peers;
+    };
+
+    Shard& getShard(const QUuid& id) { return _shards[qHash(id) % NUM_SHARDS]; }
+    const Shard& getShard(const QUuid& id) const { return _shards[qHash(id) % NUM_SHARDS]; }
+
+    std::array<Shard, NUM_SHARDS> _shards;
+};
+
+#endif // hifi_IcePeerMap_h
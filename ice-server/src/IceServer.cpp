@@ -11,9 +11,14 @@
 
 #include "IceServer.h"
 
+#include <algorithm>
+
 #include <openssl/x509.h>
 
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QCommandLineParser>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QThread>
 #include <QtCore/QTimer>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
@@ -24,15 +29,27 @@
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 
+#include "HeartbeatLoadGenerator.h"
+
 const int CLEAR_INACTIVE_PEERS_INTERVAL_MSECS = 1 * 1000;
 const int PEER_SILENCE_THRESHOLD_MSECS = 5 * 1000;
 
+// a cached verification is trusted for this long before the signature is checked again
+const quint64 VERIFIED_HEARTBEAT_CACHE_USECS = 60 * USECS_PER_SECOND;
+
+// past this many heartbeats waiting on the verification pool new ones are dropped, domains will send another
+const int MAX_PENDING_VERIFICATIONS = 4096;
+
 IceServer::IceServer(int argc, char* argv[]) :
     QCoreApplication(argc, argv),
     _id(QUuid::createUuid()),
-    _serverSocket(0, false),
-    _activePeers()
+    _serverSocket(0, false)
 {
+    // leave a core for the socket thread, the rest verify signatures
+    _verificationPool.setMaxThreadCount(std::max(QThread::idealThreadCount() - 1, 1));
+
+    parseCommandLine();
+
     // start the ice-server socket
     qDebug() << "ice-server socket is listening on" << ICE_SERVER_DEFAULT_PORT;
     _serverSocket.bind(QHostAddress::AnyIPv4, ICE_SERVER_DEFAULT_PORT);
@@ -54,6 +71,49 @@ IceServer::IceServer(int argc, char* argv[]) :
     connect(&networkAccessManager, &QNetworkAccessManager::finished, this, &IceServer::publicKeyReplyFinished);
 }
 
+IceServer::~IceServer() {
+    // the pool calls back into us, so make sure it is done before anything else goes away
+    _verificationPool.waitForDone();
+}
+
+void IceServer::parseCommandLine() {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity ICE Server");
+    parser.addHelpOption();
+
+    const QCommandLineOption heartbeatLoadOption("heartbeat-load",
+        "Send heartbeats from this many simulated domains to ourselves and report heartbeats/sec", "num-domains");
+    parser.addOption(heartbeatLoadOption);
+
+    const QCommandLineOption noHeartbeatCacheOption("no-heartbeat-cache", "Verify the signature of every heartbeat");
+    parser.addOption(noHeartbeatCacheOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qWarning() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(noHeartbeatCacheOption)) {
+        qDebug() << "Heartbeat verification cache is disabled";
+        _heartbeatCacheEnabled = false;
+    }
+
+    if (parser.isSet(heartbeatLoadOption)) {
+        int numDomains = parser.value(heartbeatLoadOption).toInt();
+        if (numDomains > 0) {
+            _loadGenerator = new HeartbeatLoadGenerator(this, numDomains, this);
+        } else {
+            qWarning() << "Could not parse a number of domains from" << parser.value(heartbeatLoadOption);
+        }
+    }
+}
+
+void IceServer::setDomainPublicKey(const QUuid& domainID, RSAPointer publicKey) {
+    _domainPublicKeys[domainID] = publicKey;
+    _verifiedHeartbeatCache.erase(domainID);
+}
+
 bool IceServer::packetVersionMatch(const udt::Packet& packet) {
     PacketType headerType = NLPacket::typeInHeader(packet);
     PacketVersion headerVersion = NLPacket::versionInHeader(packet);
@@ -73,20 +133,7 @@ void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
     if (nlPacket->getPayloadSize() >= NLPacket::localHeaderSize(PacketType::ICEServerHeartbeat)) {
         
         if (nlPacket->getType() == PacketType::ICEServerHeartbeat) {
-            SharedNetworkPeer peer = addOrUpdateHeartbeatingPeer(*nlPacket);
-            if (peer) {
-                // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
-                peer->activateMatchingOrNewSymmetricSocket(nlPacket->getSenderSockAddr());
-
-                // we have an active and verified heartbeating peer
-                // send them an ACK packet so they know that they are being heard and ready for ICE
-                static auto ackPacket = NLPacket::create(PacketType::ICEServerHeartbeatACK);
-                _serverSocket.writePacket(*ackPacket, nlPacket->getSenderSockAddr());
-            } else {
-                // we couldn't verify this peer - respond back to them so they know they may need to perform keypair re-generation
-                static auto deniedPacket = NLPacket::create(PacketType::ICEServerHeartbeatDenied);
-                _serverSocket.writePacket(*deniedPacket, nlPacket->getSenderSockAddr());
-            }
+            processHeartbeat(*nlPacket);
         } else if (nlPacket->getType() == PacketType::ICEServerQuery) {
             QDataStream heartbeatStream(nlPacket.get());
             
@@ -123,85 +170,156 @@ void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
     }
 }
 
-SharedNetworkPeer IceServer::addOrUpdateHeartbeatingPeer(NLPacket& packet) {
-
+void IceServer::processHeartbeat(NLPacket& packet) {
     // pull the UUID, public and private sock addrs for this peer
-    QUuid senderUUID;
-    HifiSockAddr publicSocket, localSocket;
-    QByteArray signature;
+    Heartbeat heartbeat;
+    heartbeat.senderSockAddr = packet.getSenderSockAddr();
 
     QDataStream heartbeatStream(&packet);
-    heartbeatStream >> senderUUID >> publicSocket >> localSocket;
+    heartbeatStream >> heartbeat.domainID >> heartbeat.publicSocket >> heartbeat.localSocket;
 
     auto signedPlaintext = QByteArray::fromRawData(packet.getPayload(), heartbeatStream.device()->pos());
-    heartbeatStream >> signature;
-
-    // make sure this is a verified heartbeat before performing any more processing
-    if (isVerifiedHeartbeat(senderUUID, signedPlaintext, signature)) {
-        // make sure we have this sender in our peer hash
-        SharedNetworkPeer matchingPeer = _activePeers.value(senderUUID);
+    heartbeatStream >> heartbeat.signature;
 
-        if (!matchingPeer) {
-            // if we don't have this sender we need to create them now
-            matchingPeer = QSharedPointer<NetworkPeer>::create(senderUUID, publicSocket, localSocket);
-            _activePeers.insert(senderUUID, matchingPeer);
+    // make sure we're not already waiting for a public key for this domain-server
+    if (_pendingPublicKeyRequests.contains(heartbeat.domainID)) {
+        heartbeatDenied(heartbeat);
+        return;
+    }
 
-            qDebug() << "Added a new network peer" << *matchingPeer;
-        } else {
-            // we already had the peer so just potentially update their sockets
-            matchingPeer->setPublicSocket(publicSocket);
-            matchingPeer->setLocalSocket(localSocket);
+    // check if we have a public key for this domain ID - if we do not then fire off the request for it
+    auto it = _domainPublicKeys.find(heartbeat.domainID);
+    if (it == _domainPublicKeys.end() || !it->second) {
+        if (it != _domainPublicKeys.end()) {
+            // we can't let this user in since we couldn't convert their public key to an RSA key we could use
+            qWarning() << "Public key for" << heartbeat.domainID << "is not a usable RSA* public key.";
+            qWarning() << "Re-requesting public key from API";
         }
+        requestDomainPublicKey(heartbeat.domainID);
+        heartbeatDenied(heartbeat);
+        return;
+    }
 
-        // update our last heard microstamp for this network peer to now
-        matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
-        
-        return matchingPeer;
-    } else {
-        // not verified, return the empty peer object
-        return SharedNetworkPeer();
+    heartbeat.plaintextHash = QCryptographicHash::hash(signedPlaintext, QCryptographicHash::Sha256);
+
+    // domains only re-sign when their sockets change, so most heartbeats are one we've already checked
+    if (isCachedHeartbeat(heartbeat)) {
+        heartbeatVerified(heartbeat);
+        return;
     }
+
+    if ((int)_pendingVerifications.size() >= MAX_PENDING_VERIFICATIONS) {
+        return;
+    }
+
+    // hand the RSA check to the verification pool
+    quint64 verificationID = _nextVerificationID++;
+    RSAPointer rsaPublicKey = it->second;
+    QByteArray plaintextHash = heartbeat.plaintextHash;
+    QByteArray signature = heartbeat.signature;
+    _pendingVerifications.emplace(verificationID, heartbeat);
+
+    QtConcurrent::run(&_verificationPool, [this, verificationID, rsaPublicKey, plaintextHash, signature] {
+        int verificationResult = RSA_verify(NID_sha256,
+                                            reinterpret_cast<const unsigned char*>(plaintextHash.constData()),
+                                            plaintextHash.size(),
+                                            reinterpret_cast<const unsigned char*>(signature.constData()),
+                                            signature.size(),
+                                            rsaPublicKey.get());
+
+        bool wasEmpty;
+        {
+            std::lock_guard<std::mutex> lock(_verificationResultsLock);
+            wasEmpty = _verificationResults.empty();
+            _verificationResults.emplace_back(verificationID, verificationResult == 1);
+        }
+        if (wasEmpty) {
+            QMetaObject::invokeMethod(this, "processVerifiedHeartbeats", Qt::QueuedConnection);
+        }
+    });
 }
 
-bool IceServer::isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature) {
-    // make sure we're not already waiting for a public key for this domain-server
-    if (!_pendingPublicKeyRequests.contains(domainID)) {
-        // check if we have a public key for this domain ID - if we do not then fire off the request for it
-        auto it = _domainPublicKeys.find(domainID);
-        if (it != _domainPublicKeys.end()) {
+void IceServer::processVerifiedHeartbeats() {
+    std::vector<std::pair<quint64, bool>> results;
+    {
+        std::lock_guard<std::mutex> lock(_verificationResultsLock);
+        results.swap(_verificationResults);
+    }
 
-            // attempt to verify the signature for this heartbeat
-            const auto rsaPublicKey = it->second.get();
-
-            if (rsaPublicKey) {
-                auto hashedPlaintext = QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
-                int verificationResult = RSA_verify(NID_sha256,
-                                                    reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
-                                                    hashedPlaintext.size(),
-                                                    reinterpret_cast<const unsigned char*>(signature.constData()),
-                                                    signature.size(),
-                                                    rsaPublicKey);
-
-                if (verificationResult == 1) {
-                    // this is the only success case - we return true here to indicate that the heartbeat is verified
-                    return true;
-                } else {
-                    qDebug() << "Failed to verify heartbeat for" << domainID << "- re-requesting public key from API.";
-                }
+    for (const auto& result : results) {
+        auto it = _pendingVerifications.find(result.first);
+        if (it == _pendingVerifications.end()) {
+            continue;
+        }
+        Heartbeat heartbeat = it->second;
+        _pendingVerifications.erase(it);
 
-            } else {
-                // we can't let this user in since we couldn't convert their public key to an RSA key we could use
-                qWarning() << "Public key for" << domainID << "is not a usable RSA* public key.";
-                qWarning() << "Re-requesting public key from API";
+        if (result.second) {
+            if (_heartbeatCacheEnabled) {
+                _verifiedHeartbeatCache[heartbeat.domainID] = { heartbeat.plaintextHash, heartbeat.signature, usecTimestampNow() };
+            }
+            heartbeatVerified(heartbeat);
+        } else {
+            // we could not verify this heartbeat (stale public key, bad actor)
+            // ask the metaverse API for the right public key
+            qDebug() << "Failed to verify heartbeat for" << heartbeat.domainID << "- re-requesting public key from API.";
+            _verifiedHeartbeatCache.erase(heartbeat.domainID);
+            if (!_pendingPublicKeyRequests.contains(heartbeat.domainID)) {
+                requestDomainPublicKey(heartbeat.domainID);
             }
+            heartbeatDenied(heartbeat);
         }
+    }
+}
 
-        // we could not verify this heartbeat (missing public key, could not load public key, bad actor)
-        // ask the metaverse API for the right public key and return false to indicate that this is not verified
-        requestDomainPublicKey(domainID);
+bool IceServer::isCachedHeartbeat(const Heartbeat& heartbeat) const {
+    if (!_heartbeatCacheEnabled) {
+        return false;
     }
+    auto it = _verifiedHeartbeatCache.find(heartbeat.domainID);
+    return it != _verifiedHeartbeatCache.end() &&
+        it->second.plaintextHash == heartbeat.plaintextHash &&
+        it->second.signature == heartbeat.signature &&
+        usecTimestampNow() - it->second.verifiedUsecs < VERIFIED_HEARTBEAT_CACHE_USECS;
+}
+
+void IceServer::heartbeatVerified(const Heartbeat& heartbeat) {
+    SharedNetworkPeer peer = addOrUpdateHeartbeatingPeer(heartbeat);
+
+    // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
+    peer->activateMatchingOrNewSymmetricSocket(heartbeat.senderSockAddr);
+
+    // we have an active and verified heartbeating peer
+    // send them an ACK packet so they know that they are being heard and ready for ICE
+    static auto ackPacket = NLPacket::create(PacketType::ICEServerHeartbeatACK);
+    _serverSocket.writePacket(*ackPacket, heartbeat.senderSockAddr);
+}
+
+void IceServer::heartbeatDenied(const Heartbeat& heartbeat) {
+    // we couldn't verify this peer - respond back to them so they know they may need to perform keypair re-generation
+    static auto deniedPacket = NLPacket::create(PacketType::ICEServerHeartbeatDenied);
+    _serverSocket.writePacket(*deniedPacket, heartbeat.senderSockAddr);
+}
+
+SharedNetworkPeer IceServer::addOrUpdateHeartbeatingPeer(const Heartbeat& heartbeat) {
+    // make sure we have this sender in our peer hash, if we don't have this sender we need to create them now
+    bool inserted;
+    SharedNetworkPeer matchingPeer = _activePeers.findOrInsert(heartbeat.domainID, [&] {
+        return QSharedPointer<NetworkPeer>::create(heartbeat.domainID, heartbeat.publicSocket, heartbeat.localSocket);
+    }, inserted);
 
-    return false;
+    if (inserted) {
+        qDebug() << "Added a new network peer" << *matchingPeer;
+    } else {
+        // we already had the peer so just potentially update their sockets
+        matchingPeer->setPublicSocket(heartbeat.publicSocket);
+        matchingPeer->setLocalSocket(heartbeat.localSocket);
+    }
+
+    // update our last heard microstamp for this network peer to now
+    matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
+
+    return matchingPeer;
 }
 
 void IceServer::requestDomainPublicKey(const QUuid& domainID) {
@@ -253,7 +371,7 @@ void IceServer::publicKeyReplyFinished(QNetworkReply* reply) {
                 RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, apiPublicKey.size());
 
                 if (rsaPublicKey) {
-                    _domainPublicKeys[domainID] = { rsaPublicKey, RSA_free };
+                    setDomainPublicKey(domainID, RSAPointer(rsaPublicKey, RSA_free));
                 } else {
                     qWarning() << "Could not convert in-memory public key for" << domainID << "to usable RSA public key.";
                     qWarning() << "Public key will be re-requested on next heartbeat.";
@@ -290,22 +408,16 @@ void IceServer::sendPeerInformationPacket(const NetworkPeer& peer, const HifiSoc
 }
 
 void IceServer::clearInactivePeers() {
-    NetworkPeerHash::iterator peerItem = _activePeers.begin();
+    quint64 now = usecTimestampNow();
+    auto inactivePeers = _activePeers.removeIf([&](const SharedNetworkPeer& peer) {
+        return (now - peer->getLastHeardMicrostamp()) > (PEER_SILENCE_THRESHOLD_MSECS * 1000);
+    });
 
-    while (peerItem != _activePeers.end()) {
-        SharedNetworkPeer peer = peerItem.value();
+    for (const auto& peer : inactivePeers) {
+        qDebug() << "Removing peer from memory for inactivity -" << *peer;
 
-        if ((usecTimestampNow() - peer->getLastHeardMicrostamp()) > (PEER_SILENCE_THRESHOLD_MSECS * 1000)) {
-            qDebug() << "Removing peer from memory for inactivity -" << *peer;
-
-            // if we had a public key for this domain, remove it now
-            _domainPublicKeys.erase(peer->getUUID());
-
-            // remove the peer object
-            peerItem = _activePeers.erase(peerItem);
-        } else {
-            // we didn't kill this peer, push the iterator forwards
-            ++peerItem;
-        }
+        // if we had a public key for this domain, remove it now
+        _domainPublicKeys.erase(peer->getUUID());
+        _verifiedHeartbeatCache.erase(peer->getUUID());
     }
 }
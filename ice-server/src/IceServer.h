@@ -12,8 +12,15 @@
 #ifndef hifi_IceServer_h
 #define hifi_IceServer_h
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
 #include <QUdpSocket>
 
 #include <openssl/rsa.h>
@@ -26,36 +33,81 @@
 #include <NLPacket.h>
 #include <udt/Socket.h>
 
+#include "IcePeerMap.h"
+
 class QNetworkReply;
+class HeartbeatLoadGenerator;
 
 class IceServer : public QCoreApplication {
     Q_OBJECT
 public:
+    using RSAPointer = std::shared_ptr<RSA>;
+
     IceServer(int argc, char* argv[]);
+    ~IceServer();
+
+    // lets a local load generator stand in for the metaverse API
+    void setDomainPublicKey(const QUuid& domainID, RSAPointer publicKey);
+
 private slots:
     void clearInactivePeers();
     void publicKeyReplyFinished(QNetworkReply* reply);
+    void processVerifiedHeartbeats();
+
 private:
+    struct Heartbeat {
+        QUuid domainID;
+        HifiSockAddr publicSocket;
+        HifiSockAddr localSocket;
+        HifiSockAddr senderSockAddr;
+        QByteArray plaintextHash;
+        QByteArray signature;
+    };
+
+    struct VerifiedHeartbeat {
+        QByteArray plaintextHash;
+        QByteArray signature;
+        quint64 verifiedUsecs;
+    };
+
+    void parseCommandLine();
+
     bool packetVersionMatch(const udt::Packet& packet);
     void processPacket(std::unique_ptr<udt::Packet> packet);
-    
-    SharedNetworkPeer addOrUpdateHeartbeatingPeer(NLPacket& incomingPacket);
+    void processHeartbeat(NLPacket& packet);
+    void heartbeatVerified(const Heartbeat& heartbeat);
+    void heartbeatDenied(const Heartbeat& heartbeat);
+    bool isCachedHeartbeat(const Heartbeat& heartbeat) const;
+
+    SharedNetworkPeer addOrUpdateHeartbeatingPeer(const Heartbeat& heartbeat);
     void sendPeerInformationPacket(const NetworkPeer& peer, const HifiSockAddr* destinationSockAddr);
 
-    bool isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature);
     void requestDomainPublicKey(const QUuid& domainID);
 
     QUuid _id;
     udt::Socket _serverSocket;
 
-    using NetworkPeerHash = QHash<QUuid, SharedNetworkPeer>;
-    NetworkPeerHash _activePeers;
+    IcePeerMap _activePeers;
 
-    using RSAUniquePtr = std::unique_ptr<RSA, std::function<void(RSA*)>>;
-    using DomainPublicKeyHash = std::unordered_map<QUuid, RSAUniquePtr>;
+    using DomainPublicKeyHash = std::unordered_map<QUuid, RSAPointer>;
     DomainPublicKeyHash _domainPublicKeys;
 
     QSet<QUuid> _pendingPublicKeyRequests;
+
+    // heartbeats that repeat one we've already verified (same plaintext, same signature) skip the RSA check
+    bool _heartbeatCacheEnabled { true };
+    std::unordered_map<QUuid, VerifiedHeartbeat> _verifiedHeartbeatCache;
+
+    // heartbeats wait here while the verification pool checks their signatures, the results come back through
+    // _verificationResults. only the ID and the result cross threads, the sockets stay on this one.
+    std::unordered_map<quint64, Heartbeat> _pendingVerifications;
+    quint64 _nextVerificationID { 0 };
+    std::mutex _verificationResultsLock;
+    std::vector<std::pair<quint64, bool>> _verificationResults;
+
+    HeartbeatLoadGenerator* _loadGenerator { nullptr };
+
+    QThreadPool _verificationPool;
 };
 
 #endif // hifi_IceServer_h
@@ -117,6 +117,16 @@ Item {
                         visible: root.expanded
                         text: "Avatars NOT Updated: " + root.notUpdatedAvatarCount
                     }
+                    StatText {
+                        visible: root.expanded
+                        text: "Avatar Animation Full/Reduced/Low: " + root.fullAnimationAvatarCount + "/" +
+                            root.reducedAnimationAvatarCount + "/" + root.lowAnimationAvatarCount
+                    }
+                    StatText {
+                        visible: root.expanded
+                        text: "Avatar Animation ms: " + root.fullAnimationAvatarTime.toFixed(2) + "/" +
+                            root.reducedAnimationAvatarTime.toFixed(2) + "/" + root.lowAnimationAvatarTime.toFixed(2)
+                    }
                 }
             }
 
@@ -267,7 +277,8 @@ Item {
                     }
                     StatText {
                         text: "Triangles: " + root.triangles +
-                            " / Material Switches: " + root.materialSwitches
+                            " / Material Switches: " + root.materialSwitches +
+                            " / Instanced: " + root.instancedShapes
                     }
                     StatText {
                         text: "GPU Free Memory: " + root.gpuFreeMemory + " MB";
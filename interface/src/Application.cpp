@@ -201,6 +201,7 @@
 #include <raypick/PickScriptingInterface.h>
 #include <raypick/PointerScriptingInterface.h>
 #include <raypick/MouseRayPick.h>
+#include <raypick/StylusPick.h>
 
 #include <FadeEffect.h>
 
@@ -1821,6 +1822,8 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
         glm::vec2 pos2D = DependencyManager::get<HMDScriptingInterface>()->overlayFromWorldPoint(intersection);
         return glm::max(MARGIN, glm::min(pos2D, maxPos));
     });
+    DependencyManager::get<PickManager>()->setRayPickBatchOperators(&RayPick::getEntityIntersections, &RayPick::getAvatarIntersections);
+    DependencyManager::get<PickManager>()->setStylusPickEntityBatchOperator(&StylusPick::getEntityIntersections);
 
     // Setup the mouse ray pick and related operators
     DependencyManager::get<EntityTreeRenderer>()->setMouseRayPickID(DependencyManager::get<PickManager>()->addPick(PickQuery::Ray, std::make_shared<MouseRayPick>(
@@ -4237,6 +4240,9 @@ void Application::init() {
     ShapeEntityItem::setShapeInfoCalulator(ShapeEntityItem::ShapeInfoCalculator(&shapeInfoCalculator));
 
     getEntities()->init();
+    // servers that support it send compact entity packets, read with the string dictionary our queries acknowledge
+    _octreeQuery.setWantsCompactPackets(true);
+    getEntities()->setStringDictionary(_octreeQuery.getStringDictionary());
     getEntities()->setEntityLoadingPriorityFunction([this](const EntityItem& item) {
         auto dims = item.getDimensions();
         auto maxSize = glm::compMax(dims);
@@ -4969,11 +4975,13 @@ void Application::update(float deltaTime) {
     // TODO: break these out into distinct perfTimers when they prove interesting
     {
         PROFILE_RANGE(app, "PickManager");
+        PerformanceTimer perfTimer("picks");
         DependencyManager::get<PickManager>()->update();
     }
 
     {
         PROFILE_RANGE(app, "PointerManager");
+        PerformanceTimer perfTimer("pointers");
         DependencyManager::get<PointerManager>()->update();
     }
 
@@ -5239,6 +5247,12 @@ void Application::queryOctree(NodeType_t serverType, PacketType packetType, Node
     //qCDebug(interfaceapp) << ">>> inside... queryOctree()... _viewFrustum.getFieldOfView()=" << _viewFrustum.getFieldOfView();
     bool wantExtraDebugging = getLogger()->extraDebugging();
 
+    // a compact packet referred to a string we never got, so start a new connection, for which the server starts its
+    // dictionary over and sends the whole scene again
+    if (_octreeQuery.getStringDictionary()->isOutOfSync()) {
+        _octreeQuery.incrementConnectionID();
+    }
+
     ViewFrustum viewFrustum;
     copyViewFrustum(viewFrustum);
     _octreeQuery.setCameraPosition(viewFrustum.getPosition());
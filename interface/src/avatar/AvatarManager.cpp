@@ -83,6 +83,7 @@ void AvatarManager::init() {
     {
         QWriteLocker locker(&_hashLock);
         _avatarHash.insert(MY_AVATAR_KEY, _myAvatar);
+        publishHash();
     }
 
     _shouldRender = DependencyManager::get<SceneScriptingInterface>()->shouldRenderAvatars();
@@ -134,12 +135,10 @@ float AvatarManager::getAvatarSimulationRate(const QUuid& sessionID, const QStri
 }
 
 void AvatarManager::updateOtherAvatars(float deltaTime) {
-    // lock the hash for read to check the size
-    QReadLocker lock(&_hashLock);
-    if (_avatarHash.size() < 2 && _avatarsToFade.isEmpty()) {
+    auto hashSnapshot = getHashSnapshot();
+    if (hashSnapshot->size() < 2 && _avatarsToFade.isEmpty()) {
         return;
     }
-    lock.unlock();
 
     PerformanceTimer perfTimer("otherAvatars");
 
@@ -163,9 +162,8 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
             AvatarData::_avatarSortCoefficientAge);
 
     // sort
-    auto avatarMap = getHashCopy();
-    AvatarHash::iterator itr = avatarMap.begin();
-    while (itr != avatarMap.end()) {
+    AvatarHash::const_iterator itr = hashSnapshot->begin();
+    while (itr != hashSnapshot->end()) {
         const auto& avatar = std::static_pointer_cast<Avatar>(*itr);
         // DO NOT update _myAvatar!  Its update has already been done earlier in the main loop.
         // DO NOT update or fade out uninitialized Avatars
@@ -181,6 +179,8 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
     uint64_t updateExpiry = startTime + UPDATE_BUDGET;
     int numAvatarsUpdated = 0;
     int numAVatarsNotUpdated = 0;
+    std::array<int, Avatar::AnimationLOD::NUM_LEVELS> numAvatarsAtAnimationLOD {{ 0, 0, 0 }};
+    std::array<uint64_t, Avatar::AnimationLOD::NUM_LEVELS> animationLODSimulationUsecs {{ 0, 0, 0 }};
 
     render::Transaction transaction;
     while (!sortedAvatars.empty()) {
@@ -216,10 +216,21 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
         if (now < updateExpiry) {
             // we're within budget
             bool inView = sortData.getPriority() > OUT_OF_VIEW_THRESHOLD;
-            if (inView && avatar->hasNewJointData()) {
-                numAvatarsUpdated++;
+            if (inView) {
+                auto lod = computeAnimationLOD(avatar, cameraView);
+                avatar->setAnimationLOD(lod);
+                numAvatarsAtAnimationLOD[lod.level]++;
+                bool hadNewJointData = avatar->hasNewJointData();
+                avatar->simulate(deltaTime, inView);
+                animationLODSimulationUsecs[lod.level] += usecTimestampNow() - now;
+
+                // an avatar whose rig waits for its animation LOD keeps its joint data, and wasn't updated
+                if (hadNewJointData && !avatar->hasNewJointData()) {
+                    numAvatarsUpdated++;
+                }
+            } else {
+                avatar->simulate(deltaTime, inView);
             }
-            avatar->simulate(deltaTime, inView);
             avatar->updateRenderItem(transaction);
             avatar->setLastRenderUpdateTime(startTime);
         } else {
@@ -253,7 +264,6 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
 
     if (_shouldRender) {
         if (!_avatarsToFade.empty()) {
-            QReadLocker lock(&_hashLock);
             QVector<AvatarSharedPointer>::iterator itr = _avatarsToFade.begin();
             while (itr != _avatarsToFade.end() && usecTimestampNow() > updateExpiry) {
                 auto avatar = std::static_pointer_cast<Avatar>(*itr);
@@ -268,16 +278,35 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
 
     _numAvatarsUpdated = numAvatarsUpdated;
     _numAvatarsNotUpdated = numAVatarsNotUpdated;
+    for (int i = 0; i < Avatar::AnimationLOD::NUM_LEVELS; ++i) {
+        _numAvatarsAtAnimationLOD[i] = numAvatarsAtAnimationLOD[i];
+        _animationLODSimulationTime[i] = (float)animationLODSimulationUsecs[i] / (float)USECS_PER_MSEC;
+    }
 
     simulateAvatarFades(deltaTime);
 
     _avatarSimulationTime = (float)(usecTimestampNow() - startTime) / (float)USECS_PER_MSEC;
 }
 
+Avatar::AnimationLOD AvatarManager::computeAnimationLOD(const AvatarSharedPointer& avatar, const ViewFrustum& cameraView) const {
+    float radius = std::static_pointer_cast<Avatar>(avatar)->getBoundingRadius();
+    float distance = glm::distance(avatar->getWorldPosition(), cameraView.getPosition());
+    float angularSize = distance > radius ? radius / distance : 1.0f;
+
+    Avatar::AnimationLOD lod;
+    if (angularSize < _lowAnimationThreshold) {
+        lod.level = Avatar::AnimationLOD::LOW;
+    } else if (angularSize < _reducedAnimationThreshold) {
+        lod.level = Avatar::AnimationLOD::REDUCED;
+    }
+    lod.eyeIK = angularSize >= _eyeIKThreshold;
+    lod.blendshapes = angularSize >= _blendshapesThreshold;
+    return lod;
+}
+
 void AvatarManager::postUpdate(float deltaTime, const render::ScenePointer& scene) {
-    auto hashCopy = getHashCopy();
-    AvatarHash::iterator avatarIterator = hashCopy.begin();
-    for (avatarIterator = hashCopy.begin(); avatarIterator != hashCopy.end(); avatarIterator++) {
+    auto hashSnapshot = getHashSnapshot();
+    for (auto avatarIterator = hashSnapshot->begin(); avatarIterator != hashSnapshot->end(); avatarIterator++) {
         auto avatar = std::static_pointer_cast<Avatar>(avatarIterator.value());
         avatar->postUpdate(deltaTime, scene);
     }
@@ -288,7 +317,6 @@ void AvatarManager::simulateAvatarFades(float deltaTime) {
         return;
     }
 
-    QReadLocker locker(&_hashLock);
     QVector<AvatarSharedPointer>::iterator avatarItr = _avatarsToFade.begin();
     const render::ScenePointer& scene = qApp->getMain3DScene();
     while (avatarItr != _avatarsToFade.end()) {
@@ -345,7 +373,7 @@ void AvatarManager::clearOtherAvatars() {
     const render::ScenePointer& scene = qApp->getMain3DScene();
     render::Transaction transaction;
 
-    QReadLocker locker(&_hashLock);
+    QWriteLocker locker(&_hashLock);
     AvatarHash::iterator avatarIterator =  _avatarHash.begin();
     while (avatarIterator != _avatarHash.end()) {
         auto avatar = std::static_pointer_cast<Avatar>(avatarIterator.value());
@@ -359,6 +387,7 @@ void AvatarManager::clearOtherAvatars() {
             ++avatarIterator;
         }
     }
+    publishHash();
     assert(scene);
     scene->enqueueTransaction(transaction);
     _myAvatar->clearLookAtTargetAvatar();
@@ -368,13 +397,14 @@ void AvatarManager::deleteAllAvatars() {
     assert(_motionStates.empty()); // should have called clearOtherAvatars() before getting here
     deleteMotionStates();
 
-    QReadLocker locker(&_hashLock);
+    QWriteLocker locker(&_hashLock);
     AvatarHash::iterator avatarIterator =  _avatarHash.begin();
     while (avatarIterator != _avatarHash.end()) {
         auto avatar = std::static_pointer_cast<Avatar>(avatarIterator.value());
         avatarIterator = _avatarHash.erase(avatarIterator);
         avatar->die();
     }
+    publishHash();
 }
 
 void AvatarManager::deleteMotionStates() {
@@ -463,13 +493,14 @@ void AvatarManager::updateAvatarRenderStatus(bool shouldRenderAvatars) {
     _shouldRender = shouldRenderAvatars;
     const render::ScenePointer& scene = qApp->getMain3DScene();
     render::Transaction transaction;
+    auto hashSnapshot = getHashSnapshot();
     if (_shouldRender) {
-        for (auto avatarData : _avatarHash) {
+        for (auto avatarData : *hashSnapshot) {
             auto avatar = std::static_pointer_cast<Avatar>(avatarData);
             avatar->addToScene(avatar, scene, transaction);
         }
     } else {
-        for (auto avatarData : _avatarHash) {
+        for (auto avatarData : *hashSnapshot) {
             auto avatar = std::static_pointer_cast<Avatar>(avatarData);
             avatar->removeFromScene(avatar, scene, transaction);
         }
@@ -509,7 +540,8 @@ RayToAvatarIntersectionResult AvatarManager::findRayIntersectionVector(const Pic
 
     glm::vec3 normDirection = glm::normalize(ray.direction);
 
-    for (auto avatarData : _avatarHash) {
+    auto hashSnapshot = getHashSnapshot();
+    for (auto avatarData : *hashSnapshot) {
         auto avatar = std::static_pointer_cast<Avatar>(avatarData);
         if ((avatarsToInclude.size() > 0 && !avatarsToInclude.contains(avatar->getID())) ||
             (avatarsToDiscard.size() > 0 && avatarsToDiscard.contains(avatar->getID()))) {
@@ -564,6 +596,72 @@ RayToAvatarIntersectionResult AvatarManager::findRayIntersectionVector(const Pic
     return result;
 }
 
+QVector<RayToAvatarIntersectionResult> AvatarManager::findRayIntersectionVectors(const QVector<PickRay>& rays,
+                                                                                 const QVector<QVector<EntityItemID>>& avatarsToInclude,
+                                                                                 const QVector<QVector<EntityItemID>>& avatarsToDiscard) {
+    QVector<RayToAvatarIntersectionResult> results(rays.size());
+    if (QThread::currentThread() != thread()) {
+        // the avatar models can only be intersected on our thread, so let each ray block on it
+        for (int i = 0; i < rays.size(); i++) {
+            results[i] = findRayIntersectionVector(rays[i], avatarsToInclude[i], avatarsToDiscard[i]);
+        }
+        return results;
+    }
+
+    QVector<glm::vec3> normDirections;
+    normDirections.reserve(rays.size());
+    for (const auto& ray : rays) {
+        normDirections.push_back(glm::normalize(ray.direction));
+    }
+
+    auto hashSnapshot = getHashSnapshot();
+    for (auto avatarData : *hashSnapshot) {
+        auto avatar = std::static_pointer_cast<Avatar>(avatarData);
+        SkeletonModelPointer avatarModel = avatar->getSkeletonModel();
+
+        // see findRayIntersectionVector() for why we intersect the capsule and then the (T-pose) mesh
+        glm::vec3 start;
+        glm::vec3 end;
+        float radius;
+        avatar->getCapsule(start, end, radius);
+
+        for (int i = 0; i < rays.size(); i++) {
+            if ((avatarsToInclude[i].size() > 0 && !avatarsToInclude[i].contains(avatar->getID())) ||
+                (avatarsToDiscard[i].size() > 0 && avatarsToDiscard[i].contains(avatar->getID()))) {
+                continue;
+            }
+
+            float distance;
+            BoxFace face;
+            glm::vec3 surfaceNormal;
+
+            if (!findRayCapsuleIntersection(rays[i].origin, normDirections[i], start, end, radius, distance)) {
+                // ray doesn't intersect avatar's capsule
+                continue;
+            }
+
+            QString extraInfo;
+            bool intersects = avatarModel->findRayIntersectionAgainstSubMeshes(rays[i].origin, normDirections[i],
+                                                                               distance, face, surfaceNormal, extraInfo, true);
+
+            RayToAvatarIntersectionResult& result = results[i];
+            if (intersects && (!result.intersects || distance < result.distance)) {
+                result.intersects = true;
+                result.avatarID = avatar->getID();
+                result.distance = distance;
+            }
+        }
+    }
+
+    for (int i = 0; i < rays.size(); i++) {
+        if (results[i].intersects) {
+            results[i].intersection = rays[i].origin + normDirections[i] * results[i].distance;
+        }
+    }
+
+    return results;
+}
+
 // HACK
 float AvatarManager::getAvatarSortCoefficient(const QString& name) {
     if (name == "size") {
@@ -604,3 +702,32 @@ void AvatarManager::setAvatarSortCoefficient(const QString& name, const QScriptV
         DependencyManager::get<NodeList>()->broadcastToNodes(std::move(packet), NodeSet() << NodeType::AvatarMixer);
     }
 }
+
+float AvatarManager::getAvatarAnimationLODThreshold(const QString& name) {
+    if (name == "reduced") {
+        return _reducedAnimationThreshold;
+    } else if (name == "low") {
+        return _lowAnimationThreshold;
+    } else if (name == "eyeIK") {
+        return _eyeIKThreshold;
+    } else if (name == "blendshapes") {
+        return _blendshapesThreshold;
+    }
+    return 0.0f;
+}
+
+void AvatarManager::setAvatarAnimationLODThreshold(const QString& name, const QScriptValue& value) {
+    if (!value.isNumber()) {
+        return;
+    }
+    float numericalValue = (float)value.toNumber();
+    if (name == "reduced") {
+        _reducedAnimationThreshold = numericalValue;
+    } else if (name == "low") {
+        _lowAnimationThreshold = numericalValue;
+    } else if (name == "eyeIK") {
+        _eyeIKThreshold = numericalValue;
+    } else if (name == "blendshapes") {
+        _blendshapesThreshold = numericalValue;
+    }
+}
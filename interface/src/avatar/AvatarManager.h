@@ -12,6 +12,8 @@
 #ifndef hifi_AvatarManager_h
 #define hifi_AvatarManager_h
 
+#include <array>
+
 #include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QSharedPointer>
@@ -21,6 +23,7 @@
 #include <PIDController.h>
 #include <SimpleMovingAverage.h>
 #include <shared/RateCounter.h>
+#include <ViewFrustum.h>
 #include <avatars-renderer/ScriptAvatar.h>
 #include <AudioInjector.h>
 
@@ -51,6 +54,8 @@ public:
     int getNumAvatarsUpdated() const { return _numAvatarsUpdated; }
     int getNumAvatarsNotUpdated() const { return _numAvatarsNotUpdated; }
     float getAvatarSimulationTime() const { return _avatarSimulationTime; }
+    int getNumAvatarsAtAnimationLOD(Avatar::AnimationLOD::Level level) const { return _numAvatarsAtAnimationLOD[level]; }
+    float getAnimationLODSimulationTime(Avatar::AnimationLOD::Level level) const { return _animationLODSimulationTime[level]; }
 
     void updateMyAvatar(float deltaTime);
     void updateOtherAvatars(float deltaTime);
@@ -76,11 +81,20 @@ public:
     Q_INVOKABLE RayToAvatarIntersectionResult findRayIntersectionVector(const PickRay& ray,
                                                                         const QVector<EntityItemID>& avatarsToInclude,
                                                                         const QVector<EntityItemID>& avatarsToDiscard);
+    // Same as above for a batch of rays, each with its own avatar filters, tested in a single pass over the avatars
+    QVector<RayToAvatarIntersectionResult> findRayIntersectionVectors(const QVector<PickRay>& rays,
+                                                                      const QVector<QVector<EntityItemID>>& avatarsToInclude,
+                                                                      const QVector<QVector<EntityItemID>>& avatarsToDiscard);
 
     // TODO: remove this HACK once we settle on optimal default sort coefficients
     Q_INVOKABLE float getAvatarSortCoefficient(const QString& name);
     Q_INVOKABLE void setAvatarSortCoefficient(const QString& name, const QScriptValue& value);
 
+    // The angular sizes (bounding radius over distance from the camera) below which other avatars
+    // get less of their animation evaluated: "reduced", "low", "eyeIK" and "blendshapes"
+    Q_INVOKABLE float getAvatarAnimationLODThreshold(const QString& name);
+    Q_INVOKABLE void setAvatarAnimationLODThreshold(const QString& name, const QScriptValue& value);
+
     float getMyAvatarSendRate() const { return _myAvatarSendRate.rate(); }
 
 public slots:
@@ -91,6 +105,7 @@ private:
     explicit AvatarManager(const AvatarManager& other);
 
     void simulateAvatarFades(float deltaTime);
+    Avatar::AnimationLOD computeAnimationLOD(const AvatarSharedPointer& avatar, const ViewFrustum& cameraView) const;
 
     AvatarSharedPointer newSharedAvatar() override;
     void deleteMotionStates();
@@ -113,6 +128,12 @@ private:
     int _numAvatarsUpdated { 0 };
     int _numAvatarsNotUpdated { 0 };
     float _avatarSimulationTime { 0.0f };
+    std::array<int, Avatar::AnimationLOD::NUM_LEVELS> _numAvatarsAtAnimationLOD {{ 0, 0, 0 }};
+    std::array<float, Avatar::AnimationLOD::NUM_LEVELS> _animationLODSimulationTime {{ 0.0f, 0.0f, 0.0f }};
+    float _reducedAnimationThreshold { 0.1f };
+    float _lowAnimationThreshold { 0.03f };
+    float _eyeIKThreshold { 0.08f };
+    float _blendshapesThreshold { 0.05f };
     bool _shouldRender { true };
 };
 
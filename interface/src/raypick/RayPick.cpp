@@ -50,6 +50,59 @@ PickResultPointer RayPick::getHUDIntersection(const PickRay& pick) {
     return std::make_shared<RayPickResult>(IntersectionType::HUD, QUuid(), glm::distance(pick.origin, hudRes), hudRes, pick);
 }
 
+void RayPick::getEntityIntersections(std::vector<PickBatchQuery<PickRay>>& queries) {
+    std::vector<EntityRayQuery> rayQueries(queries.size());
+    for (size_t i = 0; i < queries.size(); i++) {
+        const auto& pick = queries[i].pick;
+        EntityRayQuery& rayQuery = rayQueries[i];
+        rayQuery.origin = queries[i].mathPick.origin;
+        rayQuery.direction = queries[i].mathPick.direction;
+        rayQuery.entityIdsToInclude = pick->getIncludeItemsAs<EntityItemID>();
+        rayQuery.entityIdsToDiscard = pick->getIgnoreItemsAs<EntityItemID>();
+        rayQuery.visibleOnly = !pick->getFilter().doesPickInvisible();
+        rayQuery.collidableOnly = !pick->getFilter().doesPickNonCollidable();
+        rayQuery.precisionPicking = !pick->getFilter().doesPickCoarse();
+    }
+
+    QVector<RayToEntityIntersectionResult> entityResults =
+        DependencyManager::get<EntityScriptingInterface>()->findRayIntersectionVectors(rayQueries);
+    for (size_t i = 0; i < queries.size(); i++) {
+        const RayToEntityIntersectionResult& entityRes = entityResults[(int)i];
+        const PickRay& pick = queries[i].mathPick;
+        if (entityRes.intersects) {
+            queries[i].result = std::make_shared<RayPickResult>(IntersectionType::ENTITY, entityRes.entityID, entityRes.distance, entityRes.intersection, pick, entityRes.surfaceNormal);
+        } else {
+            queries[i].result = std::make_shared<RayPickResult>(pick.toVariantMap());
+        }
+    }
+}
+
+void RayPick::getAvatarIntersections(std::vector<PickBatchQuery<PickRay>>& queries) {
+    QVector<PickRay> rays;
+    QVector<QVector<EntityItemID>> avatarsToInclude;
+    QVector<QVector<EntityItemID>> avatarsToDiscard;
+    rays.reserve((int)queries.size());
+    avatarsToInclude.reserve((int)queries.size());
+    avatarsToDiscard.reserve((int)queries.size());
+    for (const auto& query : queries) {
+        rays.push_back(query.mathPick);
+        avatarsToInclude.push_back(query.pick->getIncludeItemsAs<EntityItemID>());
+        avatarsToDiscard.push_back(query.pick->getIgnoreItemsAs<EntityItemID>());
+    }
+
+    QVector<RayToAvatarIntersectionResult> avatarResults =
+        DependencyManager::get<AvatarManager>()->findRayIntersectionVectors(rays, avatarsToInclude, avatarsToDiscard);
+    for (size_t i = 0; i < queries.size(); i++) {
+        const RayToAvatarIntersectionResult& avatarRes = avatarResults[(int)i];
+        const PickRay& pick = queries[i].mathPick;
+        if (avatarRes.intersects) {
+            queries[i].result = std::make_shared<RayPickResult>(IntersectionType::AVATAR, avatarRes.avatarID, avatarRes.distance, avatarRes.intersection, pick);
+        } else {
+            queries[i].result = std::make_shared<RayPickResult>(pick.toVariantMap());
+        }
+    }
+}
+
 glm::vec3 RayPick::intersectRayWithXYPlane(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& point, const glm::quat& rotation, const glm::vec3& registration) {
     // TODO: take into account registration
     glm::vec3 n = rotation * Vectors::FRONT;
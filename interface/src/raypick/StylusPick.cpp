@@ -9,12 +9,15 @@
 
 #include "RayPick.h"
 
+#include <unordered_map>
+
 #include <glm/glm.hpp>
 
 #include "ui/overlays/Base3DOverlay.h"
 
 #include "Application.h"
 #include <DependencyManager.h>
+#include <UUIDHasher.h>
 #include "avatar/AvatarManager.h"
 
 #include <controllers/StandardControls.h>
@@ -179,6 +182,61 @@ PickResultPointer StylusPick::getEntityIntersection(const StylusTip& pick) {
     return std::make_shared<StylusPickResult>(nearestTarget);
 }
 
+void StylusPick::getEntityIntersections(std::vector<PickBatchQuery<StylusTip>>& queries) {
+    struct TargetPlane {
+        bool visible;
+        glm::vec3 position;
+        glm::quat rotation;
+        glm::vec3 dimensions;
+        glm::vec3 registrationPoint;
+    };
+
+    auto entityTree = qApp->getEntities()->getTree();
+    std::unordered_map<QUuid, std::shared_ptr<TargetPlane>> targets;
+    for (auto& query : queries) {
+        const StylusTip& pick = query.mathPick;
+        bool pickInvisible = query.pick->getFilter().doesPickInvisible();
+
+        StylusPickResult nearestTarget(pick.toVariantMap());
+        for (const auto& target : query.pick->getIncludeItems()) {
+            if (target.isNull()) {
+                continue;
+            }
+
+            auto cached = targets.find(target);
+            if (cached == targets.end()) {
+                std::shared_ptr<TargetPlane> plane;
+                auto entity = entityTree->findEntityByEntityItemID(target);
+                if (entity) {
+                    plane = std::make_shared<TargetPlane>();
+                    plane->visible = entity->getVisible();
+                    plane->position = entity->getWorldPosition();
+                    plane->rotation = entity->getWorldOrientation();
+                    plane->dimensions = entity->getDimensions();
+                    plane->registrationPoint = entity->getRegistrationPoint();
+                }
+                cached = targets.emplace(target, plane).first;
+            }
+
+            const auto& plane = cached->second;
+            if (!plane || (!plane->visible && !pickInvisible)) {
+                continue;
+            }
+
+            glm::vec3 normal = plane->rotation * Vectors::UNIT_Z;
+            float distance = glm::dot(pick.position - plane->position, normal);
+            glm::vec3 intersection = pick.position - (normal * distance);
+
+            glm::vec2 pos2D = RayPick::projectOntoXYPlane(intersection, plane->position, plane->rotation, plane->dimensions,
+                plane->registrationPoint, false);
+            if (pos2D == glm::clamp(pos2D, glm::vec2(0), glm::vec2(1)) && distance < nearestTarget.distance) {
+                nearestTarget = StylusPickResult(IntersectionType::ENTITY, target, distance, intersection, pick, normal);
+            }
+        }
+        query.result = std::make_shared<StylusPickResult>(nearestTarget);
+    }
+}
+
 PickResultPointer StylusPick::getOverlayIntersection(const StylusTip& pick) {
     std::vector<StylusPickResult> results;
     for (const auto& target : getIncludeItems()) {
@@ -67,6 +67,9 @@ public:
     PickResultPointer getAvatarIntersection(const StylusTip& pick) override;
     PickResultPointer getHUDIntersection(const StylusTip& pick) override;
 
+    // Answers a frame's batch of stylus pick queries, looking each target entity up once for the whole batch
+    static void getEntityIntersections(std::vector<PickBatchQuery<StylusTip>>& queries);
+
     bool isLeftHand() const override { return _side == Side::Left; }
     bool isRightHand() const override { return _side == Side::Right; }
 
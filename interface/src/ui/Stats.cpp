@@ -124,6 +124,9 @@ void Stats::updateStats(bool force) {
     STAT_UPDATE(avatarCount, avatarManager->size() - 1);
     STAT_UPDATE(updatedAvatarCount, avatarManager->getNumAvatarsUpdated());
     STAT_UPDATE(notUpdatedAvatarCount, avatarManager->getNumAvatarsNotUpdated());
+    STAT_UPDATE(fullAnimationAvatarCount, avatarManager->getNumAvatarsAtAnimationLOD(Avatar::AnimationLOD::FULL));
+    STAT_UPDATE(reducedAnimationAvatarCount, avatarManager->getNumAvatarsAtAnimationLOD(Avatar::AnimationLOD::REDUCED));
+    STAT_UPDATE(lowAnimationAvatarCount, avatarManager->getNumAvatarsAtAnimationLOD(Avatar::AnimationLOD::LOW));
     STAT_UPDATE(serverCount, (int)nodeList->size());
     STAT_UPDATE_FLOAT(renderrate, qApp->getRenderLoopRate(), 0.1f);
     if (qApp->getActiveDisplayPlugin()) {
@@ -341,6 +344,9 @@ void Stats::updateStats(bool force) {
     auto config = qApp->getRenderEngine()->getConfiguration().get();
     STAT_UPDATE(engineFrameTime, (float) config->getCPURunTime());
     STAT_UPDATE(avatarSimulationTime, (float)avatarManager->getAvatarSimulationTime());
+    STAT_UPDATE(fullAnimationAvatarTime, avatarManager->getAnimationLODSimulationTime(Avatar::AnimationLOD::FULL));
+    STAT_UPDATE(reducedAnimationAvatarTime, avatarManager->getAnimationLODSimulationTime(Avatar::AnimationLOD::REDUCED));
+    STAT_UPDATE(lowAnimationAvatarTime, avatarManager->getAnimationLODSimulationTime(Avatar::AnimationLOD::LOW));
     
 
     STAT_UPDATE(gpuBuffers, (int)gpu::Context::getBufferGPUCount());
@@ -508,6 +514,7 @@ void Stats::updateStats(bool force) {
 void Stats::setRenderDetails(const render::RenderDetails& details) {
     STAT_UPDATE(triangles, details._trianglesRendered);
     STAT_UPDATE(materialSwitches, details._materialSwitches);
+    STAT_UPDATE(instancedShapes, details._instancedShapes);
     if (_expanded) {
         STAT_UPDATE(itemConsidered, details._item._considered);
         STAT_UPDATE(itemOutOfView, details._item._outOfView);
@@ -49,6 +49,9 @@ class Stats : public QQuickItem {
     STATS_PROPERTY(int, avatarCount, 0)
     STATS_PROPERTY(int, updatedAvatarCount, 0)
     STATS_PROPERTY(int, notUpdatedAvatarCount, 0)
+    STATS_PROPERTY(int, fullAnimationAvatarCount, 0)
+    STATS_PROPERTY(int, reducedAnimationAvatarCount, 0)
+    STATS_PROPERTY(int, lowAnimationAvatarCount, 0)
     STATS_PROPERTY(int, packetInCount, 0)
     STATS_PROPERTY(int, packetOutCount, 0)
     STATS_PROPERTY(float, mbpsIn, 0)
@@ -93,6 +96,7 @@ class Stats : public QQuickItem {
     STATS_PROPERTY(int, triangles, 0)
     STATS_PROPERTY(int, quads, 0)
     STATS_PROPERTY(int, materialSwitches, 0)
+    STATS_PROPERTY(int, instancedShapes, 0)
     STATS_PROPERTY(int, itemConsidered, 0)
     STATS_PROPERTY(int, itemOutOfView, 0)
     STATS_PROPERTY(int, itemTooSmall, 0)
@@ -132,6 +136,9 @@ class Stats : public QQuickItem {
     STATS_PROPERTY(float, batchFrameTime, 0)
     STATS_PROPERTY(float, engineFrameTime, 0)
     STATS_PROPERTY(float, avatarSimulationTime, 0)
+    STATS_PROPERTY(float, fullAnimationAvatarTime, 0)
+    STATS_PROPERTY(float, reducedAnimationAvatarTime, 0)
+    STATS_PROPERTY(float, lowAnimationAvatarTime, 0)
 
 public:
     static Stats* getInstance();
@@ -177,6 +184,9 @@ signals:
     void avatarCountChanged();
     void updatedAvatarCountChanged();
     void notUpdatedAvatarCountChanged();
+    void fullAnimationAvatarCountChanged();
+    void reducedAnimationAvatarCountChanged();
+    void lowAnimationAvatarCountChanged();
     void packetInCountChanged();
     void packetOutCountChanged();
     void mbpsInChanged();
@@ -220,6 +230,7 @@ signals:
     void trianglesChanged();
     void quadsChanged();
     void materialSwitchesChanged();
+    void instancedShapesChanged();
     void itemConsideredChanged();
     void itemOutOfViewChanged();
     void itemTooSmallChanged();
@@ -257,6 +268,9 @@ signals:
     void batchFrameTimeChanged();
     void engineFrameTimeChanged();
     void avatarSimulationTimeChanged();
+    void fullAnimationAvatarTimeChanged();
+    void reducedAnimationAvatarTimeChanged();
+    void lowAnimationAvatarTimeChanged();
     void rectifiedTextureCountChanged();
     void decimatedTextureCountChanged();
 
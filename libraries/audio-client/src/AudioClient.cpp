@@ -74,6 +74,7 @@ Setting::Handle<bool> dynamicJitterBufferEnabled("dynamicJitterBuffersEnabled",
     InboundAudioStream::DEFAULT_DYNAMIC_JITTER_BUFFER_ENABLED);
 Setting::Handle<int> staticJitterBufferFrames("staticJitterBufferFrames",
     InboundAudioStream::DEFAULT_STATIC_JITTER_FRAMES);
+Setting::Handle<bool> timeStretchJitterBufferEnabled("timeStretchJitterBufferEnabled", false);
 
 // protect the Qt internal device list
 using Mutex = std::mutex;
@@ -1946,6 +1947,7 @@ void AudioClient::stopRecording() {
 void AudioClient::loadSettings() {
     _receivedAudioStream.setDynamicJitterBufferEnabled(dynamicJitterBufferEnabled.get());
     _receivedAudioStream.setStaticJitterBufferFrames(staticJitterBufferFrames.get());
+    _receivedAudioStream.setTimeStretchEnabled(timeStretchJitterBufferEnabled.get());
 
     qCDebug(audioclient) << "---- Initializing Audio Client ----";
     auto codecPlugins = PluginManager::getInstance()->getCodecPlugins();
@@ -1958,6 +1960,7 @@ void AudioClient::loadSettings() {
 void AudioClient::saveSettings() {
     dynamicJitterBufferEnabled.set(_receivedAudioStream.dynamicJitterBufferEnabled());
     staticJitterBufferFrames.set(_receivedAudioStream.getStaticJitterBufferFrames());
+    timeStretchJitterBufferEnabled.set(_receivedAudioStream.timeStretchEnabled());
 }
 
 void AudioClient::setAvatarBoundingBoxParameters(glm::vec3 corner, glm::vec3 scale) {
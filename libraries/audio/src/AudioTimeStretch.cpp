@@ -0,0 +1,120 @@
+//
+//  AudioTimeStretch.cpp
+//  libraries/audio/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioTimeStretch.h"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+// the shortest lag searched, 2.5ms is a 400Hz pitch
+static const float MIN_LAG_SECONDS = 0.0025f;
+
+// normalized correlation needed before a block is considered periodic enough to edit
+static const float MIN_CORRELATION = 0.7f;
+
+// blocks with an RMS below this (about -50dBFS) are edited whatever their correlation
+static const float QUIET_RMS = 100.0f;
+
+AudioTimeStretch::AudioTimeStretch(int sampleRate, int numChannels) :
+    _sampleRate(sampleRate),
+    _numChannels(numChannels),
+    _minLag((int)(sampleRate * MIN_LAG_SECONDS)) {
+    assert(numChannels > 0);
+}
+
+int AudioTimeStretch::findLag(const int16_t* input, int numFrames) {
+    int maxLag = getMaxLag(numFrames);
+    if (maxLag < _minLag || maxLag <= 0) {
+        return 0;
+    }
+
+    // search on the average of all channels, the same edit is then made to each of them
+    _mono.resize(numFrames);
+    float energy = 0.0f;
+    for (int i = 0; i < numFrames; i++) {
+        float sum = 0.0f;
+        for (int c = 0; c < _numChannels; c++) {
+            sum += input[i * _numChannels + c];
+        }
+        _mono[i] = sum / _numChannels;
+        energy += _mono[i] * _mono[i];
+    }
+
+    if (sqrtf(energy / numFrames) < QUIET_RMS) {
+        return maxLag;
+    }
+
+    // find the lag where the first segment best matches the one that follows it
+    int bestLag = 0;
+    float bestCorrelation = MIN_CORRELATION;
+    for (int lag = _minLag; lag <= maxLag; lag++) {
+        float cross = 0.0f;
+        float energyA = 0.0f;
+        float energyB = 0.0f;
+        for (int i = 0; i < lag; i++) {
+            float a = _mono[i];
+            float b = _mono[i + lag];
+            cross += a * b;
+            energyA += a * a;
+            energyB += b * b;
+        }
+        float denominator = sqrtf(energyA * energyB);
+        if (denominator > 0.0f) {
+            float correlation = cross / denominator;
+            if (correlation > bestCorrelation) {
+                bestCorrelation = correlation;
+                bestLag = lag;
+            }
+        }
+    }
+    return bestLag;
+}
+
+// output[i] fades from a to b over numFrames
+static void crossFade(const int16_t* a, const int16_t* b, int16_t* output, int numFrames, int numChannels) {
+    float step = 1.0f / numFrames;
+    for (int i = 0; i < numFrames; i++) {
+        float fade = (i + 0.5f) * step;
+        for (int c = 0; c < numChannels; c++) {
+            int j = i * numChannels + c;
+            output[j] = (int16_t)lrintf(a[j] + fade * (b[j] - a[j]));
+        }
+    }
+}
+
+int AudioTimeStretch::compress(const int16_t* input, int16_t* output, int numFrames) {
+    int lag = findLag(input, numFrames);
+    if (lag == 0) {
+        memcpy(output, input, numFrames * _numChannels * sizeof(int16_t));
+        return numFrames;
+    }
+
+    // [0, lag) blends into [lag, 2 * lag), which removes one lag from the block
+    crossFade(input, input + lag * _numChannels, output, lag, _numChannels);
+    int remaining = numFrames - 2 * lag;
+    memcpy(output + lag * _numChannels, input + 2 * lag * _numChannels, remaining * _numChannels * sizeof(int16_t));
+    return numFrames - lag;
+}
+
+int AudioTimeStretch::expand(const int16_t* input, int16_t* output, int numFrames) {
+    int lag = findLag(input, numFrames);
+    if (lag == 0) {
+        memcpy(output, input, numFrames * _numChannels * sizeof(int16_t));
+        return numFrames;
+    }
+
+    // play [0, lag), then [lag, 2 * lag) blending back into [0, lag), then [lag, numFrames) again
+    memcpy(output, input, lag * _numChannels * sizeof(int16_t));
+    crossFade(input + lag * _numChannels, input, output + lag * _numChannels, lag, _numChannels);
+    int remaining = numFrames - lag;
+    memcpy(output + 2 * lag * _numChannels, input + lag * _numChannels, remaining * _numChannels * sizeof(int16_t));
+    return numFrames + lag;
+}
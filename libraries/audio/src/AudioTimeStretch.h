@@ -0,0 +1,50 @@
+//
+//  AudioTimeStretch.h
+//  libraries/audio/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioTimeStretch_h
+#define hifi_AudioTimeStretch_h
+
+#include <stdint.h>
+#include <vector>
+
+//
+// WSOLA-style time-stretching of short blocks, used to grow or shrink the latency of a jitter buffer.
+//
+// Each call searches the block for the lag at which the waveform best repeats itself (about one pitch period for
+// voiced audio), then removes or repeats one lag worth of audio, cross-fading so that the edit is not audible.
+// Blocks that do not repeat well enough are left untouched, unless they are quiet enough for an edit not to matter.
+//
+class AudioTimeStretch {
+public:
+    AudioTimeStretch(int sampleRate, int numChannels);
+
+    // interleaved int16_t input/output, the output can not alias the input.
+    // returns the number of frames written, which is numFrames when the block could not be stretched.
+    int compress(const int16_t* input, int16_t* output, int numFrames);
+
+    // the output must have room for numFrames + getMaxLag(numFrames) frames
+    int expand(const int16_t* input, int16_t* output, int numFrames);
+
+    int getMaxLag(int numFrames) const { return numFrames / 2; }
+
+    int getSampleRate() const { return _sampleRate; }
+    int getNumChannels() const { return _numChannels; }
+
+private:
+    // returns the lag to cut or repeat, or 0 if the block should be left alone
+    int findLag(const int16_t* input, int numFrames);
+
+    int _sampleRate;
+    int _numChannels;
+    int _minLag;
+    std::vector<float> _mono;
+};
+
+#endif // hifi_AudioTimeStretch_h
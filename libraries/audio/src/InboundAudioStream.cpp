@@ -50,6 +50,19 @@ static const quint64 FRAMES_AVAILABLE_STAT_WINDOW_USECS = 10 * USECS_PER_SECOND;
 // A SelectedAudioFormat packet is not sent until this threshold is exceeded.
 static const int MAX_MISMATCHED_AUDIO_CODEC_COUNT = 10;
 
+// Adaptive playout: the inter-arrival jitter is smoothed the same way as RFC 3550, and the buffer aims to hold
+// enough audio to cover JITTER_DEVIATIONS_COVERED times that jitter.
+static const float INTER_ARRIVAL_JITTER_SMOOTHING = 1.0f / 16.0f;
+static const float JITTER_DEVIATIONS_COVERED = 4.0f;
+static const int MAX_ADAPTIVE_JITTER_BUFFER_FRAMES = 20;
+
+// how far over the desired frames the buffer can get before it is compressed, this keeps it from flapping
+// between compressing and expanding
+static const int TIME_STRETCH_HYSTERESIS_FRAMES = 1;
+
+// at most one of every this many packets is stretched, so that edits stay spread out
+static const int PACKETS_PER_TIME_STRETCH = 2;
+
 InboundAudioStream::InboundAudioStream(int numChannels, int numFrames, int numBlocks, int numStaticJitterBlocks) :
     _ringBuffer(numChannels * numFrames, numBlocks),
     _numChannels(numChannels),
@@ -59,7 +72,8 @@ InboundAudioStream::InboundAudioStream(int numChannels, int numFrames, int numBl
     _incomingSequenceNumberStats(STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
     _starveHistory(STARVE_HISTORY_CAPACITY),
     _unplayedMs(0, UNPLAYED_MS_WINDOW_SECS),
-    _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS) {}
+    _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
+    _timeStretch(new AudioTimeStretch(AudioConstants::SAMPLE_RATE, numChannels)) {}
 
 InboundAudioStream::~InboundAudioStream() {
     cleanupCodec();
@@ -94,6 +108,12 @@ void InboundAudioStream::resetStats() {
     _currentJitterBufferFrames = 0;
     _timeGapStatsForStatsPacket.reset();
     _unplayedMs.reset();
+    _packetsSinceTimeStretch = 0;
+    _timeStretchFramesAdded = 0;
+    _timeStretchFramesRemoved = 0;
+    _interArrivalJitter = 0.0f;
+    _starveFloorFrames = 0;
+    _secondsSinceStarveFloorChanged = 0;
 }
 
 void InboundAudioStream::clearBuffer() {
@@ -114,6 +134,13 @@ void InboundAudioStream::perSecondCallbackForUpdatingStats() {
     _timeGapStatsForDesiredReduction.currentIntervalComplete();
     _timeGapStatsForStatsPacket.currentIntervalComplete();
     _unplayedMs.currentIntervalComplete();
+
+    // let the extra frames added for starves decay, the same way the window for desired reduction does
+    if (_starveFloorFrames > 0 && ++_secondsSinceStarveFloorChanged >= WINDOW_SECONDS_FOR_DESIRED_REDUCTION) {
+        _starveFloorFrames--;
+        _secondsSinceStarveFloorChanged = 0;
+        updateAdaptiveJitterBufferFrames();
+    }
 }
 
 int InboundAudioStream::parseData(ReceivedMessage& message) {
@@ -174,7 +201,7 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
                     if (packetPCM) {
                         // If there are PCM packets in-flight after the codec is changed, use them.
                         auto afterProperties = message.readWithoutCopy(message.getBytesLeftToRead());
-                        _ringBuffer.writeData(afterProperties.data(), afterProperties.size());
+                        writeSamplesToBuffer(afterProperties.data(), afterProperties.size());
                     } else {
                         // Since the data in the stream is using a codec that we aren't prepared for,
                         // we need to let the codec know that we don't have data for it, this will
@@ -252,7 +279,7 @@ int InboundAudioStream::lostAudioData(int numPackets) {
             decodedBuffer.resize(AudioConstants::NETWORK_FRAME_BYTES_STEREO);
             memset(decodedBuffer.data(), 0, decodedBuffer.size());
         }
-        _ringBuffer.writeData(decodedBuffer.data(), decodedBuffer.size());
+        writeSamplesToBuffer(decodedBuffer.data(), decodedBuffer.size());
     }
     return 0;
 }
@@ -265,7 +292,51 @@ int InboundAudioStream::parseAudioData(PacketType type, const QByteArray& packet
         decodedBuffer = packetAfterStreamProperties;
     }
     auto actualSize = decodedBuffer.size();
-    return _ringBuffer.writeData(decodedBuffer.data(), actualSize);
+    return writeSamplesToBuffer(decodedBuffer.data(), actualSize);
+}
+
+int InboundAudioStream::writeSamplesToBuffer(const char* data, int numBytes) {
+    int numChannels = _timeStretch->getNumChannels();
+    int numFrames = numBytes / (int)(numChannels * sizeof(int16_t));
+
+    if (_timeStretchEnabled && numFrames > 0 && ++_packetsSinceTimeStretch >= PACKETS_PER_TIME_STRETCH) {
+        // compare against what is buffered before this write, that is what playback will run through first
+        int framesAvailable = _ringBuffer.framesAvailable();
+        bool shouldCompress = !_isStarved && framesAvailable > _desiredJitterBufferFrames + TIME_STRETCH_HYSTERESIS_FRAMES;
+        bool shouldExpand = framesAvailable < _desiredJitterBufferFrames;
+
+        if (shouldCompress || shouldExpand) {
+            auto input = reinterpret_cast<const int16_t*>(data);
+            _timeStretchBuffer.resize((numFrames + _timeStretch->getMaxLag(numFrames)) * numChannels);
+
+            int stretchedFrames = shouldCompress ? _timeStretch->compress(input, _timeStretchBuffer.data(), numFrames)
+                                                 : _timeStretch->expand(input, _timeStretchBuffer.data(), numFrames);
+            if (stretchedFrames != numFrames) {
+                _packetsSinceTimeStretch = 0;
+                if (stretchedFrames > numFrames) {
+                    _timeStretchFramesAdded += stretchedFrames - numFrames;
+                } else {
+                    _timeStretchFramesRemoved += numFrames - stretchedFrames;
+                }
+                int stretchedBytes = stretchedFrames * numChannels * (int)sizeof(int16_t);
+                return _ringBuffer.writeData(reinterpret_cast<const char*>(_timeStretchBuffer.data()), stretchedBytes);
+            }
+        }
+    }
+
+    return _ringBuffer.writeData(data, numBytes);
+}
+
+void InboundAudioStream::setupTimeStretch(int sampleRate, int numChannels) {
+    _timeStretch.reset(new AudioTimeStretch(sampleRate, numChannels));
+}
+
+float InboundAudioStream::getTimeStretchAddedMsecs() const {
+    return (float)_timeStretchFramesAdded * MSECS_PER_SECOND / _timeStretch->getSampleRate();
+}
+
+float InboundAudioStream::getTimeStretchRemovedMsecs() const {
+    return (float)_timeStretchFramesRemoved * MSECS_PER_SECOND / _timeStretch->getSampleRate();
 }
 
 int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
@@ -390,7 +461,12 @@ void InboundAudioStream::setToStarved() {
     quint64 now = usecTimestampNow();
     _starveHistory.insert(now);
 
-    if (_dynamicJitterBufferEnabled) {
+    if (_dynamicJitterBufferEnabled && _timeStretchEnabled) {
+        // every starve buys some extra frames, which then decay away if the stream settles down
+        _starveFloorFrames = std::min(_starveFloorFrames + 1, MAX_ADAPTIVE_JITTER_BUFFER_FRAMES);
+        _secondsSinceStarveFloorChanged = 0;
+        updateAdaptiveJitterBufferFrames();
+    } else if (_dynamicJitterBufferEnabled) {
         // dynamic jitter buffers are enabled. check if this starve put us over the window
         // starve threshold
         quint64 windowEnd = now - WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES * USECS_PER_SECOND;
@@ -436,6 +512,27 @@ void InboundAudioStream::setDynamicJitterBufferEnabled(bool enable) {
     _dynamicJitterBufferEnabled = enable;
 }
 
+void InboundAudioStream::setTimeStretchEnabled(bool enable) {
+    _timeStretchEnabled = enable;
+    _packetsSinceTimeStretch = 0;
+    if (enable) {
+        updateAdaptiveJitterBufferFrames();
+    }
+}
+
+void InboundAudioStream::updateAdaptiveJitterBufferFrames() {
+    if (!_dynamicJitterBufferEnabled || !_timeStretchEnabled) {
+        return;
+    }
+
+    int jitterFrames = 1 + (int)ceilf(JITTER_DEVIATIONS_COVERED * _interArrivalJitter / AudioConstants::NETWORK_FRAME_USECS);
+    int desiredFrames = std::min(std::max(jitterFrames, 1 + _starveFloorFrames), MAX_ADAPTIVE_JITTER_BUFFER_FRAMES);
+    if (desiredFrames != _desiredJitterBufferFrames) {
+        _desiredJitterBufferFrames = desiredFrames;
+        qCDebug(audiostream, "Set desired jitter frames to %d (adaptive)", _desiredJitterBufferFrames);
+    }
+}
+
 void InboundAudioStream::setStaticJitterBufferFrames(int staticJitterBufferFrames) {
     _staticJitterBufferFrames = staticJitterBufferFrames;
     if (!_dynamicJitterBufferEnabled) {
@@ -449,6 +546,13 @@ void InboundAudioStream::packetReceivedUpdateTimingStats() {
     // discard the first few packets we receive since they usually have gaps that aren't represensative of normal jitter
     const quint32 NUM_INITIAL_PACKETS_DISCARD = 1000; // 10s
     quint64 now = usecTimestampNow();
+
+    // the adaptive estimate reacts within a few packets, so it does not wait for the initial packets to go by
+    if (_timeStretchEnabled && _lastPacketReceivedTime != 0) {
+        float deviation = fabsf((float)(now - _lastPacketReceivedTime) - (float)AudioConstants::NETWORK_FRAME_USECS);
+        _interArrivalJitter += INTER_ARRIVAL_JITTER_SMOOTHING * (deviation - _interArrivalJitter);
+        updateAdaptiveJitterBufferFrames();
+    }
     if (_incomingSequenceNumberStats.getReceived() > NUM_INITIAL_PACKETS_DISCARD) {
         quint64 gap = now - _lastPacketReceivedTime;
         _timeGapStatsForStatsPacket.update(gap);
@@ -463,7 +567,7 @@ void InboundAudioStream::packetReceivedUpdateTimingStats() {
             _timeGapStatsForDesiredCalcOnTooManyStarves.clearNewStatsAvailableFlag();
         }
 
-        if (_dynamicJitterBufferEnabled) {
+        if (_dynamicJitterBufferEnabled && !_timeStretchEnabled) {
             // if the max gap in window B (_timeGapStatsForDesiredReduction) corresponds to a smaller number of frames than _desiredJitterBufferFrames,
             // then reduce _desiredJitterBufferFrames to that number of frames.
             if (_timeGapStatsForDesiredReduction.getNewStatsAvailableFlag() && _timeGapStatsForDesiredReduction.isWindowFilled()) {
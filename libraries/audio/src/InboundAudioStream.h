@@ -12,6 +12,9 @@
 #ifndef hifi_InboundAudioStream_h
 #define hifi_InboundAudioStream_h
 
+#include <memory>
+#include <vector>
+
 #include <Node.h>
 #include <NodeData.h>
 #include <NumericalConstants.h>
@@ -22,6 +25,7 @@
 #include <plugins/CodecPlugin.h>
 
 #include "AudioRingBuffer.h"
+#include "AudioTimeStretch.h"
 #include "MovingMinMaxAvg.h"
 #include "SequenceNumberStats.h"
 #include "AudioStreamStats.h"
@@ -69,6 +73,11 @@ public:
     void setDynamicJitterBufferEnabled(bool enable);
     void setStaticJitterBufferFrames(int staticJitterBufferFrames);
 
+    /// when enabled along with dynamic jitter buffers, the desired frames follow the measured inter-arrival jitter and
+    /// the buffer is time-stretched towards them, instead of dropping or waiting on whole frames
+    void setTimeStretchEnabled(bool enable);
+    bool timeStretchEnabled() const { return _timeStretchEnabled; }
+
     virtual AudioStreamStats getAudioStreamStats() const;
 
     /// returns the desired number of jitter buffer frames under the dyanmic jitter buffers scheme
@@ -91,6 +100,9 @@ public:
     int getStarveCount() const { return _starveCount; }
     int getSilentFramesDropped() const { return _silentFramesDropped; }
     int getOverflowCount() const { return _ringBuffer.getOverflowCount(); }
+    float getTimeStretchAddedMsecs() const;
+    float getTimeStretchRemovedMsecs() const;
+    float getInterArrivalJitterMsecs() const { return _interArrivalJitter / USECS_PER_MSEC; }
 
     int getPacketsReceived() const { return _incomingSequenceNumberStats.getReceived(); }
     
@@ -117,6 +129,7 @@ private:
 
     void popSamplesNoCheck(int samples);
     void framesAvailableChanged();
+    void updateAdaptiveJitterBufferFrames();
 
 protected:
     // disallow copying of InboundAudioStream objects
@@ -137,6 +150,13 @@ protected:
 
     /// writes silent frames to the buffer that may be dropped to reduce latency caused by the buffer
     virtual int writeDroppableSilentFrames(int silentFrames);
+
+    /// writes audio to the buffer, compressing or expanding it first if time-stretching is enabled and the buffer
+    /// is away from its desired frames
+    int writeSamplesToBuffer(const char* data, int numBytes);
+
+    /// sets the format of the samples given to writeSamplesToBuffer, defaults to the network format
+    void setupTimeStretch(int sampleRate, int numChannels);
     
 protected:
 
@@ -183,6 +203,17 @@ protected:
     float _reverbTime { 0.0f };
     float _wetLevel { 0.0f };
 
+    // adaptive playout
+    bool _timeStretchEnabled { false };
+    std::unique_ptr<AudioTimeStretch> _timeStretch;
+    std::vector<int16_t> _timeStretchBuffer;
+    int _packetsSinceTimeStretch { 0 };
+    int _timeStretchFramesAdded { 0 };
+    int _timeStretchFramesRemoved { 0 };
+    float _interArrivalJitter { 0.0f }; // usecs
+    int _starveFloorFrames { 0 };
+    int _secondsSinceStarveFloorChanged { 0 };
+
     CodecPluginPointer _codec;
     QString _selectedCodecName;
     Decoder* _decoder { nullptr };
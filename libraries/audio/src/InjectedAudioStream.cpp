@@ -41,12 +41,7 @@ int InjectedAudioStream::parseStreamProperties(PacketType type,
     packetStream >> isStereo;
     
     // if isStereo value has changed, restart the ring buffer with new frame size
-    if (isStereo != _isStereo) {
-        _ringBuffer.resizeForFrameSize(isStereo
-                                       ? AudioConstants::NETWORK_FRAME_SAMPLES_STEREO
-                                       : AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
-        _isStereo = isStereo;
-    }
+    setIsStereo(isStereo);
 
     // pull the loopback flag and set our boolean
     uchar shouldLoopback;
@@ -22,6 +22,8 @@ void MixedProcessedAudioStream::outputFormatChanged(int sampleRate, int channelC
     int deviceOutputFrameFrames = networkToDeviceFrames(AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / AudioConstants::STEREO);
     int deviceOutputFrameSamples = deviceOutputFrameFrames * AudioConstants::STEREO;
     _ringBuffer.resizeForFrameSize(deviceOutputFrameSamples);
+    // stretching happens after the samples are processed for the device
+    setupTimeStretch(sampleRate, channelCount);
 }
 
 int MixedProcessedAudioStream::writeDroppableSilentFrames(int silentFrames) {
@@ -47,7 +49,7 @@ int MixedProcessedAudioStream::lostAudioData(int numPackets) {
 
         emit processSamples(decodedBuffer, outputBuffer);
 
-        _ringBuffer.writeData(outputBuffer.data(), outputBuffer.size());
+        writeSamplesToBuffer(outputBuffer.data(), outputBuffer.size());
         qCDebug(audiostream, "Wrote %d samples to buffer (%d available)", outputBuffer.size() / (int)sizeof(int16_t), getSamplesAvailable());
     }
     return 0;
@@ -66,7 +68,7 @@ int MixedProcessedAudioStream::parseAudioData(PacketType type, const QByteArray&
     QByteArray outputBuffer;
     emit processSamples(decodedBuffer, outputBuffer);
 
-    _ringBuffer.writeData(outputBuffer.data(), outputBuffer.size());
+    writeSamplesToBuffer(outputBuffer.data(), outputBuffer.size());
     qCDebug(audiostream, "Wrote %d samples to buffer (%d available)", outputBuffer.size() / (int)sizeof(int16_t), getSamplesAvailable());
 
     return packetAfterStreamProperties.size();
@@ -72,6 +72,16 @@ void PositionalAudioStream::updateLastPopOutputLoudnessAndTrailingLoudness() {
     }
 }
 
+void PositionalAudioStream::setIsStereo(bool isStereo) {
+    if (isStereo != _isStereo) {
+        _ringBuffer.resizeForFrameSize(isStereo
+                                       ? AudioConstants::NETWORK_FRAME_SAMPLES_STEREO
+                                       : AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        setupTimeStretch(AudioConstants::SAMPLE_RATE, isStereo ? AudioConstants::STEREO : AudioConstants::MONO);
+        _isStereo = isStereo;
+    }
+}
+
 int PositionalAudioStream::parsePositionalData(const QByteArray& positionalByteArray) {
     QDataStream packetStream(positionalByteArray);
 
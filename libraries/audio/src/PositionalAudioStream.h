@@ -57,6 +57,9 @@ protected:
 
     int parsePositionalData(const QByteArray& positionalByteArray);
 
+    /// switches the stream between mono and stereo, restarting the ring buffer and time-stretch with the new format
+    void setIsStereo(bool isStereo);
+
 protected:
     Type _type;
     glm::vec3 _position;
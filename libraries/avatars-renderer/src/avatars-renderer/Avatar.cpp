@@ -361,7 +361,7 @@ void Avatar::simulate(float deltaTime, bool inView) {
         PROFILE_RANGE(simulation, "updateJoints");
         if (inView) {
             Head* head = getHead();
-            if (_hasNewJointData) {
+            if (_hasNewJointData && isTimeToEvaluateRig()) {
                 _skeletonModel->getRig().copyJointsFromJointData(_jointData);
                 glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
                 _skeletonModel->getRig().computeExternalPoses(rootTransform);
@@ -377,6 +377,9 @@ void Avatar::simulate(float deltaTime, bool inView) {
                     headPosition = getWorldPosition();
                 }
                 head->setPosition(headPosition);
+            } else if (_hasNewJointData) {
+                // only the joints wait for the animation LOD, the model still follows the avatar's position and bounds
+                _skeletonModel->simulate(deltaTime, false);
             }
             head->setScale(getModelScale());
             head->simulate(deltaTime);
@@ -416,6 +419,23 @@ void Avatar::simulate(float deltaTime, bool inView) {
     }
 }
 
+// Distant avatars keep their last pose until it is their turn again; the joint data received in between is not lost,
+// as the next evaluation uses the latest of it.
+static const uint64_t ANIMATION_LOD_INTERVALS[Avatar::AnimationLOD::NUM_LEVELS] = {
+    0,
+    USECS_PER_SECOND / 30,
+    USECS_PER_SECOND / 10
+};
+
+bool Avatar::isTimeToEvaluateRig() {
+    uint64_t now = usecTimestampNow();
+    if (now - _lastRigEvaluationTime < ANIMATION_LOD_INTERVALS[_animationLOD.level]) {
+        return false;
+    }
+    _lastRigEvaluationTime = now;
+    return true;
+}
+
 float Avatar::getSimulationRate(const QString& rateName) const {
     if (rateName == "") {
         return _simulationRate.rate();
@@ -238,6 +238,21 @@ public:
 
     bool hasNewJointData() const { return _hasNewJointData; }
 
+    /// How much of its animation an avatar in view evaluates, picked by its manager from how large it appears
+    struct AnimationLOD {
+        enum Level {
+            FULL = 0,   // the rig is evaluated whenever new joint data arrives
+            REDUCED,    // at most 30 times a second
+            LOW,        // at most 10 times a second
+            NUM_LEVELS
+        };
+        Level level { FULL };
+        bool eyeIK { true };
+        bool blendshapes { true };
+    };
+    void setAnimationLOD(const AnimationLOD& lod) { _animationLOD = lod; }
+    const AnimationLOD& getAnimationLOD() const { return _animationLOD; }
+
     float getBoundingRadius() const;
 
     void addToScene(AvatarSharedPointer self, const render::ScenePointer& scene);
@@ -297,6 +312,9 @@ protected:
 
     SkeletonModelPointer _skeletonModel;
 
+    // Whether enough time has passed, for the current animation LOD, since the rig was last evaluated
+    bool isTimeToEvaluateRig();
+
     void invalidateJointIndicesCache() const;
     void withValidJointIndicesCache(std::function<void()> const& worker) const;
     mutable QHash<QString, int> _modelJointIndicesCache;
@@ -361,6 +379,9 @@ protected:
     RateCounter<> _skeletonModelSimulationRate;
     RateCounter<> _jointDataSimulationRate;
 
+    AnimationLOD _animationLOD;
+    uint64_t _lastRigEvaluationTime { 0 };
+
 protected:
     class AvatarEntityDataHash {
     public:
@@ -107,6 +107,11 @@ void SkeletonModel::updateRig(float deltaTime, glm::mat4 parentTransform) {
     head->setBaseYaw(glm::degrees(eulers.y));
     head->setBaseRoll(glm::degrees(-eulers.z));
 
+    // The eyes of small or distant avatars are left as they came over the wire
+    if (!_owningAvatar->getAnimationLOD().eyeIK) {
+        return;
+    }
+
     Rig::EyeParameters eyeParams;
     eyeParams.eyeLookAt = lookAt;
     eyeParams.eyeSaccade = glm::vec3(0.0f);
@@ -129,7 +134,10 @@ void SkeletonModel::updateAttitude(const glm::quat& orientation) {
 void SkeletonModel::simulate(float deltaTime, bool fullUpdate) {
     updateAttitude(_owningAvatar->getWorldOrientation());
     if (fullUpdate) {
-        setBlendshapeCoefficients(_owningAvatar->getHead()->getSummedBlendshapeCoefficients());
+        // Small or distant avatars keep the face they had, which also spares blending their meshes again
+        if (_owningAvatar->getAnimationLOD().blendshapes) {
+            setBlendshapeCoefficients(_owningAvatar->getHead()->getSummedBlendshapeCoefficients());
+        }
 
         Parent::simulate(deltaTime, fullUpdate);
 
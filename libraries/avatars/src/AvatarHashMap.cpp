@@ -9,7 +9,14 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <QtCore/QDataStream>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 
 #include <NodeList.h>
 #include <udt/PacketHeaders.h>
@@ -19,20 +26,50 @@
 #include "AvatarLogging.h"
 #include "AvatarHashMap.h"
 
-AvatarHashMap::AvatarHashMap() {
+// Bulk avatar data is parsed on the calling thread alone unless it holds at least this many avatars per thread
+static const size_t MIN_AVATARS_PER_PARSE_THREAD { 8 };
+
+class AvatarDataParser : public QRunnable {
+public:
+    using Parse = std::function<void()>;
+
+    AvatarDataParser(Parse parse, QSemaphore& done) : _parse(parse), _done(done) {}
+
+    void run() override {
+        _parse();
+        _done.release();
+    }
+
+private:
+    Parse _parse;
+    QSemaphore& _done;
+};
+
+AvatarHashMap::AvatarHashMap() : _parsePool(new QThreadPool()) {
     auto nodeList = DependencyManager::get<NodeList>();
 
     connect(nodeList.data(), &NodeList::uuidChanged, this, &AvatarHashMap::sessionUUIDChanged);
+
+    _parsePool->setObjectName("AvatarDataParser");
+    _parsePool->setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+}
+
+AvatarHashMap::~AvatarHashMap() {
+    _parsePool->waitForDone();
+}
+
+void AvatarHashMap::publishHash() {
+    // The snapshot shares the hash's data until it next changes
+    std::atomic_store(&_avatarHashSnapshot, std::make_shared<const AvatarHash>(_avatarHash));
 }
 
 QVector<QUuid> AvatarHashMap::getAvatarIdentifiers() {
-    QReadLocker locker(&_hashLock);
-    return _avatarHash.keys().toVector();
+    return getHashSnapshot()->keys().toVector();
 }
 
 bool AvatarHashMap::isAvatarInRange(const glm::vec3& position, const float range) {
-    auto hashCopy = getHashCopy();
-    foreach(const AvatarSharedPointer& sharedAvatar, hashCopy) {
+    auto hashSnapshot = getHashSnapshot();
+    foreach(const AvatarSharedPointer& sharedAvatar, *hashSnapshot) {
         glm::vec3 avatarPosition = sharedAvatar->getWorldPosition();
         float distance = glm::distance(avatarPosition, position);
         if (distance < range) {
@@ -43,10 +80,10 @@ bool AvatarHashMap::isAvatarInRange(const glm::vec3& position, const float range
 }
 
 int AvatarHashMap::numberOfAvatarsInRange(const glm::vec3& position, float rangeMeters) {
-    auto hashCopy = getHashCopy();
+    auto hashSnapshot = getHashSnapshot();
     auto rangeMeters2 = rangeMeters * rangeMeters;
     int count = 0;
-    for (const AvatarSharedPointer& sharedAvatar : hashCopy) {
+    for (const AvatarSharedPointer& sharedAvatar : *hashSnapshot) {
         glm::vec3 avatarPosition = sharedAvatar->getWorldPosition();
         auto distance2 = glm::distance2(avatarPosition, position);
         if (distance2 < rangeMeters2) {
@@ -68,14 +105,21 @@ AvatarSharedPointer AvatarHashMap::addAvatar(const QUuid& sessionUUID, const QWe
     avatar->setOwningAvatarMixer(mixerWeakPointer);
 
     _avatarHash.insert(sessionUUID, avatar);
+    publishHash();
     emit avatarAddedEvent(sessionUUID);
 
     return avatar;
 }
 
 AvatarSharedPointer AvatarHashMap::newOrExistingAvatar(const QUuid& sessionUUID, const QWeakPointer<Node>& mixerWeakPointer) {
+    // Only adding an avatar needs the lock
+    auto avatar = getHashSnapshot()->value(sessionUUID);
+    if (avatar) {
+        return avatar;
+    }
+
     QWriteLocker locker(&_hashLock);
-    auto avatar = _avatarHash.value(sessionUUID);
+    avatar = _avatarHash.value(sessionUUID);
     if (!avatar) {
         avatar = addAvatar(sessionUUID, mixerWeakPointer);
     }
@@ -83,46 +127,81 @@ AvatarSharedPointer AvatarHashMap::newOrExistingAvatar(const QUuid& sessionUUID,
 }
 
 AvatarSharedPointer AvatarHashMap::findAvatar(const QUuid& sessionUUID) const {
-    QReadLocker locker(&_hashLock);
-    if (_avatarHash.contains(sessionUUID)) {
-        return _avatarHash.value(sessionUUID);
-    }
-    return nullptr;
+    return getHashSnapshot()->value(sessionUUID);
 }
 
 void AvatarHashMap::processAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     PerformanceTimer perfTimer("receiveAvatar");
-    // enumerate over all of the avatars in this packet
-    // only add them if mixerWeakPointer points to something (meaning that mixer is still around)
-    while (message->getBytesLeftToRead()) {
-        parseAvatarData(message, sendingNode);
-    }
-}
+    auto nodeList = DependencyManager::get<NodeList>();
+    bool requestsDomainListData = nodeList->getRequestsDomainListData();
+
+    // Each avatar's data is preceded by its length, so the message is split up by avatar before any of it is parsed,
+    // and the data of our own avatar or of ignored ones is skipped without parsing it
+    std::vector<AvatarDataSlice> slices;
+    QSet<QUuid> sessionUUIDs;
+    bool isParallel = true;
+    while (message->getBytesLeftToRead() >= NUM_BYTES_RFC4122_UUID + (qint64)sizeof(quint16)) {
+        QUuid sessionUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+        quint16 numBytes;
+        message->readPrimitive(&numBytes);
+        if (numBytes > message->getBytesLeftToRead()) {
+            qCWarning(avatars) << "Avatar data for" << sessionUUID << "is longer than the rest of the packet";
+            break;
+        }
+        QByteArray data = message->readWithoutCopy(numBytes);
 
-AvatarSharedPointer AvatarHashMap::parseAvatarData(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
-    QUuid sessionUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+        if (sessionUUID == _lastOwnerSessionUUID || (nodeList->isIgnoringNode(sessionUUID) && !requestsDomainListData)) {
+            continue;
+        }
+        // only add them if mixerWeakPointer points to something (meaning that mixer is still around)
+        bool isNew = !getHashSnapshot()->contains(sessionUUID);
+        slices.push_back({ newOrExistingAvatar(sessionUUID, sendingNode), data, isNew });
 
-    int positionBeforeRead = message->getPosition();
+        // an avatar that appears more than once has to be parsed in order, on one thread
+        if (sessionUUIDs.contains(sessionUUID)) {
+            isParallel = false;
+        }
+        sessionUUIDs.insert(sessionUUID);
+    }
 
-    QByteArray byteArray = message->readWithoutCopy(message->getBytesLeftToRead());
+    parseAvatarDataSlices(slices, isParallel);
+}
 
-    // make sure this isn't our own avatar data or for a previously ignored node
-    auto nodeList = DependencyManager::get<NodeList>();
+void AvatarHashMap::parseAvatarDataSlices(std::vector<AvatarDataSlice>& slices, bool isParallel) {
+    size_t numThreads = std::min((size_t)_parsePool->maxThreadCount() + 1, slices.size() / MIN_AVATARS_PER_PARSE_THREAD);
+    if (!isParallel || numThreads <= 1) {
+        for (auto& slice : slices) {
+            slice.avatar->parseDataFromBuffer(slice.data);
+        }
+        return;
+    }
 
-    if (sessionUUID != _lastOwnerSessionUUID && (!nodeList->isIgnoringNode(sessionUUID) || nodeList->getRequestsDomainListData())) {
-        auto avatar = newOrExistingAvatar(sessionUUID, sendingNode);
+    // Avatars are independent of each other, so they are parsed in parallel, with this thread taking the first share
+    // as well as the new avatars
+    for (auto& slice : slices) {
+        if (slice.isNew) {
+            slice.avatar->parseDataFromBuffer(slice.data);
+        }
+    }
 
-        // have the matching (or new) avatar parse the data from the packet
-        int bytesRead = avatar->parseDataFromBuffer(byteArray);
-        message->seek(positionBeforeRead + bytesRead);
-        return avatar;
-    } else {
-        // create a dummy AvatarData class to throw this data on the ground
-        AvatarData dummyData;
-        int bytesRead = dummyData.parseDataFromBuffer(byteArray);
-        message->seek(positionBeforeRead + bytesRead);
-        return std::make_shared<AvatarData>();
+    size_t sliceCount = (slices.size() + numThreads - 1) / numThreads;
+    auto parseRange = [&slices](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            if (!slices[i].isNew) {
+                slices[i].avatar->parseDataFromBuffer(slices[i].data);
+            }
+        }
+    };
+
+    QSemaphore done;
+    int numStarted = 0;
+    for (size_t first = sliceCount; first < slices.size(); first += sliceCount) {
+        size_t last = std::min(first + sliceCount, slices.size());
+        _parsePool->start(new AvatarDataParser([=] { parseRange(first, last); }, done));
+        numStarted++;
     }
+    parseRange(0, sliceCount);
+    done.acquire(numStarted);
 }
 
 void AvatarHashMap::processAvatarIdentityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
@@ -140,9 +219,9 @@ void AvatarHashMap::processAvatarIdentityPacket(QSharedPointer<ReceivedMessage>
     static auto EMPTY = QUuid();
 
     {
-        QReadLocker locker(&_hashLock);
-        auto me = _avatarHash.find(EMPTY);
-        if ((me != _avatarHash.end()) && (identityUUID == me.value()->getSessionUUID())) {
+        auto hashSnapshot = getHashSnapshot();
+        auto me = hashSnapshot->find(EMPTY);
+        if ((me != hashSnapshot->end()) && (identityUUID == me.value()->getSessionUUID())) {
             // We add MyAvatar to _avatarHash with an empty UUID. Code relies on this. In order to correctly handle an
             // identity packet for ourself (such as when we are assigned a sessionDisplayName by the mixer upon joining),
             // we make things match here.
@@ -176,6 +255,7 @@ void AvatarHashMap::removeAvatar(const QUuid& sessionUUID, KillAvatarReason remo
     auto removedAvatar = _avatarHash.take(sessionUUID);
 
     if (removedAvatar) {
+        publishHash();
         handleRemovedAvatar(removedAvatar, removalReason);
     }
 }
@@ -18,6 +18,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -29,13 +30,24 @@
 
 #include "AvatarData.h"
 
+class QThreadPool;
+
+/// An immutable copy of the avatar hash.  The avatars it holds stay alive for as long as the snapshot does,
+/// whether or not they have been removed from the hash since.
+using AvatarHashSnapshot = std::shared_ptr<const AvatarHash>;
+
 class AvatarHashMap : public QObject, public Dependency {
     Q_OBJECT
     SINGLETON_DEPENDENCY
 
 public:
-    AvatarHash getHashCopy() { QReadLocker lock(&_hashLock); return _avatarHash; }
-    int size() { return _avatarHash.size(); }
+    ~AvatarHashMap();
+
+    /// The avatars as of the last change to the hash.  Taking it doesn't wait for the hash lock, and it can
+    /// be iterated on any thread while avatars are added and removed.
+    AvatarHashSnapshot getHashSnapshot() const { return std::atomic_load(&_avatarHashSnapshot); }
+    AvatarHash getHashCopy() { return *getHashSnapshot(); }
+    int size() { return getHashSnapshot()->size(); }
 
     // Currently, your own avatar will be included as the null avatar id.
     Q_INVOKABLE QVector<QUuid> getAvatarIdentifiers();
@@ -64,21 +76,33 @@ protected slots:
 protected:
     AvatarHashMap();
 
-    virtual AvatarSharedPointer parseAvatarData(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
     virtual AvatarSharedPointer newSharedAvatar();
     virtual AvatarSharedPointer addAvatar(const QUuid& sessionUUID, const QWeakPointer<Node>& mixerWeakPointer);
     AvatarSharedPointer newOrExistingAvatar(const QUuid& sessionUUID, const QWeakPointer<Node>& mixerWeakPointer);
-    virtual AvatarSharedPointer findAvatar(const QUuid& sessionUUID) const; // uses a QReadLocker on the hashLock
+    virtual AvatarSharedPointer findAvatar(const QUuid& sessionUUID) const; // uses the hash snapshot, without locking
     virtual void removeAvatar(const QUuid& sessionUUID, KillAvatarReason removalReason = KillAvatarReason::NoReason);
 
     virtual void handleRemovedAvatar(const AvatarSharedPointer& removedAvatar, KillAvatarReason removalReason = KillAvatarReason::NoReason);
 
+    // Must be called with the _hashLock locked for write, after every change to the _avatarHash
+    void publishHash();
+
     AvatarHash _avatarHash;
-    // "Case-based safety": Most access to the _avatarHash is on the same thread. Write access is protected by a write-lock.
-    // If you read from a different thread, you must read-lock the _hashLock. (Scripted write access is not supported).
+    // "Case-based safety": Most access to the _avatarHash is on the same thread. Write access is protected by a write-lock,
+    // and must be followed by publishHash(). Reads from other threads should use getHashSnapshot().
+    // (Scripted write access is not supported).
     mutable QReadWriteLock _hashLock;
 
 private:
+    struct AvatarDataSlice {
+        AvatarSharedPointer avatar;
+        QByteArray data;
+        bool isNew; // the first data of a new avatar is parsed on the receiving thread, as it may initialize it
+    };
+    void parseAvatarDataSlices(std::vector<AvatarDataSlice>& slices, bool isParallel);
+
+    AvatarHashSnapshot _avatarHashSnapshot { std::make_shared<const AvatarHash>() };
+    std::unique_ptr<QThreadPool> _parsePool;
     QUuid _lastOwnerSessionUUID;
 };
 
@@ -206,6 +206,7 @@ void EntityTreeRenderer::clear() {
     }
     _entitiesInScene.clear();
     _renderablesToUpdate.clear();
+    _particleSimulation.clear();
 
     // reset the zone to the default (while we load the next scene)
     _layeredZones.clear();
@@ -416,6 +417,7 @@ void EntityTreeRenderer::update(bool simulate) {
                 _viewState->copyCurrentViewFrustum(view);
                 updateChangedEntities(scene, view, transaction);
                 scene->enqueueTransaction(transaction);
+                _particleSimulation.update(view);
             }
         }
 
@@ -434,46 +436,33 @@ void EntityTreeRenderer::update(bool simulate) {
     }
 }
 
-bool EntityTreeRenderer::findBestZoneAndMaybeContainingEntities(QVector<EntityItemID>* entitiesContainingAvatar) {
+bool EntityTreeRenderer::findBestZoneAndMaybeContainingEntities(QSet<EntityItemID>* entitiesContainingAvatar) {
     bool didUpdate = false;
-    float radius = 0.01f; // for now, assume 0.01 meter radius, because we actually check the point inside later
     QVector<EntityItemPointer> foundEntities;
 
-    // find the entities near us
     // don't let someone else change our tree while we search
     _tree->withReadLock([&] {
 
-        // FIXME - if EntityTree had a findEntitiesContainingPoint() this could theoretically be a little faster
-        std::static_pointer_cast<EntityTree>(_tree)->findEntities(_avatarPosition, radius, foundEntities);
+        // only zones and entities with scripts are found, as all other entities can be ignored because they
+        // can't have events fired on them.
+        // FIXME - this could be optimized further by determining if the script is loaded
+        // and if it has either an enterEntity or leaveEntity method
+        std::static_pointer_cast<EntityTree>(_tree)->findEntitiesContainingPoint(_avatarPosition, foundEntities);
 
         LayeredZones oldLayeredZones(std::move(_layeredZones));
         _layeredZones.clear();
 
-        // create a list of entities that actually contain the avatar's position
         for (auto& entity : foundEntities) {
-            auto isZone = entity->getType() == EntityTypes::Zone;
-            auto hasScript = !entity->getScript().isEmpty();
-
-            // only consider entities that are zones or have scripts, all other entities can
-            // be ignored because they can have events fired on them.
-            // FIXME - this could be optimized further by determining if the script is loaded
-            // and if it has either an enterEntity or leaveEntity method
-            if (isZone || hasScript) {
-                // now check to see if the point contains our entity, this can be expensive if
-                // the entity has a collision hull
-                if (entity->contains(_avatarPosition)) {
-                    if (entitiesContainingAvatar) {
-                        *entitiesContainingAvatar << entity->getEntityItemID();
-                    }
+            if (entitiesContainingAvatar) {
+                *entitiesContainingAvatar << entity->getEntityItemID();
+            }
 
-                    // if this entity is a zone and visible, determine if it is the bestZone
-                    if (isZone && entity->getVisible() && renderableForEntity(entity)) {
-                            auto zone = std::dynamic_pointer_cast<ZoneEntityItem>(entity);
-                            _layeredZones.insert(zone);
-                        }
-                    }
-                }
+            // if this entity is a zone and visible, determine if it is the bestZone
+            if (entity->getType() == EntityTypes::Zone && entity->getVisible() && renderableForEntity(entity)) {
+                auto zone = std::dynamic_pointer_cast<ZoneEntityItem>(entity);
+                _layeredZones.insert(zone);
             }
+        }
 
         // check if our layered zones have changed
         if (_layeredZones.empty()) {
@@ -514,33 +503,32 @@ bool EntityTreeRenderer::checkEnterLeaveEntities() {
         if (movedEnough || enoughTimeElapsed) {
             _avatarPosition = avatarPosition;
             _lastZoneCheck = now;
-            QVector<EntityItemID> entitiesContainingAvatar;
+            QSet<EntityItemID> entitiesContainingAvatar;
             didUpdate = findBestZoneAndMaybeContainingEntities(&entitiesContainingAvatar);
             
             // Note: at this point we don't need to worry about the tree being locked, because we only deal with
             // EntityItemIDs from here. The callEntityScriptMethod() method is robust against attempting to call scripts
             // for entity IDs that no longer exist.
 
-            // for all of our previous containing entities, if they are no longer containing then send them a leave event
-            foreach(const EntityItemID& entityID, _currentEntitiesInside) {
-                if (!entitiesContainingAvatar.contains(entityID)) {
+            // only the entities that were left or entered get events, so usually there is nothing to do here
+            if (entitiesContainingAvatar != _currentEntitiesInside) {
+                // for all of our previous containing entities, if they are no longer containing then send them a leave event
+                foreach(const EntityItemID& entityID, QSet<EntityItemID>(_currentEntitiesInside).subtract(entitiesContainingAvatar)) {
                     emit leaveEntity(entityID);
                     if (_entitiesScriptEngine) {
                         _entitiesScriptEngine->callEntityScriptMethod(entityID, "leaveEntity");
                     }
                 }
-            }
 
-            // for all of our new containing entities, if they weren't previously containing then send them an enter event
-            foreach(const EntityItemID& entityID, entitiesContainingAvatar) {
-                if (!_currentEntitiesInside.contains(entityID)) {
+                // for all of our new containing entities, if they weren't previously containing then send them an enter event
+                foreach(const EntityItemID& entityID, QSet<EntityItemID>(entitiesContainingAvatar).subtract(_currentEntitiesInside)) {
                     emit enterEntity(entityID);
                     if (_entitiesScriptEngine) {
                         _entitiesScriptEngine->callEntityScriptMethod(entityID, "enterEntity");
                     }
                 }
+                _currentEntitiesInside = entitiesContainingAvatar;
             }
-            _currentEntitiesInside = entitiesContainingAvatar;
         }
     }
     return didUpdate;
@@ -25,6 +25,8 @@
 #include <OctreeProcessor.h>
 #include <render/Forward.h>
 
+#include "ParticleSimulation.h"
+
 class AbstractScriptingServicesInterface;
 class AbstractViewStateInterface;
 class Model;
@@ -135,6 +137,8 @@ public slots:
     EntityRendererPointer renderableForEntityId(const EntityItemID& id) const;
     render::ItemID renderableIdForEntityId(const EntityItemID& id) const;
 
+    render::entities::ParticleSimulation& getParticleSimulation() { return _particleSimulation; }
+
 protected:
     virtual OctreePointer createTree() override {
         EntityTreePointer newTree = EntityTreePointer(new EntityTree(true));
@@ -150,7 +154,7 @@ private:
 
     void resetEntitiesScriptEngine();
 
-    bool findBestZoneAndMaybeContainingEntities(QVector<EntityItemID>* entitiesContainingAvatar = nullptr);
+    bool findBestZoneAndMaybeContainingEntities(QSet<EntityItemID>* entitiesContainingAvatar = nullptr);
 
     bool applyLayeredZones();
 
@@ -165,7 +169,7 @@ private:
     void forceRecheckEntities();
 
     glm::vec3 _avatarPosition { 0.0f };
-    QVector<EntityItemID> _currentEntitiesInside;
+    QSet<EntityItemID> _currentEntitiesInside;
 
     bool _wantScripts;
     ScriptEnginePointer _entitiesScriptEngine;
@@ -236,6 +240,7 @@ private:
     QString _ambientTextureURL;
     QString _skyboxTextureURL;
     float _avgRenderableUpdateCost { 0.0f };
+    render::entities::ParticleSimulation _particleSimulation;
     bool _pendingAmbientTexture { false };
     bool _pendingSkyboxTexture { false };
 
@@ -0,0 +1,105 @@
+//
+//  ParticleSimulation.cpp
+//  libraries/entities-renderer/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ParticleSimulation.h"
+
+#include <algorithm>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+#include <Profile.h>
+#include <ViewFrustum.h>
+
+#include "RenderableParticleEffectEntityItem.h"
+
+using namespace render::entities;
+
+// Emitters are handed to the workers in batches, so a few large emitters don't hold up the rest
+static const size_t MIN_EMITTERS_PER_BATCH { 4 };
+
+class ParticleSimulationBatch : public QRunnable {
+public:
+    ParticleSimulationBatch(std::vector<ParticleEffectEntityRenderer*>&& emitters) : _emitters(std::move(emitters)) {}
+
+    void run() override {
+        PROFILE_RANGE(simulation, "ParticleSimulation");
+        for (auto emitter : _emitters) {
+            emitter->simulate();
+        }
+    }
+
+private:
+    const std::vector<ParticleEffectEntityRenderer*> _emitters;
+};
+
+ParticleSimulation::ParticleSimulation() : _pool(new QThreadPool()) {
+    _pool->setObjectName("ParticleSimulation");
+    _pool->setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+}
+
+ParticleSimulation::~ParticleSimulation() {
+    clear();
+}
+
+void ParticleSimulation::addEmitter(const EmitterPointer& emitter) {
+    _emitters.push_back(emitter);
+}
+
+void ParticleSimulation::removeEmitter(const ParticleEffectEntityRenderer* emitter) {
+    _emitters.erase(std::remove_if(_emitters.begin(), _emitters.end(), [&](const std::weak_ptr<ParticleEffectEntityRenderer>& weakEmitter) {
+        auto lockedEmitter = weakEmitter.lock();
+        return !lockedEmitter || lockedEmitter.get() == emitter;
+    }), _emitters.end());
+}
+
+void ParticleSimulation::wait() {
+    _pool->waitForDone();
+    _simulated.clear();
+}
+
+void ParticleSimulation::clear() {
+    wait();
+    _emitters.clear();
+}
+
+void ParticleSimulation::update(const ViewFrustum& view) {
+    PROFILE_RANGE(simulation, "ParticleSimulation::update");
+    // The previous frame's simulation has had the whole frame to run, so this rarely waits
+    wait();
+
+    for (auto it = _emitters.begin(); it != _emitters.end();) {
+        auto emitter = it->lock();
+        if (!emitter) {
+            it = _emitters.erase(it);
+            continue;
+        }
+        if (emitter->prepareSimulation(view)) {
+            _simulated.push_back(emitter);
+        }
+        ++it;
+    }
+    if (_simulated.empty()) {
+        return;
+    }
+
+    size_t numBatches = std::min((size_t)_pool->maxThreadCount(), (_simulated.size() + MIN_EMITTERS_PER_BATCH - 1) / MIN_EMITTERS_PER_BATCH);
+    size_t batchSize = (_simulated.size() + numBatches - 1) / numBatches;
+    for (size_t first = 0; first < _simulated.size(); first += batchSize) {
+        size_t last = std::min(first + batchSize, _simulated.size());
+        std::vector<ParticleEffectEntityRenderer*> batch;
+        batch.reserve(last - first);
+        for (size_t i = first; i < last; i++) {
+            batch.push_back(_simulated[i].get());
+        }
+        _pool->start(new ParticleSimulationBatch(std::move(batch)));
+    }
+}
@@ -0,0 +1,58 @@
+//
+//  ParticleSimulation.h
+//  libraries/entities-renderer/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ParticleSimulation_h
+#define hifi_ParticleSimulation_h
+
+#include <memory>
+#include <vector>
+
+class QThreadPool;
+class ViewFrustum;
+
+namespace render { namespace entities {
+
+class ParticleEffectEntityRenderer;
+
+/// Steps the particles of all the particle effects in view once a frame, on workers of its own, so the
+/// render thread only waits for the particles it draws rather than simulating them itself.
+class ParticleSimulation {
+public:
+    using EmitterPointer = std::shared_ptr<ParticleEffectEntityRenderer>;
+
+    ParticleSimulation();
+    ~ParticleSimulation();
+
+    // Must be called on the main thread
+    void addEmitter(const EmitterPointer& emitter);
+    void removeEmitter(const ParticleEffectEntityRenderer* emitter);
+
+    /// Starts this frame's simulation of the emitters in the view, once the previous frame's is done.
+    /// Must be called on the main thread.
+    void update(const ViewFrustum& view);
+
+    /// Waits for the simulation in progress, and forgets all the emitters
+    void clear();
+
+    size_t getNumEmitters() const { return _emitters.size(); }
+    size_t getNumSimulated() const { return _simulated.size(); }
+
+private:
+    void wait();
+
+    std::vector<std::weak_ptr<ParticleEffectEntityRenderer>> _emitters;
+    // Kept alive here until the workers are done with them, so they are only ever destroyed on the main thread
+    std::vector<EmitterPointer> _simulated;
+    std::unique_ptr<QThreadPool> _pool;
+};
+
+} } // namespace
+
+#endif // hifi_ParticleSimulation_h
@@ -13,6 +13,10 @@
 #include <StencilMaskPass.h>
 
 #include <GeometryCache.h>
+#include <ViewFrustum.h>
+
+#include "EntityTreeRenderer.h"
+#include "ParticleSimulation.h"
 
 #include "textured_particle_vert.h"
 #include "textured_particle_frag.h"
@@ -44,13 +48,113 @@ static ShapePipelinePointer shapePipelineFactory(const ShapePlumber& plumber, co
     return std::make_shared<render::ShapePipeline>(texturedPipeline, nullptr, nullptr, nullptr);
 }
 
-struct GpuParticle {
-    GpuParticle(const glm::vec3& xyzIn, const glm::vec2& uvIn) : xyz(xyzIn), uv(uvIn) {}
-    glm::vec3 xyz; // Position
-    glm::vec2 uv; // Lifetime + seed
-};
+static void integrateParticles_ref(float* positions, float* velocities, const float* accelerations, float deltaTime, int numParticles) {
+    const float halfDeltaTimeSquared = 0.5f * deltaTime * deltaTime;
+    for (int i = 0; i < numParticles; i++) {
+        positions[i] += velocities[i] * deltaTime + accelerations[i] * halfDeltaTimeSquared;
+        velocities[i] += accelerations[i] * deltaTime;
+    }
+}
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+//
+// Runtime CPU dispatch
+//
+
+#include <CPUDetect.h>
+
+void integrateParticles_AVX2(float* positions, float* velocities, const float* accelerations, float deltaTime, int numParticles);
+
+static void integrateParticles(float* positions, float* velocities, const float* accelerations, float deltaTime, int numParticles) {
+    static auto f = cpuSupportsAVX2() ? integrateParticles_AVX2 : integrateParticles_ref;
+    (*f)(positions, velocities, accelerations, deltaTime, numParticles);  // dispatch
+}
+
+#else
+
+static void integrateParticles(float* positions, float* velocities, const float* accelerations, float deltaTime, int numParticles) {
+    integrateParticles_ref(positions, velocities, accelerations, deltaTime, numParticles);
+}
 
-using GpuParticles = std::vector<GpuParticle>;
+#endif
+
+void ParticleEffectEntityRenderer::CpuParticles::push_back(const CpuParticle& particle) {
+    if (_size == _capacity) {
+        grow();
+    }
+
+    size_t index = (_first + _size) % _capacity;
+    _components[POSITION_X][index] = particle.position.x;
+    _components[POSITION_Y][index] = particle.position.y;
+    _components[POSITION_Z][index] = particle.position.z;
+    _components[VELOCITY_X][index] = particle.velocity.x;
+    _components[VELOCITY_Y][index] = particle.velocity.y;
+    _components[VELOCITY_Z][index] = particle.velocity.z;
+    _components[ACCELERATION_X][index] = particle.acceleration.x;
+    _components[ACCELERATION_Y][index] = particle.acceleration.y;
+    _components[ACCELERATION_Z][index] = particle.acceleration.z;
+    _components[LIFETIME][index] = particle.lifetime;
+    _components[SEED][index] = particle.seed;
+    _expirations[index] = particle.expiration;
+    _size++;
+}
+
+void ParticleEffectEntityRenderer::CpuParticles::pop_front() {
+    _first = (_first + 1) % _capacity;
+    _size--;
+}
+
+void ParticleEffectEntityRenderer::CpuParticles::grow() {
+    // Unwrap the ring as it grows, so the oldest particle is first again
+    const size_t MIN_CAPACITY = 64;
+    size_t capacity = std::max(MIN_CAPACITY, 2 * _capacity);
+    for (auto& component : _components) {
+        std::vector<float> grown(capacity);
+        for (size_t i = 0; i < _size; i++) {
+            grown[i] = component[(_first + i) % _capacity];
+        }
+        component.swap(grown);
+    }
+    std::vector<uint64_t> grownExpirations(capacity);
+    for (size_t i = 0; i < _size; i++) {
+        grownExpirations[i] = _expirations[(_first + i) % _capacity];
+    }
+    _expirations.swap(grownExpirations);
+    _capacity = capacity;
+    _first = 0;
+}
+
+void ParticleEffectEntityRenderer::CpuParticles::integrate(float deltaTime) {
+    // The particles are in at most two contiguous spans of the ring
+    size_t firstSpan = std::min(_size, _capacity - _first);
+    size_t spans[2][2] = { { _first, firstSpan }, { 0, _size - firstSpan } };
+    for (const auto& span : spans) {
+        size_t offset = span[0];
+        int count = (int)span[1];
+        if (count == 0) {
+            continue;
+        }
+        for (int axis = 0; axis < 3; axis++) {
+            integrateParticles(&_components[POSITION_X + axis][offset], &_components[VELOCITY_X + axis][offset],
+                &_components[ACCELERATION_X + axis][offset], deltaTime, count);
+        }
+        float* lifetimes = &_components[LIFETIME][offset];
+        for (int i = 0; i < count; i++) {
+            lifetimes[i] += deltaTime;
+        }
+    }
+}
+
+size_t ParticleEffectEntityRenderer::CpuParticles::copyTo(GpuParticle* gpuParticles) const {
+    for (size_t i = 0; i < _size; i++) {
+        size_t index = (_first + i) % _capacity;
+        GpuParticle& gpuParticle = gpuParticles[i];
+        gpuParticle.xyz = glm::vec3(_components[POSITION_X][index], _components[POSITION_Y][index], _components[POSITION_Z][index]);
+        gpuParticle.uv = glm::vec2(_components[LIFETIME][index], _components[SEED][index]);
+    }
+    return _size;
+}
 
 ParticleEffectEntityRenderer::ParticleEffectEntityRenderer(const EntityItemPointer& entity) : Parent(entity) {
     ParticleUniforms uniforms;
@@ -93,7 +197,10 @@ void ParticleEffectEntityRenderer::doRenderUpdateSynchronousTyped(const ScenePoi
     }
     
     if (resultWithReadLock<bool>([&]{ return _particleProperties != newParticleProperties; })) {
-        _timeUntilNextEmit = 0;
+        {
+            std::unique_lock<std::mutex> lock(_simulationMutex);
+            _timeUntilNextEmit = 0;
+        }
         withWriteLock([&]{
             _particleProperties = newParticleProperties;
         });
@@ -235,7 +342,62 @@ ParticleEffectEntityRenderer::CpuParticle ParticleEffectEntityRenderer::createPa
     return particle;
 }
 
-void ParticleEffectEntityRenderer::stepSimulation() {
+void ParticleEffectEntityRenderer::onAddToSceneTyped(const TypedEntityPointer& entity) {
+    auto renderer = DependencyManager::get<EntityTreeRenderer>();
+    if (renderer) {
+        renderer->getParticleSimulation().addEmitter(std::static_pointer_cast<ParticleEffectEntityRenderer>(shared_from_this()));
+    }
+}
+
+void ParticleEffectEntityRenderer::onRemoveFromSceneTyped(const TypedEntityPointer& entity) {
+    auto renderer = DependencyManager::get<EntityTreeRenderer>();
+    if (renderer) {
+        renderer->getParticleSimulation().removeEmitter(this);
+    }
+}
+
+bool ParticleEffectEntityRenderer::prepareSimulation(const ViewFrustum& view) {
+    if (!_visible) {
+        return false;
+    }
+
+    // Particles nobody can see aren't simulated, as they wouldn't be drawn either.  The query cube holds all of the
+    // emitter's particles, so an emitter too far away for it to be more than a few pixels across is left alone too.
+    const float MIN_SIMULATED_ANGULAR_SIZE = 0.005f;
+    AACube cube = _entity->getQueryAACube();
+    if (!view.cubeIntersectsKeyhole(cube)) {
+        return false;
+    }
+    float distance = glm::distance(view.getPosition(), cube.calcCenter());
+    if (distance > 0.0f && cube.getScale() / distance < MIN_SIMULATED_ANGULAR_SIZE) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(_simulationMutex);
+    if (_simulationPending) {
+        return false;
+    }
+    _simulationPending = true;
+    _simulationTransform = resultWithReadLock<Transform>([&] { return getModelTransform(); });
+    _simulationEmitting = _emitting;
+    return true;
+}
+
+void ParticleEffectEntityRenderer::simulate() {
+    particle::Properties particleProperties;
+    withReadLock([&]{
+        particleProperties = _particleProperties;
+    });
+
+    {
+        std::unique_lock<std::mutex> lock(_simulationMutex);
+        stepSimulation(_simulationTransform, _simulationEmitting, particleProperties);
+        _simulationPending = false;
+    }
+    _simulationDone.notify_all();
+}
+
+void ParticleEffectEntityRenderer::stepSimulation(const Transform& modelTransform, bool emitting, const particle::Properties& particleProperties) {
     if (_lastSimulated == 0) {
         _lastSimulated = usecTimestampNow();
         return;
@@ -244,14 +406,8 @@ void ParticleEffectEntityRenderer::stepSimulation() {
     const auto now = usecTimestampNow();
     const auto interval = std::min<uint64_t>(USECS_PER_SECOND / 60, now - _lastSimulated);
     _lastSimulated = now;
-    
-    particle::Properties particleProperties;
-    withReadLock([&]{
-        particleProperties = _particleProperties;
-    });
 
-    if (_emitting && particleProperties.emitting()) {
-        const auto& modelTransform = getModelTransform();
+    if (emitting && particleProperties.emitting()) {
         uint64_t emitInterval = particleProperties.emitIntervalUsecs();
         if (emitInterval > 0 && interval >= _timeUntilNextEmit) {
             auto timeRemaining = interval;
@@ -269,31 +425,20 @@ void ParticleEffectEntityRenderer::stepSimulation() {
     }
 
     // Kill any particles that have expired or are over the max size
-    while (_cpuParticles.size() > particleProperties.maxParticles || (!_cpuParticles.empty() && _cpuParticles.front().expiration <= now)) {
+    while (_cpuParticles.size() > particleProperties.maxParticles || (!_cpuParticles.empty() && _cpuParticles.frontExpiration() <= now)) {
         _cpuParticles.pop_front();
     }
 
     const float deltaTime = (float)interval / (float)USECS_PER_SECOND;
-    // update the particles 
-    for (auto& particle : _cpuParticles) {
-        particle.integrate(deltaTime);
-    }
-
-    // Build particle primitives
-    static GpuParticles gpuParticles;
-    gpuParticles.clear();
-    gpuParticles.reserve(_cpuParticles.size()); // Reserve space
-    std::transform(_cpuParticles.begin(), _cpuParticles.end(), std::back_inserter(gpuParticles), [](const CpuParticle& particle) {
-        return GpuParticle(particle.position, glm::vec2(particle.lifetime, particle.seed));
-    });
+    // update the particles
+    _cpuParticles.integrate(deltaTime);
 
-    // Update particle buffer
-    auto& particleBuffer = _particleBuffer;
-    size_t numBytes = sizeof(GpuParticle) * gpuParticles.size();
-    particleBuffer->resize(numBytes);
-    if (numBytes != 0) {
-        particleBuffer->setData(numBytes, (const gpu::Byte*)gpuParticles.data());
+    // Build particle primitives, in an array that only grows so it isn't reallocated every frame
+    if (_gpuParticles.size() < _cpuParticles.size()) {
+        _gpuParticles.resize(_cpuParticles.size());
     }
+    _numGpuParticles = _cpuParticles.copyTo(_gpuParticles.data());
+    _gpuParticlesChanged = true;
 }
 
 void ParticleEffectEntityRenderer::doRender(RenderArgs* args) {
@@ -302,8 +447,23 @@ void ParticleEffectEntityRenderer::doRender(RenderArgs* args) {
     }
 
 
-    // FIXME migrate simulation to a compute stage
-    stepSimulation();
+    // Wait for the particles simulated for this frame, and update the particle buffer.  The buffer only grows,
+    // so it is written in place rather than reallocated every frame.
+    {
+        std::unique_lock<std::mutex> lock(_simulationMutex);
+        _simulationDone.wait(lock, [&] { return !_simulationPending; });
+        if (_gpuParticlesChanged) {
+            size_t numBytes = sizeof(GpuParticle) * _numGpuParticles;
+            if (_particleBuffer->getSize() < numBytes) {
+                _particleBuffer->resize(sizeof(GpuParticle) * _gpuParticles.size());
+            }
+            if (numBytes != 0) {
+                _particleBuffer->setSubData(0, numBytes, (const gpu::Byte*)_gpuParticles.data());
+            }
+            _numParticlesDrawn = _numGpuParticles;
+            _gpuParticlesChanged = false;
+        }
+    }
 
     gpu::Batch& batch = *args->_batch;
     if (_networkTexture && _networkTexture->isLoaded()) {
@@ -324,8 +484,7 @@ void ParticleEffectEntityRenderer::doRender(RenderArgs* args) {
     batch.setInputFormat(_vertexFormat);
     batch.setInputBuffer(0, _particleBuffer, 0, sizeof(GpuParticle));
 
-    auto numParticles = _particleBuffer->getSize() / sizeof(GpuParticle);
-    batch.drawInstanced((gpu::uint32)numParticles, gpu::TRIANGLE_STRIP, (gpu::uint32)VERTEX_PER_PARTICLE);
+    batch.drawInstanced((gpu::uint32)_numParticlesDrawn, gpu::TRIANGLE_STRIP, (gpu::uint32)VERTEX_PER_PARTICLE);
 }
 
 
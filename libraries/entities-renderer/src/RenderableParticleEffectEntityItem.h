@@ -11,10 +11,16 @@
 #ifndef hifi_RenderableParticleEffectEntityItem_h
 #define hifi_RenderableParticleEffectEntityItem_h
 
+#include <array>
+#include <condition_variable>
+#include <mutex>
+
 #include "RenderableEntityItem.h"
 #include <ParticleEffectEntityItem.h>
 #include <TextureCache.h>
 
+class ViewFrustum;
+
 namespace render { namespace entities {
 
 class ParticleEffectEntityRenderer : public TypedEntityRenderer<ParticleEffectEntityItem> {
@@ -24,6 +30,11 @@ class ParticleEffectEntityRenderer : public TypedEntityRenderer<ParticleEffectEn
 public:
     ParticleEffectEntityRenderer(const EntityItemPointer& entity);
 
+    // Called by the ParticleSimulation on the main thread, returns false if the emitter needs no simulation this frame
+    bool prepareSimulation(const ViewFrustum& view);
+    // Called by the ParticleSimulation on one of its workers, after prepareSimulation
+    void simulate();
+
 protected:
     virtual bool needsRenderUpdateFromTypedEntity(const TypedEntityPointer& entity) const override;
 
@@ -34,6 +45,8 @@ protected:
     virtual ShapeKey getShapeKey() override;
     virtual Item::Bound getBound() override;
     virtual void doRender(RenderArgs* args) override;
+    virtual void onAddToSceneTyped(const TypedEntityPointer& entity) override;
+    virtual void onRemoveFromSceneTyped(const TypedEntityPointer& entity) override;
 
 private:
     using PipelinePointer = gpu::PipelinePointer;
@@ -43,9 +56,6 @@ private:
     using Buffer = gpu::Buffer;
     using BufferView = gpu::BufferView;
 
-    // CPU particles
-    // FIXME either switch to GPU compute particles or switch to simd updating of the particles
-#if 1
     struct CpuParticle {
         float seed{ 0.0f };
         uint64_t expiration { 0 };
@@ -53,29 +63,47 @@ private:
         glm::vec3 position;
         glm::vec3 velocity;
         glm::vec3 acceleration;
+    };
 
-        void integrate(float deltaTime) {
-            glm::vec3 atSquared = (0.5f * deltaTime * deltaTime) * acceleration;
-            position += velocity * deltaTime + atSquared;
-            velocity += acceleration * deltaTime;
-            lifetime += deltaTime;
-        }
+    // Per instance data of the particles drawn
+    struct GpuParticle {
+        glm::vec3 xyz; // Position
+        glm::vec2 uv; // Lifetime + seed
     };
-    using CpuParticles = std::deque<CpuParticle>;
-#else
-    struct CpuParticles {
-        std::vector<float> seeds;
-        std::vector<float> lifetimes;
-        std::vector<vec4> positions;
-        std::vector<vec4> velocities;
-        std::vector<vec4> accelerations;
-
-        size_t size() const;
-        void resize(size_t size);
+    using GpuParticles = std::vector<GpuParticle>;
+
+    // CPU particles, oldest first, in a ring buffer of arrays per component, so they are integrated
+    // a component at a time rather than a particle at a time
+    class CpuParticles {
+    public:
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        uint64_t frontExpiration() const { return _expirations[_first]; }
+
+        void push_back(const CpuParticle& particle);
+        void pop_front();
         void integrate(float deltaTime);
+        // Writes the particles, oldest first, and returns how many were written
+        size_t copyTo(GpuParticle* gpuParticles) const;
+
+    private:
+        enum Component {
+            POSITION_X = 0, POSITION_Y, POSITION_Z,
+            VELOCITY_X, VELOCITY_Y, VELOCITY_Z,
+            ACCELERATION_X, ACCELERATION_Y, ACCELERATION_Z,
+            LIFETIME,
+            SEED,
+            NUM_COMPONENTS
+        };
+
+        void grow();
+
+        std::array<std::vector<float>, NUM_COMPONENTS> _components;
+        std::vector<uint64_t> _expirations;
+        size_t _capacity { 0 };
+        size_t _first { 0 };
+        size_t _size { 0 };
     };
-#endif
-
 
     template<typename T>
     struct InterpolationData {
@@ -94,16 +122,28 @@ private:
 
 
     static CpuParticle createParticle(uint64_t now, const Transform& baseTransform, const particle::Properties& particleProperties);
-    void stepSimulation();
+    void stepSimulation(const Transform& modelTransform, bool emitting, const particle::Properties& particleProperties);
 
     particle::Properties _particleProperties;
-    CpuParticles _cpuParticles;
     bool _emitting { false };
     uint64_t _timeUntilNextEmit { 0 };
     BufferPointer _particleBuffer{ std::make_shared<Buffer>() };
     BufferView _uniformBuffer;
     quint64 _lastSimulated { 0 };
 
+    // The simulation state is guarded by _simulationMutex, as it is stepped on the ParticleSimulation's
+    // workers while the render thread waits for the particles to draw
+    std::mutex _simulationMutex;
+    std::condition_variable _simulationDone;
+    bool _simulationPending { false };
+    Transform _simulationTransform;
+    bool _simulationEmitting { false };
+    CpuParticles _cpuParticles;
+    GpuParticles _gpuParticles;
+    size_t _numGpuParticles { 0 };
+    bool _gpuParticlesChanged { false };
+    size_t _numParticlesDrawn { 0 };
+
     NetworkTexturePointer _networkTexture;
     ScenePointer _scene;
 };
@@ -0,0 +1,44 @@
+//
+//  RenderableParticleEffectEntityItem_avx2.cpp
+//  libraries/entities-renderer/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+void integrateParticles_AVX2(float* positions, float* velocities, const float* accelerations, float deltaTime, int numParticles) {
+    const float halfDeltaTimeSquared = 0.5f * deltaTime * deltaTime;
+    __m256 dt = _mm256_set1_ps(deltaTime);
+    __m256 hdt2 = _mm256_set1_ps(halfDeltaTimeSquared);
+
+    int i = 0;
+    for (; i <= numParticles - 8; i += 8) {   // SIMD8
+
+        __m256 p0 = _mm256_loadu_ps(&positions[i]);
+        __m256 v0 = _mm256_loadu_ps(&velocities[i]);
+        __m256 a0 = _mm256_loadu_ps(&accelerations[i]);
+
+        p0 = _mm256_fmadd_ps(v0, dt, p0);
+        p0 = _mm256_fmadd_ps(a0, hdt2, p0);
+        v0 = _mm256_fmadd_ps(a0, dt, v0);
+
+        _mm256_storeu_ps(&positions[i], p0);
+        _mm256_storeu_ps(&velocities[i], v0);
+    }
+
+    // remaining particles
+    for (; i < numParticles; i++) {
+        positions[i] += velocities[i] * deltaTime + accelerations[i] * halfDeltaTimeSquared;
+        velocities[i] += accelerations[i] * deltaTime;
+    }
+
+    _mm256_zeroupper();
+}
+
+#endif
@@ -0,0 +1,191 @@
+//
+//  EntityContainmentIndex.cpp
+//  libraries/entities/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityContainmentIndex.h"
+
+#include <algorithm>
+
+static const int MAX_LEAVES_PER_NODE { 4 };
+
+EntityContainmentIndex::~EntityContainmentIndex() {
+    clear();
+}
+
+bool EntityContainmentIndex::isContainmentVolume(const EntityItemPointer& entity) {
+    // only zones and entities with scripts get enter and leave events
+    return entity->getType() == EntityTypes::Zone || !entity->getScript().isEmpty();
+}
+
+void EntityContainmentIndex::update(const EntityItemPointer& entity) {
+    EntityItemID entityID = entity->getEntityItemID();
+    if (!isContainmentVolume(entity)) {
+        remove(entityID);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_volumes.contains(entityID)) {
+        return;
+    }
+    auto needsRebuild = _needsRebuild;
+    auto changeHandlerId = entity->registerChangeHandler([needsRebuild](const EntityItemID& changedEntity) {
+        *needsRebuild = true;
+    });
+    _volumes.insert(entityID, { entity, changeHandlerId });
+    *_needsRebuild = true;
+}
+
+void EntityContainmentIndex::remove(const EntityItemID& entityID) {
+    Volume volume;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        auto itr = _volumes.find(entityID);
+        if (itr == _volumes.end()) {
+            return;
+        }
+        volume = itr.value();
+        _volumes.erase(itr);
+        *_needsRebuild = true;
+    }
+
+    auto entity = volume.entity.lock();
+    if (entity) {
+        entity->deregisterChangeHandler(volume.changeHandlerId);
+    }
+}
+
+void EntityContainmentIndex::clear() {
+    QHash<EntityItemID, Volume> volumes;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        volumes.swap(_volumes);
+        _leaves.clear();
+        _nodes.clear();
+        *_needsRebuild = false;
+    }
+
+    for (const auto& volume : volumes) {
+        auto entity = volume.entity.lock();
+        if (entity) {
+            entity->deregisterChangeHandler(volume.changeHandlerId);
+        }
+    }
+}
+
+int EntityContainmentIndex::size() const {
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _volumes.size();
+}
+
+void EntityContainmentIndex::findEntitiesContainingPoint(const glm::vec3& point, QVector<EntityItemPointer>& foundEntities) {
+    std::vector<EntityItemPointer> candidates;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_needsRebuild->exchange(false)) {
+            rebuild();
+        }
+
+        std::vector<int> stack;
+        if (!_nodes.empty()) {
+            stack.push_back(0);
+        }
+        while (!stack.empty()) {
+            int nodeIndex = stack.back();
+            stack.pop_back();
+            const Node& node = _nodes[nodeIndex];
+            if (glm::any(glm::lessThan(point, node.minimum)) || glm::any(glm::greaterThan(point, node.maximum))) {
+                continue;
+            }
+            if (node.secondChild < 0) {
+                for (int i = node.firstLeaf; i < node.firstLeaf + node.numLeaves; ++i) {
+                    const Leaf& leaf = _leaves[i];
+                    if (glm::all(glm::greaterThanEqual(point, leaf.minimum)) && glm::all(glm::lessThanEqual(point, leaf.maximum))) {
+                        auto entity = leaf.entity.lock();
+                        if (entity) {
+                            candidates.push_back(entity);
+                        }
+                    }
+                }
+            } else {
+                stack.push_back(nodeIndex + 1);
+                stack.push_back(node.secondChild);
+            }
+        }
+    }
+
+    // the exact test can be expensive for entities with collision hulls, so it is left for the few that remain
+    for (const auto& entity : candidates) {
+        if (entity->contains(point)) {
+            foundEntities << entity;
+        }
+    }
+}
+
+void EntityContainmentIndex::rebuild() {
+    _leaves.clear();
+    _nodes.clear();
+    _leaves.reserve(_volumes.size());
+    for (const auto& volume : _volumes) {
+        auto entity = volume.entity.lock();
+        if (!entity) {
+            continue;
+        }
+        bool success;
+        AABox box = entity->getAABox(success);
+        if (success) {
+            _leaves.push_back({ entity, box.getCorner(), box.getCorner() + box.getDimensions() });
+        }
+    }
+
+    if (!_leaves.empty()) {
+        _nodes.reserve(2 * _leaves.size() / MAX_LEAVES_PER_NODE + 1);
+        buildNode(0, (int)_leaves.size());
+    }
+}
+
+// The first child of a node always follows it, so only the second child's index is kept
+void EntityContainmentIndex::buildNode(int firstLeaf, int numLeaves) {
+    int nodeIndex = (int)_nodes.size();
+    _nodes.emplace_back();
+
+    glm::vec3 minimum = _leaves[firstLeaf].minimum;
+    glm::vec3 maximum = _leaves[firstLeaf].maximum;
+    glm::vec3 minimumCenter = 0.5f * (minimum + maximum);
+    glm::vec3 maximumCenter = minimumCenter;
+    for (int i = firstLeaf + 1; i < firstLeaf + numLeaves; ++i) {
+        const Leaf& leaf = _leaves[i];
+        minimum = glm::min(minimum, leaf.minimum);
+        maximum = glm::max(maximum, leaf.maximum);
+        glm::vec3 center = 0.5f * (leaf.minimum + leaf.maximum);
+        minimumCenter = glm::min(minimumCenter, center);
+        maximumCenter = glm::max(maximumCenter, center);
+    }
+    _nodes[nodeIndex].minimum = minimum;
+    _nodes[nodeIndex].maximum = maximum;
+    _nodes[nodeIndex].firstLeaf = firstLeaf;
+    _nodes[nodeIndex].numLeaves = numLeaves;
+    if (numLeaves <= MAX_LEAVES_PER_NODE) {
+        return;
+    }
+
+    // split at the median center along the axis over which the centers are most spread out
+    glm::vec3 spread = maximumCenter - minimumCenter;
+    int axis = (spread.x >= spread.y && spread.x >= spread.z) ? 0 : (spread.y >= spread.z ? 1 : 2);
+    int numFirstLeaves = numLeaves / 2;
+    auto begin = _leaves.begin() + firstLeaf;
+    std::nth_element(begin, begin + numFirstLeaves, begin + numLeaves, [axis](const Leaf& a, const Leaf& b) {
+        return a.minimum[axis] + a.maximum[axis] < b.minimum[axis] + b.maximum[axis];
+    });
+
+    buildNode(firstLeaf, numFirstLeaves);
+    int secondChild = (int)_nodes.size();
+    buildNode(firstLeaf + numFirstLeaves, numLeaves - numFirstLeaves);
+    _nodes[nodeIndex].secondChild = secondChild;
+}
@@ -0,0 +1,82 @@
+//
+//  EntityContainmentIndex.h
+//  libraries/entities/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityContainmentIndex_h
+#define hifi_EntityContainmentIndex_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QHash>
+#include <QVector>
+
+#include <glm/glm.hpp>
+
+#include "EntityItem.h"
+
+// The zones and scripted entities of a tree, the volumes that avatars enter and leave, in a bounding volume hierarchy
+// of their world boxes. Finding the ones containing a point then only tests the few whose boxes contain it, rather than
+// searching the octree and testing everything near the point.
+//
+// The tree updates it as entities are added, deleted or get a script. Volumes that move or change size flag it through
+// their change handlers, and the hierarchy is rebuilt on the next query after any change.
+class EntityContainmentIndex {
+public:
+    ~EntityContainmentIndex();
+
+    // Whether the entity is one of the volumes kept in the index
+    static bool isContainmentVolume(const EntityItemPointer& entity);
+
+    // Adds the entity if it is a containment volume, or removes it if it no longer is one
+    void update(const EntityItemPointer& entity);
+    void remove(const EntityItemID& entityID);
+    void clear();
+
+    // Finds the volumes that contain the point, using their exact shapes
+    void findEntitiesContainingPoint(const glm::vec3& point, QVector<EntityItemPointer>& foundEntities);
+
+    int size() const;
+
+private:
+    struct Volume {
+        EntityItemWeakPointer entity;
+        EntityItem::ChangeHandlerId changeHandlerId;
+    };
+
+    struct Leaf {
+        EntityItemWeakPointer entity;
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+    };
+
+    // Inner nodes have two children, the second one at secondChild; leaves cover numLeaves leaves from firstLeaf
+    struct Node {
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        int secondChild { -1 };
+        int firstLeaf { 0 };
+        int numLeaves { 0 };
+    };
+
+    void rebuild();
+    void buildNode(int firstLeaf, int numLeaves);
+
+    mutable std::mutex _mutex;
+    QHash<EntityItemID, Volume> _volumes;
+    std::vector<Leaf> _leaves;
+    std::vector<Node> _nodes;
+
+    // Set by the volumes' change handlers, which may outlive the index
+    std::shared_ptr<std::atomic<bool>> _needsRebuild { std::make_shared<std::atomic<bool>>(false) };
+};
+
+#endif // hifi_EntityContainmentIndex_h
@@ -759,6 +759,31 @@ RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionVecto
     return findRayIntersectionWorker(ray, Octree::Lock, precisionPicking, entityIdsToInclude, entityIdsToDiscard, visibleOnly, collidableOnly);
 }
 
+QVector<RayToEntityIntersectionResult> EntityScriptingInterface::findRayIntersectionVectors(std::vector<EntityRayQuery>& queries) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    QVector<RayToEntityIntersectionResult> results(queries.size());
+    if (_entityTree) {
+        bool accurate = false;
+        _entityTree->findRayIntersections(queries, Octree::Lock, &accurate);
+        for (size_t i = 0; i < queries.size(); i++) {
+            const EntityRayQuery& query = queries[i];
+            RayToEntityIntersectionResult& result = results[(int)i];
+            result.accurate = accurate;
+            EntityItem* intersectedEntity = static_cast<EntityItem*>(query.intersectedObject);
+            result.intersects = query.found && intersectedEntity;
+            if (result.intersects) {
+                result.entityID = intersectedEntity->getEntityItemID();
+                result.distance = query.distance;
+                result.face = query.face;
+                result.surfaceNormal = query.surfaceNormal;
+                result.intersection = query.origin + (query.direction * query.distance);
+            }
+        }
+    }
+    return results;
+}
+
 // FIXME - we should remove this API and encourage all users to use findRayIntersection() instead. We've changed
 //         findRayIntersection() to be blocking because it never makes sense for a script to get back a non-answer
 RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionBlocking(const PickRay& ray, bool precisionPicking, 
@@ -283,6 +283,9 @@ public slots:
         const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIdsToDiscard,
         bool visibleOnly, bool collidableOnly);
 
+    /// Same as above for a batch of rays, each with its own filters, cast in a single traversal of the entity tree
+    QVector<RayToEntityIntersectionResult> findRayIntersectionVectors(std::vector<EntityRayQuery>& queries);
+
     /// If the scripting context has visible entities, this will determine a ray intersection, and will block in
     /// order to return an accurate result
     Q_INVOKABLE RayToEntityIntersectionResult findRayIntersectionBlocking(const PickRay& ray, bool precisionPicking = false, const QScriptValue& entityIdsToInclude = QScriptValue(), const QScriptValue& entityIdsToDiscard = QScriptValue());
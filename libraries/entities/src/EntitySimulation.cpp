@@ -15,7 +15,7 @@
 #include <Profile.h>
 
 #include "EntitiesLogging.h"
-#include "MovingEntitiesOperator.h"
+#include "MovingEntitiesBatch.h"
 
 void EntitySimulation::setEntityTree(EntityTreePointer tree) {
     if (_entityTree && _entityTree != tree) {
@@ -148,7 +148,7 @@ void EntitySimulation::callUpdateOnEntitiesThatNeedIt(const quint64& now) {
 void EntitySimulation::sortEntitiesThatMoved() {
     // NOTE: this is only for entities that have been moved by THIS EntitySimulation.
     // External changes to entity position/shape are expected to be sorted outside of the EntitySimulation.
-    MovingEntitiesOperator moveOperator;
+    MovingEntitiesBatch moveBatch(_entityTree);
     AACube domainBounds(glm::vec3((float)-HALF_TREE_SCALE), (float)TREE_SCALE);
     SetOfEntities::iterator itemItr = _entitiesToSort.begin();
     while (itemItr != _entitiesToSort.end()) {
@@ -162,13 +162,13 @@ void EntitySimulation::sortEntitiesThatMoved() {
             entity->die();
             prepareEntityForDelete(entity);
         } else {
-            moveOperator.addEntityToMoveList(entity, newCube);
+            moveBatch.addEntityToMoveList(entity, newCube);
             ++itemItr;
         }
     }
-    if (moveOperator.hasMovingEntities()) {
-        PerformanceTimer perfTimer("recurseTreeWithOperator");
-        _entityTree->recurseTreeWithOperator(&moveOperator);
+    if (moveBatch.hasMovingEntities()) {
+        PerformanceTimer perfTimer("relocateMovedEntities");
+        moveBatch.apply();
     }
 
     _entitiesToSort.clear();
@@ -102,6 +102,7 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
     }
     QHash<EntityItemID, EntityItemPointer> localMap;
     localMap.swap(_entityMap);
+    _containmentIndex.clear();
     this->withWriteLock([&] {
         foreach(EntityItemPointer entity, localMap) {
             EntityTreeElementPointer element = entity->getElement();
@@ -535,6 +536,11 @@ EntityItemPointer EntityTree::addEntity(const EntityItemID& entityID, const Enti
 }
 
 void EntityTree::emitEntityScriptChanging(const EntityItemID& entityItemID, bool reload) {
+    // gaining or losing a script makes an entity a containment volume or not
+    EntityItemPointer entity = findEntityByEntityItemID(entityItemID);
+    if (entity) {
+        _containmentIndex.update(entity);
+    }
     emit entityScriptChanging(entityItemID, reload);
 }
 
@@ -781,6 +787,61 @@ bool EntityTree::findRayIntersection(const glm::vec3& origin, const glm::vec3& d
     return args.found;
 }
 
+static void findRayIntersectionsInElement(const EntityTreeElementPointer& element, std::vector<EntityRayQuery>& queries,
+                                          const std::vector<size_t>& liveQueries, int recursionCount = 0) {
+    if (recursionCount > DANGEROUSLY_DEEP_RECURSION) {
+        qCDebug(entities) << "findRayIntersectionsInElement() reached DANGEROUSLY_DEEP_RECURSION, bailing!";
+        return;
+    }
+
+    // only the rays that keep searching past this element descend into its children
+    std::vector<size_t> childQueries;
+    childQueries.reserve(liveQueries.size());
+    for (size_t index : liveQueries) {
+        EntityRayQuery& query = queries[index];
+        bool keepSearching = true;
+        if (element->findRayIntersection(query.origin, query.direction, keepSearching,
+            query.element, query.distance, query.face, query.surfaceNormal, query.entityIdsToInclude,
+            query.entityIdsToDiscard, query.visibleOnly, query.collidableOnly, &query.intersectedObject, query.precisionPicking)) {
+            query.found = true;
+        }
+        if (keepSearching) {
+            childQueries.push_back(index);
+        }
+    }
+
+    if (childQueries.empty()) {
+        return;
+    }
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        EntityTreeElementPointer child = std::static_pointer_cast<EntityTreeElement>(element->getChildAtIndex(i));
+        if (child) {
+            findRayIntersectionsInElement(child, queries, childQueries, recursionCount + 1);
+        }
+    }
+}
+
+void EntityTree::findRayIntersections(std::vector<EntityRayQuery>& queries, Octree::lockType lockType, bool* accurateResult) {
+    std::vector<size_t> liveQueries;
+    liveQueries.reserve(queries.size());
+    for (size_t i = 0; i < queries.size(); i++) {
+        queries[i].distance = FLT_MAX;
+        queries[i].found = false;
+        liveQueries.push_back(i);
+    }
+
+    bool requireLock = lockType == Octree::Lock;
+    bool lockResult = withReadLock([&]{
+        if (_rootElement && !liveQueries.empty()) {
+            findRayIntersectionsInElement(std::static_pointer_cast<EntityTreeElement>(_rootElement), queries, liveQueries);
+        }
+    }, requireLock);
+
+    if (accurateResult) {
+        *accurateResult = lockResult; // if user asked to accuracy or result, let them know this is accurate
+    }
+}
+
 
 EntityItemPointer EntityTree::findClosestEntity(const glm::vec3& position, float targetRadius) {
     FindNearPointArgs args = { position, targetRadius, false, NULL, FLT_MAX };
@@ -835,6 +896,10 @@ public:
     QVector<EntityItemPointer> _foundEntities;
 };
 
+void EntityTree::findEntitiesContainingPoint(const glm::vec3& point, QVector<EntityItemPointer>& foundEntities) {
+    _containmentIndex.findEntitiesContainingPoint(point, foundEntities);
+}
+
 bool EntityTree::findInCubeOperation(const OctreeElementPointer& element, void* extraData) {
     FindEntitiesInCubeArgs* args = static_cast<FindEntitiesInCubeArgs*>(extraData);
     if (element->getAACube().touches(args->_cube)) {
@@ -1381,21 +1446,51 @@ void EntityTree::processChallengeOwnershipPacket(ReceivedMessage& message, const
     }
 }
 
+// An edit decoded from an entity edit packet. Adds, edits and physics results carry the decoded properties, and erases
+// the IDs of the entities to delete.
+class EntityTreeDecodedEdit : public OctreeDecodedEdit {
+public:
+    PacketType packetType;
+    bool isValid { false };
+    EntityItemID entityItemID;
+    EntityItemProperties properties;
+    bool suppressDisallowedClientScript { false };
+    bool suppressDisallowedServerScript { false };
+    quint64 decodeTime { 0 };
+    QSet<EntityItemID> entityItemIDsToDelete;
+};
+
 int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                      const SharedNodePointer& senderNode) {
+    OctreeDecodedEditPointer edit;
+    int processedBytes = decodeEditPacketData(message.getType(), editData, maxLength, senderNode, edit);
+    if (edit) {
+        applyDecodedEdit(*edit, senderNode);
+    }
+    return processedBytes;
+}
+
+// Decoding doesn't touch the tree, and may run on several threads at once. Everything that needs the tree, or the edit
+// filters' script engines, is left for applyDecodedEdit().
+int EntityTree::decodeEditPacketData(PacketType packetType, const unsigned char* editData, int maxLength,
+                                     const SharedNodePointer& senderNode, OctreeDecodedEditPointer& edit) {
 
     if (!getIsServer()) {
-        qCWarning(entities) << "EntityTree::processEditPacketData() should only be called on a server tree.";
+        qCWarning(entities) << "EntityTree::decodeEditPacketData() should only be called on a server tree.";
         return 0;
     }
 
+    auto decodedEdit = std::unique_ptr<EntityTreeDecodedEdit>(new EntityTreeDecodedEdit());
+    decodedEdit->packetType = packetType;
+
     int processedBytes = 0;
     bool isAdd = false;
     // we handle these types of "edit" packets
-    switch (message.getType()) {
+    switch (packetType) {
         case PacketType::EntityErase: {
             QByteArray dataByteArray = QByteArray::fromRawData(reinterpret_cast<const char*>(editData), maxLength);
-            processedBytes = processEraseMessageDetails(dataByteArray, senderNode);
+            processedBytes = readEraseMessageDetails(dataByteArray, senderNode, decodedEdit->entityItemIDsToDelete);
+            decodedEdit->isValid = !decodedEdit->entityItemIDsToDelete.isEmpty();
             break;
         }
 
@@ -1403,38 +1498,13 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
             isAdd = true;  // fall through to next case
         case PacketType::EntityPhysics:
         case PacketType::EntityEdit: {
-            quint64 startDecode = 0, endDecode = 0;
-            quint64 startLookup = 0, endLookup = 0;
-            quint64 startUpdate = 0, endUpdate = 0;
-            quint64 startCreate = 0, endCreate = 0;
-            quint64 startFilter = 0, endFilter = 0;
-            quint64 startLogging = 0, endLogging = 0;
-
-            bool suppressDisallowedClientScript = false;
-            bool suppressDisallowedServerScript = false;
-            bool isPhysics = message.getType() == PacketType::EntityPhysics;
-
-            _totalEditMessages++;
-
-            EntityItemID entityItemID;
-            EntityItemProperties properties;
-            startDecode = usecTimestampNow();
+            EntityItemID& entityItemID = decodedEdit->entityItemID;
+            EntityItemProperties& properties = decodedEdit->properties;
 
+            quint64 startDecode = usecTimestampNow();
             bool validEditPacket = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
                                                                                 entityItemID, properties);
-            endDecode = usecTimestampNow();
-
-            EntityItemPointer existingEntity;
-            if (!isAdd) {
-                // search for the entity by EntityItemID
-                startLookup = usecTimestampNow();
-                existingEntity = findEntityByEntityItemID(entityItemID);
-                endLookup = usecTimestampNow();
-                if (!existingEntity) {
-                    // this is not an add-entity operation, and we don't know about the identified entity.
-                    validEditPacket = false;
-                }
-            }
+            decodedEdit->decodeTime = usecTimestampNow() - startDecode;
 
             if (validEditPacket && !_entityScriptSourceWhitelist.isEmpty()) {
 
@@ -1457,7 +1527,7 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                             validEditPacket = false;
                             wasDeletedBecauseOfClientScript = true;
                         } else {
-                            suppressDisallowedClientScript = true;
+                            decodedEdit->suppressDisallowedClientScript = true;
                         }
                     }
                 }
@@ -1482,7 +1552,7 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                                 validEditPacket = false;
                             }
                         } else {
-                            suppressDisallowedServerScript = true;
+                            decodedEdit->suppressDisallowedServerScript = true;
                         }
                     }
                 }
@@ -1500,145 +1570,184 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
                 }
             }
 
-            // If we got a valid edit packet, then it could be a new entity or it could be an update to
-            // an existing entity... handle appropriately
-            if (validEditPacket) {
-                startFilter = usecTimestampNow();
-                bool wasChanged = false;
-                // Having (un)lock rights bypasses the filter, unless it's a physics result.
-                FilterType filterType = isPhysics ? FilterType::Physics : (isAdd ? FilterType::Add : FilterType::Edit);
-                bool allowed = (!isPhysics && senderNode->isAllowedEditor()) || filterProperties(existingEntity, properties, properties, wasChanged, filterType);
-                if (!allowed) {
-                    auto timestamp = properties.getLastEdited();
-                    properties = EntityItemProperties();
-                    properties.setLastEdited(timestamp);
-                }
-                if (!allowed || wasChanged) {
-                    bumpTimestamp(properties);
-                    // For now, free ownership on any modification.
-                    properties.clearSimulationOwner();
-                }
-                endFilter = usecTimestampNow();
+            decodedEdit->isValid = validEditPacket;
+            break;
+        }
 
-                if (existingEntity && !isAdd) {
+        default:
+            return 0;
+    }
 
-                    if (suppressDisallowedClientScript) {
-                        bumpTimestamp(properties);
-                        properties.setScript(existingEntity->getScript());
-                    }
+    edit = std::move(decodedEdit);
+    return processedBytes;
+}
+
+void EntityTree::applyDecodedEdit(OctreeDecodedEdit& edit, const SharedNodePointer& senderNode) {
+    EntityTreeDecodedEdit& decodedEdit = static_cast<EntityTreeDecodedEdit&>(edit);
 
-                    if (suppressDisallowedServerScript) {
-                        bumpTimestamp(properties);
-                        properties.setServerScripts(existingEntity->getServerScripts());
+    if (decodedEdit.packetType == PacketType::EntityErase) {
+        if (decodedEdit.isValid) {
+            deleteEntities(decodedEdit.entityItemIDsToDelete, true, true);
+        }
+        return;
+    }
+
+    quint64 startLookup = 0, endLookup = 0;
+    quint64 startUpdate = 0, endUpdate = 0;
+    quint64 startCreate = 0, endCreate = 0;
+    quint64 startFilter = 0, endFilter = 0;
+    quint64 startLogging = 0, endLogging = 0;
+
+    bool isAdd = decodedEdit.packetType == PacketType::EntityAdd;
+    bool isPhysics = decodedEdit.packetType == PacketType::EntityPhysics;
+    bool validEditPacket = decodedEdit.isValid;
+    const EntityItemID& entityItemID = decodedEdit.entityItemID;
+    EntityItemProperties& properties = decodedEdit.properties;
+
+    _totalEditMessages++;
+
+    EntityItemPointer existingEntity;
+    if (!isAdd) {
+        // search for the entity by EntityItemID
+        startLookup = usecTimestampNow();
+        existingEntity = findEntityByEntityItemID(entityItemID);
+        endLookup = usecTimestampNow();
+        if (!existingEntity) {
+            // this is not an add-entity operation, and we don't know about the identified entity.
+            validEditPacket = false;
+        }
+    }
+
+    // If we got a valid edit packet, then it could be a new entity or it could be an update to
+    // an existing entity... handle appropriately
+    if (validEditPacket) {
+        startFilter = usecTimestampNow();
+        bool wasChanged = false;
+        // Having (un)lock rights bypasses the filter, unless it's a physics result.
+        FilterType filterType = isPhysics ? FilterType::Physics : (isAdd ? FilterType::Add : FilterType::Edit);
+        bool allowed = (!isPhysics && senderNode->isAllowedEditor()) || filterProperties(existingEntity, properties, properties, wasChanged, filterType);
+        if (!allowed) {
+            auto timestamp = properties.getLastEdited();
+            properties = EntityItemProperties();
+            properties.setLastEdited(timestamp);
+        }
+        if (!allowed || wasChanged) {
+            bumpTimestamp(properties);
+            // For now, free ownership on any modification.
+            properties.clearSimulationOwner();
+        }
+        endFilter = usecTimestampNow();
+
+        if (existingEntity && !isAdd) {
+
+            if (decodedEdit.suppressDisallowedClientScript) {
+                bumpTimestamp(properties);
+                properties.setScript(existingEntity->getScript());
+            }
+
+            if (decodedEdit.suppressDisallowedServerScript) {
+                bumpTimestamp(properties);
+                properties.setServerScripts(existingEntity->getServerScripts());
+            }
+
+            // if the EntityItem exists, then update it
+            startLogging = usecTimestampNow();
+            if (wantEditLogging()) {
+                qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
+                qCDebug(entities) << "   properties:" << properties;
+            }
+            if (wantTerseEditLogging()) {
+                QList<QString> changedProperties = properties.listChangedProperties();
+                fixupTerseEditLogging(properties, changedProperties);
+                qCDebug(entities) << senderNode->getUUID() << "edit" <<
+                    existingEntity->getDebugName() << changedProperties;
+            }
+            endLogging = usecTimestampNow();
+
+            startUpdate = usecTimestampNow();
+            if (!isPhysics) {
+                properties.setLastEditedBy(senderNode->getUUID());
+            }
+            updateEntity(existingEntity, properties, senderNode);
+            existingEntity->markAsChangedOnServer();
+            endUpdate = usecTimestampNow();
+            _totalUpdates++;
+        } else if (isAdd) {
+            bool failedAdd = !allowed;
+            bool isCertified = !properties.getCertificateID().isEmpty();
+            if (!allowed) {
+                qCDebug(entities) << "Filtered entity add. ID:" << entityItemID;
+            } else if (!isCertified && !senderNode->getCanRez() && !senderNode->getCanRezTmp()) {
+                failedAdd = true;
+                qCDebug(entities) << "User without 'uncertified rez rights' [" << senderNode->getUUID()
+                    << "] attempted to add an uncertified entity with ID:" << entityItemID;
+            } else if (isCertified && !senderNode->getCanRezCertified() && !senderNode->getCanRezTmpCertified()) {
+                failedAdd = true;
+                qCDebug(entities) << "User without 'certified rez rights' [" << senderNode->getUUID()
+                    << "] attempted to add a certified entity with ID:" << entityItemID;
+            } else {
+                // this is a new entity... assign a new entityID
+                properties.setCreated(properties.getLastEdited());
+                properties.setLastEditedBy(senderNode->getUUID());
+                startCreate = usecTimestampNow();
+                EntityItemPointer newEntity = addEntity(entityItemID, properties);
+                endCreate = usecTimestampNow();
+                _totalCreates++;
+
+                if (newEntity && isCertified && getIsServer()) {
+                    if (!properties.verifyStaticCertificateProperties()) {
+                        qCDebug(entities) << "User" << senderNode->getUUID()
+                            << "attempted to add a certified entity with ID" << entityItemID << "which failed"
+                            << "static certificate verification.";
+                        // Delete the entity we just added if it doesn't pass static certificate verification
+                        deleteEntity(entityItemID, true);
+                    } else {
+                        validatePop(properties.getCertificateID(), entityItemID, senderNode, false);
                     }
+                }
+
+                if (newEntity) {
+                    newEntity->markAsChangedOnServer();
+                    notifyNewlyCreatedEntity(*newEntity, senderNode);
 
-                    // if the EntityItem exists, then update it
                     startLogging = usecTimestampNow();
                     if (wantEditLogging()) {
-                        qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
+                        qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
+                                          << newEntity->getEntityItemID();
                         qCDebug(entities) << "   properties:" << properties;
                     }
                     if (wantTerseEditLogging()) {
                         QList<QString> changedProperties = properties.listChangedProperties();
                         fixupTerseEditLogging(properties, changedProperties);
-                        qCDebug(entities) << senderNode->getUUID() << "edit" <<
-                            existingEntity->getDebugName() << changedProperties;
+                        qCDebug(entities) << senderNode->getUUID() << "add" << entityItemID << changedProperties;
                     }
                     endLogging = usecTimestampNow();
 
-                    startUpdate = usecTimestampNow();
-                    if (!isPhysics) {
-                        properties.setLastEditedBy(senderNode->getUUID());
-                    }
-                    updateEntity(existingEntity, properties, senderNode);
-                    existingEntity->markAsChangedOnServer();
-                    endUpdate = usecTimestampNow();
-                    _totalUpdates++;
-                } else if (isAdd) {
-                    bool failedAdd = !allowed;
-                    bool isCertified = !properties.getCertificateID().isEmpty();
-                    if (!allowed) {
-                        qCDebug(entities) << "Filtered entity add. ID:" << entityItemID;
-                    } else if (!isCertified && !senderNode->getCanRez() && !senderNode->getCanRezTmp()) {
-                        failedAdd = true;
-                        qCDebug(entities) << "User without 'uncertified rez rights' [" << senderNode->getUUID()
-                            << "] attempted to add an uncertified entity with ID:" << entityItemID;
-                    } else if (isCertified && !senderNode->getCanRezCertified() && !senderNode->getCanRezTmpCertified()) {
-                        failedAdd = true;
-                        qCDebug(entities) << "User without 'certified rez rights' [" << senderNode->getUUID()
-                            << "] attempted to add a certified entity with ID:" << entityItemID;
-                    } else {
-                        // this is a new entity... assign a new entityID
-                        properties.setCreated(properties.getLastEdited());
-                        properties.setLastEditedBy(senderNode->getUUID());
-                        startCreate = usecTimestampNow();
-                        EntityItemPointer newEntity = addEntity(entityItemID, properties);
-                        endCreate = usecTimestampNow();
-                        _totalCreates++;
-
-                        if (newEntity && isCertified && getIsServer()) {
-                            if (!properties.verifyStaticCertificateProperties()) {
-                                qCDebug(entities) << "User" << senderNode->getUUID()
-                                    << "attempted to add a certified entity with ID" << entityItemID << "which failed"
-                                    << "static certificate verification.";
-                                // Delete the entity we just added if it doesn't pass static certificate verification
-                                deleteEntity(entityItemID, true);
-                            } else {
-                                validatePop(properties.getCertificateID(), entityItemID, senderNode, false);
-                            }
-                        }
-
-                        if (newEntity) {
-                            newEntity->markAsChangedOnServer();
-                            notifyNewlyCreatedEntity(*newEntity, senderNode);
-
-                            startLogging = usecTimestampNow();
-                            if (wantEditLogging()) {
-                                qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
-                                                  << newEntity->getEntityItemID();
-                                qCDebug(entities) << "   properties:" << properties;
-                            }
-                            if (wantTerseEditLogging()) {
-                                QList<QString> changedProperties = properties.listChangedProperties();
-                                fixupTerseEditLogging(properties, changedProperties);
-                                qCDebug(entities) << senderNode->getUUID() << "add" << entityItemID << changedProperties;
-                            }
-                            endLogging = usecTimestampNow();
-
-                        } else {
-                            failedAdd = true;
-                            qCDebug(entities) << "Add entity failed ID:" << entityItemID;
-                        }
-                    }
-                    if (failedAdd) { // Let client know it failed, so that they don't have an entity that no one else sees.
-                        QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-                        _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
-                    }
                 } else {
-                    static QString repeatedMessage =
-                        LogHandler::getInstance().addRepeatedMessageRegex("^Edit failed.*");
-                    qCDebug(entities) << "Edit failed. [" << message.getType() <<"] " <<
-                            "entity id:" << entityItemID << 
-                            "existingEntity pointer:" << existingEntity.get();
+                    failedAdd = true;
+                    qCDebug(entities) << "Add entity failed ID:" << entityItemID;
                 }
             }
-
-
-            _totalDecodeTime += endDecode - startDecode;
-            _totalLookupTime += endLookup - startLookup;
-            _totalUpdateTime += endUpdate - startUpdate;
-            _totalCreateTime += endCreate - startCreate;
-            _totalLoggingTime += endLogging - startLogging;
-            _totalFilterTime += endFilter - startFilter;
-
-            break;
+            if (failedAdd) { // Let client know it failed, so that they don't have an entity that no one else sees.
+                QWriteLocker locker(&_recentlyDeletedEntitiesLock);
+                _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
+            }
+        } else {
+            static QString repeatedMessage =
+                LogHandler::getInstance().addRepeatedMessageRegex("^Edit failed.*");
+            qCDebug(entities) << "Edit failed. [" << decodedEdit.packetType <<"] " <<
+                    "entity id:" << entityItemID << 
+                    "existingEntity pointer:" << existingEntity.get();
         }
-
-        default:
-            processedBytes = 0;
-            break;
     }
-    return processedBytes;
+
+
+    _totalDecodeTime += decodedEdit.decodeTime;
+    _totalLookupTime += endLookup - startLookup;
+    _totalUpdateTime += endUpdate - startUpdate;
+    _totalCreateTime += endCreate - startCreate;
+    _totalLoggingTime += endLogging - startLogging;
+    _totalFilterTime += endFilter - startFilter;
 }
 
 
@@ -1892,8 +2001,18 @@ int EntityTree::processEraseMessage(ReceivedMessage& message, const SharedNodePo
 // NOTE: Caller must lock the tree before calling this.
 // TODO: consider consolidating processEraseMessageDetails() and processEraseMessage()
 int EntityTree::processEraseMessageDetails(const QByteArray& dataByteArray, const SharedNodePointer& sourceNode) {
+    QSet<EntityItemID> entityItemIDsToDelete;
+    int processedBytes = readEraseMessageDetails(dataByteArray, sourceNode, entityItemIDsToDelete);
+    if (!entityItemIDsToDelete.isEmpty()) {
+        deleteEntities(entityItemIDsToDelete, true, true);
+    }
+    return processedBytes;
+}
+
+int EntityTree::readEraseMessageDetails(const QByteArray& dataByteArray, const SharedNodePointer& sourceNode,
+                                        QSet<EntityItemID>& entityItemIDsToDelete) {
     #ifdef EXTRA_ERASE_DEBUGGING
-        qCDebug(entities) << "EntityTree::processEraseMessageDetails()";
+        qCDebug(entities) << "EntityTree::readEraseMessageDetails()";
     #endif
     const unsigned char* packetData = (const unsigned char*)dataByteArray.constData();
     const unsigned char* dataAt = packetData;
@@ -1905,35 +2024,29 @@ int EntityTree::processEraseMessageDetails(const QByteArray& dataByteArray, cons
     dataAt += sizeof(numberOfIds);
     processedBytes += sizeof(numberOfIds);
 
-    if (numberOfIds > 0) {
-        QSet<EntityItemID> entityItemIDsToDelete;
-
-        for (size_t i = 0; i < numberOfIds; i++) {
-
-
-            if (processedBytes + NUM_BYTES_RFC4122_UUID > packetLength) {
-                qCDebug(entities) << "EntityTree::processEraseMessageDetails().... bailing because not enough bytes in buffer";
-                break; // bail to prevent buffer overflow
-            }
+    for (size_t i = 0; i < numberOfIds; i++) {
 
-            QByteArray encodedID = dataByteArray.mid((int)processedBytes, NUM_BYTES_RFC4122_UUID);
-            QUuid entityID = QUuid::fromRfc4122(encodedID);
-            dataAt += encodedID.size();
-            processedBytes += encodedID.size();
+        if (processedBytes + NUM_BYTES_RFC4122_UUID > packetLength) {
+            qCDebug(entities) << "EntityTree::readEraseMessageDetails().... bailing because not enough bytes in buffer";
+            break; // bail to prevent buffer overflow
+        }
 
-            #ifdef EXTRA_ERASE_DEBUGGING
-                qCDebug(entities) << "    ---- EntityTree::processEraseMessageDetails() contains id:" << entityID;
-            #endif
+        QByteArray encodedID = dataByteArray.mid((int)processedBytes, NUM_BYTES_RFC4122_UUID);
+        QUuid entityID = QUuid::fromRfc4122(encodedID);
+        dataAt += encodedID.size();
+        processedBytes += encodedID.size();
 
-            EntityItemID entityItemID(entityID);
-            entityItemIDsToDelete << entityItemID;
+        #ifdef EXTRA_ERASE_DEBUGGING
+            qCDebug(entities) << "    ---- EntityTree::readEraseMessageDetails() contains id:" << entityID;
+        #endif
 
-            if (wantEditLogging() || wantTerseEditLogging()) {
-                qCDebug(entities) << "User [" << sourceNode->getUUID() << "] deleting entity. ID:" << entityItemID;
-            }
+        EntityItemID entityItemID(entityID);
+        entityItemIDsToDelete << entityItemID;
 
+        if (wantEditLogging() || wantTerseEditLogging()) {
+            qCDebug(entities) << "User [" << sourceNode->getUUID() << "] deleting entity. ID:" << entityItemID;
         }
-        deleteEntities(entityItemIDsToDelete, true, true);
+
     }
     return (int)processedBytes;
 }
@@ -1952,19 +2065,25 @@ EntityTreeElementPointer EntityTree::getContainingElement(const EntityItemID& en
 
 void EntityTree::addEntityMapEntry(EntityItemPointer entity) {
     EntityItemID id = entity->getEntityItemID();
-    QWriteLocker locker(&_entityMapLock);
-    EntityItemPointer otherEntity = _entityMap.value(id);
-    if (otherEntity) {
-        qCWarning(entities) << "EntityTree::addEntityMapEntry() found pre-existing id " << id;
-        assert(false);
-        return;
+    {
+        QWriteLocker locker(&_entityMapLock);
+        EntityItemPointer otherEntity = _entityMap.value(id);
+        if (otherEntity) {
+            qCWarning(entities) << "EntityTree::addEntityMapEntry() found pre-existing id " << id;
+            assert(false);
+            return;
+        }
+        _entityMap.insert(id, entity);
     }
-    _entityMap.insert(id, entity);
+    _containmentIndex.update(entity);
 }
 
 void EntityTree::clearEntityMapEntry(const EntityItemID& id) {
-    QWriteLocker locker(&_entityMapLock);
-    _entityMap.remove(id);
+    {
+        QWriteLocker locker(&_entityMapLock);
+        _entityMap.remove(id);
+    }
+    _containmentIndex.remove(id);
 }
 
 void EntityTree::debugDumpMap() {
@@ -22,6 +22,7 @@ class EntityTree;
 using EntityTreePointer = std::shared_ptr<EntityTree>;
 
 #include "AddEntityOperator.h"
+#include "EntityContainmentIndex.h"
 #include "EntityTreeElement.h"
 #include "DeleteEntityOperator.h"
 #include "MovingEntitiesOperator.h"
@@ -50,6 +51,27 @@ public:
     QHash<EntityItemID, EntityItemID>* map;
 };
 
+// one ray of a batched ray cast, with its own filters and its own closest intersection
+class EntityRayQuery {
+public:
+    // Inputs
+    glm::vec3 origin;
+    glm::vec3 direction;
+    QVector<EntityItemID> entityIdsToInclude;
+    QVector<EntityItemID> entityIdsToDiscard;
+    bool visibleOnly { false };
+    bool collidableOnly { false };
+    bool precisionPicking { false };
+
+    // Outputs
+    OctreeElementPointer element;
+    float distance { FLT_MAX };
+    BoxFace face;
+    glm::vec3 surfaceNormal;
+    void* intersectedObject { nullptr };
+    bool found { false };
+};
+
 
 class EntityTree : public Octree, public SpatialParentTree {
     Q_OBJECT
@@ -93,6 +115,10 @@ public:
     void fixupTerseEditLogging(EntityItemProperties& properties, QList<QString>& changedProperties);
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& senderNode) override;
+    virtual bool canDecodeEditsConcurrently() const override { return true; }
+    virtual int decodeEditPacketData(PacketType packetType, const unsigned char* editData, int maxLength,
+                                     const SharedNodePointer& senderNode, OctreeDecodedEditPointer& edit) override;
+    virtual void applyDecodedEdit(OctreeDecodedEdit& edit, const SharedNodePointer& senderNode) override;
     virtual void processChallengeOwnershipRequestPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
     virtual void processChallengeOwnershipReplyPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
     virtual void processChallengeOwnershipPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
@@ -104,6 +130,11 @@ public:
         BoxFace& face, glm::vec3& surfaceNormal, void** intersectedObject = NULL,
         Octree::lockType lockType = Octree::TryLock, bool* accurateResult = NULL);
 
+    // Casts every ray of the batch in a single traversal of the tree, testing each element only against the rays
+    // that reached it
+    void findRayIntersections(std::vector<EntityRayQuery>& queries,
+        Octree::lockType lockType = Octree::TryLock, bool* accurateResult = NULL);
+
     virtual bool rootElementHasData() const override { return true; }
 
     // the root at least needs to store the number of entities in the packet/buffer
@@ -158,6 +189,11 @@ public:
     /// \remark Side effect: any initial contents in entities will be lost
     void findEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities);
 
+    /// finds the zones and scripted entities that contain a point
+    /// \param point the query point in world-frame (meters)
+    /// \param foundEntities[out] vector of EntityItemPointer
+    void findEntitiesContainingPoint(const glm::vec3& point, QVector<EntityItemPointer>& foundEntities);
+
     /// finds all entities within a frustum
     /// \parameter frustum the query frustum
     /// \param foundEntities[out] vector of EntityItemPointer
@@ -193,6 +229,8 @@ public:
 
     int processEraseMessage(ReceivedMessage& message, const SharedNodePointer& sourceNode);
     int processEraseMessageDetails(const QByteArray& buffer, const SharedNodePointer& sourceNode);
+    int readEraseMessageDetails(const QByteArray& buffer, const SharedNodePointer& sourceNode,
+                                QSet<EntityItemID>& entityItemIDsToDelete);
 
     EntityTreeElementPointer getContainingElement(const EntityItemID& entityItemID)  /*const*/;
     void addEntityMapEntry(EntityItemPointer entity);
@@ -329,6 +367,7 @@ protected:
 
     mutable QReadWriteLock _entityMapLock;
     QHash<EntityItemID, EntityItemPointer> _entityMap;
+    EntityContainmentIndex _containmentIndex;
 
     mutable QReadWriteLock _entityCertificateIDMapLock;
     QHash<QString, EntityItemID> _entityCertificateIDMap;
@@ -0,0 +1,169 @@
+//
+//  MovingEntitiesBatch.cpp
+//  libraries/entities/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MovingEntitiesBatch.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include <TBBHelpers.h>
+
+#include "EntityItem.h"
+#include "EntityTree.h"
+#include "EntitiesLogging.h"
+
+static EntityTreeElementPointer getParentElement(const EntityTreeElementPointer& element) {
+    return std::static_pointer_cast<EntityTreeElement>(element->getParent());
+}
+
+// marks the path from element up to (and including) stopAt as changed, stopping early at anything already marked
+static void markPathChanged(EntityTreeElementPointer element, const EntityTreeElementPointer& stopAt,
+        std::unordered_set<EntityTreeElement*>& marked) {
+    while (element && marked.insert(element.get()).second) {
+        element->markWithChangedTime();
+        if (element == stopAt) {
+            break;
+        }
+        element = getParentElement(element);
+    }
+}
+
+void MovingEntitiesBatch::addEntityToMoveList(EntityItemPointer entity, const AACube& newCube) {
+    EntityTreeElementPointer oldContainingElement = entity->getElement();
+    if (!oldContainingElement) {
+        qCDebug(entities) << "UNEXPECTED!!!! attempting to move entity " << entity->getEntityItemID()
+                          << "that has no containing element. ";
+        return;
+    }
+
+    AABox newCubeClamped = newCube.clamp((float)-HALF_TREE_SCALE, (float)HALF_TREE_SCALE);
+
+    // If the original containing element is still the best fit there's nothing to do
+    if (oldContainingElement->bestFitBounds(newCubeClamped)) {
+        return;
+    }
+
+    Move move;
+    move.entity = entity;
+    move.newCube = newCube;
+    move.newCubeClamped = newCubeClamped;
+    move.ancestor = oldContainingElement;
+    _moves.push_back(move);
+}
+
+EntityTreeElementPointer MovingEntitiesBatch::findBestFitBelow(EntityTreeElementPointer element, const Move& move) {
+    while (!element->bestFitBounds(move.newCube)) {
+        int childIndex = element->getMyChildContaining(move.newCubeClamped);
+        if (childIndex == OctreeElement::CHILD_UNKNOWN) {
+            break;
+        }
+        EntityTreeElementPointer child = element->getChildAtIndex(childIndex);
+        if (!child) {
+            child = std::static_pointer_cast<EntityTreeElement>(element->addChildAtIndex(childIndex));
+        }
+        element = child;
+    }
+    return element;
+}
+
+void MovingEntitiesBatch::applyMoves(std::vector<Move>& moves, const EntityTreeElementPointer& subtreeRoot) {
+    if (moves.empty()) {
+        return;
+    }
+
+    // resolve every target first, so that each element's path only gets marked once however many entities land there
+    std::unordered_map<EntityTreeElementPointer, std::vector<Move*>> movesByTarget;
+    for (auto& move : moves) {
+        movesByTarget[findBestFitBelow(move.ancestor, move)].push_back(&move);
+    }
+
+    std::unordered_set<EntityTreeElement*> marked;
+    std::vector<EntityTreeElementPointer> vacatedElements;
+    for (auto& targetMoves : movesByTarget) {
+        const EntityTreeElementPointer& target = targetMoves.first;
+        for (Move* move : targetMoves.second) {
+            EntityTreeElementPointer oldElement = move->entity->getElement();
+            if (oldElement == target) {
+                target->bumpChangedContent();
+                continue;
+            }
+            if (oldElement) {
+                oldElement->removeEntityItem(move->entity);
+                vacatedElements.push_back(oldElement);
+            }
+            target->addEntityItem(move->entity);
+        }
+        markPathChanged(target, subtreeRoot, marked);
+    }
+
+    for (const auto& element : vacatedElements) {
+        markPathChanged(element, subtreeRoot, marked);
+    }
+
+    // now that every entity has landed, prune the branches that were left empty. The subtree root itself is never
+    // removed here since that would change its parent, which other subtrees may be using.
+    for (const auto& element : vacatedElements) {
+        EntityTreeElementPointer child = element;
+        while (child != subtreeRoot && child->isLeaf() && !child->hasEntities()) {
+            EntityTreeElementPointer parent = getParentElement(child);
+            if (!parent) {
+                break;
+            }
+            parent->pruneChildren();
+            child = parent;
+        }
+    }
+}
+
+void MovingEntitiesBatch::apply() {
+    if (_moves.empty()) {
+        return;
+    }
+
+    EntityTreeElementPointer root = _tree->getRoot();
+
+    // climb until the new bounds fit, and bucket each move by the child of the root it stays inside of
+    std::vector<Move> subtreeMoves[NUMBER_OF_CHILDREN];
+    std::vector<Move> rootMoves;
+    for (auto& move : _moves) {
+        EntityTreeElementPointer ancestor = move.ancestor;
+        while (ancestor != root && !ancestor->getAACube().contains(move.newCubeClamped)) {
+            ancestor = getParentElement(ancestor);
+            if (!ancestor) {
+                ancestor = root;
+            }
+        }
+        move.ancestor = ancestor;
+
+        int childIndex = ancestor == root ? OctreeElement::CHILD_UNKNOWN : root->getMyChildContaining(ancestor->getAACube());
+        if (childIndex == OctreeElement::CHILD_UNKNOWN) {
+            rootMoves.push_back(move);
+        } else {
+            subtreeMoves[childIndex].push_back(move);
+        }
+    }
+
+    if (_moves.size() - rootMoves.size() >= MIN_MOVES_FOR_PARALLEL) {
+        tbb::parallel_for(0, NUMBER_OF_CHILDREN, [&](int childIndex) {
+            applyMoves(subtreeMoves[childIndex], root->getChildAtIndex(childIndex));
+        });
+    } else {
+        for (int childIndex = 0; childIndex < NUMBER_OF_CHILDREN; childIndex++) {
+            applyMoves(subtreeMoves[childIndex], root->getChildAtIndex(childIndex));
+        }
+    }
+
+    // anything that crosses between the root's children touches the root, so it goes last and on this thread
+    applyMoves(rootMoves, root);
+    root->pruneChildren();
+    root->markWithChangedTime();
+
+    _moves.clear();
+}
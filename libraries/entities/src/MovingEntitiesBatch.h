@@ -0,0 +1,52 @@
+//
+//  MovingEntitiesBatch.h
+//  libraries/entities/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MovingEntitiesBatch_h
+#define hifi_MovingEntitiesBatch_h
+
+#include <vector>
+
+#include "EntityTypes.h"
+#include "EntityTreeElement.h"
+
+// Relocates entities that moved to their new best fit elements without a traversal from the root.
+//
+// Each entity climbs from its current element until the new bounds fit, then descends to the best fit element from
+// there. Moves that stay inside one of the root's children are independent of moves inside the other children, so
+// large batches are applied to each of those subtrees in parallel. Must be applied under the tree's write lock.
+class MovingEntitiesBatch {
+public:
+    MovingEntitiesBatch(EntityTreePointer tree) : _tree(tree) {}
+
+    void addEntityToMoveList(EntityItemPointer entity, const AACube& newCube);
+    bool hasMovingEntities() const { return !_moves.empty(); }
+    size_t size() const { return _moves.size(); }
+
+    void apply();
+    void reset() { _moves.clear(); }
+
+    static const size_t MIN_MOVES_FOR_PARALLEL = 64;
+
+private:
+    struct Move {
+        EntityItemPointer entity;
+        AACube newCube;
+        AABox newCubeClamped;
+        EntityTreeElementPointer ancestor; // the first element on the way up from the old element that fits newCube
+    };
+
+    void applyMoves(std::vector<Move>& moves, const EntityTreeElementPointer& subtreeRoot);
+    EntityTreeElementPointer findBestFitBelow(EntityTreeElementPointer element, const Move& move);
+
+    EntityTreePointer _tree;
+    std::vector<Move> _moves;
+};
+
+#endif // hifi_MovingEntitiesBatch_h
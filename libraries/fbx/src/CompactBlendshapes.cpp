@@ -0,0 +1,168 @@
+//
+//  CompactBlendshapes.cpp
+//  libraries/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CompactBlendshapes.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "FBX.h"
+
+static void accumulateBlendshapeRun_ref(float* vertices, float* normals, const float* vertexDeltas, const float* normalDeltas,
+                                        float vertexCoefficient, float normalCoefficient, int numFloats) {
+    for (int i = 0; i < numFloats; i++) {
+        vertices[i] += vertexDeltas[i] * vertexCoefficient;
+        normals[i] += normalDeltas[i] * normalCoefficient;
+    }
+}
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+//
+// Runtime CPU dispatch
+//
+
+#include "CPUDetect.h"
+
+void accumulateBlendshapeRun_AVX2(float* vertices, float* normals, const float* vertexDeltas, const float* normalDeltas,
+                                  float vertexCoefficient, float normalCoefficient, int numFloats);
+
+static void accumulateBlendshapeRun(float* vertices, float* normals, const float* vertexDeltas, const float* normalDeltas,
+                                    float vertexCoefficient, float normalCoefficient, int numFloats) {
+    static auto f = cpuSupportsAVX2() ? accumulateBlendshapeRun_AVX2 : accumulateBlendshapeRun_ref;
+    (*f)(vertices, normals, vertexDeltas, normalDeltas, vertexCoefficient, normalCoefficient, numFloats);  // dispatch
+}
+
+#else
+
+static void accumulateBlendshapeRun(float* vertices, float* normals, const float* vertexDeltas, const float* normalDeltas,
+                                    float vertexCoefficient, float normalCoefficient, int numFloats) {
+    accumulateBlendshapeRun_ref(vertices, normals, vertexDeltas, normalDeltas, vertexCoefficient, normalCoefficient, numFloats);
+}
+
+#endif
+
+CompactBlendshape::CompactBlendshape(const FBXBlendshape& blendshape, int numVertices) {
+    struct Delta {
+        uint32_t index;
+        glm::vec3 vertex;
+        glm::vec3 normal;
+    };
+
+    std::vector<Delta> deltas;
+    deltas.reserve(blendshape.indices.size());
+    for (int i = 0; i < blendshape.indices.size(); i++) {
+        int index = blendshape.indices.at(i);
+        if (index < 0 || index >= numVertices) {
+            continue;
+        }
+        glm::vec3 vertex = i < blendshape.vertices.size() ? blendshape.vertices.at(i) : glm::vec3(0.0f);
+        glm::vec3 normal = i < blendshape.normals.size() ? blendshape.normals.at(i) : glm::vec3(0.0f);
+        deltas.push_back({ (uint32_t)index, vertex, normal });
+    }
+    std::stable_sort(deltas.begin(), deltas.end(), [](const Delta& a, const Delta& b) {
+        return a.index < b.index;
+    });
+
+    // Sum the deltas of vertices listed more than once, and drop those that don't change anything
+    size_t numDeltas = 0;
+    for (size_t i = 0; i < deltas.size(); i++) {
+        if (numDeltas > 0 && deltas[numDeltas - 1].index == deltas[i].index) {
+            deltas[numDeltas - 1].vertex += deltas[i].vertex;
+            deltas[numDeltas - 1].normal += deltas[i].normal;
+        } else {
+            deltas[numDeltas++] = deltas[i];
+        }
+    }
+    deltas.resize(numDeltas);
+    deltas.erase(std::remove_if(deltas.begin(), deltas.end(), [](const Delta& delta) {
+        return delta.vertex == glm::vec3(0.0f) && delta.normal == glm::vec3(0.0f);
+    }), deltas.end());
+
+    _vertexDeltas.reserve(deltas.size() * 3);
+    _normalDeltas.reserve(deltas.size() * 3);
+    auto appendDelta = [&](const glm::vec3& vertex, const glm::vec3& normal) {
+        _vertexDeltas.insert(_vertexDeltas.end(), { vertex.x, vertex.y, vertex.z });
+        _normalDeltas.insert(_normalDeltas.end(), { normal.x, normal.y, normal.z });
+    };
+
+    for (const auto& delta : deltas) {
+        if (!_runs.empty()) {
+            auto& run = _runs.back();
+            uint32_t runEnd = run.firstIndex + run.numIndices;
+            if (delta.index - runEnd <= MAX_RUN_GAP) {
+                for (uint32_t index = runEnd; index < delta.index; index++) {
+                    appendDelta(glm::vec3(0.0f), glm::vec3(0.0f));
+                }
+                appendDelta(delta.vertex, delta.normal);
+                run.numIndices = delta.index + 1 - run.firstIndex;
+                continue;
+            }
+        }
+        _runs.push_back({ delta.index, 1, (uint32_t)getNumDeltas() });
+        appendDelta(delta.vertex, delta.normal);
+    }
+}
+
+void CompactBlendshape::accumulate(glm::vec3* vertices, glm::vec3* normals, float vertexCoefficient, float normalCoefficient) const {
+    static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "Blendshape runs are accumulated as packed floats");
+
+    for (const auto& run : _runs) {
+        accumulateBlendshapeRun(&vertices[run.firstIndex].x, &normals[run.firstIndex].x,
+            &_vertexDeltas[3 * run.firstDelta], &_normalDeltas[3 * run.firstDelta],
+            vertexCoefficient, normalCoefficient, 3 * run.numIndices);
+    }
+}
+
+CompactBlendedMeshes::CompactBlendedMeshes(const FBXGeometry& geometry) {
+    for (int i = 0; i < geometry.meshes.size(); i++) {
+        const FBXMesh& fbxMesh = geometry.meshes.at(i);
+        if (fbxMesh.blendshapes.isEmpty()) {
+            continue;
+        }
+
+        Mesh mesh;
+        mesh.meshIndex = i;
+        mesh.firstVertex = _numVertices;
+        mesh.vertices = fbxMesh.vertices;
+        mesh.normals = fbxMesh.normals.mid(0, fbxMesh.vertices.size());
+        // blended normals are written for every vertex, so those a mesh lacks are zero rather than left unset
+        mesh.normals.reserve(fbxMesh.vertices.size());
+        while (mesh.normals.size() < fbxMesh.vertices.size()) {
+            mesh.normals.push_back(glm::vec3(0.0f));
+        }
+        mesh.blendshapes.reserve(fbxMesh.blendshapes.size());
+        foreach (const FBXBlendshape& blendshape, fbxMesh.blendshapes) {
+            mesh.blendshapes.emplace_back(blendshape, fbxMesh.vertices.size());
+        }
+        _meshes.push_back(std::move(mesh));
+        _numVertices += fbxMesh.vertices.size();
+    }
+}
+
+void CompactBlendedMeshes::blend(const QVector<float>& coefficients, glm::vec3* vertices, glm::vec3* normals) const {
+    const float NORMAL_COEFFICIENT_SCALE = 0.01f;
+    const float EPSILON = 0.0001f;
+
+    for (const auto& mesh : _meshes) {
+        glm::vec3* meshVertices = vertices + mesh.firstVertex;
+        glm::vec3* meshNormals = normals + mesh.firstVertex;
+        memcpy(meshVertices, mesh.vertices.constData(), mesh.vertices.size() * sizeof(glm::vec3));
+        memcpy(meshNormals, mesh.normals.constData(), mesh.normals.size() * sizeof(glm::vec3));
+
+        for (int i = 0, n = std::min(coefficients.size(), (int)mesh.blendshapes.size()); i < n; i++) {
+            float vertexCoefficient = coefficients.at(i);
+            if (vertexCoefficient < EPSILON) {
+                continue;
+            }
+            mesh.blendshapes[i].accumulate(meshVertices, meshNormals, vertexCoefficient, vertexCoefficient * NORMAL_COEFFICIENT_SCALE);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+//
+//  CompactBlendshapes.h
+//  libraries/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CompactBlendshapes_h
+#define hifi_CompactBlendshapes_h
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <QVector>
+
+#include <glm/glm.hpp>
+
+class FBXBlendshape;
+class FBXGeometry;
+
+/// A blendshape's deltas without the vertices it leaves alone, grouped into runs of consecutive vertices
+/// so they are added in straight loops over floats rather than scattered one vertex at a time.
+class CompactBlendshape {
+public:
+    struct Run {
+        uint32_t firstIndex; // of the first vertex it changes
+        uint32_t numIndices;
+        uint32_t firstDelta; // of its deltas in the blendshape
+    };
+
+    /// Gaps of up to this many unchanged vertices are filled with zero deltas rather than starting a new run
+    static const uint32_t MAX_RUN_GAP { 4 };
+
+    CompactBlendshape(const FBXBlendshape& blendshape, int numVertices);
+
+    /// Adds the deltas, scaled by the coefficients, to the mesh's vertices and normals
+    void accumulate(glm::vec3* vertices, glm::vec3* normals, float vertexCoefficient, float normalCoefficient) const;
+
+    const std::vector<Run>& getRuns() const { return _runs; }
+    size_t getNumDeltas() const { return _vertexDeltas.size() / 3; }
+    bool isEmpty() const { return _runs.empty(); }
+
+private:
+    std::vector<Run> _runs;
+    std::vector<float> _vertexDeltas;
+    std::vector<float> _normalDeltas;
+};
+
+/// The meshes of a geometry that have blendshapes, laid out one after the other as in Model's blended vertex buffers.
+/// Built once per geometry, and shared by the models using it.
+class CompactBlendedMeshes {
+public:
+    using Pointer = std::shared_ptr<const CompactBlendedMeshes>;
+
+    struct Mesh {
+        int meshIndex;
+        int firstVertex; // in the blended vertices of all the meshes
+        QVector<glm::vec3> vertices;
+        QVector<glm::vec3> normals;
+        std::vector<CompactBlendshape> blendshapes;
+    };
+
+    CompactBlendedMeshes(const FBXGeometry& geometry);
+
+    const std::vector<Mesh>& getMeshes() const { return _meshes; }
+    int getNumVertices() const { return _numVertices; }
+
+    /// Writes the blended vertices and normals of all the meshes, getNumVertices() of each
+    void blend(const QVector<float>& coefficients, glm::vec3* vertices, glm::vec3* normals) const;
+
+private:
+    std::vector<Mesh> _meshes;
+    int _numVertices { 0 };
+};
+
+#endif // hifi_CompactBlendshapes_h
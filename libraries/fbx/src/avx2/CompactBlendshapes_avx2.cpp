@@ -0,0 +1,42 @@
+//
+//  CompactBlendshapes_avx2.cpp
+//  libraries/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+void accumulateBlendshapeRun_AVX2(float* vertices, float* normals, const float* vertexDeltas, const float* normalDeltas,
+                                  float vertexCoefficient, float normalCoefficient, int numFloats) {
+    __m256 vc = _mm256_set1_ps(vertexCoefficient);
+    __m256 nc = _mm256_set1_ps(normalCoefficient);
+
+    int i = 0;
+    for (; i <= numFloats - 8; i += 8) {   // SIMD8
+
+        __m256 v0 = _mm256_loadu_ps(&vertices[i]);
+        __m256 n0 = _mm256_loadu_ps(&normals[i]);
+
+        v0 = _mm256_fmadd_ps(_mm256_loadu_ps(&vertexDeltas[i]), vc, v0);
+        n0 = _mm256_fmadd_ps(_mm256_loadu_ps(&normalDeltas[i]), nc, n0);
+
+        _mm256_storeu_ps(&vertices[i], v0);
+        _mm256_storeu_ps(&normals[i], n0);
+    }
+
+    // remaining floats
+    for (; i < numFloats; i++) {
+        vertices[i] += vertexDeltas[i] * vertexCoefficient;
+        normals[i] += normalDeltas[i] * normalCoefficient;
+    }
+
+    _mm256_zeroupper();
+}
+
+#endif
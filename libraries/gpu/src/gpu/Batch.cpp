@@ -102,6 +102,163 @@ void Batch::clear() {
     _framebuffers.clear();
     _objects.clear();
     _drawCallInfos.clear();
+    _queries.clear();
+    _lambdas.clear();
+    _profileRanges.clear();
+    _names.clear();
+    _namedData.clear();
+    _currentNamedCall.clear();
+
+    _invalidModel = true;
+    _currentModel = Transform();
+    _enableStereo = true;
+    _enableSkybox = false;
+}
+
+template <typename V>
+static size_t appendCache(V& cache, const V& other) {
+    size_t base = cache.size();
+    cache._items.insert(cache._items.end(), other._items.begin(), other._items.end());
+    return base;
+}
+
+void Batch::append(const Batch& batch) {
+    // The offsets the params of the other batch hold move by the size of what this batch already had
+    const size_t bufferBase = appendCache(_buffers, batch._buffers);
+    const size_t textureBase = appendCache(_textures, batch._textures);
+    const size_t streamFormatBase = appendCache(_streamFormats, batch._streamFormats);
+    const size_t transformBase = appendCache(_transforms, batch._transforms);
+    const size_t pipelineBase = appendCache(_pipelines, batch._pipelines);
+    const size_t framebufferBase = appendCache(_framebuffers, batch._framebuffers);
+    const size_t queryBase = appendCache(_queries, batch._queries);
+    const size_t lambdaBase = appendCache(_lambdas, batch._lambdas);
+    const size_t profileRangeBase = appendCache(_profileRanges, batch._profileRanges);
+    const size_t nameBase = appendCache(_names, batch._names);
+
+    const size_t dataBase = _data.size();
+    _data.insert(_data.end(), batch._data.begin(), batch._data.end());
+
+    const size_t paramBase = _params.size();
+    _params.insert(_params.end(), batch._params.begin(), batch._params.end());
+
+    auto rebase = [&](size_t paramOffset, size_t base) {
+        _params[paramOffset] = Param(_params[paramOffset]._uint + base);
+    };
+
+    bool setsModel = false;
+    for (size_t i = 0; i < batch._commands.size(); ++i) {
+        auto command = batch._commands[i];
+        size_t paramOffset = batch._commandOffsets[i] + paramBase;
+        _commands.push_back(command);
+        _commandOffsets.push_back(paramOffset);
+
+        // Params are indexed in the order the commands above emplace them
+        switch (command) {
+            case COMMAND_setInputFormat:
+                rebase(paramOffset + 0, streamFormatBase);
+                break;
+            case COMMAND_setInputBuffer:
+            case COMMAND_setUniformBuffer:
+                rebase(paramOffset + 2, bufferBase);
+                break;
+            case COMMAND_setIndexBuffer:
+                rebase(paramOffset + 1, bufferBase);
+                break;
+            case COMMAND_setIndirectBuffer:
+            case COMMAND_setResourceBuffer:
+                rebase(paramOffset + 0, bufferBase);
+                break;
+            case COMMAND_setModelTransform:
+                setsModel = true;
+                break;
+            case COMMAND_setViewTransform:
+                rebase(paramOffset + 0, transformBase);
+                break;
+            case COMMAND_setProjectionTransform:
+            case COMMAND_setViewportTransform:
+            case COMMAND_setStateScissorRect:
+            case COMMAND_glUniform3fv:
+            case COMMAND_glUniform4fv:
+            case COMMAND_glUniform4iv:
+            case COMMAND_glUniformMatrix3fv:
+            case COMMAND_glUniformMatrix4fv:
+                rebase(paramOffset + 0, dataBase);
+                break;
+            case COMMAND_setPipeline:
+                rebase(paramOffset + 0, pipelineBase);
+                break;
+            case COMMAND_setResourceTexture:
+            case COMMAND_generateTextureMips:
+                rebase(paramOffset + 0, textureBase);
+                break;
+            case COMMAND_setFramebuffer:
+                rebase(paramOffset + 0, framebufferBase);
+                break;
+            case COMMAND_blit:
+                rebase(paramOffset + 0, framebufferBase);
+                rebase(paramOffset + 5, framebufferBase);
+                break;
+            case COMMAND_beginQuery:
+            case COMMAND_endQuery:
+            case COMMAND_getQuery:
+                rebase(paramOffset + 0, queryBase);
+                break;
+            case COMMAND_runLambda:
+                rebase(paramOffset + 0, lambdaBase);
+                break;
+            case COMMAND_startNamedCall:
+                rebase(paramOffset + 0, nameBase);
+                break;
+            case COMMAND_pushProfileRange:
+                rebase(paramOffset + 0, profileRangeBase);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // The draw calls point at the model transforms of the other batch, which now follow this one's
+    const size_t objectBase = _objects.size();
+    _objects.insert(_objects.end(), batch._objects.begin(), batch._objects.end());
+
+    auto appendDrawCallInfos = [&](DrawCallInfoBuffer& drawCallInfos, const DrawCallInfoBuffer& other) {
+        for (const auto& drawCallInfo : other) {
+            drawCallInfos.emplace_back((DrawCallInfo::Index)(drawCallInfo.index + objectBase));
+            drawCallInfos.back().unused = drawCallInfo.unused;
+        }
+    };
+    appendDrawCallInfos(_drawCallInfos, batch._drawCallInfos);
+
+    // Named calls of the same name are drawn together, so their instance data is concatenated
+    for (const auto& namedData : batch._namedData) {
+        auto& instance = _namedData[namedData.first];
+        if (!instance.function) {
+            instance.function = namedData.second.function;
+        }
+        appendDrawCallInfos(instance.drawCallInfos, namedData.second.drawCallInfos);
+
+        const auto& buffers = namedData.second.buffers;
+        if (instance.buffers.size() < buffers.size()) {
+            instance.buffers.resize(buffers.size());
+        }
+        for (size_t i = 0; i < buffers.size(); ++i) {
+            if (!buffers[i]) {
+                continue;
+            }
+            if (!instance.buffers[i]) {
+                instance.buffers[i] = std::make_shared<Buffer>();
+            }
+            instance.buffers[i]->append(buffers[i]->getSize(), buffers[i]->getData());
+        }
+    }
+
+    // Later draws use the model the other batch left off with, if it had one
+    if (setsModel) {
+        _currentModel = batch._currentModel;
+        _invalidModel = batch._invalidModel;
+    } else if (!batch._objects.empty()) {
+        _invalidModel = true;
+    }
 }
 
 size_t Batch::cacheData(size_t size, const void* data) {
@@ -97,6 +97,12 @@ public:
 
     void clear();
 
+    // Append the commands of another batch, with everything they refer to, as if they had been recorded here.
+    // The other batch is left as it was, so it can be cleared and recorded into again.
+    // Lets independent parts of a frame be recorded into their own batches on different threads
+    // and put back together in a known order.
+    void append(const Batch& batch);
+
     // Batches may need to override the context level stereo settings
     // if they're performing framebuffer copy operations, like the 
     // deferred lighting resolution mechanism
@@ -13,12 +13,8 @@
 
 #include <mutex>
 
-#include <QtConcurrent/QtConcurrentRun>
-
 #include <QCryptographicHash>
 #include <QImageReader>
-#include <QRunnable>
-#include <QThreadPool>
 #include <QNetworkReply>
 #include <QPainter>
 #include <QUrlQuery>
@@ -38,13 +34,11 @@
 #include <NumericalConstants.h>
 #include <shared/NsightHelpers.h>
 
-#include <Finally.h>
 #include <Profile.h>
 
 #include "NetworkLogging.h"
 #include "ModelNetworkingLogging.h"
 #include <Trace.h>
-#include <StatTracker.h>
 
 Q_LOGGING_CATEGORY(trace_resource_parse_image, "trace.resource.parse.image")
 Q_LOGGING_CATEGORY(trace_resource_parse_image_raw, "trace.resource.parse.image.raw")
@@ -342,23 +336,28 @@ gpu::TexturePointer NetworkTexture::getFallbackTexture() const {
     return getFallbackTextureForType(_type);
 }
 
-class ImageReader : public QRunnable {
+class ImageReader {
 public:
-    ImageReader(const QWeakPointer<Resource>& resource, const QUrl& url,
+    ImageReader(const QWeakPointer<Resource>& resource, const TexturePipeline::TicketPointer& ticket, const QUrl& url,
                 const QByteArray& data, int maxNumPixels);
-    void run() override final;
+    void run();
     void read();
 
 private:
     static void listSupportedImageFormats();
+    static void write(const QWeakPointer<Resource>& resource, const TexturePipeline::TicketPointer& ticket, const QUrl& url,
+                      const std::string& hash, gpu::TexturePointer texture);
 
     QWeakPointer<Resource> _resource;
+    TexturePipeline::TicketPointer _ticket;
     QUrl _url;
     QByteArray _content;
     int _maxNumPixels;
 };
 
 NetworkTexture::~NetworkTexture() {
+    cancelProcessing();
+
     if (_ktxHeaderRequest || _ktxMipRequest) {
         if (_ktxHeaderRequest) {
             _ktxHeaderRequest->disconnect(this);
@@ -593,22 +592,14 @@ void NetworkTexture::ktxMipRequestFinished() {
             _ktxResourceState = WAITING_FOR_MIP_REQUEST;
 
             auto self = _self;
+            auto ticket = _processingTicket;
             auto url = _url;
             auto data = _ktxMipRequest->getData();
             auto mipLevel = _ktxMipLevelRangeInFlight.first;
             auto texture = _textureSource->getGPUTexture();
-            DependencyManager::get<StatTracker>()->incrementStat("PendingProcessing");
-            QtConcurrent::run(QThreadPool::globalInstance(), [self, data, mipLevel, url, texture] {
+            // Assigning the mip writes it to the texture's KTX cache file
+            DependencyManager::get<TextureCache>()->_pipeline->submit(TexturePipeline::WRITE, ticket, [self, ticket, data, mipLevel, url, texture] {
                 PROFILE_RANGE_EX(resource_parse_image, "NetworkTexture - Processing Mip Data", 0xffff0000, 0, { { "url", url.toString() } });
-                DependencyManager::get<StatTracker>()->decrementStat("PendingProcessing");
-                CounterStat counter("Processing");
-
-                auto originalPriority = QThread::currentThread()->priority();
-                if (originalPriority == QThread::InheritPriority) {
-                    originalPriority = QThread::NormalPriority;
-                }
-                QThread::currentThread()->setPriority(QThread::LowPriority);
-                Finally restorePriority([originalPriority] { QThread::currentThread()->setPriority(originalPriority); });
 
                 auto resource = self.lock();
                 if (!resource) {
@@ -626,12 +617,7 @@ void NetworkTexture::ktxMipRequestFinished() {
                     return;
                 }
 
-                QMetaObject::invokeMethod(resource.data(), "setImage",
-                    Q_ARG(gpu::TexturePointer, texture),
-                    Q_ARG(int, texture->getWidth()),
-                    Q_ARG(int, texture->getHeight()));
-
-                QMetaObject::invokeMethod(resource.data(), "startRequestForNextMipLevel");
+                handOffImage(self, ticket, texture, true);
             });
         } else {
             qWarning(networking) << "Mip request finished in an unexpected state: " << _ktxResourceState;
@@ -664,19 +650,10 @@ void NetworkTexture::handleFinishedInitialLoad() {
     _ktxResourceState = WAITING_FOR_MIP_REQUEST;
 
     auto self = _self;
+    auto ticket = _processingTicket;
     auto url = _url;
-    DependencyManager::get<StatTracker>()->incrementStat("PendingProcessing");
-    QtConcurrent::run(QThreadPool::globalInstance(), [self, ktxHeaderData, ktxHighMipData, url] {
+    DependencyManager::get<TextureCache>()->_pipeline->submit(TexturePipeline::DECODE, ticket, [self, ticket, ktxHeaderData, ktxHighMipData, url] {
         PROFILE_RANGE_EX(resource_parse_image, "NetworkTexture - Processing Initial Data", 0xffff0000, 0, { { "url", url.toString() } });
-        DependencyManager::get<StatTracker>()->decrementStat("PendingProcessing");
-        CounterStat counter("Processing");
-
-        auto originalPriority = QThread::currentThread()->priority();
-        if (originalPriority == QThread::InheritPriority) {
-            originalPriority = QThread::NormalPriority;
-        }
-        QThread::currentThread()->setPriority(QThread::LowPriority);
-        Finally restorePriority([originalPriority] { QThread::currentThread()->setPriority(originalPriority); });
 
         auto resource = self.lock();
         if (!resource) {
@@ -688,20 +665,14 @@ void NetworkTexture::handleFinishedInitialLoad() {
 
         if (!ktx::checkIdentifier(header->identifier)) {
             qWarning() << "Cannot load " << url << ", invalid header identifier";
-            QMetaObject::invokeMethod(resource.data(), "setImage",
-                Q_ARG(gpu::TexturePointer, nullptr),
-                Q_ARG(int, 0),
-                Q_ARG(int, 0));
+            handOffImage(self, ticket, nullptr);
             return;
         }
 
         auto kvSize = header->bytesOfKeyValueData;
         if (kvSize > (ktxHeaderData.size() - ktx::KTX_HEADER_SIZE)) {
             qWarning() << "Cannot load " << url << ", did not receive all kv data with initial request";
-            QMetaObject::invokeMethod(resource.data(), "setImage",
-                Q_ARG(gpu::TexturePointer, nullptr),
-                Q_ARG(int, 0),
-                Q_ARG(int, 0));
+            handOffImage(self, ticket, nullptr);
             return;
         }
 
@@ -710,15 +681,19 @@ void NetworkTexture::handleFinishedInitialLoad() {
         auto imageDescriptors = header->generateImageDescriptors();
         if (imageDescriptors.size() == 0) {
             qWarning(networking) << "Failed to process ktx file " << url;
-            QMetaObject::invokeMethod(resource.data(), "setImage",
-                Q_ARG(gpu::TexturePointer, nullptr),
-                Q_ARG(int, 0),
-                Q_ARG(int, 0));
+            handOffImage(self, ticket, nullptr);
             return;
         }
-        auto originalKtxDescriptor = new ktx::KTXDescriptor(*header, keyValues, imageDescriptors);
-        QMetaObject::invokeMethod(resource.data(), "setOriginalDescriptor",
-            Q_ARG(ktx::KTXDescriptor*, originalKtxDescriptor));
+        auto originalKtxDescriptor = std::make_shared<ktx::KTXDescriptor>(*header, keyValues, imageDescriptors);
+
+        // The original descriptor is handed off along with the texture, as the mip requests that follow need it
+        auto handOffKtx = [self, ticket, originalKtxDescriptor](const gpu::TexturePointer& texture) {
+            handOff(self, ticket, [originalKtxDescriptor, texture](NetworkTexture& networkTexture) {
+                networkTexture._originalKtxDescriptor.reset(new ktx::KTXDescriptor(*originalKtxDescriptor));
+                networkTexture.setImage(texture, texture->getWidth(), texture->getHeight());
+                networkTexture.startRequestForNextMipLevel();
+            });
+        };
 
         // Create bare ktx in memory
         auto found = std::find_if(keyValues.begin(), keyValues.end(), [](const ktx::KeyValue& val) -> bool {
@@ -728,10 +703,7 @@ void NetworkTexture::handleFinishedInitialLoad() {
         std::string hash;
         if (found == keyValues.end() || found->_value.size() != gpu::SOURCE_HASH_BYTES) {
             qWarning("Invalid source hash key found, bailing");
-            QMetaObject::invokeMethod(resource.data(), "setImage",
-                Q_ARG(gpu::TexturePointer, nullptr),
-                Q_ARG(int, 0),
-                Q_ARG(int, 0));
+            handOffImage(self, ticket, nullptr);
             return;
         } else {
             // at this point the source hash is in binary 16-byte form
@@ -754,35 +726,40 @@ void NetworkTexture::handleFinishedInitialLoad() {
             }
         }
 
-        if (!texture) {
+        if (texture) {
+            handOffKtx(texture);
+            return;
+        }
+
+        std::shared_ptr<ktx::KTX> memKtx = ktx::KTX::createBare(*header, keyValues);
+        if (!memKtx) {
+            qWarning() << " Ktx could not be created, bailing";
+            handOffImage(self, ticket, nullptr);
+            return;
+        }
 
-            auto memKtx = ktx::KTX::createBare(*header, keyValues);
-            if (!memKtx) {
-                qWarning() << " Ktx could not be created, bailing";
-                QMetaObject::invokeMethod(resource.data(), "setImage",
-                    Q_ARG(gpu::TexturePointer, nullptr),
-                    Q_ARG(int, 0),
-                    Q_ARG(int, 0));
+        // Move ktx to file
+        textureCache->_pipeline->submit(TexturePipeline::WRITE, ticket, [self, ticket, memKtx, ktxHighMipData, originalKtxDescriptor, filename, url, handOffKtx] {
+            PROFILE_RANGE_EX(resource_parse_image, "NetworkTexture - Writing Initial Data", 0xffff0000, 0, { { "url", url.toString() } });
+
+            auto textureCache = DependencyManager::get<TextureCache>();
+            if (!textureCache || !self.lock()) {
                 return;
             }
 
-            // Move ktx to file
             const char* data = reinterpret_cast<const char*>(memKtx->_storage->data());
             size_t length = memKtx->_storage->size();
             cache::FilePointer file;
             auto& ktxCache = textureCache->_ktxCache;
-            if (!memKtx || !(file = ktxCache->writeFile(data, KTXCache::Metadata(filename, length)))) {
+            if (!(file = ktxCache->writeFile(data, KTXCache::Metadata(filename, length)))) {
                 qCWarning(modelnetworking) << url << " failed to write cache file";
-                QMetaObject::invokeMethod(resource.data(), "setImage",
-                    Q_ARG(gpu::TexturePointer, nullptr),
-                    Q_ARG(int, 0),
-                    Q_ARG(int, 0));
+                handOffImage(self, ticket, nullptr);
                 return;
             }
 
             auto newKtxDescriptor = memKtx->toDescriptor();
 
-            texture = gpu::Texture::build(newKtxDescriptor);
+            auto texture = gpu::Texture::build(newKtxDescriptor);
             texture->setKtxBacking(file);
             texture->setSource(filename);
 
@@ -806,14 +783,47 @@ void NetworkTexture::handleFinishedInitialLoad() {
             // images with the same hash being loaded concurrently.  Only one of them will make it into the cache by hash first and will
             // be the winner
             texture = textureCache->cacheTextureByHash(filename, texture);
-        }
 
-        QMetaObject::invokeMethod(resource.data(), "setImage",
-            Q_ARG(gpu::TexturePointer, texture),
-            Q_ARG(int, texture->getWidth()),
-            Q_ARG(int, texture->getHeight()));
+            handOffKtx(texture);
+        });
+    });
+}
+
+void NetworkTexture::cancelProcessing() {
+    auto textureCache = DependencyManager::get<TextureCache>();
+    if (textureCache) {
+        textureCache->_pipeline->cancel(_processingTicket);
+    } else {
+        // the pipeline went with the cache, so there is no one left to wake
+        _processingTicket->canceled = true;
+    }
+}
+
+void NetworkTexture::handOff(const QWeakPointer<Resource>& self, const TexturePipeline::TicketPointer& ticket,
+                             std::function<void(NetworkTexture&)> work) {
+    auto textureCache = DependencyManager::get<TextureCache>();
+    if (!textureCache) {
+        return;
+    }
+    textureCache->_pipeline->submit(TexturePipeline::HANDOFF, ticket, [self, work] {
+        auto resource = self.lock();
+        if (resource) {
+            work(*resource.staticCast<NetworkTexture>());
+        }
+    });
+}
 
-        QMetaObject::invokeMethod(resource.data(), "startRequestForNextMipLevel");
+void NetworkTexture::handOffImage(const QWeakPointer<Resource>& self, const TexturePipeline::TicketPointer& ticket,
+                                  const gpu::TexturePointer& texture, bool requestNextMipLevel) {
+    handOff(self, ticket, [texture, requestNextMipLevel](NetworkTexture& networkTexture) {
+        if (texture) {
+            networkTexture.setImage(texture, texture->getWidth(), texture->getHeight());
+        } else {
+            networkTexture.setImage(texture, 0, 0);
+        }
+        if (requestNextMipLevel) {
+            networkTexture.startRequestForNextMipLevel();
+        }
     });
 }
 
@@ -827,7 +837,10 @@ void NetworkTexture::loadContent(const QByteArray& content) {
         return;
     }
 
-    QThreadPool::globalInstance()->start(new ImageReader(_self, _url, content, _maxNumPixels));
+    auto reader = std::make_shared<ImageReader>(_self, _processingTicket, _url, content, _maxNumPixels);
+    DependencyManager::get<TextureCache>()->_pipeline->submit(TexturePipeline::DECODE, _processingTicket, [reader] {
+        reader->run();
+    });
 }
 
 void NetworkTexture::refresh() {
@@ -848,17 +861,38 @@ void NetworkTexture::refresh() {
         TextureCache::requestCompleted(_self);
     }
 
+    // Drop the processing of the previous content
+    cancelProcessing();
+    _processingTicket = std::make_shared<TexturePipeline::Ticket>();
+    _processingTicket->priority = getLoadPriority();
+
     _ktxResourceState = PENDING_INITIAL_LOAD;
     Resource::refresh();
 }
 
-ImageReader::ImageReader(const QWeakPointer<Resource>& resource, const QUrl& url, const QByteArray& data, int maxNumPixels) :
+void NetworkTexture::setLoadPriority(const QPointer<QObject>& owner, float priority) {
+    Resource::setLoadPriority(owner, priority);
+    _processingTicket->priority = getLoadPriority();
+}
+
+void NetworkTexture::setLoadPriorities(const QHash<QPointer<QObject>, float>& priorities) {
+    Resource::setLoadPriorities(priorities);
+    _processingTicket->priority = getLoadPriority();
+}
+
+void NetworkTexture::clearLoadPriority(const QPointer<QObject>& owner) {
+    Resource::clearLoadPriority(owner);
+    _processingTicket->priority = getLoadPriority();
+}
+
+ImageReader::ImageReader(const QWeakPointer<Resource>& resource, const TexturePipeline::TicketPointer& ticket, const QUrl& url,
+                         const QByteArray& data, int maxNumPixels) :
     _resource(resource),
+    _ticket(ticket),
     _url(url),
     _content(data),
     _maxNumPixels(maxNumPixels)
 {
-    DependencyManager::get<StatTracker>()->incrementStat("PendingProcessing");
     listSupportedImageFormats();
 
 #if DEBUG_DUMP_TEXTURE_LOADS
@@ -891,16 +925,6 @@ void ImageReader::listSupportedImageFormats() {
 
 void ImageReader::run() {
     PROFILE_RANGE_EX(resource_parse_image, __FUNCTION__, 0xffff0000, 0, { { "url", _url.toString() } });
-    DependencyManager::get<StatTracker>()->decrementStat("PendingProcessing");
-    CounterStat counter("Processing");
-
-    auto originalPriority = QThread::currentThread()->priority();
-    if (originalPriority == QThread::InheritPriority) {
-        originalPriority = QThread::NormalPriority;
-    }
-    QThread::currentThread()->setPriority(QThread::LowPriority);
-    Finally restorePriority([originalPriority] { QThread::currentThread()->setPriority(originalPriority); });
-
     read();
 }
 
@@ -942,10 +966,7 @@ void ImageReader::read() {
         // If we found the texture either because it's in use or via KTX deserialization,
         // set the image and return immediately.
         if (texture) {
-            QMetaObject::invokeMethod(resource.data(), "setImage",
-                                      Q_ARG(gpu::TexturePointer, texture),
-                                      Q_ARG(int, texture->getWidth()),
-                                      Q_ARG(int, texture->getHeight()));
+            NetworkTexture::handOffImage(_resource, _ticket, texture);
             return;
         }
     }
@@ -960,10 +981,7 @@ void ImageReader::read() {
 
         if (!texture) {
             qCWarning(modelnetworking) << "Could not process:" << _url;
-            QMetaObject::invokeMethod(resource.data(), "setImage",
-                                      Q_ARG(gpu::TexturePointer, texture),
-                                      Q_ARG(int, 0),
-                                      Q_ARG(int, 0));
+            NetworkTexture::handOffImage(_resource, _ticket, texture);
             return;
         }
 
@@ -971,35 +989,49 @@ void ImageReader::read() {
         texture->setFallbackTexture(networkTexture->getFallbackTexture());
     }
 
-    // Save the image into a KTXFile
-    if (texture && textureCache) {
-        auto memKtx = gpu::Texture::serialize(*texture);
+    // Save the image into a KTXFile, leaving the decoding workers to the next image
+    if (textureCache) {
+        auto self = _resource;
+        auto ticket = _ticket;
+        auto url = _url;
+        textureCache->_pipeline->submit(TexturePipeline::WRITE, ticket, [self, ticket, url, hash, texture] {
+            write(self, ticket, url, hash, texture);
+        });
+    }
+}
+
+void ImageReader::write(const QWeakPointer<Resource>& resource, const TexturePipeline::TicketPointer& ticket, const QUrl& url,
+                        const std::string& hash, gpu::TexturePointer texture) {
+    PROFILE_RANGE_EX(resource_parse_image, __FUNCTION__, 0xffff0000, 0, { { "url", url.toString() } });
 
-        // Move the texture into a memory mapped file
-        if (memKtx) {
-            const char* data = reinterpret_cast<const char*>(memKtx->_storage->data());
-            size_t length = memKtx->_storage->size();
-            auto& ktxCache = textureCache->_ktxCache;
-            auto file = ktxCache->writeFile(data, KTXCache::Metadata(hash, length));
-            if (!file) {
-                qCWarning(modelnetworking) << _url << "file cache failed";
-            } else {
-                texture->setKtxBacking(file);
-            }
+    auto textureCache = DependencyManager::get<TextureCache>();
+    if (!textureCache || !resource.lock()) {
+        return;
+    }
+
+    auto memKtx = gpu::Texture::serialize(*texture);
+
+    // Move the texture into a memory mapped file
+    if (memKtx) {
+        const char* data = reinterpret_cast<const char*>(memKtx->_storage->data());
+        size_t length = memKtx->_storage->size();
+        auto& ktxCache = textureCache->_ktxCache;
+        auto file = ktxCache->writeFile(data, KTXCache::Metadata(hash, length));
+        if (!file) {
+            qCWarning(modelnetworking) << url << "file cache failed";
         } else {
-            qCWarning(modelnetworking) << "Unable to serialize texture to KTX " << _url;
+            texture->setKtxBacking(file);
         }
-
-        // We replace the texture with the one stored in the cache.  This deals with the possible race condition of two different
-        // images with the same hash being loaded concurrently.  Only one of them will make it into the cache by hash first and will
-        // be the winner
-        texture = textureCache->cacheTextureByHash(hash, texture);
+    } else {
+        qCWarning(modelnetworking) << "Unable to serialize texture to KTX " << url;
     }
 
-    QMetaObject::invokeMethod(resource.data(), "setImage",
-                                Q_ARG(gpu::TexturePointer, texture),
-                                Q_ARG(int, texture->getWidth()),
-                                Q_ARG(int, texture->getHeight()));
+    // We replace the texture with the one stored in the cache.  This deals with the possible race condition of two different
+    // images with the same hash being loaded concurrently.  Only one of them will make it into the cache by hash first and will
+    // be the winner
+    texture = textureCache->cacheTextureByHash(hash, texture);
+
+    NetworkTexture::handOffImage(resource, ticket, texture);
 }
 
 NetworkTexturePointer TextureCache::getResourceTexture(QUrl resourceTextureUrl) {
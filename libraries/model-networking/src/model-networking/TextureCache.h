@@ -26,6 +26,7 @@
 #include <ktx/KTX.h>
 
 #include "KTXCache.h"
+#include "TexturePipeline.h"
 
 namespace gpu {
 class Batch;
@@ -59,6 +60,10 @@ public:
 
     void refresh() override;
 
+    void setLoadPriority(const QPointer<QObject>& owner, float priority) override;
+    void setLoadPriorities(const QHash<QPointer<QObject>, float>& priorities) override;
+    void clearLoadPriority(const QPointer<QObject>& owner) override;
+
     Q_INVOKABLE void setOriginalDescriptor(ktx::KTXDescriptor* descriptor) { _originalKtxDescriptor.reset(descriptor); }
 
 signals:
@@ -85,7 +90,16 @@ protected:
     void startMipRangeRequest(uint16_t low, uint16_t high);
     void handleFinishedInitialLoad();
 
+    // Runs work on the texture's thread through the texture pipeline, unless the texture is gone by then
+    static void handOff(const QWeakPointer<Resource>& self, const TexturePipeline::TicketPointer& ticket,
+        std::function<void(NetworkTexture&)> work);
+    static void handOffImage(const QWeakPointer<Resource>& self, const TexturePipeline::TicketPointer& ticket,
+        const gpu::TexturePointer& texture, bool requestNextMipLevel = false);
+
 private:
+    // Drops the work queued for the current processing ticket
+    void cancelProcessing();
+
     friend class KTXReader;
     friend class ImageReader;
 
@@ -128,6 +142,9 @@ private:
     int _height { 0 };
     int _maxNumPixels { ABSOLUTE_MAX_TEXTURE_NUM_PIXELS };
 
+    // Shared with the work queued in the texture pipeline, which is dropped once the texture is released or refreshed
+    TexturePipeline::TicketPointer _processingTicket { std::make_shared<TexturePipeline::Ticket>() };
+
     friend class TextureCache;
 };
 
@@ -173,6 +190,9 @@ public:
     const gpu::FramebufferPointer& getSpectatorCameraFramebuffer(int width, int height);
     void updateSpectatorCameraNetworkTexture();
 
+    /// Returns the queue depths, throughput and latencies of the texture processing stages.
+    Q_INVOKABLE QVariantMap getProcessingStats() const { return _pipeline->getStats(); }
+
     static const int DEFAULT_SPECTATOR_CAM_WIDTH { 2048 };
     static const int DEFAULT_SPECTATOR_CAM_HEIGHT { 1024 };
 
@@ -198,6 +218,8 @@ private:
     static const std::string KTX_EXT;
 
     std::shared_ptr<cache::FileCache> _ktxCache { std::make_shared<KTXCache>(KTX_DIRNAME, KTX_EXT) };
+    // Destroyed before the KTX cache, as its workers write to it
+    std::unique_ptr<TexturePipeline> _pipeline { new TexturePipeline() };
     // Map from image hashes to texture weak pointers
     std::unordered_map<std::string, std::weak_ptr<gpu::Texture>> _texturesByHashes;
     std::mutex _texturesByHashesMutex;
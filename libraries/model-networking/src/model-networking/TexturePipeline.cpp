@@ -0,0 +1,269 @@
+//
+//  TexturePipeline.cpp
+//  libraries/model-networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TexturePipeline.h"
+
+#include <algorithm>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <StatTracker.h>
+
+// How much work may wait in each stage before the stages feeding it wait for room.  Decoded images
+// waiting to be written are large, so only a few are let through at a time.
+static const size_t DECODE_CAPACITY { 64 };
+static const size_t WRITE_CAPACITY { 4 };
+static const size_t HANDOFF_CAPACITY { 16 };
+
+// Cache files are written one at a time
+static const int MAX_WRITE_WORKERS { 1 };
+
+// Handoffs run on the pipeline's thread in small batches, so they don't hold up its event loop
+static const int MAX_HANDOFFS_PER_RUN { 8 };
+
+class TexturePipelineWorker : public QRunnable {
+public:
+    TexturePipelineWorker(TexturePipeline& pipeline, TexturePipeline::Stage stage) : _pipeline(pipeline), _stage(stage) {}
+
+    void run() override {
+        // The pool threads only ever run texture work, so their priority is set once rather than per task
+        QThread::currentThread()->setPriority(QThread::LowPriority);
+        _pipeline.runWorker(_stage);
+    }
+
+private:
+    TexturePipeline& _pipeline;
+    const TexturePipeline::Stage _stage;
+};
+
+TexturePipeline::TexturePipeline(QObject* parent) : QObject(parent) {
+    _stages[DECODE].capacity = DECODE_CAPACITY;
+    _stages[DECODE].maxWorkers = std::max(1, QThread::idealThreadCount() - 1);
+    _stages[WRITE].capacity = WRITE_CAPACITY;
+    _stages[WRITE].maxWorkers = MAX_WRITE_WORKERS;
+    _stages[HANDOFF].capacity = HANDOFF_CAPACITY;
+
+    for (int i = 0; i < HANDOFF; ++i) {
+        auto& stage = _stages[i];
+        stage.pool.reset(new QThreadPool());
+        stage.pool->setObjectName(QString("TexturePipeline ") + getStageName((Stage)i));
+        stage.pool->setMaxThreadCount(stage.maxWorkers);
+    }
+}
+
+TexturePipeline::~TexturePipeline() {
+    _stopping = true;
+
+    // Drop whatever is queued, and release the workers waiting for room
+    for (int i = 0; i < NUM_STAGES; ++i) {
+        auto& state = _stages[i];
+        size_t numDropped = 0;
+        {
+            std::unique_lock<std::mutex> lock(state.mutex);
+            numDropped = state.tasks.size();
+            state.canceled += numDropped;
+            state.tasks.clear();
+        }
+        state.hasRoom.notify_all();
+        if (i != HANDOFF) {
+            for (size_t j = 0; j < numDropped; ++j) {
+                DependencyManager::get<StatTracker>()->decrementStat("PendingProcessing");
+            }
+        }
+    }
+
+    for (auto& state : _stages) {
+        if (state.pool) {
+            state.pool->waitForDone();
+        }
+    }
+}
+
+const char* TexturePipeline::getStageName(Stage stage) {
+    switch (stage) {
+        case DECODE:
+            return "decode";
+        case WRITE:
+            return "write";
+        case HANDOFF:
+            return "handoff";
+        default:
+            return "unknown";
+    }
+}
+
+void TexturePipeline::submit(Stage stage, const TicketPointer& ticket, Work work) {
+    if (_stopping || ticket->canceled) {
+        return;
+    }
+
+    auto& state = _stages[stage];
+    bool startWorker = false;
+    bool scheduleHandoffs = false;
+    {
+        std::unique_lock<std::mutex> lock(state.mutex);
+        if (QThread::currentThread() != thread()) {
+            state.hasRoom.wait(lock, [&] {
+                return _stopping || ticket->canceled || state.tasks.size() < state.capacity;
+            });
+            if (_stopping || ticket->canceled) {
+                return;
+            }
+        }
+
+        if (stage != HANDOFF) {
+            DependencyManager::get<StatTracker>()->incrementStat("PendingProcessing");
+        }
+        state.tasks.push_back({ ticket, std::move(work), usecTimestampNow() });
+        state.peakDepth = std::max(state.peakDepth, state.tasks.size());
+
+        if (stage == HANDOFF) {
+            scheduleHandoffs = !state.isScheduled;
+            state.isScheduled = true;
+        } else if (state.numWorkers < state.maxWorkers) {
+            ++state.numWorkers;
+            startWorker = true;
+        }
+    }
+
+    if (startWorker) {
+        state.pool->start(new TexturePipelineWorker(*this, stage));
+    }
+    if (scheduleHandoffs) {
+        QMetaObject::invokeMethod(this, "runHandoffs", Qt::QueuedConnection);
+    }
+}
+
+void TexturePipeline::cancel(const TicketPointer& ticket) {
+    // Set under each stage's lock, so a submitter can't miss it between checking for room and waiting
+    for (auto& state : _stages) {
+        {
+            std::unique_lock<std::mutex> lock(state.mutex);
+            ticket->canceled = true;
+        }
+        state.hasRoom.notify_all();
+    }
+}
+
+bool TexturePipeline::takeTask(Stage stage, Task& task) {
+    auto& state = _stages[stage];
+    size_t numCanceled = 0;
+    bool found = false;
+    {
+        std::unique_lock<std::mutex> lock(state.mutex);
+
+        // Priorities change while the work is queued, so the queue is searched rather than kept sorted
+        auto best = state.tasks.end();
+        for (auto it = state.tasks.begin(); it != state.tasks.end();) {
+            if (it->ticket->canceled) {
+                it = state.tasks.erase(it);
+                ++numCanceled;
+                continue;
+            }
+            if (best == state.tasks.end() || it->ticket->priority > best->ticket->priority) {
+                best = it;
+            }
+            ++it;
+        }
+
+        if (best != state.tasks.end()) {
+            task = std::move(*best);
+            state.tasks.erase(best);
+            found = true;
+        }
+        state.canceled += numCanceled;
+    }
+
+    if (numCanceled > 0 || found) {
+        state.hasRoom.notify_all();
+    }
+    if (stage != HANDOFF) {
+        for (size_t i = 0; i < numCanceled + (found ? 1 : 0); ++i) {
+            DependencyManager::get<StatTracker>()->decrementStat("PendingProcessing");
+        }
+    }
+    return found;
+}
+
+void TexturePipeline::runTask(Stage stage, Task& task) {
+    auto start = usecTimestampNow();
+    if (stage == HANDOFF) {
+        task.work();
+    } else {
+        CounterStat counter("Processing");
+        task.work();
+    }
+    auto end = usecTimestampNow();
+
+    auto& state = _stages[stage];
+    std::unique_lock<std::mutex> lock(state.mutex);
+    ++state.completed;
+    state.totalWaitUsecs += start - task.queuedAt;
+    state.totalRunUsecs += end - start;
+}
+
+void TexturePipeline::runWorker(Stage stage) {
+    auto& state = _stages[stage];
+    Task task;
+    while (true) {
+        if (takeTask(stage, task)) {
+            runTask(stage, task);
+            task = Task();
+            continue;
+        }
+
+        // Only leave once nothing was queued since, as it would otherwise wait for the next submission
+        std::unique_lock<std::mutex> lock(state.mutex);
+        if (_stopping || state.tasks.empty()) {
+            --state.numWorkers;
+            return;
+        }
+    }
+}
+
+void TexturePipeline::runHandoffs() {
+    Task task;
+    for (int i = 0; i < MAX_HANDOFFS_PER_RUN && takeTask(HANDOFF, task); ++i) {
+        runTask(HANDOFF, task);
+        task = Task();
+    }
+
+    auto& state = _stages[HANDOFF];
+    bool reschedule = false;
+    {
+        std::unique_lock<std::mutex> lock(state.mutex);
+        reschedule = !state.tasks.empty();
+        state.isScheduled = reschedule;
+    }
+    if (reschedule) {
+        QMetaObject::invokeMethod(this, "runHandoffs", Qt::QueuedConnection);
+    }
+}
+
+QVariantMap TexturePipeline::getStats() const {
+    QVariantMap result;
+    for (int i = 0; i < NUM_STAGES; ++i) {
+        const auto& state = _stages[i];
+        QVariantMap stats;
+        std::unique_lock<std::mutex> lock(state.mutex);
+        stats["queueDepth"] = (int)state.tasks.size();
+        stats["peakQueueDepth"] = (int)state.peakDepth;
+        stats["completed"] = (qulonglong)state.completed;
+        stats["canceled"] = (qulonglong)state.canceled;
+        stats["averageWaitMsecs"] = state.completed ? (double)state.totalWaitUsecs / state.completed / USECS_PER_MSEC : 0.0;
+        stats["averageRunMsecs"] = state.completed ? (double)state.totalRunUsecs / state.completed / USECS_PER_MSEC : 0.0;
+        result[getStageName((Stage)i)] = stats;
+    }
+    return result;
+}
@@ -0,0 +1,99 @@
+//
+//  TexturePipeline.h
+//  libraries/model-networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TexturePipeline_h
+#define hifi_TexturePipeline_h
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtCore/QVariantMap>
+
+class QThreadPool;
+
+/// The stages a downloaded texture goes through before the renderer gets it: decoding the image (or the KTX header),
+/// writing the KTX cache file (or a streamed mip into it), and handing the texture off on the cache's thread.
+/// Each stage has its own workers and queue, and always runs the queued work of the most important texture first.
+class TexturePipeline : public QObject {
+    Q_OBJECT
+public:
+    enum Stage {
+        DECODE = 0,
+        WRITE,
+        HANDOFF, // runs on the pipeline's thread
+        NUM_STAGES
+    };
+
+    /// Shared by a texture and all of its queued work
+    struct Ticket {
+        std::atomic<float> priority { 0.0f };
+        std::atomic<bool> canceled { false };
+    };
+    using TicketPointer = std::shared_ptr<Ticket>;
+    using Work = std::function<void()>;
+
+    TexturePipeline(QObject* parent = nullptr);
+    ~TexturePipeline();
+
+    /// Queue work for a stage.  Work for a canceled ticket is dropped, whether it is submitted or still queued.
+    /// Submitting to a full stage waits for room, unless done from the pipeline's own thread, which never blocks.
+    void submit(Stage stage, const TicketPointer& ticket, Work work);
+
+    /// Cancel a ticket's queued and future work, and wake whoever is waiting for room to submit it
+    void cancel(const TicketPointer& ticket);
+
+    /// Per stage queue depth, peak queue depth, completed and canceled work, and average wait and run times
+    QVariantMap getStats() const;
+
+    static const char* getStageName(Stage stage);
+
+private:
+    struct Task {
+        TicketPointer ticket;
+        Work work;
+        quint64 queuedAt;
+    };
+
+    struct StageState {
+        std::unique_ptr<QThreadPool> pool;
+        mutable std::mutex mutex;
+        std::condition_variable hasRoom;
+        std::vector<Task> tasks;
+        size_t capacity { 0 };
+        int maxWorkers { 0 };
+        int numWorkers { 0 };
+        bool isScheduled { false };
+
+        size_t peakDepth { 0 };
+        size_t completed { 0 };
+        size_t canceled { 0 };
+        quint64 totalWaitUsecs { 0 };
+        quint64 totalRunUsecs { 0 };
+    };
+
+    friend class TexturePipelineWorker;
+
+    // Returns false once the stage has nothing left to run
+    bool takeTask(Stage stage, Task& task);
+    void runTask(Stage stage, Task& task);
+    void runWorker(Stage stage);
+    Q_INVOKABLE void runHandoffs();
+
+    std::array<StageState, NUM_STAGES> _stages;
+    std::atomic<bool> _stopping { false };
+};
+
+#endif // hifi_TexturePipeline_h
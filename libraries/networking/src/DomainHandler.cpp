@@ -97,6 +97,7 @@ void DomainHandler::softReset() {
     
     clearSettings();
 
+    _connectionSecret = QUuid();
     _connectionDenialsSinceKeypairRegen = 0;
 
     // cancel the failure timeout for any pending requests for settings
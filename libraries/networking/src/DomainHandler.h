@@ -55,6 +55,10 @@ public:
 
     const QUuid& getConnectionToken() const { return _connectionToken; }
     void setConnectionToken(const QUuid& connectionToken) { _connectionToken = connectionToken; }
+
+    // the secret the domain-server signs the sourced packets it sends us with
+    const QUuid& getConnectionSecret() const { return _connectionSecret; }
+    void setConnectionSecret(const QUuid& connectionSecret) { _connectionSecret = connectionSecret; }
     
     const QUuid& getAssignmentUUID() const { return _assignmentUUID; }
     void setAssignmentUUID(const QUuid& assignmentUUID) { _assignmentUUID = assignmentUUID; }
@@ -135,6 +139,7 @@ private:
     HifiSockAddr _sockAddr;
     QUuid _assignmentUUID;
     QUuid _connectionToken;
+    QUuid _connectionSecret;
     QUuid _pendingDomainID; // ID of domain being connected to, via ICE or direct connection
     QUuid _iceClientID;
     HifiSockAddr _iceServerSockAddr;
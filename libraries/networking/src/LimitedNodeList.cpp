@@ -341,6 +341,11 @@ bool LimitedNodeList::packetSourceAndHashMatchAndTrackBandwidth(const udt::Packe
 
             return true;
 
+        } else if (isVerifiedDomainServerPacket(packet, sourceID)) {
+            emit dataReceived(NodeType::DomainServer, packet.getPayloadSize());
+
+            return true;
+
         } else {
             static const QString UNKNOWN_REGEX = "Packet of type \\d+ \\([\\sa-zA-Z:]+\\) received from unknown node with UUID";
             static QString repeatedMessage
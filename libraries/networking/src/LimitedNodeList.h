@@ -365,6 +365,8 @@ protected:
     void setLocalSocket(const HifiSockAddr& sockAddr);
 
     bool packetSourceAndHashMatchAndTrackBandwidth(const udt::Packet& packet, Node* sourceNode = nullptr);
+    // the domain-server isn't in our node list, so sourced packets from it are checked here instead
+    virtual bool isVerifiedDomainServerPacket(const udt::Packet& packet, const QUuid& sourceID) { return false; }
     void processSTUNResponse(std::unique_ptr<udt::BasePacket> packet);
 
     void handleNodeKill(const SharedNodePointer& node);
@@ -624,6 +624,11 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     packetStream >> newPermissions;
     setPermissions(newPermissions);
 
+    // pull the secret the domain-server will sign its sourced packets to us with
+    QUuid domainConnectionSecret;
+    packetStream >> domainConnectionSecret;
+    _domainHandler.setConnectionSecret(domainConnectionSecret);
+
     // pull each node in the packet
     while (packetStream.device()->pos() < message->getSize()) {
         parseNodeFromPacketStream(packetStream);
@@ -786,6 +791,16 @@ bool NodeList::sockAddrBelongsToDomainOrNode(const HifiSockAddr& sockAddr) {
     return _domainHandler.getSockAddr() == sockAddr || LimitedNodeList::sockAddrBelongsToNode(sockAddr);
 }
 
+bool NodeList::isVerifiedDomainServerPacket(const udt::Packet& packet, const QUuid& sourceID) {
+    const QUuid& connectionSecret = _domainHandler.getConnectionSecret();
+    if (!_domainHandler.isConnected() || connectionSecret.isNull() || sourceID != _domainHandler.getUUID()
+        || packet.getSenderSockAddr() != _domainHandler.getSockAddr()) {
+        return false;
+    }
+
+    return NLPacket::verificationHashInHeader(packet) == NLPacket::hashForPacketAndSecret(packet, connectionSecret);
+}
+
 void NodeList::ignoreNodesInRadius(bool enabled) {
     bool isEnabledChange = _ignoreRadiusEnabled.get() != enabled;
     _ignoreRadiusEnabled.set(enabled);
@@ -158,6 +158,8 @@ private:
 
     bool sockAddrBelongsToDomainOrNode(const HifiSockAddr& sockAddr);
 
+    bool isVerifiedDomainServerPacket(const udt::Packet& packet, const QUuid& sourceID) override;
+
     std::atomic<NodeType_t> _ownerType;
     NodeSet _nodeTypesOfInterest;
     DomainHandler _domainHandler;
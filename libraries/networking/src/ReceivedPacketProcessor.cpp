@@ -26,7 +26,7 @@ void ReceivedPacketProcessor::terminating() {
 
 void ReceivedPacketProcessor::queueReceivedPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     lock();
-    _packets.push_back({ sendingNode, message });
+    _packets.push_back({ sendingNode, message, usecTimestampNow() });
     _nodePacketCounts[sendingNode->getUUID()]++;
     _lastWindowIncomingPackets++;
     unlock();
@@ -66,19 +66,15 @@ bool ReceivedPacketProcessor::process() {
     }
 
     lock();
-    std::list<NodeSharedReceivedMessagePair> currentPackets;
+    std::list<QueuedPacket> currentPackets;
     currentPackets.swap(_packets);
     unlock();
 
-    for(auto& packetPair : currentPackets) {
-        processPacket(packetPair.second, packetPair.first);
-        _lastWindowProcessedPackets++;
-        midProcess();
-    }
+    processPackets(currentPackets);
 
     lock();
-    for(auto& packetPair : currentPackets) {
-        _nodePacketCounts[packetPair.first->getUUID()]--;
+    for(auto& packet : currentPackets) {
+        _nodePacketCounts[packet.sendingNode->getUUID()]--;
     }
     unlock();
 
@@ -86,6 +82,14 @@ bool ReceivedPacketProcessor::process() {
     return isStillRunning();  // keep running till they terminate us
 }
 
+void ReceivedPacketProcessor::processPackets(std::list<QueuedPacket>& packets) {
+    for(auto& packet : packets) {
+        processPacket(packet.message, packet.sendingNode);
+        _lastWindowProcessedPackets++;
+        midProcess();
+    }
+}
+
 void ReceivedPacketProcessor::nodeKilled(SharedNodePointer node) {
     lock();
     _nodePacketCounts.remove(node->getUUID());
@@ -62,6 +62,16 @@ protected:
     /// \param QByteArray& the packet to be processed
     virtual void processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) = 0;
 
+    struct QueuedPacket {
+        SharedNodePointer sendingNode;
+        QSharedPointer<ReceivedMessage> message;
+        quint64 queuedAt; // usecs
+    };
+
+    /// Processes the packets taken from the queue in one pass. The default calls processPacket() and midProcess() for each
+    /// packet in turn. Override this to process several packets together.
+    virtual void processPackets(std::list<QueuedPacket>& packets);
+
     /// Implements generic processing behavior for this thread.
     virtual bool process() override;
 
@@ -78,7 +88,7 @@ protected:
     virtual void postProcess() { }
 
 protected:
-    std::list<NodeSharedReceivedMessagePair> _packets;
+    std::list<QueuedPacket> _packets;
     QHash<QUuid, int> _nodePacketCounts;
 
     QWaitCondition _hasPackets;
@@ -12,10 +12,15 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
+#include <QtCore/QPointer>
+#include <QtCore/QRunnable>
 #include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <QtCore/QTimer>
 
 #include <LogHandler.h>
+#include <UUID.h>
+#include <shared/FrameTracer.h>
 
 #include "ThreadedAssignment.h"
 
@@ -88,6 +93,9 @@ void ThreadedAssignment::commonInit(const QString& targetName, NodeType_t nodeTy
 
     // stop sending stats if we disconnect
     connect(&nodeList->getDomainHandler(), &DomainHandler::disconnectedFromDomain, &_statsTimer, &QTimer::stop);
+
+    // the domain-server asks for our frame trace when someone requests it from its HTTP stats
+    nodeList->getPacketReceiver().registerListener(PacketType::NodeTraceRequest, this, "handleFrameTraceRequest");
 }
 
 void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject statsObject) {
@@ -105,6 +113,11 @@ void ThreadedAssignment::addPacketStatsAndSendStatsPacket(QJsonObject statsObjec
 
     statsObject["io_stats"] = ioStats;
 
+    QJsonObject frameTiming = FrameTracer::getInstance().takePhaseStats();
+    if (!frameTiming.isEmpty()) {
+        statsObject["frame_timing"] = frameTiming;
+    }
+
     nodeList->sendStatsToDomainServer(statsObject);
 }
 
@@ -129,6 +142,56 @@ void ThreadedAssignment::checkInWithDomainServerOrExit() {
     }
 }
 
+// builds the trace away from the assignment's thread, which is usually in the middle of a mix loop
+class FrameTraceExporter : public QRunnable {
+public:
+    FrameTraceExporter(ThreadedAssignment* assignment, const QUuid& requesterID) :
+        _assignment(assignment),
+        _requesterID(requesterID) {}
+
+    void run() override {
+        QByteArray compressedTrace = qCompress(FrameTracer::getInstance().toChromeTraceJSON());
+        if (_assignment) {
+            QMetaObject::invokeMethod(_assignment.data(), "sendFrameTrace", Qt::QueuedConnection,
+                                      Q_ARG(QUuid, _requesterID), Q_ARG(QByteArray, compressedTrace));
+        }
+    }
+
+private:
+    QPointer<ThreadedAssignment> _assignment;
+    QUuid _requesterID;
+};
+
+void ThreadedAssignment::handleFrameTraceRequest(QSharedPointer<ReceivedMessage> message) {
+    auto nodeList = DependencyManager::get<NodeList>();
+    QUuid requesterID = message->getSourceID();
+
+    // the packet was verified on the way in, so it is either from our domain-server or from a node we know
+    if (requesterID != nodeList->getDomainHandler().getUUID()) {
+        SharedNodePointer requester = nodeList->nodeWithUUID(requesterID);
+        if (!requester || !requester->getCanKick()) {
+            qCDebug(networking) << "Ignoring frame trace request from" << uuidStringWithoutCurlyBraces(requesterID)
+                << "- only the domain-server and admins may ask for one";
+            return;
+        }
+    }
+
+    QThreadPool::globalInstance()->start(new FrameTraceExporter(this, requesterID));
+}
+
+void ThreadedAssignment::sendFrameTrace(QUuid requesterID, QByteArray compressedTrace) {
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    auto tracePacketList = NLPacketList::create(PacketType::NodeTraceReply, QByteArray(), true, true);
+    tracePacketList->write(compressedTrace);
+
+    if (requesterID == nodeList->getDomainHandler().getUUID()) {
+        nodeList->sendPacketList(std::move(tracePacketList), nodeList->getDomainHandler().getSockAddr());
+    } else if (SharedNodePointer requester = nodeList->nodeWithUUID(requesterID)) {
+        nodeList->sendPacketList(std::move(tracePacketList), *requester);
+    }
+}
+
 void ThreadedAssignment::domainSettingsRequestFailed() {
     qCDebug(networking) << "Failed to retreive settings object from domain-server. Bailing on assignment.";
     setFinished(true);
@@ -53,6 +53,8 @@ protected slots:
     
 private slots:
     void checkInWithDomainServerOrExit();
+    void handleFrameTraceRequest(QSharedPointer<ReceivedMessage> message);
+    void sendFrameTrace(QUuid requesterID, QByteArray compressedTrace);
 };
 
 typedef QSharedPointer<ThreadedAssignment> SharedAssignmentPointer;
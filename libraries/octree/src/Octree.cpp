@@ -52,6 +52,7 @@
 #include "OctreeElementBag.h"
 #include "OctreeLogging.h"
 #include "OctreeQueryNode.h"
+#include "OctreeStringDictionary.h"
 #include "OctreeUtils.h"
 
 
@@ -441,6 +442,9 @@ void Octree::readBitstreamToTree(const unsigned char * bitstream, uint64_t buffe
         args.destinationElement = _rootElement;
     }
 
+    // strings are decoded by the static OctreePacketData::unpackDataFromBytes(), which finds the dictionary through this
+    OctreeStringDictionary::ReadingScope readingScope(args.stringDictionary, args.connectionID);
+
     // Keep looping through the buffer calling readElementData() this allows us to pack multiple root-relative Octal codes
     // into a single network packet. readElementData() basically goes down a tree from the root, and fills things in from there
     // if there are more bytes after that, it's assumed to be another root relative tree
@@ -34,6 +34,7 @@ class ReadBitstreamToTreeParams;
 class Octree;
 class OctreeElement;
 class OctreePacketData;
+class OctreeStringDictionary;
 class Shape;
 using OctreePointer = std::shared_ptr<Octree>;
 
@@ -178,6 +179,8 @@ public:
     PacketVersion bitstreamVersion;
     int elementsPerPacket = 0;
     int entitiesPerPacket = 0;
+    OctreeStringDictionary* stringDictionary = nullptr; // for the strings of compact packets
+    uint16_t connectionID = 0; // the query connection the compact packet was written for
 
     ReadBitstreamToTreeParams(
         bool includeExistsBits = WANT_EXISTS_BITS,
@@ -195,6 +198,13 @@ public:
     {}
 };
 
+// An inbound edit that a tree has decoded from an edit packet but not yet applied to itself
+class OctreeDecodedEdit {
+public:
+    virtual ~OctreeDecodedEdit() { }
+};
+using OctreeDecodedEditPointer = std::unique_ptr<OctreeDecodedEdit>;
+
 class Octree : public QObject, public std::enable_shared_from_this<Octree>, public ReadWriteLockable {
     Q_OBJECT
 public:
@@ -212,6 +222,14 @@ public:
     virtual bool handlesEditPacketType(PacketType packetType) const { return false; }
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& sourceNode) { return 0; }
+
+    // Trees that can decode an edit without holding their lock implement these, so that the server can decode edit
+    // packets on several threads and then apply the decoded edits in order under one write lock. Decoding returns the
+    // number of bytes read, and may leave the edit null when there is nothing to apply.
+    virtual bool canDecodeEditsConcurrently() const { return false; }
+    virtual int decodeEditPacketData(PacketType packetType, const unsigned char* editData, int maxLength,
+                                     const SharedNodePointer& sourceNode, OctreeDecodedEditPointer& edit) { return 0; }
+    virtual void applyDecodedEdit(OctreeDecodedEdit& edit, const SharedNodePointer& sourceNode) { }
     virtual void processChallengeOwnershipRequestPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
     virtual void processChallengeOwnershipReplyPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
     virtual void processChallengeOwnershipPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
@@ -301,6 +301,10 @@ void OctreeElement::deleteAllChildren() {
 }
 
 void OctreeElement::setChildAtIndex(int childIndex, const OctreeElementPointer& child) {
+    if (child) {
+        child->_parent = shared_from_this();
+    }
+
 #ifdef SIMPLE_CHILD_ARRAY
     int previousChildCount = getChildCount();
     if (child) {
@@ -123,6 +123,7 @@ public:
     void deleteChildAtIndex(int childIndex);
     OctreeElementPointer removeChildAtIndex(int childIndex);
     bool isParentOf(const OctreeElementPointer& possibleChild) const;
+    OctreeElementPointer getParent() const { return _parent.lock(); } // null for the root
 
     /// handles deletion of all descendants, returns false if delete not approved
     bool safeDeepDeleteChildAtIndex(int childIndex, int recursionCount = 0);
@@ -236,6 +237,8 @@ protected:
 
     quint64 _lastChanged; /// Client and server, timestamp this node was last changed, 8 bytes
 
+    OctreeElementWeakPointer _parent; /// Client and server, set when this node is added to its parent, 16 bytes
+
     /// Client and server, pointers to child nodes, various encodings
 #ifdef SIMPLE_CHILD_ARRAY
     OctreeElementPointer _simpleChildArray[8]; /// Only used when SIMPLE_CHILD_ARRAY is enabled
@@ -29,12 +29,13 @@ struct aaCubeData {
     float scale;
 };
 
-OctreePacketData::OctreePacketData(bool enableCompression, int targetSize) {
-    changeSettings(enableCompression, targetSize); // does reset...
+OctreePacketData::OctreePacketData(bool enableCompression, int targetSize, bool compactSections) {
+    changeSettings(enableCompression, targetSize, compactSections); // does reset...
 }
 
-void OctreePacketData::changeSettings(bool enableCompression, unsigned int targetSize) {
+void OctreePacketData::changeSettings(bool enableCompression, unsigned int targetSize, bool compactSections) {
     _enableCompression = enableCompression;
+    _compactSections = compactSections;
     _targetSize = targetSize;
     _uncompressedByteArray.resize(_targetSize);
     _compressedByteArray.resize(_targetSize);
@@ -45,9 +46,20 @@ void OctreePacketData::changeSettings(bool enableCompression, unsigned int targe
     reset();
 }
 
+void OctreePacketData::setStringDictionary(const OctreeStringDictionaryPointer& dictionary) {
+    _stringDictionary = dictionary;
+    _finalizedDictionarySize = getDictionarySize();
+    _subTreeDictionarySize = _finalizedDictionarySize;
+}
+
 void OctreePacketData::reset() {
+    if (_stringDictionary) {
+        _stringDictionary->truncate(_finalizedDictionarySize);
+    }
+
     _bytesInUse = 0;
-    _bytesAvailable = _targetSize;
+    // leave room for the encoding byte of compact sections
+    _bytesAvailable = _compactSections ? _targetSize - sizeof(OCTREE_PACKET_SECTION_ENCODING) : _targetSize;
     _bytesReserved = 0;
     _subTreeAt = 0;
     _compressedBytes = 0;
@@ -173,6 +185,7 @@ bool OctreePacketData::startSubTree(const unsigned char* octcode) {
     if (success) {
         _subTreeAt = possibleStartAt;
         _subTreeBytesReserved = _bytesReserved;
+        _subTreeDictionarySize = getDictionarySize();
     }
     if (success) {
         _bytesOfOctalCodes += length;
@@ -182,6 +195,9 @@ bool OctreePacketData::startSubTree(const unsigned char* octcode) {
 }
 
 const unsigned char* OctreePacketData::getFinalizedData() {
+    // the finalized data is what gets sent, and with it any dictionary entries it defines
+    _finalizedDictionarySize = getDictionarySize();
+
     if (!_enableCompression) {
         return &_uncompressed[0]; 
     }
@@ -229,10 +245,14 @@ void OctreePacketData::discardSubTree() {
     
     // if we discard the subtree then reset reserved bytes to the value when we started the subtree
     _bytesReserved = _subTreeBytesReserved;
+
+    if (_stringDictionary) {
+        _stringDictionary->truncate(_subTreeDictionarySize);
+    }
 }
 
 LevelDetails OctreePacketData::startLevel() {
-    LevelDetails key(_bytesInUse, _bytesOfOctalCodes, _bytesOfBitMasks, _bytesOfColor, _bytesReserved);
+    LevelDetails key(_bytesInUse, _bytesOfOctalCodes, _bytesOfBitMasks, _bytesOfColor, _bytesReserved, getDictionarySize());
     return key;
 }
 
@@ -252,6 +272,10 @@ void OctreePacketData::discardLevel(LevelDetails key) {
     _totalBytesOfBitMasks -= reduceBytesOfBitMasks;
     _totalBytesOfColor -= reduceBytesOfColor;
 
+    if (_stringDictionary) {
+        _stringDictionary->truncate(key._dictionarySize);
+    }
+
     if (_debug) {
         qCDebug(octree, "discardLevel() BEFORE _dirty=%s bytesInLevel=%d _compressedBytes=%d _bytesInUse=%d",
             debug::valueOf(_dirty), bytesInLevel, _compressedBytes, _bytesInUse);
@@ -494,6 +518,23 @@ bool OctreePacketData::appendValue(bool value) {
 }
 
 bool OctreePacketData::appendValue(const QString& string) {
+    if (_stringDictionary && string.size() >= OctreeStringDictionary::MIN_STRING_LENGTH) {
+        bool isAcknowledged = false;
+        int index = _stringDictionary->findOrAdd(string, isAcknowledged);
+        if (index >= 0) {
+            uint16_t reference = STRING_IS_DICTIONARY_REFERENCE | (uint16_t)index;
+            if (isAcknowledged) {
+                return appendValue(reference);
+            }
+            // the client may not have the entry yet, so it is defined again until it says it has
+            uint16_t definition = reference | STRING_IS_DICTIONARY_DEFINITION;
+            return appendValue(definition) && appendInlineValue(string);
+        }
+    }
+    return appendInlineValue(string);
+}
+
+bool OctreePacketData::appendInlineValue(const QString& string) {
     // TODO: make this a ByteCountCoded leading byte
     uint16_t length = string.size() + 1; // include NULL
     bool success = appendValue(length);
@@ -585,6 +626,25 @@ bool OctreePacketData::compressContent() {
     const uchar* uncompressedData = &_uncompressed[0];
     int uncompressedSize = _bytesInUse;
 
+    if (_compactSections) {
+        // zlib's header and checksum outweigh anything it could save on the smallest sections
+        const int MIN_COMPRESSIBLE_SIZE = 32;
+        QByteArray compressedData;
+        if (uncompressedSize >= MIN_COMPRESSIBLE_SIZE) {
+            compressedData = qCompress(uncompressedData, uncompressedSize, MAX_COMPRESSION);
+        }
+
+        bool isZlib = !compressedData.isEmpty() && compressedData.size() < uncompressedSize;
+        const uchar* sectionData = isZlib ? (const uchar*)compressedData.constData() : uncompressedData;
+        int sectionSize = isZlib ? compressedData.size() : uncompressedSize;
+
+        _compressed[0] = isZlib ? SECTION_IS_ZLIB : SECTION_IS_RAW;
+        memcpy(&_compressed[sizeof(OCTREE_PACKET_SECTION_ENCODING)], sectionData, sectionSize);
+        _compressedBytes = sizeof(OCTREE_PACKET_SECTION_ENCODING) + sectionSize;
+        _dirty = false;
+        return true;
+    }
+
     QByteArray compressedData = qCompress(uncompressedData, uncompressedSize, MAX_COMPRESSION);
 
     if (compressedData.size() < (int)MAX_OCTREE_PACKET_DATA_SIZE) {
@@ -600,9 +660,16 @@ bool OctreePacketData::compressContent() {
 void OctreePacketData::loadFinalizedContent(const unsigned char* data, int length) {
     reset();
 
+    bool isZlib = _enableCompression;
+    if (data && length > 0 && _compactSections) {
+        isZlib = data[0] == SECTION_IS_ZLIB;
+        data += sizeof(OCTREE_PACKET_SECTION_ENCODING);
+        length -= sizeof(OCTREE_PACKET_SECTION_ENCODING);
+    }
+
     if (data && length > 0) {
 
-        if (_enableCompression) {
+        if (isZlib) {
             _compressedBytes = length;
             memcpy(_compressed, data, _compressedBytes);
 
@@ -616,7 +683,7 @@ void OctreePacketData::loadFinalizedContent(const unsigned char* data, int lengt
                 _bytesAvailable -= uncompressedData.size();
                 memcpy(_uncompressed, uncompressedData.constData(), _bytesInUse);
             }
-        } else {
+        } else if (length <= _bytesAvailable) {
             memcpy(_uncompressed, data, length);
             memcpy(_compressed, data, length);
             _bytesInUse = _compressedBytes = length;
@@ -665,6 +732,19 @@ int OctreePacketData::unpackDataFromBytes(const unsigned char* dataBytes, QStrin
     uint16_t length;
     memcpy(&length, dataBytes, sizeof(length));
     dataBytes += sizeof(length);
+
+    OctreeStringDictionary* dictionary = OctreeStringDictionary::getReadingDictionary();
+    if (dictionary && (length & STRING_IS_DICTIONARY_REFERENCE)) {
+        int index = length & DICTIONARY_INDEX_MASK;
+        if (length & STRING_IS_DICTIONARY_DEFINITION) {
+            int bytes = sizeof(length) + unpackDataFromBytes(dataBytes, result);
+            dictionary->define(index, result, OctreeStringDictionary::getReadingConnectionID());
+            return bytes;
+        }
+        dictionary->lookup(index, result, OctreeStringDictionary::getReadingConnectionID());
+        return sizeof(length);
+    }
+
     QString value((const char*)dataBytes);
     result = value;
     return sizeof(length) + length;
@@ -36,6 +36,7 @@
 
 #include "OctreeConstants.h"
 #include "OctreeElement.h"
+#include "OctreeStringDictionary.h"
 
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
@@ -44,6 +45,7 @@ typedef uint16_t OCTREE_PACKET_SEQUENCE;
 const uint16_t MAX_OCTREE_PACKET_SEQUENCE = 65535;
 typedef quint64 OCTREE_PACKET_SENT_TIME;
 typedef uint16_t OCTREE_PACKET_INTERNAL_SECTION_SIZE;
+typedef uint16_t OCTREE_PACKET_CONNECTION_ID; // follows the sent time in compact packets only
 const int MAX_OCTREE_PACKET_SIZE = udt::MAX_PACKET_SIZE;
 
 const unsigned int OCTREE_PACKET_EXTRA_HEADERS_SIZE = sizeof(OCTREE_PACKET_FLAGS)
@@ -59,15 +61,30 @@ const int REASONABLE_NUMBER_OF_PACKING_ATTEMPTS = 5;
 
 const int PACKET_IS_COLOR_BIT = 0;
 const int PACKET_IS_COMPRESSED_BIT = 1;
+const int PACKET_IS_COMPACT_BIT = 2; // only sent to clients that asked for it in their query
+
+// Each section of a compact packet starts with a byte saying how the rest of it is encoded, so sections that zlib
+// would not make any smaller are sent as they are
+typedef uint8_t OCTREE_PACKET_SECTION_ENCODING;
+const OCTREE_PACKET_SECTION_ENCODING SECTION_IS_RAW = 0;
+const OCTREE_PACKET_SECTION_ENCODING SECTION_IS_ZLIB = 1;
+
+// In compact packets, the length leading a string may instead be a reference to an entry of the connection's string
+// dictionary, which is followed by the string when the entry is also being defined
+const uint16_t STRING_IS_DICTIONARY_REFERENCE = 0x8000;
+const uint16_t STRING_IS_DICTIONARY_DEFINITION = 0x4000;
+const uint16_t DICTIONARY_INDEX_MASK = 0x3FFF;
 
 /// An opaque key used when starting, ending, and discarding encoding/packing levels of OctreePacketData
 class LevelDetails {
-    LevelDetails(int startIndex, int bytesOfOctalCodes, int bytesOfBitmasks, int bytesOfColor, int bytesReservedAtStart) :
+    LevelDetails(int startIndex, int bytesOfOctalCodes, int bytesOfBitmasks, int bytesOfColor, int bytesReservedAtStart,
+                 int dictionarySize) :
         _startIndex(startIndex),
         _bytesOfOctalCodes(bytesOfOctalCodes),
         _bytesOfBitmasks(bytesOfBitmasks),
         _bytesOfColor(bytesOfColor),
-        _bytesReservedAtStart(bytesReservedAtStart) {
+        _bytesReservedAtStart(bytesReservedAtStart),
+        _dictionarySize(dictionarySize) {
     }
     
     friend class OctreePacketData;
@@ -78,16 +95,22 @@ private:
     int _bytesOfBitmasks;
     int _bytesOfColor;
     int _bytesReservedAtStart;
+    int _dictionarySize;
 };
 
 /// Handles packing of the data portion of PacketType_OCTREE_DATA messages. 
 class OctreePacketData {
 public:
-    OctreePacketData(bool enableCompression = false, int maxFinalizedSize = MAX_OCTREE_PACKET_DATA_SIZE);
+    OctreePacketData(bool enableCompression = false, int maxFinalizedSize = MAX_OCTREE_PACKET_DATA_SIZE,
+                     bool compactSections = false);
     ~OctreePacketData();
 
-    /// change compression and target size settings
-    void changeSettings(bool enableCompression = false, unsigned int targetSize = MAX_OCTREE_PACKET_DATA_SIZE);
+    /// change compression and target size settings, compact sections lead with their OCTREE_PACKET_SECTION_ENCODING
+    void changeSettings(bool enableCompression = false, unsigned int targetSize = MAX_OCTREE_PACKET_DATA_SIZE,
+                        bool compactSections = false);
+
+    /// strings are appended by reference to this dictionary where they can be, or inline if it is null
+    void setStringDictionary(const OctreeStringDictionaryPointer& dictionary);
 
     /// reset completely, all data is discarded
     void reset();
@@ -229,6 +252,9 @@ public:
     
     /// returns whether or not zlib compression enabled on finalization
     bool isCompressed() const { return _enableCompression; }
+
+    /// returns whether or not sections are finalized with their encoding, raw or zlib
+    bool hasCompactSections() const { return _compactSections; }
     
     /// returns the target uncompressed size
     unsigned int getTargetSize() const { return _targetSize; }
@@ -276,8 +302,16 @@ private:
     /// append a single byte, might fail if byte would cause packet to be too large
     bool append(unsigned char byte);
 
+    bool appendInlineValue(const QString& string);
+    int getDictionarySize() const { return _stringDictionary ? _stringDictionary->size() : 0; }
+
     unsigned int _targetSize;
     bool _enableCompression;
+    bool _compactSections { false };
+
+    OctreeStringDictionaryPointer _stringDictionary;
+    int _subTreeDictionarySize { 0 };
+    int _finalizedDictionarySize { 0 }; // entries added since are discarded on reset, as they weren't sent
     
     QByteArray _uncompressedByteArray;
     unsigned char* _uncompressed { nullptr };
@@ -70,6 +70,21 @@ void OctreeProcessor::processDatagram(ReceivedMessage& message, SharedNodePointe
 
         bool packetIsColored = oneAtBit(flags, PACKET_IS_COLOR_BIT);
         bool packetIsCompressed = oneAtBit(flags, PACKET_IS_COMPRESSED_BIT);
+        bool packetIsCompact = oneAtBit(flags, PACKET_IS_COMPACT_BIT);
+
+        OCTREE_PACKET_CONNECTION_ID connectionID = 0;
+        if (packetIsCompact) {
+            if (!_stringDictionary) {
+                qCDebug(octree) << "OctreeProcessor::processDatagram() got a compact packet without a string dictionary, dropping it";
+                return;
+            }
+
+            // packets still in flight from before we started a new connection refer to the old dictionary
+            message.readPrimitive(&connectionID);
+            if (connectionID != _stringDictionary->getConnectionID()) {
+                return;
+            }
+        }
         
         OCTREE_PACKET_SENT_TIME arrivedAt = usecTimestampNow();
         qint64 clockSkew = sourceNode ? sourceNode->getClockSkewUsec() : 0;
@@ -118,6 +133,10 @@ void OctreeProcessor::processDatagram(ReceivedMessage& message, SharedNodePointe
                 // ask the VoxelTree to read the bitstream into the tree
                 ReadBitstreamToTreeParams args(WANT_EXISTS_BITS, NULL,
                                                 sourceUUID, sourceNode, false, message.getVersion());
+                if (packetIsCompact) {
+                    args.stringDictionary = _stringDictionary.get();
+                    args.connectionID = connectionID;
+                }
                 quint64 startUncompress, startLock = usecTimestampNow();
                 quint64 startReadBitsteam, endReadBitsteam;
                 // FIXME STUTTER - there may be an opportunity to bump this lock outside of the
@@ -125,7 +144,7 @@ void OctreeProcessor::processDatagram(ReceivedMessage& message, SharedNodePointe
                 _tree->withWriteLock([&] {
                     startUncompress = usecTimestampNow();
 
-                    OctreePacketData packetData(packetIsCompressed);
+                    OctreePacketData packetData(packetIsCompressed, MAX_OCTREE_PACKET_DATA_SIZE, packetIsCompact);
                     packetData.loadFinalizedContent(reinterpret_cast<const unsigned char*>(message.getRawMessage() + message.getPosition()),
                         sectionLength);
                     if (extraDebugging) {
@@ -46,6 +46,9 @@ public:
     /// clears the tree
     virtual void clear();
 
+    /// the string dictionary of the connection that compact packets are read with
+    void setStringDictionary(const OctreeStringDictionaryPointer& dictionary) { _stringDictionary = dictionary; }
+
     float getAverageElementsPerPacket() const { return _elementsPerPacket.getAverage(); }
     float getAverageEntitiesPerPacket() const { return _entitiesPerPacket.getAverage(); }
 
@@ -62,6 +65,7 @@ protected:
 
     OctreePointer _tree;
     bool _managedTree;
+    OctreeStringDictionaryPointer _stringDictionary;
 
     SimpleMovingAverage _elementsPerPacket;
     SimpleMovingAverage _entitiesPerPacket;
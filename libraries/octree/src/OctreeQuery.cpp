@@ -39,6 +39,14 @@ OctreeQuery::OctreeQuery(bool randomizeConnectionID) :
         std::random_device randomDevice;
         _connectionID = randomDevice();
     }
+    _stringDictionary->startConnection(_connectionID);
+}
+
+void OctreeQuery::incrementConnectionID() {
+    ++_connectionID;
+
+    // the server starts its dictionary over for the new connection
+    _stringDictionary->startConnection(_connectionID);
 }
 
 int OctreeQuery::getBroadcastData(unsigned char* destinationBuffer) {
@@ -102,6 +110,15 @@ int OctreeQuery::getBroadcastData(unsigned char* destinationBuffer) {
         memcpy(destinationBuffer, binaryParametersDocument.data(), binaryParametersBytes);
         destinationBuffer += binaryParametersBytes;
     }
+
+    // trailing the query so that servers which don't know about compact packets can ignore it
+    uint8_t wantsCompactPackets = _wantsCompactPackets;
+    memcpy(destinationBuffer, &wantsCompactPackets, sizeof(wantsCompactPackets));
+    destinationBuffer += sizeof(wantsCompactPackets);
+
+    uint16_t dictionaryEntriesReceived = _stringDictionary->getContiguousCount();
+    memcpy(destinationBuffer, &dictionaryEntriesReceived, sizeof(dictionaryEntriesReceived));
+    destinationBuffer += sizeof(dictionaryEntriesReceived);
     
     return destinationBuffer - bufferStart;
 }
@@ -123,11 +140,13 @@ int OctreeQuery::parseData(ReceivedMessage& message) {
 
         // set the incoming connection ID as the current
         _connectionID = newConnectionID;
+        _stringDictionary->startConnection(_connectionID);
     } else {
         if (newConnectionID != _connectionID) {
             // the connection ID has changed - emit our signal so the server
             // knows that the client is starting a new session
             _connectionID = newConnectionID;
+            _stringDictionary->startConnection(_connectionID);
             emit incomingConnectionIDChanged();
         }
     }
@@ -181,6 +200,22 @@ int OctreeQuery::parseData(ReceivedMessage& message) {
         QWriteLocker jsonParameterLocker { &_jsonParametersLock };
         _jsonParameters = newJsonDocument.object();
     }
+
+    // queries from older clients end here
+    const int COMPACT_PACKETS_REQUEST_BYTES = sizeof(uint8_t) + sizeof(uint16_t);
+    if ((sourceBuffer - startPosition) + COMPACT_PACKETS_REQUEST_BYTES <= message.getSize()) {
+        uint8_t wantsCompactPackets;
+        memcpy(&wantsCompactPackets, sourceBuffer, sizeof(wantsCompactPackets));
+        sourceBuffer += sizeof(wantsCompactPackets);
+        _wantsCompactPackets = wantsCompactPackets != 0;
+
+        uint16_t dictionaryEntriesReceived;
+        memcpy(&dictionaryEntriesReceived, sourceBuffer, sizeof(dictionaryEntriesReceived));
+        sourceBuffer += sizeof(dictionaryEntriesReceived);
+        _stringDictionary->acknowledge(dictionaryEntriesReceived);
+    } else {
+        _wantsCompactPackets = false;
+    }
     
     return sourceBuffer - startPosition;
 }
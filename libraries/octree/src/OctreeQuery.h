@@ -22,6 +22,8 @@
 
 #include <NodeData.h>
 
+#include "OctreeStringDictionary.h"
+
 
 class OctreeQuery : public NodeData {
     Q_OBJECT
@@ -68,7 +70,15 @@ public:
     bool getUsesFrustum() { return _usesFrustum; }
     void setUsesFrustum(bool usesFrustum) { _usesFrustum = usesFrustum; }
 
-    void incrementConnectionID() { ++_connectionID; }
+    void incrementConnectionID();
+
+    // Compact packets, with a string dictionary and sections left uncompressed when zlib doesn't help, are only sent to
+    // clients that ask for them. Older servers ignore the request, and older clients never make it.
+    bool getWantsCompactPackets() const { return _wantsCompactPackets; }
+    void setWantsCompactPackets(bool wantsCompactPackets) { _wantsCompactPackets = wantsCompactPackets; }
+
+    // the connection's dictionary, filled in by the packets of the server and acknowledged by the queries of the client
+    const OctreeStringDictionaryPointer& getStringDictionary() const { return _stringDictionary; }
 
     bool hasReceivedFirstQuery() const  { return _hasReceivedFirstQuery; }
 
@@ -97,12 +107,15 @@ protected:
     int _boundaryLevelAdjust = 0; /// used for LOD calculations
     
     uint8_t _usesFrustum = true;
-    uint16_t _connectionID; // query connection ID, randomized to start, increments with each new connection to server
+    uint16_t _connectionID { 0 }; // query connection ID, randomized to start, increments with each new connection to server
     
     QJsonObject _jsonParameters;
     QReadWriteLock _jsonParametersLock;
 
     bool _hasReceivedFirstQuery { false };
+
+    bool _wantsCompactPackets { false };
+    OctreeStringDictionaryPointer _stringDictionary { std::make_shared<OctreeStringDictionary>() };
     
 private:
     // privatize the copy constructor and assignment operator so they cannot be called
@@ -107,6 +107,11 @@ void OctreeQueryNode::resetOctreePacket() {
     setAtBit(flags, PACKET_IS_COLOR_BIT); // always color
     setAtBit(flags, PACKET_IS_COMPRESSED_BIT); // always compressed
 
+    _octreePacketIsCompact = getWantsCompactPackets();
+    if (_octreePacketIsCompact) {
+        setAtBit(flags, PACKET_IS_COMPACT_BIT);
+    }
+
     _octreePacket->reset();
 
     // pack in flags
@@ -119,6 +124,12 @@ void OctreeQueryNode::resetOctreePacket() {
     OCTREE_PACKET_SENT_TIME now = usecTimestampNow();
     _octreePacket->writePrimitive(now);
 
+    // compact packets say which connection's dictionary they were written against
+    if (_octreePacketIsCompact) {
+        OCTREE_PACKET_CONNECTION_ID connectionID = _connectionID;
+        _octreePacket->writePrimitive(connectionID);
+    }
+
     _octreePacketWaiting = false;
 }
 
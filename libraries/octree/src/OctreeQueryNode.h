@@ -42,6 +42,9 @@ public:
     NLPacket& getPacket() const { return *_octreePacket; }
     bool isPacketWaiting() const { return _octreePacketWaiting; }
 
+    // whether the packet being filled is compact, decided when it was reset so all its sections agree
+    bool isPacketCompact() const { return _octreePacketIsCompact; }
+
     bool packetIsDuplicate() const;
     bool shouldSuppressDuplicatePacket();
 
@@ -113,6 +116,7 @@ private:
     bool _viewSent { false };
     std::unique_ptr<NLPacket> _octreePacket;
     bool _octreePacketWaiting;
+    bool _octreePacketIsCompact { false };
 
     unsigned int _lastOctreePacketLength { 0 };
     int _duplicatePacketCount { 0 };
@@ -0,0 +1,148 @@
+//
+//  OctreeStringDictionary.cpp
+//  libraries/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeStringDictionary.h"
+
+#include <algorithm>
+
+#include "OctreeLogging.h"
+
+static const int MAX_SEEN_ONCE { 4 * OctreeStringDictionary::MAX_ENTRIES };
+
+static thread_local OctreeStringDictionary* readingDictionary { nullptr };
+static thread_local uint16_t readingConnectionID { 0 };
+
+int OctreeStringDictionary::findOrAdd(const QString& string, bool& isAcknowledged) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto itr = _indices.find(string);
+    if (itr != _indices.end()) {
+        isAcknowledged = itr.value() < _acknowledged;
+        return itr.value();
+    }
+
+    // strings sent only once, such as most user data, would just fill the dictionary
+    uint hash = qHash(string);
+    if (!_seenOnce.contains(hash)) {
+        if (_seenOnce.size() >= MAX_SEEN_ONCE) {
+            _seenOnce.clear();
+        }
+        _seenOnce.insert(hash);
+        return -1;
+    }
+    if (_strings.size() >= MAX_ENTRIES) {
+        return -1;
+    }
+
+    int index = _strings.size();
+    _strings.push_back(string);
+    _indices.insert(string, index);
+    isAcknowledged = false;
+    return index;
+}
+
+int OctreeStringDictionary::size() const {
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _strings.size();
+}
+
+void OctreeStringDictionary::truncate(int size) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    // entries the client has acknowledged were sent, and can't be taken back
+    size = std::max(size, _acknowledged);
+    while (_strings.size() > size) {
+        _indices.remove(_strings.back());
+        _strings.pop_back();
+    }
+}
+
+void OctreeStringDictionary::acknowledge(int count) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _acknowledged = std::max(_acknowledged, std::min(count, _strings.size()));
+}
+
+void OctreeStringDictionary::define(int index, const QString& string, uint16_t connectionID) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (connectionID != _connectionID || index < 0 || index >= MAX_ENTRIES) {
+        return;
+    }
+    if (index >= _strings.size()) {
+        _strings.resize(index + 1);
+    }
+    _strings[index] = string;
+    while (_contiguous < _strings.size() && !_strings[_contiguous].isNull()) {
+        ++_contiguous;
+    }
+}
+
+bool OctreeStringDictionary::lookup(int index, QString& string, uint16_t connectionID) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (connectionID != _connectionID) {
+        // the packet was written against the dictionary of an earlier connection
+        string = QString();
+        return false;
+    }
+    if (index < 0 || index >= _strings.size() || _strings[index].isNull()) {
+        if (!_outOfSync) {
+            qCDebug(octree) << "OctreeStringDictionary::lookup() missing entry" << index << "- dictionary is out of sync";
+        }
+        _outOfSync = true;
+        string = QString();
+        return false;
+    }
+    string = _strings[index];
+    return true;
+}
+
+int OctreeStringDictionary::getContiguousCount() const {
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _contiguous;
+}
+
+bool OctreeStringDictionary::isOutOfSync() const {
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _outOfSync;
+}
+
+void OctreeStringDictionary::startConnection(uint16_t connectionID) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _connectionID = connectionID;
+    _strings.clear();
+    _indices.clear();
+    _seenOnce.clear();
+    _acknowledged = 0;
+    _contiguous = 0;
+    _outOfSync = false;
+}
+
+uint16_t OctreeStringDictionary::getConnectionID() const {
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _connectionID;
+}
+
+OctreeStringDictionary* OctreeStringDictionary::getReadingDictionary() {
+    return readingDictionary;
+}
+
+uint16_t OctreeStringDictionary::getReadingConnectionID() {
+    return readingConnectionID;
+}
+
+OctreeStringDictionary::ReadingScope::ReadingScope(OctreeStringDictionary* dictionary, uint16_t connectionID) :
+    _previous(readingDictionary),
+    _previousConnectionID(readingConnectionID)
+{
+    readingDictionary = dictionary;
+    readingConnectionID = connectionID;
+}
+
+OctreeStringDictionary::ReadingScope::~ReadingScope() {
+    readingDictionary = _previous;
+    readingConnectionID = _previousConnectionID;
+}
@@ -0,0 +1,86 @@
+//
+//  OctreeStringDictionary.h
+//  libraries/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeStringDictionary_h
+#define hifi_OctreeStringDictionary_h
+
+#include <memory>
+#include <mutex>
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+class OctreeStringDictionary;
+using OctreeStringDictionaryPointer = std::shared_ptr<OctreeStringDictionary>;
+
+// The strings of one connection's compact octree packets that are sent once and then by index, such as the model,
+// texture and script URLs shared by many entities.
+//
+// The server adds strings the second time it sends them, and sends an entry with its definition until the client
+// acknowledges it in its query by the number of entries it has received without gaps. Packets are unreliable, so
+// until then the entry can't be sent by index alone. Entries added to content that is discarded rather than sent are
+// truncated again so they don't leave a gap.
+//
+// The client defines entries as they arrive and looks up the others. Looking up an entry it doesn't have marks the
+// dictionary out of sync, and the client then starts a new connection, which clears the dictionaries at both ends.
+// Compact packets carry the ID of the connection they were written for, and the receiving side ignores the strings of
+// packets from an earlier one that were still in flight.
+class OctreeStringDictionary {
+public:
+    static const int MAX_ENTRIES { 0x4000 };
+
+    // Shorter strings are sent inline, as they would take about as many bytes as a reference
+    static const int MIN_STRING_LENGTH { 8 };
+
+    // Sending side: returns the index of the string, or -1 when it should be sent inline
+    int findOrAdd(const QString& string, bool& isAcknowledged);
+    int size() const;
+    void truncate(int size);
+    void acknowledge(int count);
+
+    // Receiving side, for the strings of a packet written for the given connection
+    void define(int index, const QString& string, uint16_t connectionID);
+    bool lookup(int index, QString& string, uint16_t connectionID);
+    int getContiguousCount() const;
+    bool isOutOfSync() const;
+
+    // clears the dictionary for a new connection
+    void startConnection(uint16_t connectionID);
+    uint16_t getConnectionID() const;
+
+    // The dictionary that decoded strings refer to, and the connection the packet was written for, for the thread
+    // reading a compact packet into a tree
+    static OctreeStringDictionary* getReadingDictionary();
+    static uint16_t getReadingConnectionID();
+
+    class ReadingScope {
+    public:
+        ReadingScope(OctreeStringDictionary* dictionary, uint16_t connectionID);
+        ~ReadingScope();
+
+    private:
+        OctreeStringDictionary* _previous;
+        uint16_t _previousConnectionID;
+    };
+
+private:
+    mutable std::mutex _mutex;
+    QVector<QString> _strings; // null where the receiving side hasn't got an entry yet
+    QHash<QString, int> _indices;
+    QSet<uint> _seenOnce;
+    int _acknowledged { 0 };
+    int _contiguous { 0 };
+    bool _outOfSync { false };
+    uint16_t _connectionID { 0 };
+};
+
+#endif // hifi_OctreeStringDictionary_h
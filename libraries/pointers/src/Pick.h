@@ -8,9 +8,11 @@
 #ifndef hifi_Pick_h
 #define hifi_Pick_h
 
+#include <functional>
 #include <memory>
 #include <stdint.h>
 #include <bitset>
+#include <vector>
 
 #include <QtCore/QUuid>
 #include <QVector>
@@ -220,6 +222,18 @@ public:
     virtual PickResultPointer getHUDIntersection(const T& pick) = 0;
 };
 
+// A unique (mathematical pick, filter) question in a frame's batch of picks, shared by every pick that asks it
+template<typename T>
+struct PickBatchQuery {
+    std::shared_ptr<Pick<T>> pick;
+    T mathPick;
+    PickResultPointer result;
+};
+
+// Answers every query of a batch together, e.g. in a single traversal of the entity tree
+template<typename T>
+using PickBatchOperator = std::function<void(std::vector<PickBatchQuery<T>>& queries)>;
+
 namespace std {
     template <>
     struct hash<PickQuery::PickType> {
@@ -8,7 +8,12 @@
 #ifndef hifi_PickCacheOptimizer_h
 #define hifi_PickCacheOptimizer_h
 
+#include <functional>
 #include <unordered_map>
+#include <vector>
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QThreadPool>
 
 #include "Pick.h"
 
@@ -37,96 +42,198 @@ template<typename T>
 class PickCacheOptimizer {
 
 public:
-    void update(std::unordered_map<unsigned int, std::shared_ptr<PickQuery>>& picks, bool shouldPickHUD);
+    // If entityPickPool is provided, the entity queries of the whole batch are answered on one of its threads while
+    // overlay, avatar and HUD queries, which must stay on the calling thread, are answered here.
+    void update(std::unordered_map<unsigned int, std::shared_ptr<PickQuery>>& picks, bool shouldPickHUD,
+        QThreadPool* entityPickPool = nullptr);
+
+    // When set, these answer every unique entity or avatar query of the frame at once instead of one pick at a time
+    void setEntityBatchOperator(const PickBatchOperator<T>& entityBatchOperator) { _entityBatchOperator = entityBatchOperator; }
+    void setAvatarBatchOperator(const PickBatchOperator<T>& avatarBatchOperator) { _avatarBatchOperator = avatarBatchOperator; }
 
 protected:
     typedef std::unordered_map<T, std::unordered_map<PickCacheKey, PickResultPointer>> PickCache;
+    typedef std::unordered_map<T, std::unordered_map<PickCacheKey, size_t>> PickBatchIndices;
+    typedef PickResultPointer (Pick<T>::*PickEvaluator)(const T&);
+
+    static const size_t NO_BATCH_QUERY = (size_t)-1;
+
+    // An enabled pick waiting for the results that will be combined into its final result
+    struct PendingPick {
+        std::shared_ptr<Pick<T>> pick;
+        T mathPick;
+        size_t entityQuery { NO_BATCH_QUERY };
+        size_t avatarQuery { NO_BATCH_QUERY };
+        PickResultPointer overlayResult;
+        PickResultPointer hudResult;
+    };
 
-    // Returns true if this pick exists in the cache, and if it does, update res if the cached result is closer
-    bool checkAndCompareCachedResults(T& pick, PickCache& cache, PickResultPointer& res, const PickCacheKey& key);
-    void cacheResult(const bool intersects, const PickResultPointer& resTemp, const PickCacheKey& key, PickResultPointer& res, T& mathPick, PickCache& cache, const std::shared_ptr<Pick<T>> pick);
+    PickBatchOperator<T> _entityBatchOperator;
+    PickBatchOperator<T> _avatarBatchOperator;
+
+    // Returns the index of the batch query asking this question, adding it to the batch if it is the first to ask
+    static size_t addBatchQuery(std::vector<PickBatchQuery<T>>& queries, PickBatchIndices& indices,
+        const std::shared_ptr<Pick<T>>& pick, const T& mathPick, const PickCacheKey& key);
+    // Answers the batch with batchOperator if there is one, or one query at a time with evaluate
+    static void evaluateBatch(std::vector<PickBatchQuery<T>>& queries, const PickBatchOperator<T>& batchOperator,
+        PickEvaluator evaluate);
+
+    // Returns the result cached for this pick and key, evaluating and caching it first if needed
+    PickResultPointer getCachedOrEvaluate(PickCache& cache, const T& mathPick, const PickCacheKey& key,
+        const std::function<PickResultPointer()>& evaluate);
+    PickResultPointer combineResults(const PickResultPointer& res, const PickResultPointer& newRes) const;
 };
 
 template<typename T>
-bool PickCacheOptimizer<T>::checkAndCompareCachedResults(T& pick, PickCache& cache, PickResultPointer& res, const PickCacheKey& key) {
-    if (cache.find(pick) != cache.end() && cache[pick].find(key) != cache[pick].end()) {
-        res = res->compareAndProcessNewResult(cache[pick][key]);
-        return true;
+size_t PickCacheOptimizer<T>::addBatchQuery(std::vector<PickBatchQuery<T>>& queries, PickBatchIndices& indices,
+        const std::shared_ptr<Pick<T>>& pick, const T& mathPick, const PickCacheKey& key) {
+    auto& keyedIndices = indices[mathPick];
+    auto existing = keyedIndices.find(key);
+    if (existing != keyedIndices.end()) {
+        return existing->second;
     }
-    return false;
+    size_t index = queries.size();
+    keyedIndices[key] = index;
+    PickBatchQuery<T> query;
+    query.pick = pick;
+    query.mathPick = mathPick;
+    queries.push_back(query);
+    return index;
 }
 
 template<typename T>
-void PickCacheOptimizer<T>::cacheResult(const bool intersects, const PickResultPointer& resTemp, const PickCacheKey& key, PickResultPointer& res, T& mathPick, PickCache& cache, const std::shared_ptr<Pick<T>> pick) {
-    if (intersects) {
-        cache[mathPick][key] = resTemp;
-        res = res->compareAndProcessNewResult(resTemp);
+void PickCacheOptimizer<T>::evaluateBatch(std::vector<PickBatchQuery<T>>& queries, const PickBatchOperator<T>& batchOperator,
+        PickEvaluator evaluate) {
+    if (queries.empty()) {
+        return;
+    }
+    if (batchOperator) {
+        batchOperator(queries);
     } else {
-        cache[mathPick][key] = pick->getDefaultResult(mathPick.toVariantMap());
+        for (auto& query : queries) {
+            query.result = ((*query.pick).*evaluate)(query.mathPick);
+        }
     }
 }
 
 template<typename T>
-void PickCacheOptimizer<T>::update(std::unordered_map<unsigned int, std::shared_ptr<PickQuery>>& picks, bool shouldPickHUD) {
-    PickCache results;
+PickResultPointer PickCacheOptimizer<T>::getCachedOrEvaluate(PickCache& cache, const T& mathPick, const PickCacheKey& key,
+        const std::function<PickResultPointer()>& evaluate) {
+    auto& keyedResults = cache[mathPick];
+    auto cached = keyedResults.find(key);
+    if (cached != keyedResults.end()) {
+        return cached->second;
+    }
+    PickResultPointer result = evaluate();
+    keyedResults[key] = result;
+    return result;
+}
+
+template<typename T>
+PickResultPointer PickCacheOptimizer<T>::combineResults(const PickResultPointer& res, const PickResultPointer& newRes) const {
+    if (newRes && newRes->doesIntersect()) {
+        return res->compareAndProcessNewResult(newRes);
+    }
+    return res;
+}
+
+template<typename T>
+void PickCacheOptimizer<T>::update(std::unordered_map<unsigned int, std::shared_ptr<PickQuery>>& picks, bool shouldPickHUD,
+        QThreadPool* entityPickPool) {
+    // gather the enabled picks for this frame, and the unique entity and avatar queries they make
+    std::vector<PendingPick> pending;
+    std::vector<PickBatchQuery<T>> entityQueries;
+    std::vector<PickBatchQuery<T>> avatarQueries;
+    PickBatchIndices entityIndices;
+    PickBatchIndices avatarIndices;
+    pending.reserve(picks.size());
+
     for (const auto& pickPair : picks) {
         std::shared_ptr<Pick<T>> pick = std::static_pointer_cast<Pick<T>>(pickPair.second);
 
         T mathematicalPick = pick->getMathematicalPick();
-        PickResultPointer res = pick->getDefaultResult(mathematicalPick.toVariantMap());
 
         if (!pick->isEnabled() || pick->getFilter().doesPickNothing() || pick->getMaxDistance() < 0.0f || !mathematicalPick) {
-            pick->setPickResult(res);
+            pick->setPickResult(pick->getDefaultResult(mathematicalPick.toVariantMap()));
             continue;
         }
 
+        PendingPick pendingPick;
+        pendingPick.pick = pick;
+        pendingPick.mathPick = mathematicalPick;
+
         if (pick->getFilter().doesPickEntities()) {
             PickCacheKey entityKey = { pick->getFilter().getEntityFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
-            if (!checkAndCompareCachedResults(mathematicalPick, results, res, entityKey)) {
-                PickResultPointer entityRes = pick->getEntityIntersection(mathematicalPick);
-                if (entityRes) {
-                    cacheResult(entityRes->doesIntersect(), entityRes, entityKey, res, mathematicalPick, results, pick);
-                }
-            }
-        }
-
-        if (pick->getFilter().doesPickOverlays()) {
-            PickCacheKey overlayKey = { pick->getFilter().getOverlayFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
-            if (!checkAndCompareCachedResults(mathematicalPick, results, res, overlayKey)) {
-                PickResultPointer overlayRes = pick->getOverlayIntersection(mathematicalPick);
-                if (overlayRes) {
-                    cacheResult(overlayRes->doesIntersect(), overlayRes, overlayKey, res, mathematicalPick, results, pick);
-                }
-            }
+            pendingPick.entityQuery = addBatchQuery(entityQueries, entityIndices, pick, mathematicalPick, entityKey);
         }
 
         if (pick->getFilter().doesPickAvatars()) {
             PickCacheKey avatarKey = { pick->getFilter().getAvatarFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
-            if (!checkAndCompareCachedResults(mathematicalPick, results, res, avatarKey)) {
-                PickResultPointer avatarRes = pick->getAvatarIntersection(mathematicalPick);
-                if (avatarRes) {
-                    cacheResult(avatarRes->doesIntersect(), avatarRes, avatarKey, res, mathematicalPick, results, pick);
-                }
-            }
+            pendingPick.avatarQuery = addBatchQuery(avatarQueries, avatarIndices, pick, mathematicalPick, avatarKey);
+        }
+
+        pending.push_back(pendingPick);
+    }
+
+    // entity picks only need the entity tree's read lock, so the whole batch goes to a worker
+    QFuture<void> entityFuture;
+    if (entityPickPool && !entityQueries.empty()) {
+        PickBatchOperator<T> entityBatchOperator = _entityBatchOperator;
+        entityFuture = QtConcurrent::run(entityPickPool, [&entityQueries, entityBatchOperator] {
+            evaluateBatch(entityQueries, entityBatchOperator, &Pick<T>::getEntityIntersection);
+        });
+    } else {
+        evaluateBatch(entityQueries, _entityBatchOperator, &Pick<T>::getEntityIntersection);
+    }
+
+    // meanwhile, pick everything that has to be picked from this thread
+    evaluateBatch(avatarQueries, _avatarBatchOperator, &Pick<T>::getAvatarIntersection);
+
+    PickCache results;
+    for (auto& pendingPick : pending) {
+        const std::shared_ptr<Pick<T>>& pick = pendingPick.pick;
+        const T& mathematicalPick = pendingPick.mathPick;
+
+        if (pick->getFilter().doesPickOverlays()) {
+            PickCacheKey overlayKey = { pick->getFilter().getOverlayFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
+            pendingPick.overlayResult = getCachedOrEvaluate(results, mathematicalPick, overlayKey, [&] {
+                return pick->getOverlayIntersection(mathematicalPick);
+            });
         }
 
         // Can't intersect with HUD in desktop mode
         if (pick->getFilter().doesPickHUD() && shouldPickHUD) {
             PickCacheKey hudKey = { pick->getFilter().getHUDFlags(), QVector<QUuid>(), QVector<QUuid>() };
-            if (!checkAndCompareCachedResults(mathematicalPick, results, res, hudKey)) {
-                PickResultPointer hudRes = pick->getHUDIntersection(mathematicalPick);
-                if (hudRes) {
-                    cacheResult(true, hudRes, hudKey, res, mathematicalPick, results, pick);
-                }
-            }
+            pendingPick.hudResult = getCachedOrEvaluate(results, mathematicalPick, hudKey, [&] {
+                return pick->getHUDIntersection(mathematicalPick);
+            });
+        }
+    }
+
+    entityFuture.waitForFinished();
+
+    // combine in the same order the picks were always evaluated in: entities, overlays, avatars, then HUD
+    for (const auto& pendingPick : pending) {
+        const std::shared_ptr<Pick<T>>& pick = pendingPick.pick;
+        PickResultPointer res = pick->getDefaultResult(pendingPick.mathPick.toVariantMap());
+
+        if (pendingPick.entityQuery != NO_BATCH_QUERY) {
+            res = combineResults(res, entityQueries[pendingPick.entityQuery].result);
+        }
+        res = combineResults(res, pendingPick.overlayResult);
+        if (pendingPick.avatarQuery != NO_BATCH_QUERY) {
+            res = combineResults(res, avatarQueries[pendingPick.avatarQuery].result);
+        }
+        if (pendingPick.hudResult) {
+            res = res->compareAndProcessNewResult(pendingPick.hudResult);
         }
 
         if (pick->getMaxDistance() == 0.0f || (pick->getMaxDistance() > 0.0f && res->checkOrFilterAgainstMaxDistance(pick->getMaxDistance()))) {
             pick->setPickResult(res);
         } else {
-            pick->setPickResult(pick->getDefaultResult(mathematicalPick.toVariantMap()));
+            pick->setPickResult(pick->getDefaultResult(pendingPick.mathPick.toVariantMap()));
         }
     }
 }
 
-#endif // hifi_PickCacheOptimizer_h
\ No newline at end of file
+#endif // hifi_PickCacheOptimizer_h
@@ -10,6 +10,9 @@
 PickManager::PickManager() {
     setShouldPickHUDOperator([]() { return false; });
     setCalculatePos2DFromHUDOperator([](const glm::vec3& intersection) { return glm::vec2(NAN); });
+
+    // each pick type's entity batch is a single traversal of the tree, so one worker is all it can use
+    _entityPickPool.setMaxThreadCount(1);
 }
 
 unsigned int PickManager::addPick(PickQuery::PickType type, const std::shared_ptr<PickQuery> pick) {
@@ -95,8 +98,8 @@ void PickManager::update() {
     });
 
     bool shouldPickHUD = _shouldPickHUDOperator();
-    _rayPickCacheOptimizer.update(cachedPicks[PickQuery::Ray], shouldPickHUD);
-    _stylusPickCacheOptimizer.update(cachedPicks[PickQuery::Stylus], false);
+    _rayPickCacheOptimizer.update(cachedPicks[PickQuery::Ray], shouldPickHUD, _parallelPicking ? &_entityPickPool : nullptr);
+    _stylusPickCacheOptimizer.update(cachedPicks[PickQuery::Stylus], false, _parallelPicking ? &_entityPickPool : nullptr);
 }
 
 bool PickManager::isLeftHand(unsigned int uid) {
@@ -8,6 +8,10 @@
 #ifndef hifi_PickManager_h
 #define hifi_PickManager_h
 
+#include <atomic>
+
+#include <QtCore/QThreadPool>
+
 #include <DependencyManager.h>
 #include "RegisteredMetaTypes.h"
 
@@ -46,6 +50,20 @@ public:
     void setCalculatePos2DFromHUDOperator(std::function<glm::vec2(const glm::vec3&)> calculatePos2DFromHUDOperator) { _calculatePos2DFromHUDOperator = calculatePos2DFromHUDOperator; }
     glm::vec2 calculatePos2DFromHUD(const glm::vec3& intersection) { return _calculatePos2DFromHUDOperator(intersection); }
 
+    // Let each frame's entity and avatar intersections be answered for all picks of a type at once
+    void setRayPickBatchOperators(const PickBatchOperator<PickRay>& entityBatchOperator, const PickBatchOperator<PickRay>& avatarBatchOperator) {
+        _rayPickCacheOptimizer.setEntityBatchOperator(entityBatchOperator);
+        _rayPickCacheOptimizer.setAvatarBatchOperator(avatarBatchOperator);
+    }
+    void setStylusPickEntityBatchOperator(const PickBatchOperator<StylusTip>& entityBatchOperator) {
+        _stylusPickCacheOptimizer.setEntityBatchOperator(entityBatchOperator);
+    }
+
+    // When enabled, each frame's batch of entity intersections is evaluated on a worker thread while the main thread
+    // picks overlays, avatars and the HUD
+    void setParallelPicking(bool parallelPicking) { _parallelPicking = parallelPicking; }
+    bool isParallelPicking() const { return _parallelPicking; }
+
     static const unsigned int INVALID_PICK_ID { 0 };
 
 protected:
@@ -57,6 +75,9 @@ protected:
     std::unordered_map<unsigned int, PickQuery::PickType> _typeMap;
     unsigned int _nextPickID { INVALID_PICK_ID + 1 };
 
+    std::atomic<bool> _parallelPicking { true };
+    QThreadPool _entityPickPool;
+
     PickCacheOptimizer<PickRay> _rayPickCacheOptimizer;
     PickCacheOptimizer<StylusTip> _stylusPickCacheOptimizer;
 };
@@ -13,6 +13,7 @@
 
 #include "impl/FileClip.h"
 #include "impl/BufferClip.h"
+#include "impl/ChunkedClip.h"
 
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
@@ -22,21 +23,34 @@
 using namespace recording;
 
 Clip::Pointer Clip::fromFile(const QString& filePath) {
-    auto result = std::make_shared<FileClip>(filePath);
+    Clip::Pointer result;
+    if (ChunkedFileClip::isChunkedFile(filePath)) {
+        result = std::make_shared<ChunkedFileClip>(filePath);
+    } else {
+        result = std::make_shared<FileClip>(filePath);
+    }
     if (result->frameCount() == 0) {
         return Clip::Pointer();
     }
     return result;
 }
 
-void Clip::toFile(const QString& filePath, const Clip::ConstPointer& clip) {
-    FileClip::write(filePath, clip->duplicate());
+void Clip::toFile(const QString& filePath, const Clip::ConstPointer& clip, Format format) {
+    if (format == Format::Chunked) {
+        ChunkedFileClip::write(filePath, clip->duplicate());
+    } else {
+        FileClip::write(filePath, clip->duplicate());
+    }
 }
 
-QByteArray Clip::toBuffer(const Clip::ConstPointer& clip) {
+QByteArray Clip::toBuffer(const Clip::ConstPointer& clip, Format format) {
     QBuffer buffer;
     if (buffer.open(QFile::Truncate | QFile::WriteOnly)) {
-        clip->duplicate()->write(buffer);
+        if (format == Format::Chunked) {
+            ChunkedClip::write(buffer, clip->duplicate());
+        } else {
+            clip->duplicate()->write(buffer);
+        }
         buffer.close();
     }
     return buffer.data();
@@ -49,9 +49,15 @@ public:
 
     bool write(QIODevice& output);
 
+    enum class Format {
+        Frames, // one compressed frame after another, readable by every version
+        Chunked // columnar chunks with a seek index, see ChunkedClip
+    };
+
+    // reads either format
     static Pointer fromFile(const QString& filePath);
-    static void toFile(const QString& filePath, const ConstPointer& clip);
-    static QByteArray toBuffer(const ConstPointer& clip);
+    static void toFile(const QString& filePath, const ConstPointer& clip, Format format = Format::Frames);
+    static QByteArray toBuffer(const ConstPointer& clip, Format format = Format::Frames);
     static Pointer newClip();
     
     static const QString FRAME_TYPE_MAP;
@@ -16,16 +16,28 @@
 
 using namespace recording;
 NetworkClipLoader::NetworkClipLoader(const QUrl& url) :
-    Resource(url),
-    _clip(std::make_shared<NetworkClip>(url)) {}
+    Resource(url) {}
 
 void NetworkClip::init(const QByteArray& clipData) {
     _clipData = clipData;
     PointerClip::init((uchar*)_clipData.data(), _clipData.size());
 }
 
+void NetworkChunkedClip::init(const QByteArray& clipData) {
+    _clipData = clipData;
+    ChunkedClip::init((uchar*)_clipData.data(), _clipData.size());
+}
+
 void NetworkClipLoader::downloadFinished(const QByteArray& data) {
-    _clip->init(data);
+    if (ChunkedClip::isChunkedClip((const uchar*)data.constData(), data.size())) {
+        auto clip = std::make_shared<NetworkChunkedClip>(_url);
+        clip->init(data);
+        _clip = clip;
+    } else {
+        auto clip = std::make_shared<NetworkClip>(_url);
+        clip->init(data);
+        _clip = clip;
+    }
     finishedLoading(true);
     emit clipLoaded();
 }
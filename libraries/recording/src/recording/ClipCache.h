@@ -13,6 +13,7 @@
 
 #include "Forward.h"
 #include "impl/PointerClip.h"
+#include "impl/ChunkedClip.h"
 
 namespace recording {
 
@@ -29,6 +30,19 @@ private:
     QUrl _url;
 };
 
+class NetworkChunkedClip : public ChunkedClip {
+public:
+    using Pointer = std::shared_ptr<NetworkChunkedClip>;
+
+    NetworkChunkedClip(const QUrl& url) : _url(url) {}
+    virtual void init(const QByteArray& clipData);
+    virtual QString getName() const override { return _url.toString(); }
+
+private:
+    QByteArray _clipData;
+    QUrl _url;
+};
+
 class NetworkClipLoader : public Resource {
     Q_OBJECT
 public:
@@ -41,7 +55,7 @@ signals:
     void clipLoaded();
 
 private:
-    const NetworkClip::Pointer _clip;
+    ClipPointer _clip; // created once the data arrives and its format is known
 };
 
 using NetworkClipLoaderPointer = QSharedPointer<NetworkClipLoader>;
@@ -0,0 +1,471 @@
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ChunkedClip.h"
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+#include <QtCore/QIODevice>
+#include <QtCore/QJsonObject>
+
+#include "../Frame.h"
+#include "../Logging.h"
+#include "PointerClip.h"
+
+using namespace recording;
+
+// File layout: a FileHeader and the binary JSON clip header, then the compressed chunks in order of their first
+// frame time, then an IndexEntry for every chunk (grouped by frame type, in time order) and finally the Footer.
+namespace {
+
+const char CLIP_MAGIC[ChunkedClip::MAGIC_SIZE] = { 'H', 'F', 'R', 'C' };
+const char INDEX_MAGIC[4] = { 'H', 'F', 'R', 'I' };
+const uint32_t CLIP_VERSION = 1;
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t headerSize;
+};
+
+struct IndexEntry {
+    FrameType type;
+    uint16_t reserved;
+    uint32_t frameCount;
+    Frame::Time firstTime;
+    Frame::Time lastTime;
+    quint64 fileOffset;
+    uint32_t size;
+    uint32_t reserved2;
+};
+
+struct Footer {
+    quint64 indexOffset;
+    uint32_t indexCount;
+    char magic[4];
+};
+
+}
+
+// Chunk contents before compression: the time of each frame as a delta from the one before it (the first from the
+// chunk's first time), the size of each frame, then the frame data.
+static const size_t FRAME_COLUMNS_SIZE = sizeof(Frame::Time) + sizeof(FrameSize);
+
+static QByteArray encodeChunk(std::vector<FrameConstPointer>::const_iterator begin,
+                              std::vector<FrameConstPointer>::const_iterator end) {
+    size_t count = end - begin;
+    size_t dataSize = 0;
+    for (auto itr = begin; itr != end; ++itr) {
+        dataSize += (*itr)->data.size();
+    }
+
+    QByteArray result(count * FRAME_COLUMNS_SIZE + dataSize, 0);
+    auto times = reinterpret_cast<Frame::Time*>(result.data());
+    auto sizes = reinterpret_cast<FrameSize*>(result.data() + count * sizeof(Frame::Time));
+    auto data = result.data() + count * FRAME_COLUMNS_SIZE;
+
+    Frame::Time lastTime = (*begin)->timeOffset;
+    const QByteArray* lastData = nullptr;
+    for (auto itr = begin; itr != end; ++itr) {
+        const auto& frame = **itr;
+        FrameSize size = frame.data.size();
+        *times++ = frame.timeOffset - lastTime;
+        *sizes++ = size;
+        lastTime = frame.timeOffset;
+
+        // consecutive frames of the same size share their layout, so store only what changed
+        if (lastData && lastData->size() == size) {
+            auto current = frame.data.constData();
+            auto previous = lastData->constData();
+            for (FrameSize i = 0; i < size; ++i) {
+                data[i] = current[i] ^ previous[i];
+            }
+        } else {
+            memcpy(data, frame.data.constData(), size);
+        }
+        data += size;
+        lastData = &frame.data;
+    }
+    return qCompress(result);
+}
+
+bool ChunkedClip::isChunkedClip(const uchar* data, size_t size) {
+    return size >= MAGIC_SIZE && memcmp(data, CLIP_MAGIC, MAGIC_SIZE) == 0;
+}
+
+bool ChunkedClip::write(QIODevice& output, const Clip::Pointer& clip) {
+    // split the frames by type, keeping the types in the order they first appear
+    std::vector<FrameType> types;
+    std::vector<std::vector<FrameConstPointer>> typeFrames;
+    clip->seek(0);
+    for (auto frame = clip->nextFrame(); frame; frame = clip->nextFrame()) {
+        if (frame->type == Frame::TYPE_INVALID || frame->type == Frame::TYPE_HEADER) {
+            continue;
+        }
+        auto itr = std::find(types.begin(), types.end(), frame->type);
+        if (itr == types.end()) {
+            types.push_back(frame->type);
+            typeFrames.emplace_back();
+            itr = types.end() - 1;
+        }
+        typeFrames[itr - types.begin()].push_back(frame);
+    }
+
+    struct EncodedChunk {
+        IndexEntry entry;
+        QByteArray data;
+    };
+    std::vector<EncodedChunk> chunks;
+    for (size_t i = 0; i < types.size(); ++i) {
+        const auto& frames = typeFrames[i];
+        auto begin = frames.begin();
+        while (begin != frames.end()) {
+            auto end = begin;
+            uint32_t dataSize = 0;
+            while (end != frames.end() && (uint32_t)(end - begin) < MAX_FRAMES_PER_CHUNK && dataSize < MAX_CHUNK_DATA_SIZE) {
+                dataSize += (*end)->data.size();
+                ++end;
+            }
+
+            EncodedChunk chunk;
+            chunk.data = encodeChunk(begin, end);
+            chunk.entry.type = types[i];
+            chunk.entry.reserved = 0;
+            chunk.entry.frameCount = end - begin;
+            chunk.entry.firstTime = (*begin)->timeOffset;
+            chunk.entry.lastTime = (*(end - 1))->timeOffset;
+            chunk.entry.size = chunk.data.size();
+            chunk.entry.reserved2 = 0;
+            chunks.push_back(chunk);
+            begin = end;
+        }
+    }
+
+    auto frameTypes = Frame::getFrameTypes();
+    QJsonObject frameTypeObj;
+    for (const auto& frameTypeName : frameTypes.keys()) {
+        frameTypeObj[frameTypeName] = frameTypes[frameTypeName];
+    }
+    QJsonObject rootObject;
+    rootObject.insert(FRAME_TYPE_MAP, frameTypeObj);
+    QByteArray headerData = QJsonDocument(rootObject).toBinaryData();
+
+    FileHeader fileHeader;
+    memcpy(fileHeader.magic, CLIP_MAGIC, sizeof(CLIP_MAGIC));
+    fileHeader.version = CLIP_VERSION;
+    fileHeader.headerSize = headerData.size();
+    if (output.write((const char*)&fileHeader, sizeof(fileHeader)) != sizeof(fileHeader) ||
+        output.write(headerData) != headerData.size()) {
+        return false;
+    }
+
+    // lay the chunks out in playback order so a streaming read only ever moves forward
+    std::vector<EncodedChunk*> fileOrder;
+    for (auto& chunk : chunks) {
+        fileOrder.push_back(&chunk);
+    }
+    std::stable_sort(fileOrder.begin(), fileOrder.end(), [](const EncodedChunk* a, const EncodedChunk* b) {
+        return a->entry.firstTime < b->entry.firstTime;
+    });
+    for (auto chunk : fileOrder) {
+        chunk->entry.fileOffset = output.pos();
+        if (output.write(chunk->data) != chunk->data.size()) {
+            return false;
+        }
+    }
+
+    Footer footer;
+    footer.indexOffset = output.pos();
+    footer.indexCount = (uint32_t)chunks.size();
+    memcpy(footer.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    for (const auto& chunk : chunks) {
+        if (output.write((const char*)&chunk.entry, sizeof(IndexEntry)) != sizeof(IndexEntry)) {
+            return false;
+        }
+    }
+    return output.write((const char*)&footer, sizeof(footer)) == sizeof(footer);
+}
+
+void ChunkedClip::reset() {
+    _tracks.clear();
+    _header = QJsonDocument();
+    _data = nullptr;
+    _size = 0;
+    _frameCount = 0;
+    _duration = 0;
+}
+
+void ChunkedClip::init(uchar* data, size_t size) {
+    Locker lock(_mutex);
+    reset();
+
+    if (!isChunkedClip(data, size) || size < sizeof(FileHeader) + sizeof(Footer)) {
+        qCWarning(recordingLog) << "Not a chunked clip, invalid file";
+        return;
+    }
+
+    FileHeader fileHeader;
+    memcpy(&fileHeader, data, sizeof(fileHeader));
+    if (fileHeader.version != CLIP_VERSION) {
+        qCWarning(recordingLog) << "Unsupported chunked clip version" << fileHeader.version;
+        return;
+    }
+    if (sizeof(FileHeader) + fileHeader.headerSize > size - sizeof(Footer)) {
+        qCWarning(recordingLog) << "Truncated chunked clip header, invalid file";
+        return;
+    }
+
+    Footer footer;
+    memcpy(&footer, data + size - sizeof(Footer), sizeof(footer));
+    if (memcmp(footer.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+        footer.indexOffset + (quint64)footer.indexCount * sizeof(IndexEntry) + sizeof(Footer) != size) {
+        qCWarning(recordingLog) << "Missing chunk index, invalid file";
+        return;
+    }
+
+    _header = QJsonDocument::fromBinaryData(QByteArray((const char*)data + sizeof(FileHeader), fileHeader.headerSize));
+    auto translationMap = PointerClip::parseTranslationMap(_header);
+    if (translationMap.empty()) {
+        qCWarning(recordingLog) << "Header missing frame type map, invalid file";
+        reset();
+        return;
+    }
+
+    _data = data;
+    _size = size;
+
+    std::vector<FrameType> storedTypes;
+    for (uint32_t i = 0; i < footer.indexCount; ++i) {
+        IndexEntry entry;
+        memcpy(&entry, data + footer.indexOffset + i * sizeof(IndexEntry), sizeof(entry));
+        if (entry.fileOffset + entry.size > footer.indexOffset || entry.frameCount == 0) {
+            qCWarning(recordingLog) << "Chunk out of bounds, invalid file";
+            reset();
+            return;
+        }
+        // frame types this build doesn't know are skipped, as in the frame by frame format
+        if (!translationMap.contains(entry.type)) {
+            continue;
+        }
+
+        auto itr = std::find(storedTypes.begin(), storedTypes.end(), entry.type);
+        if (itr == storedTypes.end()) {
+            storedTypes.push_back(entry.type);
+            _tracks.emplace_back();
+            _tracks.back().type = translationMap[entry.type];
+            itr = storedTypes.end() - 1;
+        }
+        _tracks[itr - storedTypes.begin()].chunks.push_back({ entry.firstTime, entry.lastTime, entry.frameCount,
+            entry.fileOffset, entry.size });
+        _frameCount += entry.frameCount;
+        _duration = std::max(_duration, entry.lastTime);
+    }
+    qCDebug(recordingLog) << "Indexed" << footer.indexCount << "chunks holding" << _frameCount << "frames";
+}
+
+bool ChunkedClip::decodeChunk(Track& track, size_t chunkIndex) const {
+    if (track.decodedChunk == chunkIndex) {
+        return true;
+    }
+
+    const auto& chunk = track.chunks[chunkIndex];
+    track.decodedChunk = std::numeric_limits<size_t>::max();
+    track.data = qUncompress(_data + chunk.fileOffset, chunk.size);
+
+    const uint32_t count = chunk.frameCount;
+    const size_t columnsSize = count * FRAME_COLUMNS_SIZE;
+    if ((size_t)track.data.size() < columnsSize) {
+        qCWarning(recordingLog) << "Corrupt chunk at" << chunk.fileOffset;
+        track.data = QByteArray();
+        return false;
+    }
+
+    auto data = track.data.data();
+    auto times = reinterpret_cast<const Frame::Time*>(data);
+    auto sizes = reinterpret_cast<const FrameSize*>(data + count * sizeof(Frame::Time));
+    track.times.resize(count);
+    track.offsets.resize(count + 1);
+    Frame::Time time = chunk.firstTime;
+    uint32_t offset = (uint32_t)columnsSize;
+    for (uint32_t i = 0; i < count; ++i) {
+        time += times[i];
+        track.times[i] = time;
+        track.offsets[i] = offset;
+        offset += sizes[i];
+    }
+    track.offsets[count] = offset;
+    if (offset > (uint32_t)track.data.size()) {
+        qCWarning(recordingLog) << "Corrupt chunk at" << chunk.fileOffset;
+        track.data = QByteArray();
+        return false;
+    }
+
+    // undo the XOR against the previous frame, front to back
+    for (uint32_t i = 1; i < count; ++i) {
+        if (sizes[i] == sizes[i - 1]) {
+            auto current = data + track.offsets[i];
+            auto previous = data + track.offsets[i - 1];
+            for (FrameSize j = 0; j < sizes[i]; ++j) {
+                current[j] ^= previous[j];
+            }
+        }
+    }
+    track.decodedChunk = chunkIndex;
+    return true;
+}
+
+Frame::Time ChunkedClip::nextFrameTime(const Track& track) const {
+    if (track.chunkIndex >= track.chunks.size()) {
+        return Frame::INVALID_TIME;
+    }
+    if (track.frameIndex == 0) {
+        // known from the index, no need to decode
+        return track.chunks[track.chunkIndex].firstTime;
+    }
+    return track.times[track.frameIndex];
+}
+
+ChunkedClip::Track* ChunkedClip::nextTrack() const {
+    Track* result = nullptr;
+    auto soonestTime = Frame::INVALID_TIME;
+    for (auto& track : _tracks) {
+        auto time = nextFrameTime(track);
+        if (time < soonestTime) {
+            soonestTime = time;
+            result = &track;
+        }
+    }
+    return result;
+}
+
+void ChunkedClip::advance(Track& track) const {
+    if (++track.frameIndex >= track.chunks[track.chunkIndex].frameCount) {
+        ++track.chunkIndex;
+        track.frameIndex = 0;
+        // let the finished chunk go, the next one is decoded when the playhead reaches it
+        track.decodedChunk = std::numeric_limits<size_t>::max();
+        track.data = QByteArray();
+    } else if (!decodeChunk(track, track.chunkIndex)) {
+        // a frameIndex past 0 relies on the chunk's times, so skip the rest of a chunk that can't be decoded
+        ++track.chunkIndex;
+        track.frameIndex = 0;
+    }
+}
+
+FrameConstPointer ChunkedClip::readFrame(Track& track) const {
+    FramePointer result;
+    if (decodeChunk(track, track.chunkIndex)) {
+        auto index = track.frameIndex;
+        result = std::make_shared<Frame>();
+        result->type = track.type;
+        result->timeOffset = track.times[index];
+        result->data = QByteArray(track.data.constData() + track.offsets[index],
+                                  track.offsets[index + 1] - track.offsets[index]);
+    }
+    return result;
+}
+
+Clip::Pointer ChunkedClip::duplicate() const {
+    auto result = newClip();
+    Locker lock(_mutex);
+
+    std::vector<std::pair<size_t, uint32_t>> positions;
+    for (auto& track : _tracks) {
+        positions.emplace_back(track.chunkIndex, track.frameIndex);
+        track.chunkIndex = 0;
+        track.frameIndex = 0;
+    }
+    for (auto track = nextTrack(); track; track = nextTrack()) {
+        if (auto frame = readFrame(*track)) {
+            result->addFrame(frame);
+            advance(*track);
+        } else {
+            ++track->chunkIndex;
+            track->frameIndex = 0;
+        }
+    }
+    for (size_t i = 0; i < _tracks.size(); ++i) {
+        _tracks[i].chunkIndex = positions[i].first;
+        _tracks[i].frameIndex = positions[i].second;
+        if (_tracks[i].frameIndex != 0 && !decodeChunk(_tracks[i], _tracks[i].chunkIndex)) {
+            _tracks[i].frameIndex = 0;
+        }
+    }
+    return result;
+}
+
+float ChunkedClip::duration() const {
+    Locker lock(_mutex);
+    return Frame::frameTimeToSeconds(_duration);
+}
+
+size_t ChunkedClip::frameCount() const {
+    Locker lock(_mutex);
+    return _frameCount;
+}
+
+void ChunkedClip::seekFrameTime(Frame::Time offset) {
+    Locker lock(_mutex);
+    for (auto& track : _tracks) {
+        auto itr = std::lower_bound(track.chunks.begin(), track.chunks.end(), offset,
+            [](const ChunkInfo& chunk, Frame::Time time)->bool {
+                return chunk.lastTime < time;
+            }
+        );
+        track.chunkIndex = itr - track.chunks.begin();
+        track.frameIndex = 0;
+        if (itr == track.chunks.end() || offset <= itr->firstTime) {
+            continue;
+        }
+        if (!decodeChunk(track, track.chunkIndex)) {
+            ++track.chunkIndex;
+            continue;
+        }
+        track.frameIndex = std::lower_bound(track.times.begin(), track.times.end(), offset) - track.times.begin();
+    }
+}
+
+Frame::Time ChunkedClip::positionFrameTime() const {
+    Locker lock(_mutex);
+    auto track = nextTrack();
+    return track ? nextFrameTime(*track) : Frame::INVALID_TIME;
+}
+
+FrameConstPointer ChunkedClip::peekFrame() const {
+    Locker lock(_mutex);
+    FrameConstPointer result;
+    if (auto track = nextTrack()) {
+        result = readFrame(*track);
+    }
+    return result;
+}
+
+FrameConstPointer ChunkedClip::nextFrame() {
+    Locker lock(_mutex);
+    for (auto track = nextTrack(); track; track = nextTrack()) {
+        if (auto result = readFrame(*track)) {
+            advance(*track);
+            return result;
+        }
+        // skip a chunk that can't be decoded
+        ++track->chunkIndex;
+        track->frameIndex = 0;
+    }
+    return FrameConstPointer();
+}
+
+void ChunkedClip::skipFrame() {
+    Locker lock(_mutex);
+    if (auto track = nextTrack()) {
+        advance(*track);
+    }
+}
+
+void ChunkedClip::addFrame(FrameConstPointer) {
+    throw std::runtime_error("Chunked clips are read only, use duplicate to create a read/write clip");
+}
@@ -0,0 +1,102 @@
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_Impl_ChunkedClip_h
+#define hifi_Recording_Impl_ChunkedClip_h
+
+#include "../Clip.h"
+
+#include <vector>
+
+#include <QtCore/QJsonDocument>
+
+#include "../Frame.h"
+
+class QIODevice;
+
+namespace recording {
+
+// A read only clip in the chunked columnar format. The frames of each type are stored in compressed chunks holding
+// a column of times, a column of sizes and a column of data, where a frame of the same size as the one before it is
+// stored as the XOR of the two. Avatar frames are binary JSON with a fixed layout, so that leaves only the joint values
+// that actually changed. An index of every chunk's time range at the end of the file gives O(log n) seeks, and only
+// the chunk under the playhead of each frame type is ever decompressed.
+class ChunkedClip : public Clip {
+public:
+    using Pointer = std::shared_ptr<ChunkedClip>;
+
+    static const uint32_t MAX_FRAMES_PER_CHUNK = 256;
+    static const uint32_t MAX_CHUNK_DATA_SIZE = 256 * 1024;
+    static const size_t MAGIC_SIZE = 4;
+
+    ChunkedClip() {};
+    ChunkedClip(uchar* data, size_t size) { init(data, size); }
+
+    void init(uchar* data, size_t size);
+    const QJsonDocument& getHeader() const { return _header; }
+
+    // true if the data starts like a chunked clip, so MAGIC_SIZE bytes are enough to tell the formats apart
+    static bool isChunkedClip(const uchar* data, size_t size);
+    static bool write(QIODevice& output, const Clip::Pointer& clip);
+
+    virtual Clip::Pointer duplicate() const override;
+
+    virtual float duration() const override;
+    virtual size_t frameCount() const override;
+
+    virtual void seekFrameTime(Frame::Time offset) override;
+    virtual Frame::Time positionFrameTime() const override;
+
+    virtual FrameConstPointer peekFrame() const override;
+    virtual FrameConstPointer nextFrame() override;
+    virtual void skipFrame() override;
+    virtual void addFrame(FrameConstPointer) override;
+
+protected:
+    void reset() override;
+
+    struct ChunkInfo {
+        Frame::Time firstTime;
+        Frame::Time lastTime;
+        uint32_t frameCount;
+        quint64 fileOffset;
+        uint32_t size;
+    };
+
+    // all the chunks of one frame type, and the playhead within them
+    struct Track {
+        FrameType type;
+        std::vector<ChunkInfo> chunks;
+
+        size_t chunkIndex { 0 };
+        uint32_t frameIndex { 0 };
+
+        // the decoded contents of chunks[decodedChunk]
+        size_t decodedChunk { std::numeric_limits<size_t>::max() };
+        std::vector<Frame::Time> times;
+        std::vector<uint32_t> offsets;
+        QByteArray data;
+    };
+
+    bool decodeChunk(Track& track, size_t chunkIndex) const;
+    Frame::Time nextFrameTime(const Track& track) const;
+    Track* nextTrack() const;
+    FrameConstPointer readFrame(Track& track) const;
+    void advance(Track& track) const;
+
+    QJsonDocument _header;
+    uchar* _data { nullptr };
+    size_t _size { 0 };
+    mutable std::vector<Track> _tracks;
+    size_t _frameCount { 0 };
+    Frame::Time _duration { 0 };
+};
+
+}
+
+#endif
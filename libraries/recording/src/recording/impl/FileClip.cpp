@@ -65,3 +65,52 @@ FileClip::~FileClip() {
     }
     reset();
 }
+
+ChunkedFileClip::ChunkedFileClip(const QString& fileName) : _file(fileName) {
+    auto size = _file.size();
+    qDebug(recordingLog) << "Opening chunked file of size: " << size;
+    bool opened = _file.open(QIODevice::ReadOnly);
+    if (!opened) {
+        qCWarning(recordingLog) << "Unable to open file " << fileName;
+        return;
+    }
+    // mapped, so only the chunks that get played are ever paged in
+    auto mappedFile = _file.map(0, size, QFile::MapPrivateOption);
+    init(mappedFile, size);
+}
+
+QString ChunkedFileClip::getName() const {
+    return _file.fileName();
+}
+
+bool ChunkedFileClip::isChunkedFile(const QString& fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray start = file.read(MAGIC_SIZE);
+    return isChunkedClip(reinterpret_cast<const uchar*>(start.constData()), start.size());
+}
+
+bool ChunkedFileClip::write(const QString& fileName, Clip::Pointer clip) {
+    if (0 == clip->frameCount()) {
+        return false;
+    }
+
+    QFile outputFile(fileName);
+    if (!outputFile.open(QFile::Truncate | QFile::WriteOnly)) {
+        return false;
+    }
+
+    Finally closer([&] { outputFile.close(); });
+    return ChunkedClip::write(outputFile, clip);
+}
+
+ChunkedFileClip::~ChunkedFileClip() {
+    Locker lock(_mutex);
+    _file.unmap(_data);
+    if (_file.isOpen()) {
+        _file.close();
+    }
+    reset();
+}
@@ -42,6 +42,9 @@ public:
         return _header;
     }
 
+    // maps the frame types stored in a clip header to the ones registered in this build
+    static QMap<FrameType, FrameType> parseTranslationMap(const QJsonDocument& doc);
+
     // FIXME move to frame?
     static const qint64 MINIMUM_FRAME_SIZE = sizeof(FrameType) + sizeof(Frame::Time) + sizeof(FrameSize);
 protected:
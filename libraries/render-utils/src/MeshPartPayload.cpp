@@ -51,6 +51,7 @@ MeshPartPayload::MeshPartPayload(const std::shared_ptr<const model::Mesh>& mesh,
 
 void MeshPartPayload::updateMeshPart(const std::shared_ptr<const model::Mesh>& drawMesh, int partIndex) {
     _drawMesh = drawMesh;
+    _partIndex = partIndex;
     if (_drawMesh) {
         auto vertexFormat = _drawMesh->getVertexFormat();
         _hasColorAttrib = vertexFormat->hasAttribute(gpu::Stream::COLOR);
@@ -361,6 +362,11 @@ void ModelMeshPartPayload::initCache() {
     if (networkMaterial) {
         _drawMaterial = networkMaterial;
     }
+
+    // Parts of models sharing the geometry and materials of the model cache share their mesh and material. Parts
+    // that can be instanced take their shape key from these alone, so they also share their pipeline in a batch.
+    _instanceName = "model_part_" + std::to_string((uintptr_t)_drawMesh.get()) + "_" + std::to_string(_partIndex) +
+        "_" + std::to_string((uintptr_t)_drawMaterial.get());
 }
 
 void ModelMeshPartPayload::notifyLocationChanged() {
@@ -570,6 +576,14 @@ void ModelMeshPartPayload::render(RenderArgs* args) {
         return;
     }
 
+    const int INDICES_PER_TRIANGLE = 3;
+    args->_details._trianglesRendered += _drawPart._numIndices / INDICES_PER_TRIANGLE;
+
+    if (canBeInstanced(args)) {
+        renderInstance(args);
+        return;
+    }
+
     gpu::Batch& batch = *(args->_batch);
     auto locations =  args->_shapePipeline->locations;
     assert(locations);
@@ -589,9 +603,44 @@ void ModelMeshPartPayload::render(RenderArgs* args) {
         PerformanceTimer perfTimer("batch.drawIndexed()");
         drawCall(batch);
     }
+}
 
-    const int INDICES_PER_TRIANGLE = 3;
-    args->_details._trianglesRendered += _drawPart._numIndices / INDICES_PER_TRIANGLE;
+bool ModelMeshPartPayload::canBeInstanced(RenderArgs* args) const {
+    if (_isSkinned || _isBlendShaped || !_drawMesh) {
+        return false;
+    }
+
+    // Translucent parts are drawn back to front, and fading parts each set their own fade parameters
+    ShapeKey key { ShapeKey::Flags(args->_itemShapeKey) };
+    return key.useMaterial() && !key.isTranslucent() && !key.isFaded() && !key.isWireframe() && !key.hasOwnPipeline();
+}
+
+void ModelMeshPartPayload::renderInstance(RenderArgs* args) {
+    gpu::Batch& batch = *(args->_batch);
+    batch.setModelTransform(_transform);
+
+    // The first part of a group to be recorded sets up the draw, which runs once the batch is complete. By then the
+    // args may be gone, as they are for the concurrent shape recordings, so the draw keeps its own copy of them.
+    gpu::Batch::NamedBatchData::Function draw;
+    auto namedData = batch._namedData.find(_instanceName);
+    if (namedData == batch._namedData.end() || !namedData->second.function) {
+        auto pipeline = args->_shapePipeline;
+        bool enableTextures = args->_enableTexturing;
+        auto drawArgs = std::make_shared<RenderArgs>(*args);
+        drawArgs->_batch = nullptr;
+        MeshPartPayload part(*this);
+        draw = [drawArgs, pipeline, enableTextures, part](gpu::Batch& batch, gpu::Batch::NamedBatchData& data) mutable {
+            batch.setPipeline(pipeline->pipeline);
+            pipeline->prepare(batch, drawArgs.get());
+
+            part.bindMesh(batch);
+            part.bindMaterial(batch, pipeline->locations, enableTextures);
+            batch.drawIndexedInstanced((gpu::uint32)data.count(), gpu::TRIANGLES, part._drawPart._numIndices, part._drawPart._startIndex);
+        };
+    }
+    batch.setupNamedCalls(_instanceName, draw);
+
+    args->_details._instancedShapes++;
 }
 
 void ModelMeshPartPayload::computeAdjustedLocalBound(const std::vector<glm::mat4>& clusterMatrices) {
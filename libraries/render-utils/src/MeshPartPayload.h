@@ -104,6 +104,11 @@ public:
 
     void computeAdjustedLocalBound(const std::vector<glm::mat4>& clusterMatrices);
 
+    // Static parts of the same mesh, with the same material and pipeline, are drawn together in one instanced draw
+    // by whichever of them is recorded first, each of them adding only its transform
+    bool canBeInstanced(RenderArgs* args) const;
+    void renderInstance(RenderArgs* args);
+
     gpu::BufferPointer _clusterBuffer;
     ModelWeakPointer _model;
 
@@ -122,6 +127,8 @@ private:
     };
 
     mutable State _state { WAITING_TO_START } ;
+
+    std::string _instanceName;
 };
 
 namespace render {
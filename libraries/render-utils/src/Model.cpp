@@ -37,6 +37,7 @@ using namespace std;
 int nakedModelPointerTypeId = qRegisterMetaType<ModelPointer>();
 int weakGeometryResourceBridgePointerTypeId = qRegisterMetaType<Geometry::WeakPointer >();
 int vec3VectorTypeId = qRegisterMetaType<QVector<glm::vec3> >();
+int blendedVerticesPointerTypeId = qRegisterMetaType<BlendedVerticesPointer>();
 float Model::FAKE_DIMENSION_PLACEHOLDER = -1.0f;
 #define HTTP_INVALID_COM "http://invalid.com"
 
@@ -322,6 +323,15 @@ bool Model::updateGeometry() {
             }
             _blendedVertexBuffers.push_back(buffer);
         }
+        if (fbxGeometry.hasBlendedMeshes()) {
+            _compactBlendedMeshes = DependencyManager::get<ModelBlender>()->getCompactBlendedMeshes(_renderGeometry);
+            for (int i = 0; i < NUM_BLENDED_VERTICES; i++) {
+                _blendedVertices[i] = std::make_shared<BlendedVertices>();
+                _blendedVertices[i]->vertices.resize(_compactBlendedMeshes->getNumVertices());
+                _blendedVertices[i]->normals.resize(_compactBlendedMeshes->getNumVertices());
+                _isBlending[i] = false;
+            }
+        }
         needFullUpdate = true;
         emit rigReady();
     }
@@ -937,7 +947,8 @@ class Blender : public QRunnable {
 public:
 
     Blender(ModelPointer model, int blendNumber, const Geometry::WeakPointer& geometry,
-        const QVector<FBXMesh>& meshes, const QVector<float>& blendshapeCoefficients);
+        const CompactBlendedMeshes::Pointer& meshes, const BlendedVerticesPointer& blendedVertices,
+        const QVector<float>& blendshapeCoefficients);
 
     virtual void run() override;
 
@@ -946,55 +957,31 @@ private:
     ModelPointer _model;
     int _blendNumber;
     Geometry::WeakPointer _geometry;
-    QVector<FBXMesh> _meshes;
+    CompactBlendedMeshes::Pointer _meshes;
+    BlendedVerticesPointer _blendedVertices;
     QVector<float> _blendshapeCoefficients;
 };
 
 Blender::Blender(ModelPointer model, int blendNumber, const Geometry::WeakPointer& geometry,
-        const QVector<FBXMesh>& meshes, const QVector<float>& blendshapeCoefficients) :
+        const CompactBlendedMeshes::Pointer& meshes, const BlendedVerticesPointer& blendedVertices,
+        const QVector<float>& blendshapeCoefficients) :
     _model(model),
     _blendNumber(blendNumber),
     _geometry(geometry),
     _meshes(meshes),
+    _blendedVertices(blendedVertices),
     _blendshapeCoefficients(blendshapeCoefficients) {
 }
 
 void Blender::run() {
     DETAILED_PROFILE_RANGE_EX(simulation_animation, __FUNCTION__, 0xFFFF0000, 0, { { "url", _model->getURL().toString() } });
-    QVector<glm::vec3> vertices, normals;
     if (_model) {
-        int offset = 0;
-        foreach (const FBXMesh& mesh, _meshes) {
-            if (mesh.blendshapes.isEmpty()) {
-                continue;
-            }
-            vertices += mesh.vertices;
-            normals += mesh.normals;
-            glm::vec3* meshVertices = vertices.data() + offset;
-            glm::vec3* meshNormals = normals.data() + offset;
-            offset += mesh.vertices.size();
-            const float NORMAL_COEFFICIENT_SCALE = 0.01f;
-            for (int i = 0, n = qMin(_blendshapeCoefficients.size(), mesh.blendshapes.size()); i < n; i++) {
-                float vertexCoefficient = _blendshapeCoefficients.at(i);
-                const float EPSILON = 0.0001f;
-                if (vertexCoefficient < EPSILON) {
-                    continue;
-                }
-                float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
-                const FBXBlendshape& blendshape = mesh.blendshapes.at(i);
-                for (int j = 0; j < blendshape.indices.size(); j++) {
-                    int index = blendshape.indices.at(j);
-                    meshVertices[index] += blendshape.vertices.at(j) * vertexCoefficient;
-                    meshNormals[index] += blendshape.normals.at(j) * normalCoefficient;
-                }
-            }
-        }
+        _meshes->blend(_blendshapeCoefficients, _blendedVertices->vertices.data(), _blendedVertices->normals.data());
     }
     // post the result to the geometry cache, which will dispatch to the model if still alive
     QMetaObject::invokeMethod(DependencyManager::get<ModelBlender>().data(), "setBlendedVertices",
         Q_ARG(ModelPointer, _model), Q_ARG(int, _blendNumber),
-        Q_ARG(const Geometry::WeakPointer&, _geometry), Q_ARG(const QVector<glm::vec3>&, vertices),
-        Q_ARG(const QVector<glm::vec3>&, normals));
+        Q_ARG(const Geometry::WeakPointer&, _geometry), Q_ARG(BlendedVerticesPointer, _blendedVertices));
 }
 
 void Model::setScaleToFit(bool scaleToFit, const glm::vec3& dimensions, bool forceRescale) {
@@ -1163,44 +1150,60 @@ float Model::getLimbLength(int jointIndex) const {
 }
 
 bool Model::maybeStartBlender() {
-    if (isLoaded()) {
-        const FBXGeometry& fbxGeometry = getFBXGeometry();
-        if (fbxGeometry.hasBlendedMeshes()) {
-            QThreadPool::globalInstance()->start(new Blender(getThisPointer(), ++_blendNumber, _renderGeometry,
-                fbxGeometry.meshes, _blendshapeCoefficients));
-            return true;
+    if (isLoaded() && _compactBlendedMeshes) {
+        for (int i = 0; i < NUM_BLENDED_VERTICES; i++) {
+            if (!_isBlending[i]) {
+                _isBlending[i] = true;
+                QThreadPool::globalInstance()->start(new Blender(getThisPointer(), ++_blendNumber, _renderGeometry,
+                    _compactBlendedMeshes, _blendedVertices[i], _blendshapeCoefficients));
+                return true;
+            }
         }
+        // both sets of blended vertices are in use, so blend again once one of them is applied
+        _needsBlend = true;
     }
     return false;
 }
 
-void Model::setBlendedVertices(int blendNumber, const Geometry::WeakPointer& geometry,
-        const QVector<glm::vec3>& vertices, const QVector<glm::vec3>& normals) {
+void Model::setBlendedVertices(int blendNumber, const Geometry::WeakPointer& geometry, const BlendedVerticesPointer& blendedVertices) {
+    // the blended vertices are free for the next blend either way, unless they belong to a previous geometry
+    for (int i = 0; i < NUM_BLENDED_VERTICES; i++) {
+        if (_blendedVertices[i] == blendedVertices) {
+            _isBlending[i] = false;
+        }
+    }
+    if (_needsBlend) {
+        _needsBlend = false;
+        DependencyManager::get<ModelBlender>()->noteRequiresBlend(getThisPointer());
+    }
+
     auto geometryRef = geometry.lock();
     if (!geometryRef || _renderGeometry != geometryRef || _blendedVertexBuffers.empty() || blendNumber < _appliedBlendNumber) {
         return;
     }
     _appliedBlendNumber = blendNumber;
     const FBXGeometry& fbxGeometry = getFBXGeometry();
-    int index = 0;
-    for (int i = 0; i < fbxGeometry.meshes.size(); i++) {
-        const FBXMesh& mesh = fbxGeometry.meshes.at(i);
-        if (mesh.blendshapes.isEmpty()) {
-            continue;
-        }
-
-        gpu::BufferPointer& buffer = _blendedVertexBuffers[i];
-        buffer->setSubData(0, mesh.vertices.size() * sizeof(glm::vec3), (gpu::Byte*) vertices.constData() + index*sizeof(glm::vec3));
-        buffer->setSubData(mesh.vertices.size() * sizeof(glm::vec3),
-            mesh.normals.size() * sizeof(glm::vec3), (gpu::Byte*) normals.constData() + index*sizeof(glm::vec3));
-
-        index += mesh.vertices.size();
+    for (const auto& mesh : _compactBlendedMeshes->getMeshes()) {
+        const FBXMesh& fbxMesh = fbxGeometry.meshes.at(mesh.meshIndex);
+
+        gpu::BufferPointer& buffer = _blendedVertexBuffers[mesh.meshIndex];
+        buffer->setSubData(0, fbxMesh.vertices.size() * sizeof(glm::vec3),
+            (gpu::Byte*) (blendedVertices->vertices.data() + mesh.firstVertex));
+        int numNormals = std::min(fbxMesh.normals.size(), fbxMesh.vertices.size());
+        buffer->setSubData(fbxMesh.vertices.size() * sizeof(glm::vec3), numNormals * sizeof(glm::vec3),
+            (gpu::Byte*) (blendedVertices->normals.data() + mesh.firstVertex));
     }
 }
 
 void Model::deleteGeometry() {
     _deleteGeometryCounter++;
     _blendedVertexBuffers.clear();
+    _compactBlendedMeshes.reset();
+    for (int i = 0; i < NUM_BLENDED_VERTICES; i++) {
+        _blendedVertices[i].reset();
+        _isBlending[i] = false;
+    }
+    _needsBlend = false;
     _meshStates.clear();
     _rig.destroyAnimGraph();
     _blendedBlendshapeCoefficients.clear();
@@ -1361,10 +1364,32 @@ void ModelBlender::noteRequiresBlend(ModelPointer model) {
     }
 }
 
+CompactBlendedMeshes::Pointer ModelBlender::getCompactBlendedMeshes(const Geometry::Pointer& geometry) {
+    Lock lock(_mutex);
+
+    auto& entry = _compactBlendedMeshes[geometry.get()];
+    auto meshes = entry.meshes.lock();
+    if (!meshes || entry.geometry.lock() != geometry) {
+        meshes = std::make_shared<const CompactBlendedMeshes>(geometry->getFBXGeometry());
+        entry.geometry = geometry;
+        entry.meshes = meshes;
+    }
+
+    // drop the entries of geometries no longer in use
+    for (auto it = _compactBlendedMeshes.begin(); it != _compactBlendedMeshes.end();) {
+        if (it->second.meshes.expired() && it->first != geometry.get()) {
+            it = _compactBlendedMeshes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return meshes;
+}
+
 void ModelBlender::setBlendedVertices(ModelPointer model, int blendNumber,
-        const Geometry::WeakPointer& geometry, const QVector<glm::vec3>& vertices, const QVector<glm::vec3>& normals) {
+        const Geometry::WeakPointer& geometry, BlendedVerticesPointer blendedVertices) {
     if (model) {
-        model->setBlendedVertices(blendNumber, geometry, vertices, normals);
+        model->setBlendedVertices(blendNumber, geometry, blendedVertices);
     }
     _pendingBlenders--;
     {
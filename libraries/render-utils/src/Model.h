@@ -17,11 +17,13 @@
 #include <QUrl>
 #include <QMutex>
 
+#include <array>
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
 
 #include <AABox.h>
+#include <CompactBlendshapes.h>
 #include <DependencyManager.h>
 #include <GeometryUtil.h>
 #include <gpu/Batch.h>
@@ -58,6 +60,13 @@ class Model;
 using ModelPointer = std::shared_ptr<Model>;
 using ModelWeakPointer = std::weak_ptr<Model>;
 
+/// The vertices and normals of a model's blended meshes, written by a blender and handed back to the model as is
+struct BlendedVertices {
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::vec3> normals;
+};
+using BlendedVerticesPointer = std::shared_ptr<BlendedVertices>;
+
 
 /// A generic 3D model displaying geometry loaded from a URL.
 class Model : public QObject, public std::enable_shared_from_this<Model> {
@@ -113,8 +122,7 @@ public:
     bool maybeStartBlender();
 
     /// Sets blended vertices computed in a separate thread.
-    void setBlendedVertices(int blendNumber, const Geometry::WeakPointer& geometry,
-        const QVector<glm::vec3>& vertices, const QVector<glm::vec3>& normals);
+    void setBlendedVertices(int blendNumber, const Geometry::WeakPointer& geometry, const BlendedVerticesPointer& blendedVertices);
 
     bool isLoaded() const { return (bool)_renderGeometry && _renderGeometry->isGeometryLoaded(); }
     bool isAddedToScene() const { return _addedToScene; }
@@ -365,6 +373,14 @@ protected:
     int _blendNumber;
     int _appliedBlendNumber;
 
+    // The blenders write into one of two persistent sets of blended vertices, so a blend can start while
+    // the last one waits to be applied, without allocating either
+    static const int NUM_BLENDED_VERTICES { 2 };
+    CompactBlendedMeshes::Pointer _compactBlendedMeshes;
+    std::array<BlendedVerticesPointer, NUM_BLENDED_VERTICES> _blendedVertices;
+    std::array<bool, NUM_BLENDED_VERTICES> _isBlending {{ false, false }};
+    bool _needsBlend { false };
+
     QMutex _mutex;
 
     bool _triangleSetsValid { false };
@@ -427,6 +443,7 @@ private:
 
 Q_DECLARE_METATYPE(ModelPointer)
 Q_DECLARE_METATYPE(Geometry::WeakPointer)
+Q_DECLARE_METATYPE(BlendedVerticesPointer)
 
 /// Handle management of pending models that need blending
 class ModelBlender : public QObject, public Dependency {
@@ -438,9 +455,12 @@ public:
     /// Adds the specified model to the list requiring vertex blends.
     void noteRequiresBlend(ModelPointer model);
 
+    /// Returns the compacted blendshapes of a geometry, shared by all the models using it.
+    CompactBlendedMeshes::Pointer getCompactBlendedMeshes(const Geometry::Pointer& geometry);
+
 public slots:
     void setBlendedVertices(ModelPointer model, int blendNumber, const Geometry::WeakPointer& geometry,
-        const QVector<glm::vec3>& vertices, const QVector<glm::vec3>& normals);
+        BlendedVerticesPointer blendedVertices);
 
 private:
     using Mutex = std::mutex;
@@ -452,6 +472,12 @@ private:
     std::set<ModelWeakPointer, std::owner_less<ModelWeakPointer>> _modelsRequiringBlends;
     int _pendingBlenders;
     Mutex _mutex;
+
+    struct CompactBlendedMeshesEntry {
+        Geometry::WeakPointer geometry;
+        std::weak_ptr<const CompactBlendedMeshes> meshes;
+    };
+    std::unordered_map<const Geometry*, CompactBlendedMeshesEntry> _compactBlendedMeshes;
 };
 
 
@@ -85,6 +85,7 @@ class DrawStateSortConfig : public render::Job::Config {
         Q_PROPERTY(int numDrawn READ getNumDrawn NOTIFY numDrawnChanged)
         Q_PROPERTY(int maxDrawn MEMBER maxDrawn NOTIFY dirty)
         Q_PROPERTY(bool stateSort MEMBER stateSort NOTIFY dirty)
+        Q_PROPERTY(bool concurrentRecording MEMBER concurrentRecording NOTIFY dirty)
 public:
 
     int getNumDrawn() { return numDrawn; }
@@ -92,6 +93,7 @@ public:
 
     int maxDrawn{ -1 };
     bool stateSort{ true };
+    bool concurrentRecording{ false }; // record the state sorted buckets on the task workers
 
 signals:
     void numDrawnChanged();
@@ -110,13 +112,14 @@ public:
 
     DrawStateSortDeferred(render::ShapePlumberPointer shapePlumber) : _shapePlumber{ shapePlumber } {}
 
-    void configure(const Config& config) { _maxDrawn = config.maxDrawn; _stateSort = config.stateSort; }
+    void configure(const Config& config) { _maxDrawn = config.maxDrawn; _stateSort = config.stateSort; _concurrentRecording = config.concurrentRecording; }
     void run(const render::RenderContextPointer& renderContext, const Inputs& inputs);
 
 protected:
     render::ShapePlumberPointer _shapePlumber;
     int _maxDrawn; // initialized by Config
     bool _stateSort;
+    bool _concurrentRecording;
 };
 
 class DrawOverlay3DConfig : public render::Job::Config {
@@ -40,6 +40,7 @@ namespace render {
         };
 
         int _materialSwitches = 0;
+        int _instancedShapes = 0; // drawn as instances of a draw shared with identical shapes
         int _trianglesRendered = 0;
 
         Item _item;
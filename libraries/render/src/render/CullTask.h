@@ -25,6 +25,7 @@ namespace render {
     class FetchNonspatialItems {
     public:
         using JobModel = Job::ModelO<FetchNonspatialItems, ItemBounds>;
+        static const bool IsConcurrent = true;
         void run(const RenderContextPointer& renderContext, ItemBounds& outItems);
     };
 
@@ -56,6 +57,7 @@ namespace render {
     public:
         using Config = FetchSpatialTreeConfig;
         using JobModel = Job::ModelIO<FetchSpatialTree, ItemFilter, ItemSpatialTree::ItemSelection, Config>;
+        static const bool IsConcurrent = true;
 
         FetchSpatialTree() {}
 
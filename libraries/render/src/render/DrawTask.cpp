@@ -16,11 +16,13 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <mutex>
 
 #include <PerfStat.h>
 #include <ViewFrustum.h>
 #include <gpu/Context.h>
 #include <gpu/StandardShaderLib.h>
+#include <task/JobGraph.h>
 
 #include <drawItemBounds_vert.h>
 #include <drawItemBounds_frag.h>
@@ -77,8 +79,87 @@ void render::renderShapes(const RenderContextPointer& renderContext,
     }
 }
 
+using SortedPipelines = std::vector<render::ShapeKey>;
+using SortedShapes = std::unordered_map<render::ShapeKey, std::vector<Item>, render::ShapeKey::Hash, render::ShapeKey::KeyEqual>;
+
+// Big buckets are split up, so a single bucket holding most of the shapes doesn't leave the other workers idle
+static const size_t SHAPES_PER_RECORDING = 128;
+
+// The batches the workers record into, kept from frame to frame so they keep their allocations
+static std::mutex recordingBatchesMutex;
+static std::vector<std::unique_ptr<gpu::Batch>> recordingBatches;
+
+static std::unique_ptr<gpu::Batch> acquireRecordingBatch() {
+    std::lock_guard<std::mutex> lock(recordingBatchesMutex);
+    if (recordingBatches.empty()) {
+        return std::unique_ptr<gpu::Batch>(new gpu::Batch());
+    }
+    auto batch = std::move(recordingBatches.back());
+    recordingBatches.pop_back();
+    return batch;
+}
+
+static void releaseRecordingBatch(std::unique_ptr<gpu::Batch> batch) {
+    batch->clear();
+    std::lock_guard<std::mutex> lock(recordingBatchesMutex);
+    recordingBatches.push_back(std::move(batch));
+}
+
+// A run of shapes of one bucket, recorded with args of its own
+struct ShapeRecording {
+    ShapeKey key;
+    const std::vector<Item>* shapes;
+    size_t begin;
+    size_t end;
+    RenderArgs args;
+    std::unique_ptr<gpu::Batch> batch;
+};
+
+static void recordStateSortedShapesConcurrently(RenderArgs* args, const ShapePlumberPointer& shapeContext,
+    const SortedPipelines& sortedPipelines, SortedShapes& sortedShapes) {
+    std::vector<ShapeRecording> recordings;
+    for (auto& pipelineKey : sortedPipelines) {
+        const auto& bucket = sortedShapes[pipelineKey];
+        for (size_t begin = 0; begin < bucket.size(); begin += SHAPES_PER_RECORDING) {
+            ShapeRecording recording { pipelineKey, &bucket, begin, std::min(begin + SHAPES_PER_RECORDING, bucket.size()), *args, nullptr };
+            recordings.push_back(std::move(recording));
+        }
+    }
+
+    // Picking a pipeline is not thread safe, so each recording starts with its pipeline set up from here
+    for (auto& recording : recordings) {
+        recording.batch = acquireRecordingBatch();
+        recording.args._batch = recording.batch.get();
+        recording.args._details = RenderDetails();
+        recording.args._shapePipeline = shapeContext->pickPipeline(&recording.args, recording.key);
+        recording.args._itemShapeKey = recording.key._flags.to_ulong();
+    }
+
+    task::JobGraph::runIndependently(recordings.size(), [&](size_t index) {
+        auto& recording = recordings[index];
+        auto& recordingArgs = recording.args;
+        if (!recordingArgs._shapePipeline) {
+            return;
+        }
+        for (size_t i = recording.begin; i < recording.end; ++i) {
+            const auto& item = (*recording.shapes)[i];
+            recordingArgs._shapePipeline->prepareShapeItem(&recordingArgs, recording.key, item);
+            item.render(&recordingArgs);
+        }
+    });
+
+    for (auto& recording : recordings) {
+        args->_batch->append(*recording.batch);
+        args->_details._materialSwitches += recording.args._details._materialSwitches;
+        args->_details._instancedShapes += recording.args._details._instancedShapes;
+        args->_details._trianglesRendered += recording.args._details._trianglesRendered;
+        releaseRecordingBatch(std::move(recording.batch));
+    }
+}
+
 void render::renderStateSortShapes(const RenderContextPointer& renderContext,
-    const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems, const ShapeKey& globalKey) {
+    const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems, const ShapeKey& globalKey,
+    bool concurrentRecording) {
     auto& scene = renderContext->_scene;
     RenderArgs* args = renderContext->args;
 
@@ -87,8 +168,6 @@ void render::renderStateSortShapes(const RenderContextPointer& renderContext,
         numItemsToDraw = glm::min(numItemsToDraw, maxDrawnItems);
     }
 
-    using SortedPipelines = std::vector<render::ShapeKey>;
-    using SortedShapes = std::unordered_map<render::ShapeKey, std::vector<Item>, render::ShapeKey::Hash, render::ShapeKey::KeyEqual>;
     SortedPipelines sortedPipelines;
     SortedShapes sortedShapes;
     std::vector< std::tuple<Item,ShapeKey> > ownPipelineBucket;
@@ -116,16 +195,21 @@ void render::renderStateSortShapes(const RenderContextPointer& renderContext,
     }
 
     // Then render
-    for (auto& pipelineKey : sortedPipelines) {
-        auto& bucket = sortedShapes[pipelineKey];
-        args->_shapePipeline = shapeContext->pickPipeline(args, pipelineKey);
-        if (!args->_shapePipeline) {
-            continue;
-        }
-        args->_itemShapeKey = pipelineKey._flags.to_ulong();
-        for (auto& item : bucket) {
-            args->_shapePipeline->prepareShapeItem(args, pipelineKey, item);
-            item.render(args);
+    // The performance timers the payloads use are not thread safe, so nothing is recorded concurrently while they run
+    if (concurrentRecording && !PerformanceTimer::isActive()) {
+        recordStateSortedShapesConcurrently(args, shapeContext, sortedPipelines, sortedShapes);
+    } else {
+        for (auto& pipelineKey : sortedPipelines) {
+            auto& bucket = sortedShapes[pipelineKey];
+            args->_shapePipeline = shapeContext->pickPipeline(args, pipelineKey);
+            if (!args->_shapePipeline) {
+                continue;
+            }
+            args->_itemShapeKey = pipelineKey._flags.to_ulong();
+            for (auto& item : bucket) {
+                args->_shapePipeline->prepareShapeItem(args, pipelineKey, item);
+                item.render(args);
+            }
         }
     }
     args->_shapePipeline = nullptr;
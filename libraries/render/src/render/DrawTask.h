@@ -18,7 +18,10 @@ namespace render {
 
 void renderItems(const RenderContextPointer& renderContext, const ItemBounds& inItems, int maxDrawnItems = -1);
 void renderShapes(const RenderContextPointer& renderContext, const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems = -1, const ShapeKey& globalKey = ShapeKey());
-void renderStateSortShapes(const RenderContextPointer& renderContext, const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems = -1, const ShapeKey& globalKey = ShapeKey());
+// With concurrentRecording, the buckets of shapes sharing a pipeline are recorded into batches of their own
+// on the task workers, and appended to the current batch in the same order they would otherwise be recorded in.
+// The payloads of the shapes must then be safe to render from any thread.
+void renderStateSortShapes(const RenderContextPointer& renderContext, const ShapePlumberPointer& shapeContext, const ItemBounds& inItems, int maxDrawnItems = -1, const ShapeKey& globalKey = ShapeKey(), bool concurrentRecording = false);
 
 class DrawLightConfig : public Job::Config {
     Q_OBJECT
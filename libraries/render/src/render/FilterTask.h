@@ -33,6 +33,7 @@ namespace render {
         using ItemBoundsArray = VaryingArray<ItemBounds, NUM_FILTERS>;
         using Config = MultiFilterItemsConfig;
         using JobModel = Job::ModelIO<MultiFilterItems, ItemBounds, ItemBoundsArray, Config>;
+        static const bool IsConcurrent = true;
 
         MultiFilterItems() {}
         MultiFilterItems(const ItemFilterArray& filters) :
@@ -47,6 +47,7 @@ namespace render {
     class DepthSortItems {
     public:
         using JobModel = Job::ModelIO<DepthSortItems, ItemBounds, ItemBounds>;
+        static const bool IsConcurrent = true;
 
         bool _frontToBack;
         DepthSortItems(bool frontToBack = true) : _frontToBack(frontToBack) {}
@@ -131,6 +131,7 @@ public:
 
 class TaskConfig : public JobConfig {
     Q_OBJECT
+    Q_PROPERTY(bool concurrent READ isConcurrent WRITE setConcurrent NOTIFY dirtyConcurrent())
 public:
     using QConfigPointer = std::shared_ptr<QObject>;
 
@@ -174,11 +175,20 @@ public:
 
     void connectChildConfig(QConfigPointer childConfig, const std::string& name);
     void transferChildrenConfigs(QConfigPointer source);
+
+    // Run the concurrent jobs of the task across the task workers, as their inputs and outputs allow
+    bool isConcurrent() const { return concurrent; }
+    void setConcurrent(bool enable) { concurrent = enable; emit dirtyConcurrent(); }
+
+    bool concurrent{ false };
      
     JobConcept* _task;
 
 public slots:
     void refresh();
+
+signals:
+    void dirtyConcurrent();
 };
 
 using QConfigPointer = std::shared_ptr<QObject>;
@@ -0,0 +1,204 @@
+//
+//  JobGraph.cpp
+//  render/src/task
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "JobGraph.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+using namespace task;
+
+static const int MAX_TASK_THREADS = 4;
+
+static QThreadPool& getTaskThreadPool() {
+    static QThreadPool* pool = [] {
+        auto pool = new QThreadPool();
+        // leave a core for the thread running the task, which works through the jobs too
+        pool->setMaxThreadCount(std::max(1, std::min(QThread::idealThreadCount() - 1, MAX_TASK_THREADS)));
+        return pool;
+    }();
+    return *pool;
+}
+
+// the varying and every varying it holds
+static void collectIDs(const Varying& varying, std::vector<const void*>& ids) {
+    if (varying.isNull()) {
+        return;
+    }
+    ids.push_back(varying.getID());
+    for (uint8_t i = 0; i < varying.length(); ++i) {
+        collectIDs(varying[i], ids);
+    }
+}
+
+static bool intersects(const std::vector<const void*>& a, const std::vector<const void*>& b) {
+    auto itA = a.begin();
+    auto itB = b.begin();
+    while (itA != a.end() && itB != b.end()) {
+        if (*itA < *itB) {
+            ++itA;
+        } else if (*itB < *itA) {
+            ++itB;
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobGraph::build(const std::vector<JobIO>& jobs) {
+    clear();
+
+    const size_t numJobs = jobs.size();
+    _dependents.resize(numJobs);
+    _numDependencies.resize(numJobs, 0);
+
+    std::vector<std::vector<const void*>> inputs(numJobs);
+    std::vector<std::vector<const void*>> outputs(numJobs);
+    for (size_t i = 0; i < numJobs; ++i) {
+        collectIDs(jobs[i].input, inputs[i]);
+        collectIDs(jobs[i].output, outputs[i]);
+        std::sort(inputs[i].begin(), inputs[i].end());
+        std::sort(outputs[i].begin(), outputs[i].end());
+    }
+
+    size_t begin = 0;
+    while (begin < numJobs) {
+        size_t end = begin + 1;
+        if (jobs[begin].concurrent) {
+            while (end < numJobs && jobs[end].concurrent) {
+                ++end;
+            }
+        }
+        _segments.emplace_back(begin, end);
+
+        for (size_t j = begin + 1; j < end; ++j) {
+            for (size_t i = begin; i < j; ++i) {
+                if (intersects(outputs[i], inputs[j]) || intersects(inputs[i], outputs[j]) ||
+                    intersects(outputs[i], outputs[j])) {
+                    _dependents[i].push_back(j);
+                    ++_numDependencies[j];
+                }
+            }
+        }
+
+        begin = end;
+    }
+}
+
+void JobGraph::clear() {
+    _segments.clear();
+    _dependents.clear();
+    _numDependencies.clear();
+}
+
+void JobGraph::run(const RunJob& runJob) const {
+    for (const auto& segment : _segments) {
+        if (segment.second - segment.first == 1) {
+            runJob(segment.first);
+        } else {
+            runSegment(segment, runJob);
+        }
+    }
+}
+
+void JobGraph::runIndependently(size_t numJobs, const RunJob& runJob) {
+    if (numJobs == 0) {
+        return;
+    }
+
+    JobGraph graph;
+    graph._segments.emplace_back(0, numJobs);
+    graph._dependents.resize(numJobs);
+    graph._numDependencies.resize(numJobs, 0);
+    graph.run(runJob);
+}
+
+namespace {
+
+// shared with the workers, which may only get to it after the segment is done
+struct SegmentState {
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<size_t> ready;
+    std::vector<int> remaining;
+    size_t numJobs { 0 };
+    size_t numDone { 0 };
+    JobGraph::RunJob runJob;
+    const JobGraph* graph { nullptr };
+    size_t begin { 0 };
+
+    void work() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (numDone < numJobs) {
+            if (ready.empty()) {
+                condition.wait(lock);
+                continue;
+            }
+
+            size_t job = ready.front();
+            ready.pop_front();
+
+            lock.unlock();
+            runJob(job);
+            lock.lock();
+
+            ++numDone;
+            for (auto dependent : graph->getDependents(job)) {
+                if (--remaining[dependent - begin] == 0) {
+                    ready.push_back(dependent);
+                }
+            }
+            condition.notify_all();
+        }
+    }
+};
+
+class SegmentWorker : public QRunnable {
+public:
+    SegmentWorker(std::shared_ptr<SegmentState> state) : _state(state) {}
+    void run() override { _state->work(); }
+
+private:
+    std::shared_ptr<SegmentState> _state;
+};
+
+}
+
+void JobGraph::runSegment(const Segment& segment, const RunJob& runJob) const {
+    auto state = std::make_shared<SegmentState>();
+    state->numJobs = segment.second - segment.first;
+    state->runJob = runJob;
+    state->graph = this;
+    state->begin = segment.first;
+    state->remaining.resize(state->numJobs);
+    for (size_t job = segment.first; job < segment.second; ++job) {
+        state->remaining[job - segment.first] = _numDependencies[job];
+        if (_numDependencies[job] == 0) {
+            state->ready.push_back(job);
+        }
+    }
+
+    // the calling thread works through the jobs as well, so the segment finishes even if no worker ever gets to it
+    auto& pool = getTaskThreadPool();
+    int numWorkers = std::min((int)state->numJobs - 1, pool.maxThreadCount());
+    for (int i = 0; i < numWorkers; ++i) {
+        pool.start(new SegmentWorker(state));
+    }
+
+    state->work();
+}
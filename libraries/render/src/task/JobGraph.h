@@ -0,0 +1,70 @@
+//
+//  JobGraph.h
+//  render/src/task
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_task_JobGraph_h
+#define hifi_task_JobGraph_h
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "Varying.h"
+
+namespace task {
+
+// The dependencies between the jobs of a task, derived from the varyings they read and write.
+// Jobs that are not concurrent keep their place in the task's order and nothing runs alongside them, so whatever they
+// do to the context happens where it always did. Between two of them, a run of concurrent jobs only has to respect
+// the varyings: a job waits for the jobs before it that write what it reads, read what it writes or write it too.
+class JobGraph {
+public:
+    struct JobIO {
+        JobIO() {}
+        JobIO(const Varying& input, const Varying& output, bool concurrent) :
+            input(input), output(output), concurrent(concurrent) {}
+
+        Varying input;
+        Varying output;
+        bool concurrent { false };
+    };
+
+    // first and one past the last job of a run that either is a single job or only holds concurrent jobs
+    using Segment = std::pair<size_t, size_t>;
+
+    void build(const std::vector<JobIO>& jobs);
+    void clear();
+
+    size_t size() const { return _numDependencies.size(); }
+    const std::vector<Segment>& getSegments() const { return _segments; }
+
+    // the jobs of the same segment that wait for this one, and the number this one waits for
+    const std::vector<size_t>& getDependents(size_t job) const { return _dependents[job]; }
+    int getNumDependencies(size_t job) const { return _numDependencies[job]; }
+
+    using RunJob = std::function<void(size_t job)>;
+
+    // runs every job once, each segment after the one before it, and the concurrent jobs of a segment across the task
+    // workers and the calling thread as soon as the jobs they depend on are done
+    void run(const RunJob& runJob) const;
+
+    // runs jobs that don't depend on each other at all the same way, without a graph to build
+    static void runIndependently(size_t numJobs, const RunJob& runJob);
+
+private:
+    void runSegment(const Segment& segment, const RunJob& runJob) const;
+
+    std::vector<Segment> _segments;
+    std::vector<std::vector<size_t>> _dependents;
+    std::vector<int> _numDependencies;
+};
+
+}
+
+#endif // hifi_task_JobGraph_h
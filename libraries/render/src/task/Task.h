@@ -14,6 +14,7 @@
 
 #include "Config.h"
 #include "Varying.h"
+#include "JobGraph.h"
 
 #include "SettingHandle.h"
 
@@ -51,6 +52,8 @@ public:
     virtual QConfigPointer& getConfiguration() { return _config; }
     virtual void applyConfiguration() = 0;
 
+    virtual bool isConcurrent() const { return false; }
+
     void setCPURunTime(double mstime) { std::static_pointer_cast<Config>(_config)->setCPURunTime(mstime); }
 
     QConfigPointer _config;
@@ -58,6 +61,13 @@ protected:
 };
 
 
+// A job can run alongside the other jobs of its task by declaring
+//     static const bool IsConcurrent = true;
+// It then gets a context of its own, must only read what is shared through it (such as the render args),
+// and must only touch the varyings it was given
+template <class T, class = void> struct JobIsConcurrent : std::false_type {};
+template <class T> struct JobIsConcurrent<T, typename std::enable_if<T::IsConcurrent>::type> : std::true_type {};
+
 template <class T, class C> void jobConfigure(T& data, const C& configuration) {
     data.configure(configuration);
 }
@@ -130,6 +140,8 @@ public:
             jobConfigure(_data, *std::static_pointer_cast<C>(Concept::_config));
         }
 
+        bool isConcurrent() const override { return JobIsConcurrent<Data>::value; }
+
         void run(const ContextPointer& renderContext) override {
             renderContext->jobConfig = std::static_pointer_cast<Config>(Concept::_config);
             if (renderContext->jobConfig->alwaysEnabled || renderContext->jobConfig->isEnabled()) {
@@ -171,6 +183,21 @@ public:
         _concept->setCPURunTime((double)(usecTimestampNow() - start) / 1000.0);
     }
 
+    bool isConcurrent() const { return _concept->isConcurrent(); }
+
+    // Run from a task worker: the PerformanceTimer is not thread safe and the config signals its stats on the task's
+    // thread, so this only returns the run time in ms for the task to set once its jobs are done
+    double runOnWorker(const ContextPointer& renderContext) {
+        PROFILE_RANGE(render, _name.c_str());
+        auto start = usecTimestampNow();
+
+        _concept->run(renderContext);
+
+        return (double)(usecTimestampNow() - start) / 1000.0;
+    }
+
+    void setCPURunTime(double mstime) { _concept->setCPURunTime(mstime); }
+
     const std::string& getName() const { return _name; }
 
 protected:
@@ -205,6 +232,7 @@ public:
         Varying _input;
         Varying _output;
         Jobs _jobs;
+        JobGraph _graph;
 
         const Varying getInput() const override { return _input; }
         const Varying getOutput() const override { return _output; }
@@ -232,6 +260,7 @@ public:
         // Create a new job in the container's queue; returns the job's output
         template <class NT, class... NA> const Varying addJob(std::string name, const Varying& input, NA&&... args) {
             _jobs.emplace_back(name, (NT::JobModel::create(input, std::forward<NA>(args)...)));
+            _graph.clear();
 
             // Conect the child config to this task's config
             std::static_pointer_cast<TaskConfig>(Concept::getConfiguration())->connectChildConfig(_jobs.back().getConfiguration(), name);
@@ -303,9 +332,43 @@ public:
         void run(const ContextPointer& renderContext) override {
             auto config = std::static_pointer_cast<C>(Concept::_config);
             if (config->alwaysEnabled || config->enabled) {
-                for (auto job : TaskConcept::_jobs) {
+                if (config->isConcurrent()) {
+                    runConcurrently(renderContext);
+                } else {
+                    for (auto job : TaskConcept::_jobs) {
+                        job.run(renderContext);
+                    }
+                }
+            }
+        }
+
+        void runConcurrently(const ContextPointer& renderContext) {
+            auto& jobs = TaskConcept::_jobs;
+            auto& graph = TaskConcept::_graph;
+            if (graph.size() != jobs.size()) {
+                std::vector<JobGraph::JobIO> jobIOs;
+                jobIOs.reserve(jobs.size());
+                for (const auto& job : jobs) {
+                    jobIOs.push_back({ job.getInput(), job.getOutput(), job.isConcurrent() });
+                }
+                graph.build(jobIOs);
+            }
+
+            std::vector<double> runTimes(jobs.size(), -1.0);
+            graph.run([&](size_t index) {
+                auto& job = jobs[index];
+                if (job.isConcurrent()) {
+                    // the job sets its config on the context, so each one needs its own
+                    runTimes[index] = job.runOnWorker(std::make_shared<Context>(*renderContext));
+                } else {
                     job.run(renderContext);
                 }
+            });
+
+            for (size_t i = 0; i < jobs.size(); ++i) {
+                if (runTimes[i] >= 0.0) {
+                    jobs[i].setCPURunTime(runTimes[i]);
+                }
             }
         }
     };
@@ -14,9 +14,31 @@
 
 #include <tuple>
 #include <array>
+#include <type_traits>
 
 namespace task {
 
+class Varying;
+
+// The varying sets and arrays hold other varyings, a Varying holding one of them gives access to those
+template <class T> class IsVaryingContainer {
+    template <class U> static auto check(int) -> typename std::is_same<
+        typename std::decay<decltype(std::declval<const U&>().length(), std::declval<const U&>()[(uint8_t)0])>::type,
+        Varying>::type;
+    template <class U> static std::false_type check(...);
+public:
+    static const bool value = decltype(check<T>(0))::value;
+};
+
+template <class T, bool IS_CONTAINER = IsVaryingContainer<T>::value> struct VaryingElements {
+    static Varying get(const T& data, uint8_t index);
+    static uint8_t length(const T& data) { return 0; }
+};
+template <class T> struct VaryingElements<T, true> {
+    static Varying get(const T& data, uint8_t index);
+    static uint8_t length(const T& data) { return data.length(); }
+};
+
 // A varying piece of data, to be used as Job/Task I/O
 class Varying {
 public:
@@ -42,6 +64,9 @@ public:
 
     bool isNull() const { return _concept == nullptr; }
 
+    // identifies the data, which every copy of this varying shares
+    const void* getID() const { return _concept.get(); }
+
 protected:
     class Concept {
     public:
@@ -57,11 +82,8 @@ protected:
         Model(const Data& data) : _data(data) {}
         virtual ~Model() = default;
 
-        virtual Varying operator[] (uint8_t index) const override {
-            Varying var;
-            return var;
-        }
-        virtual uint8_t length() const override { return 0; }
+        virtual Varying operator[] (uint8_t index) const override { return VaryingElements<T>::get(_data, index); }
+        virtual uint8_t length() const override { return VaryingElements<T>::length(_data); }
 
         Data _data;
     };
@@ -69,6 +91,13 @@ protected:
     std::shared_ptr<Concept> _concept;
 };
 
+template <class T, bool IS_CONTAINER> Varying VaryingElements<T, IS_CONTAINER>::get(const T& data, uint8_t index) {
+    return Varying();
+}
+template <class T> Varying VaryingElements<T, true>::get(const T& data, uint8_t index) {
+    return data[index];
+}
+
 using VaryingPairBase = std::pair<Varying, Varying>;
 template < typename T0, typename T1 >
 class VaryingSet2 : public VaryingPairBase {
@@ -289,6 +318,26 @@ public:
     const T6& get6() const { return std::get<6>((*this)).template get<T6>(); }
     T6& edit6() { return std::get<6>((*this)).template edit<T6>(); }
     
+    virtual Varying operator[] (uint8_t index) const {
+        switch (index) {
+        default:
+            return std::get<0>((*this));
+        case 1:
+            return std::get<1>((*this));
+        case 2:
+            return std::get<2>((*this));
+        case 3:
+            return std::get<3>((*this));
+        case 4:
+            return std::get<4>((*this));
+        case 5:
+            return std::get<5>((*this));
+        case 6:
+            return std::get<6>((*this));
+        };
+    }
+    virtual uint8_t length() const { return 7; }
+
     Varying asVarying() const { return Varying((*this)); }
 };
 
@@ -325,6 +374,28 @@ public:
     const T7& get7() const { return std::get<7>((*this)).template get<T7>(); }
     T7& edit7() { return std::get<7>((*this)).template edit<T7>(); }
 
+    virtual Varying operator[] (uint8_t index) const {
+        switch (index) {
+        default:
+            return std::get<0>((*this));
+        case 1:
+            return std::get<1>((*this));
+        case 2:
+            return std::get<2>((*this));
+        case 3:
+            return std::get<3>((*this));
+        case 4:
+            return std::get<4>((*this));
+        case 5:
+            return std::get<5>((*this));
+        case 6:
+            return std::get<6>((*this));
+        case 7:
+            return std::get<7>((*this));
+        };
+    }
+    virtual uint8_t length() const { return 8; }
+
     Varying asVarying() const { return Varying((*this)); }
 };
 
@@ -341,6 +412,8 @@ public:
         assert(list.size() == NUM);
         std::copy(list.begin(), list.end(), std::array<Varying, NUM>::begin());
     }
+
+    uint8_t length() const { return NUM; }
 };
 }
 
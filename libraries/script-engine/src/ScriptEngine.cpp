@@ -1930,6 +1930,13 @@ int ScriptEngine::getNumRunningEntityScripts() const {
     return sum;
 }
 
+QHash<EntityItemID, quint64> ScriptEngine::takeEntityScriptCPUTimes() {
+    QHash<EntityItemID, quint64> cpuTimes;
+    std::lock_guard<std::mutex> lock(_entityScriptCPUTimesLock);
+    std::swap(cpuTimes, _entityScriptCPUTimes);
+    return cpuTimes;
+}
+
 void ScriptEngine::setEntityScriptDetails(const EntityItemID& entityID, const EntityScriptDetails& details) {
     _entityScripts[entityID] = details;
     emit entityScriptDetailsUpdated();
@@ -2455,6 +2462,10 @@ void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& s
     currentEntityIdentifier = entityID;
     currentSandboxURL = sandboxURL;
 
+    // only the outermost entity gets charged, so that nested calls aren't counted twice
+    bool accountCPUTime = oldIdentifier.isInvalidID() && !entityID.isInvalidID();
+    auto startTime = p_high_resolution_clock::now();
+
 #if DEBUG_CURRENT_ENTITY
     QScriptValue oldData = this->globalObject().property("debugEntityID");
     this->globalObject().setProperty("debugEntityID", entityID.toScriptValue(this)); // Make the entityID available to javascript as a global.
@@ -2464,6 +2475,12 @@ void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& s
     operation();
 #endif
     maybeEmitUncaughtException(!entityID.isNull() ? entityID.toString() : __FUNCTION__);
+
+    if (accountCPUTime) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now() - startTime);
+        std::lock_guard<std::mutex> lock(_entityScriptCPUTimesLock);
+        _entityScriptCPUTimes[entityID] += elapsed.count();
+    }
     currentEntityIdentifier = oldIdentifier;
     currentSandboxURL = oldSandboxURL;
 }
@@ -12,6 +12,7 @@
 #ifndef hifi_ScriptEngine_h
 #define hifi_ScriptEngine_h
 
+#include <mutex>
 #include <vector>
 
 #include <QtCore/QObject>
@@ -238,6 +239,10 @@ public:
     int getNumRunningEntityScripts() const;
     bool getEntityScriptDetails(const EntityItemID& entityID, EntityScriptDetails &details) const;
 
+    // Returns the CPU time (in usecs) spent running each entity script's code since the last call, and resets
+    // the counters. Safe to call from any thread.
+    QHash<EntityItemID, quint64> takeEntityScriptCPUTimes();
+
 public slots:
     void callAnimationStateHandler(QScriptValue callback, AnimVariantMap parameters, QStringList names, bool useNames, AnimVariantResultHandler resultHandler);
     void updateMemoryCost(const qint64&);
@@ -329,6 +334,9 @@ protected:
 
     std::chrono::microseconds _totalTimerExecution { 0 };
 
+    std::mutex _entityScriptCPUTimesLock;
+    QHash<EntityItemID, quint64> _entityScriptCPUTimes;
+
     static const QString _SETTINGS_ENABLE_EXTENDED_MODULE_COMPAT;
     static const QString _SETTINGS_ENABLE_EXTENDED_EXCEPTIONS;
 
@@ -33,24 +33,30 @@ Q_LOGGING_CATEGORY(trace_simulation_physics_detail, "trace.simulation.physics.de
 #define NSIGHT_TRACING
 #endif
 
-static bool tracingEnabled() {
-    return DependencyManager::isSet<tracing::Tracer>() && DependencyManager::get<tracing::Tracer>()->isEnabled();
-}
-
-Duration::Duration(const QLoggingCategory& category, const QString& name, uint32_t argbColor, uint64_t payload, const QVariantMap& baseArgs) : _name(name), _category(category) {
-    if (tracingEnabled() && category.isDebugEnabled()) {
-        QVariantMap args = baseArgs;
-        args["nv_payload"] = QVariant::fromValue(payload);
-        tracing::traceEvent(_category, _name, tracing::DurationBegin, "", args);
+Duration::Duration(const QLoggingCategory& category, const tracing::Name& name, uint32_t argbColor, uint64_t payload, const QVariantMap& baseArgs) : _name(name.id), _category(category) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
+        _active = true;
+        if (baseArgs.empty()) {
+            tracing::Arg arg;
+            if (payload != 0) {
+                arg = tracing::Arg("nv_payload", payload);
+            }
+            tracing::traceEvent(_category, name, tracing::DurationBegin, tracing::Name(), arg);
+        } else {
+            QVariantMap args = baseArgs;
+            args["nv_payload"] = QVariant::fromValue(payload);
+            tracing::traceEvent(_category, name, tracing::DurationBegin, tracing::Name(), args);
+        }
 
 #if defined(NSIGHT_TRACING)
+        QByteArray nameText = name.toUtf8();
         nvtxEventAttributes_t eventAttrib { 0 };
         eventAttrib.version = NVTX_VERSION;
         eventAttrib.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
         eventAttrib.colorType = NVTX_COLOR_ARGB;
         eventAttrib.color = argbColor;
         eventAttrib.messageType = NVTX_MESSAGE_TYPE_ASCII;
-        eventAttrib.message.ascii = name.toUtf8().data();
+        eventAttrib.message.ascii = nameText.data();
         eventAttrib.payload.llValue = payload;
         eventAttrib.payloadType = NVTX_PAYLOAD_TYPE_UNSIGNED_INT64;
 
@@ -60,8 +66,9 @@ Duration::Duration(const QLoggingCategory& category, const QString& name, uint32
 }
 
 Duration::~Duration() {
-    if (tracingEnabled() && _category.isDebugEnabled()) {
-        tracing::traceEvent(_category, _name, tracing::DurationEnd);
+    if (_active) {
+        // the begin event interned the name, so the end event only needs its ID
+        tracing::traceEvent(_category, tracing::Name(_name), tracing::DurationEnd, tracing::Name(), tracing::Arg());
 #ifdef NSIGHT_TRACING
         nvtxRangePop();
 #endif
@@ -71,7 +78,7 @@ Duration::~Duration() {
 // FIXME
 uint64_t Duration::beginRange(const QLoggingCategory& category, const char* name, uint32_t argbColor) {
 #ifdef NSIGHT_TRACING
-    if (tracingEnabled() && category.isDebugEnabled()) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
         nvtxEventAttributes_t eventAttrib = { 0 };
         eventAttrib.version = NVTX_VERSION;
         eventAttrib.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
@@ -88,7 +95,7 @@ uint64_t Duration::beginRange(const QLoggingCategory& category, const char* name
 // FIXME
 void Duration::endRange(const QLoggingCategory& category, uint64_t rangeId) {
 #ifdef NSIGHT_TRACING
-    if (tracingEnabled() && category.isDebugEnabled()) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
         nvtxRangeEnd(rangeId);
     }
 #endif
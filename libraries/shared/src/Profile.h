@@ -35,54 +35,67 @@ Q_DECLARE_LOGGING_CATEGORY(trace_simulation_physics_detail)
 
 class Duration {
 public:
-    Duration(const QLoggingCategory& category, const QString& name, uint32_t argbColor = 0xff0000ff, uint64_t payload = 0, const QVariantMap& args = QVariantMap());
+    Duration(const QLoggingCategory& category, const tracing::Name& name, uint32_t argbColor = 0xff0000ff, uint64_t payload = 0, const QVariantMap& args = QVariantMap());
     ~Duration();
 
     static uint64_t beginRange(const QLoggingCategory& category, const char* name, uint32_t argbColor);
     static void endRange(const QLoggingCategory& category, uint64_t rangeId);
 
 private:
-    QString _name;
+    tracing::NameID _name;
     const QLoggingCategory& _category;
+    bool _active { false };
 };
 
 
-inline void syncBegin(const QLoggingCategory& category, const QString& name, const QString& id, const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap()) {
-    if (category.isDebugEnabled()) {
+inline void syncBegin(const QLoggingCategory& category, const tracing::Name& name, const tracing::Name& id, const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap()) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
         tracing::traceEvent(category, name, tracing::DurationBegin, id, args, extra);
     }
 }
 
 
-inline void syncEnd(const QLoggingCategory& category, const QString& name, const QString& id, const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap()) {
-    if (category.isDebugEnabled()) {
+inline void syncEnd(const QLoggingCategory& category, const tracing::Name& name, const tracing::Name& id, const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap()) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
         tracing::traceEvent(category, name, tracing::DurationEnd, id, args, extra);
     }
 }
 
-inline void asyncBegin(const QLoggingCategory& category, const QString& name, const QString& id, const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap()) {
-    if (category.isDebugEnabled()) {
+inline void asyncBegin(const QLoggingCategory& category, const tracing::Name& name, const tracing::Name& id, const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap()) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
         tracing::traceEvent(category, name, tracing::AsyncNestableStart, id, args, extra);
     }
 }
 
 
-inline void asyncEnd(const QLoggingCategory& category, const QString& name, const QString& id, const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap()) {
-    if (category.isDebugEnabled()) {
+inline void asyncEnd(const QLoggingCategory& category, const tracing::Name& name, const tracing::Name& id, const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap()) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
         tracing::traceEvent(category, name, tracing::AsyncNestableEnd, id, args, extra);
     }
 }
 
-inline void instant(const QLoggingCategory& category, const QString& name, const QString& scope = "t", const QVariantMap& args = QVariantMap(), QVariantMap extra = QVariantMap()) {
-    if (category.isDebugEnabled()) {
+inline void instant(const QLoggingCategory& category, const tracing::Name& name, const QString& scope = "t", const QVariantMap& args = QVariantMap(), QVariantMap extra = QVariantMap()) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
+        if (args.empty() && extra.empty()) {
+            tracing::traceEvent(category, name, tracing::Instant, tracing::Name(), tracing::Arg(), scope.isEmpty() ? 0 : scope[0].toLatin1());
+            return;
+        }
         extra["s"] = scope;
-        tracing::traceEvent(category, name, tracing::Instant, "", args, extra);
+        tracing::traceEvent(category, name, tracing::Instant, tracing::Name(), args, extra);
     }
 }
 
-inline void counter(const QLoggingCategory& category, const QString& name, const QVariantMap& args, const QVariantMap& extra = QVariantMap()) {
-    if (category.isDebugEnabled()) {
-        tracing::traceEvent(category, name, tracing::Counter, "", args, extra);
+inline void counter(const QLoggingCategory& category, const tracing::Name& name, const QVariantMap& args, const QVariantMap& extra = QVariantMap()) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
+        tracing::traceEvent(category, name, tracing::Counter, tracing::Name(), args, extra);
+    }
+}
+
+// a counter with a single numeric series named after the counter, recorded without building a QVariantMap
+template <typename T>
+inline void counter(const QLoggingCategory& category, const tracing::Name& name, T value) {
+    if (tracing::enabled() && category.isDebugEnabled()) {
+        tracing::traceEvent(category, name, tracing::Counter, tracing::Name(), tracing::Arg(name, value));
     }
 }
 
@@ -98,8 +111,8 @@ inline void metadata(const QString& metadataType, const QVariantMap& args) {
 #define PROFILE_SYNC_END(category, name, id, ...) syncEnd(trace_##category(), name, id, ##__VA_ARGS__);
 #define PROFILE_ASYNC_BEGIN(category, name, id, ...) asyncBegin(trace_##category(), name, id, ##__VA_ARGS__);
 #define PROFILE_ASYNC_END(category, name, id, ...) asyncEnd(trace_##category(), name, id, ##__VA_ARGS__);
-#define PROFILE_COUNTER_IF_CHANGED(category, name, type, value) { static type lastValue = 0; type newValue = value;  if (newValue != lastValue) { counter(trace_##category(), name, { { name, newValue }}); lastValue = newValue; } }
-#define PROFILE_COUNTER(category, name, ...) counter(trace_##category(), name, ##__VA_ARGS__);
+#define PROFILE_COUNTER_IF_CHANGED(category, name, type, value) { static type lastValue = 0; type newValue = value;  if (newValue != lastValue) { counter(trace_##category(), name, newValue); lastValue = newValue; } }
+#define PROFILE_COUNTER(category, name, ...) { if (tracing::enabled() && trace_##category().isDebugEnabled()) { counter(trace_##category(), name, ##__VA_ARGS__); } }
 #define PROFILE_INSTANT(category, name, ...) instant(trace_##category(), name, ##__VA_ARGS__);
 #define PROFILE_SET_THREAD_NAME(threadName) metadata("thread_name", { { "name", threadName } });
 
@@ -21,6 +21,8 @@
 const float defaultAACubeSize = 1.0f;
 const int maxParentingChain = 30;
 
+std::atomic<bool> SpatiallyNestable::_worldTransformCacheEnabled { true };
+
 SpatiallyNestable::SpatiallyNestable(NestableType nestableType, QUuid id) :
     _nestableType(nestableType),
     _id(id),
@@ -35,6 +37,7 @@ SpatiallyNestable::SpatiallyNestable(NestableType nestableType, QUuid id) :
 
 SpatiallyNestable::~SpatiallyNestable() {
     forEachChild([&](SpatiallyNestablePointer object) {
+        object->invalidateWorldTransform();
         object->parentDeleted();
     });
 }
@@ -72,6 +75,7 @@ void SpatiallyNestable::setParentID(const QUuid& parentID) {
             _parentKnowsMe = false;
         }
     });
+    invalidateWorldTransform();
 
     bool success = false;
     getParentPointer(success);
@@ -161,6 +165,7 @@ void SpatiallyNestable::forgetChild(SpatiallyNestablePointer newChild) const {
 
 void SpatiallyNestable::setParentJointIndex(quint16 parentJointIndex) {
     _parentJointIndex = parentJointIndex;
+    invalidateWorldTransform();
 }
 
 glm::vec3 SpatiallyNestable::worldToLocal(const glm::vec3& position,
@@ -405,6 +410,9 @@ void SpatiallyNestable::setWorldPosition(const glm::vec3& position, bool& succes
             _translationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransform();
+    }
     if (success && changed) {
         locationChanged(tellPhysics);
     }
@@ -458,6 +466,9 @@ void SpatiallyNestable::setWorldOrientation(const glm::quat& orientation, bool&
             _rotationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransform();
+    }
     if (success && changed) {
         locationChanged(tellPhysics);
     }
@@ -593,14 +604,101 @@ glm::vec3 SpatiallyNestable::getParentAngularVelocity(bool& success) const {
 
 const Transform SpatiallyNestable::getTransform(bool& success, int depth) const {
     Transform result;
+    if (getCachedWorldTransform(result)) {
+        success = true;
+        return result;
+    }
+
+    // anything that moves us from here on bumps the generation, which keeps a stale result out of the cache
+    uint32_t generation = _worldTransformGeneration;
+
     // return a world-space transform for this object's location
     Transform parentTransform = getParentTransform(success, depth);
     _transformLock.withReadLock([&] {
         Transform::mult(result, parentTransform, _transform);
     });
+
+    if (success && _worldTransformCacheEnabled) {
+        // only cache when every ancestor is cached too, otherwise we'd never hear about it moving.  joints are
+        // left out since their poses change without telling their children.
+        SpatiallyNestablePointer parent = _parent.lock();
+        bool cacheable;
+        if (parent) {
+            cacheable = _parentKnowsMe && _parentJointIndex == INVALID_JOINT_INDEX && parent->isWorldTransformCached();
+        } else {
+            cacheable = getParentID().isNull();
+        }
+        if (cacheable) {
+            setCachedWorldTransform(result, generation);
+        }
+    }
     return result;
 }
 
+bool SpatiallyNestable::getCachedWorldTransform(Transform& result) const {
+    if (!_worldTransformCacheEnabled) {
+        return false;
+    }
+    uint32_t sequence = _worldTransformCacheSequence.load(std::memory_order_acquire);
+    if (sequence & 1) {
+        return false;
+    }
+    uint32_t cachedGeneration = _cachedWorldTransformGeneration.load(std::memory_order_relaxed);
+    glm::vec3 translation = _cachedWorldTranslation;
+    glm::quat rotation = _cachedWorldRotation;
+    glm::vec3 scale = _cachedWorldScale;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (_worldTransformCacheSequence.load(std::memory_order_relaxed) != sequence ||
+        cachedGeneration != _worldTransformGeneration.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    result.setScale(scale);
+    result.setRotation(rotation);
+    result.setTranslation(translation);
+    return true;
+}
+
+bool SpatiallyNestable::isWorldTransformCached() const {
+    return _worldTransformCacheEnabled && !(_worldTransformCacheSequence & 1) &&
+        _cachedWorldTransformGeneration == _worldTransformGeneration;
+}
+
+void SpatiallyNestable::setCachedWorldTransform(const Transform& transform, uint32_t generation) const {
+    // if another thread is already filling the cache, let it
+    uint32_t sequence = _worldTransformCacheSequence.load(std::memory_order_relaxed);
+    if ((sequence & 1) ||
+        !_worldTransformCacheSequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire)) {
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    _cachedWorldTranslation = transform.getTranslation();
+    _cachedWorldRotation = transform.getRotation();
+    _cachedWorldScale = transform.getScale();
+    _cachedWorldTransformGeneration.store(generation, std::memory_order_relaxed);
+    _worldTransformCacheSequence.store(sequence + 2, std::memory_order_release);
+}
+
+void SpatiallyNestable::invalidateWorldTransform(int depth) const {
+    _worldTransformGeneration++;
+    if (depth > maxParentingChain) {
+        // a parenting loop, which getTransform will break
+        return;
+    }
+
+    // children are visited without holding our lock, since a loop would bring us back here
+    QList<SpatiallyNestableWeakPointer> children;
+    _childrenLock.withReadLock([&] {
+        children = _children.values();
+    });
+    for (const auto& childWP : children) {
+        SpatiallyNestablePointer child = childWP.lock();
+        if (child) {
+            child->invalidateWorldTransform(depth + 1);
+        }
+    }
+}
+
 const Transform SpatiallyNestable::getTransform() const {
     bool success;
     Transform result = getTransform(success);
@@ -657,6 +755,9 @@ void SpatiallyNestable::setTransform(const Transform& transform, bool& success)
             _rotationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransform();
+    }
     if (success && changed) {
         locationChanged();
     }
@@ -711,6 +812,9 @@ void SpatiallyNestable::setSNScale(const glm::vec3& scale, bool& success) {
             _scaleChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransform();
+    }
     if (success && changed) {
         locationChanged();
     }
@@ -743,6 +847,7 @@ void SpatiallyNestable::setLocalTransform(const Transform& transform) {
     });
 
     if (changed) {
+        invalidateWorldTransform();
         locationChanged();
     }
 }
@@ -770,6 +875,7 @@ void SpatiallyNestable::setLocalPosition(const glm::vec3& position, bool tellPhy
         }
     });
     if (changed) {
+        invalidateWorldTransform();
         locationChanged(tellPhysics);
     }
 }
@@ -797,6 +903,7 @@ void SpatiallyNestable::setLocalOrientation(const glm::quat& orientation) {
         }
     });
     if (changed) {
+        invalidateWorldTransform();
         locationChanged();
     }
 }
@@ -853,6 +960,7 @@ void SpatiallyNestable::setLocalSNScale(const glm::vec3& scale) {
         }
     });
     if (changed) {
+        invalidateWorldTransform();
         dimensionsChanged();
     }
 }
@@ -1144,6 +1252,7 @@ void SpatiallyNestable::setLocalTransformAndVelocities(
     });
 
     if (changed) {
+        invalidateWorldTransform();
         locationChanged(false);
     }
 }
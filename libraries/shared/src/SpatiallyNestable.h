@@ -12,6 +12,8 @@
 #ifndef hifi_SpatiallyNestable_h
 #define hifi_SpatiallyNestable_h
 
+#include <atomic>
+
 #include <QUuid>
 
 #include "Transform.h"
@@ -194,6 +196,11 @@ public:
 
     void dump(const QString& prefix = "") const;
 
+    // World transforms are cached, and the cache is invalidated down through _children whenever a local transform or
+    // parent changes. This allows turning the cache off, to compare against.
+    static void setWorldTransformCacheEnabled(bool enabled) { _worldTransformCacheEnabled = enabled; }
+    static bool isWorldTransformCacheEnabled() { return _worldTransformCacheEnabled; }
+
 protected:
     const NestableType _nestableType; // EntityItem or an AvatarData
     QUuid _id;
@@ -231,6 +238,23 @@ private:
     mutable bool _parentKnowsMe { false };
     bool _isDead { false };
     bool _queryAACubeIsPuffed { false };
+
+    // the world transform cache. the generation is bumped every time this object or any of its ancestors moves, and
+    // the cache is only good while it holds the current generation. the sequence is odd while the cache is being
+    // written, so that readers can check it without taking a lock.
+    bool getCachedWorldTransform(Transform& result) const;
+    bool isWorldTransformCached() const;
+    void setCachedWorldTransform(const Transform& transform, uint32_t generation) const;
+    void invalidateWorldTransform(int depth = 0) const;
+
+    mutable std::atomic<uint32_t> _worldTransformGeneration { 1 };
+    mutable std::atomic<uint32_t> _cachedWorldTransformGeneration { 0 };
+    mutable std::atomic<uint32_t> _worldTransformCacheSequence { 0 };
+    mutable glm::vec3 _cachedWorldTranslation;
+    mutable glm::quat _cachedWorldRotation;
+    mutable glm::vec3 _cachedWorldScale;
+
+    static std::atomic<bool> _worldTransformCacheEnabled;
 };
 
 
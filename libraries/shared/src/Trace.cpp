@@ -8,11 +8,18 @@
 
 #include "Trace.h"
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 #include <QtCore/QDebug>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
 #include <QtCore/QFileInfo>
 #include <QtCore/QDir>
 #include <QtCore/QStandardPaths>
@@ -25,6 +32,7 @@
 #include <QtCore/QTextStream>
 
 #include <QtCore/QJsonObject>
+#include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 
 #include <BuildInfo.h>
@@ -35,28 +43,368 @@
 
 using namespace tracing;
 
+namespace {
+
+// Binary trace file layout, in native byte order: a FileHeader followed by blocks, each a BlockHeader and its payload.
+// An events block holds the ID of the thread that recorded it followed by its BinaryEvents, the names block holds
+// { NameID, length, UTF-8 text } records and the metadata block holds the metadata events as Chrome trace JSON.
+const char TRACE_FILE_MAGIC[8] = { 'H', 'F', 'T', 'R', 'A', 'C', 'E', '\0' };
+const uint32_t TRACE_FILE_VERSION = 1;
+const QString TRACE_FILE_EXTENSION = ".hftrace";
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t eventSize;
+    int64_t processID;
+};
+
+enum BlockType : uint32_t {
+    EventsBlock = 1,
+    NamesBlock,
+    MetadataBlock
+};
+
+struct BlockHeader {
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t size;
+};
+
+struct Chunk {
+    std::atomic<uint32_t> count { 0 };
+    qint64 threadID { 0 };
+    BinaryEvent events[Tracer::EVENTS_PER_CHUNK];
+};
+
+std::atomic<Tracer*> activeTracer { nullptr };
+
+uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
+}
+
+}
+
+struct Tracer::ThreadState {
+    std::shared_ptr<Session> session;
+    Chunk* chunk { nullptr };
+    qint64 threadID { int64_t(QThread::currentThreadId()) };
+    std::unordered_set<NameID> knownNames;
+    std::vector<std::pair<const QLoggingCategory*, NameID>> categories;
+
+    ~ThreadState();
+};
+
+// One trace: the chunk pool, the threads recording into it and the writer thread streaming full chunks to disk.
+class Tracer::Session {
+public:
+    Session(const QString& path);
+    ~Session();
+
+    bool isOpen() const { return _file.isOpen(); }
+
+    // queues the thread's current chunk, if any, and hands it an empty one; returns nullptr if none is free
+    Chunk* exchangeChunk(ThreadState& state);
+    void release(ThreadState& state);
+
+    // flushes everything recorded so far, appends the names and metadata and closes the file
+    void stop(const QHash<NameID, QByteArray>& names, const QByteArray& metadata);
+
+    std::atomic<uint64_t> droppedEvents { 0 };
+
+private:
+    void writeLoop();
+    void writeEvents(const Chunk& chunk, uint32_t count);
+    void writeBlock(BlockType type, const char* data, uint64_t size, const char* prefix = nullptr, uint64_t prefixSize = 0);
+
+    QFile _file;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::vector<Chunk*> _freeChunks;
+    std::vector<Chunk*> _fullChunks;
+    std::vector<Chunk*> _writingChunks;
+    std::vector<Chunk*> _retiredChunks; // chunks threads still held when the session stopped
+    std::vector<ThreadState*> _threads;
+    bool _stopping { false };
+    std::thread _writer;
+};
+
+static QThreadStorage<Tracer::ThreadState*> threadStates;
+
+static Tracer::ThreadState& getThreadState() {
+    if (!threadStates.hasLocalData()) {
+        threadStates.setLocalData(new Tracer::ThreadState());
+    }
+    return *threadStates.localData();
+}
+
+Tracer::ThreadState::~ThreadState() {
+    if (session) {
+        session->release(*this);
+    }
+}
+
+Tracer::Session::Session(const QString& path) : _file(path) {
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return;
+    }
+
+    FileHeader header;
+    memcpy(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_FILE_VERSION;
+    header.eventSize = sizeof(BinaryEvent);
+    header.processID = QCoreApplication::applicationPid();
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    _freeChunks.reserve(NUM_CHUNKS);
+    _fullChunks.reserve(NUM_CHUNKS);
+    _writingChunks.reserve(NUM_CHUNKS);
+    for (int i = 0; i < NUM_CHUNKS; ++i) {
+        _freeChunks.push_back(new Chunk());
+    }
+
+    _writer = std::thread([this] { writeLoop(); });
+}
+
+Tracer::Session::~Session() {
+    if (_writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _condition.notify_all();
+        _writer.join();
+    }
+    for (auto chunkList : { &_freeChunks, &_fullChunks, &_retiredChunks }) {
+        for (auto chunk : *chunkList) {
+            delete chunk;
+        }
+    }
+}
+
+Chunk* Tracer::Session::exchangeChunk(ThreadState& state) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (state.chunk) {
+        if (_stopping) {
+            _retiredChunks.push_back(state.chunk);
+        } else {
+            _fullChunks.push_back(state.chunk);
+            _condition.notify_one();
+        }
+        state.chunk = nullptr;
+    }
+    if (_stopping) {
+        return nullptr;
+    }
+
+    if (std::find(_threads.begin(), _threads.end(), &state) == _threads.end()) {
+        _threads.push_back(&state);
+    }
+    if (_freeChunks.empty()) {
+        return nullptr;
+    }
+
+    Chunk* chunk = _freeChunks.back();
+    _freeChunks.pop_back();
+    chunk->threadID = state.threadID;
+    chunk->count.store(0, std::memory_order_relaxed);
+    state.chunk = chunk;
+    return chunk;
+}
+
+void Tracer::Session::release(ThreadState& state) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _threads.erase(std::remove(_threads.begin(), _threads.end(), &state), _threads.end());
+    if (state.chunk) {
+        if (_stopping) {
+            _retiredChunks.push_back(state.chunk);
+        } else if (state.chunk->count.load(std::memory_order_relaxed) > 0) {
+            _fullChunks.push_back(state.chunk);
+            _condition.notify_one();
+        } else {
+            _freeChunks.push_back(state.chunk);
+        }
+        state.chunk = nullptr;
+    }
+}
+
+void Tracer::Session::writeLoop() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _condition.wait(lock, [this] { return _stopping || !_fullChunks.empty(); });
+        if (_fullChunks.empty()) {
+            break;
+        }
+        _writingChunks.swap(_fullChunks);
+
+        lock.unlock();
+        for (auto chunk : _writingChunks) {
+            writeEvents(*chunk, chunk->count.load(std::memory_order_acquire));
+        }
+        lock.lock();
+
+        for (auto chunk : _writingChunks) {
+            _freeChunks.push_back(chunk);
+        }
+        _writingChunks.clear();
+    }
+}
+
+void Tracer::Session::stop(const QHash<NameID, QByteArray>& names, const QByteArray& metadata) {
+    // the threads may keep appending to their current chunks, but never below the counts taken here
+    std::vector<std::pair<const Chunk*, uint32_t>> partialChunks;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+        for (auto state : _threads) {
+            if (state->chunk) {
+                partialChunks.emplace_back(state->chunk, state->chunk->count.load(std::memory_order_acquire));
+            }
+        }
+    }
+    _condition.notify_all();
+    if (_writer.joinable()) {
+        _writer.join();
+    }
+
+    for (const auto& partial : partialChunks) {
+        writeEvents(*partial.first, partial.second);
+    }
+
+    QByteArray namesData;
+    for (auto it = names.begin(); it != names.end(); ++it) {
+        uint32_t record[2] = { it.key(), (uint32_t)it.value().size() };
+        namesData.append(reinterpret_cast<const char*>(record), sizeof(record));
+        namesData.append(it.value());
+    }
+    writeBlock(NamesBlock, namesData.constData(), namesData.size());
+    writeBlock(MetadataBlock, metadata.constData(), metadata.size());
+    _file.close();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto chunk : _freeChunks) {
+        delete chunk;
+    }
+    _freeChunks.clear();
+}
+
+void Tracer::Session::writeEvents(const Chunk& chunk, uint32_t count) {
+    if (count > 0) {
+        writeBlock(EventsBlock, reinterpret_cast<const char*>(chunk.events), count * sizeof(BinaryEvent),
+            reinterpret_cast<const char*>(&chunk.threadID), sizeof(chunk.threadID));
+    }
+}
+
+void Tracer::Session::writeBlock(BlockType type, const char* data, uint64_t size, const char* prefix, uint64_t prefixSize) {
+    BlockHeader header { type, 0, prefixSize + size };
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (prefix) {
+        _file.write(prefix, prefixSize);
+    }
+    _file.write(data, size);
+}
+
+NameID tracing::hashName(const QString& text) {
+    NameID hash = FNV_OFFSET_BASIS;
+    for (auto character : text) {
+        if (character.unicode() >= 0x80) {
+            // hash the UTF-8 so a name gets the same ID whichever way it was passed
+            return hashName(text.toUtf8().constData());
+        }
+        hash = (hash ^ (NameID)character.unicode()) * FNV_PRIME;
+    }
+    return hash == FNV_OFFSET_BASIS ? 0 : hash;
+}
+
 bool tracing::enabled() {
-    return DependencyManager::get<Tracer>()->isEnabled();
+    return activeTracer.load(std::memory_order_relaxed) != nullptr;
+}
+
+void tracing::traceEvent(const QLoggingCategory& category, const Name& name, EventType type, const Name& id, const Arg& arg, char scope) {
+    auto tracer = activeTracer.load(std::memory_order_acquire);
+    if (tracer) {
+        tracer->traceEvent(category, name, type, id, arg, scope);
+    }
+}
+
+Tracer::~Tracer() {
+    if (isEnabled()) {
+        stopTracing();
+    }
 }
 
 void Tracer::startTracing() {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
+    std::lock_guard<std::mutex> guard(_sessionMutex);
     if (_enabled) {
         qWarning() << "Tried to enable tracer, but already enabled";
         return;
     }
 
-    _events.clear();
+    auto path = QDir::temp().filePath(QString("hifi-trace-%1%2").arg(QCoreApplication::applicationPid()).arg(TRACE_FILE_EXTENSION));
+    auto session = std::make_shared<Session>(path);
+    if (!session->isOpen()) {
+        qWarning() << "Cannot enable tracer, unable to open" << path;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> namesGuard(_namesMutex);
+        _names.clear();
+    }
+    _session = session;
+    _traceFilePath = path;
+    _activeSession.store(session.get(), std::memory_order_release);
     _enabled = true;
+    activeTracer.store(this, std::memory_order_release);
 }
 
 void Tracer::stopTracing() {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
-    if (!_enabled) {
-        qWarning() << "Cannot stop tracing, already disabled";
-        return;
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard<std::mutex> guard(_sessionMutex);
+        if (!_enabled) {
+            qWarning() << "Cannot stop tracing, already disabled";
+            return;
+        }
+        _enabled = false;
+        activeTracer.store(nullptr, std::memory_order_release);
+        _activeSession.store(nullptr, std::memory_order_release);
+        session.swap(_session);
+    }
+
+    QHash<NameID, QByteArray> names;
+    {
+        std::lock_guard<std::mutex> guard(_namesMutex);
+        names = _names;
+    }
+
+    QByteArray metadata;
+    {
+        std::lock_guard<std::mutex> guard(_eventsMutex);
+        QTextStream out(&metadata);
+        bool first = true;
+        for (const auto& event : _metadataEvents) {
+            if (first) {
+                first = false;
+            } else {
+                out << ",\n";
+            }
+            event.writeJson(out);
+        }
+    }
+
+    session->stop(names, metadata);
+    uint64_t droppedEvents = session->droppedEvents;
+    if (droppedEvents > 0) {
+        qWarning() << "Tracer dropped" << droppedEvents << "events while the trace file writer was behind";
     }
-    _enabled = false;
+    std::lock_guard<std::mutex> guard(_sessionMutex);
+    _lastDroppedEvents = droppedEvents;
+}
+
+uint64_t Tracer::getDroppedEventCount() const {
+    std::lock_guard<std::mutex> guard(_sessionMutex);
+    return _session ? _session->droppedEvents.load() : _lastDroppedEvents;
 }
 
 void TraceEvent::writeJson(QTextStream& out) const {
@@ -128,13 +476,14 @@ void Tracer::serialize(const QString& originalPath) {
 
 
 
-    std::list<TraceEvent> currentEvents;
+    QString traceFilePath;
     {
-        std::lock_guard<std::mutex> guard(_eventsMutex);
-        currentEvents.swap(_events);
-        for (auto& event : _metadataEvents) {
-            currentEvents.push_back(event);
-        }
+        std::lock_guard<std::mutex> guard(_sessionMutex);
+        traceFilePath = _traceFilePath;
+    }
+    if (traceFilePath.isEmpty()) {
+        qWarning() << "Cannot serialize trace, nothing has been traced";
+        return;
     }
 
     // If the file exists and we can't remove it, fail early
@@ -142,21 +491,15 @@ void Tracer::serialize(const QString& originalPath) {
         return;
     }
 
-    // If we can't open a temp file for writing, fail early
+    if (path.endsWith(TRACE_FILE_EXTENSION)) {
+        QFile::copy(traceFilePath, path);
+        return;
+    }
+
     QByteArray data;
-    {
-        QTextStream out(&data);
-        out << "[\n";
-        bool first = true;
-        for (const auto& event : currentEvents) {
-            if (first) {
-                first = false;
-            } else {
-                out << ",\n";
-            }
-            event.writeJson(out);
-        }
-        out << "\n]";
+    if (!convertToChromeTrace(traceFilePath, data)) {
+        qWarning() << "Cannot serialize trace, unable to read" << traceFilePath;
+        return;
     }
 
     if (path.endsWith(".gz")) {
@@ -173,83 +516,397 @@ void Tracer::serialize(const QString& originalPath) {
         file.write(data);
         file.close();
     }
+}
 
-#if 0
-    QByteArray data;
-    {
+static void appendEscaped(QByteArray& out, const QByteArray& text) {
+    out.append('"');
+    for (char character : text) {
+        switch (character) {
+            case '"':
+                out.append("\\\"");
+                break;
+            case '\\':
+                out.append("\\\\");
+                break;
+            case '\n':
+                out.append("\\n");
+                break;
+            case '\r':
+                out.append("\\r");
+                break;
+            case '\t':
+                out.append("\\t");
+                break;
+            default:
+                if ((uint8_t)character < 0x20) {
+                    out.append(QString("\\u%1").arg((int)character, 4, 16, QChar('0')).toLatin1());
+                } else {
+                    out.append(character);
+                }
+                break;
+        }
+    }
+    out.append('"');
+}
 
-        // "traceEvents":[
-        // {"args":{"nv_payload":0},"cat":"hifi.render","name":"render::Scene::processTransactionQueue","ph":"B","pid":14796,"tid":21636,"ts":68795933487}
+static void appendName(QByteArray& out, const QHash<NameID, QByteArray>& names, NameID id) {
+    auto it = names.find(id);
+    appendEscaped(out, it != names.end() ? it.value() : QByteArray("0x") + QByteArray::number(id, 16));
+}
 
-        QJsonArray traceEvents;
+static void appendArg(QByteArray& out, const QHash<NameID, QByteArray>& names, const BinaryEvent& event) {
+    appendName(out, names, event.argName);
+    out.append(':');
+    switch (event.argType) {
+        case ArgType::Int:
+            out.append(QByteArray::number((qlonglong)(int64_t)event.argValue));
+            break;
+        case ArgType::UInt:
+            out.append(QByteArray::number((qulonglong)event.argValue));
+            break;
+        case ArgType::Double: {
+            double value;
+            memcpy(&value, &event.argValue, sizeof(value));
+            out.append(std::isfinite(value) ? QByteArray::number(value, 'g', 17) : QByteArray("null"));
+            break;
+        }
+        case ArgType::Bool:
+            out.append(event.argValue ? "true" : "false");
+            break;
+        case ArgType::Name:
+            appendName(out, names, (NameID)event.argValue);
+            break;
+        default:
+            out.append("null");
+            break;
+    }
+}
 
-        QJsonDocument document {
-            QJsonObject {
-                { "traceEvents", traceEvents },
-                { "otherData", QJsonObject {
-                    { "version", QString { "High Fidelity Interface v1.0" } +BuildInfo::VERSION }
-                } }
+bool Tracer::convertToChromeTrace(const QString& binaryPath, QByteArray& json) {
+    QFile file(binaryPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    FileHeader header;
+    if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+        memcmp(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TRACE_FILE_VERSION || header.eventSize != sizeof(BinaryEvent)) {
+        return false;
+    }
+    const qint64 firstBlock = file.pos();
+
+    // the names and metadata come last, so find them before converting the events
+    QHash<NameID, QByteArray> names;
+    QByteArray metadata;
+    BlockHeader block;
+    while (file.read(reinterpret_cast<char*>(&block), sizeof(block)) == sizeof(block)) {
+        if (block.type == NamesBlock) {
+            QByteArray data = file.read(block.size);
+            int offset = 0;
+            while (offset + (int)(2 * sizeof(uint32_t)) <= data.size()) {
+                uint32_t record[2];
+                memcpy(record, data.constData() + offset, sizeof(record));
+                offset += sizeof(record);
+                names.insert(record[0], data.mid(offset, record[1]));
+                offset += record[1];
             }
-        };
-        
-        data = document.toJson(QJsonDocument::Compact);
+        } else if (block.type == MetadataBlock) {
+            metadata = file.read(block.size);
+        } else if (!file.seek(file.pos() + block.size)) {
+            break;
+        }
     }
-#endif
+
+    const QByteArray pid = QByteArray::number(header.processID);
+    json.clear();
+    json.append("[\n");
+    bool first = true;
+
+    // events flagged MoreArgs are merged with the ones after them, per thread since a chunk can end between them.
+    // a record dropped from a full buffer would merge unrelated events, so the rest of a group must be the same event.
+    struct PendingEvent {
+        QByteArray json;
+        bool hasArgs { false };
+        NameID name { 0 };
+        NameID category { 0 };
+        uint64_t timestamp { 0 };
+        EventType type { EventType::Instant };
+    };
+    QHash<qint64, PendingEvent> pendingEvents;
+
+    file.seek(firstBlock);
+    while (file.read(reinterpret_cast<char*>(&block), sizeof(block)) == sizeof(block)) {
+        if (block.type != EventsBlock) {
+            file.seek(file.pos() + block.size);
+            continue;
+        }
+
+        qint64 threadID;
+        QByteArray data = file.read(block.size);
+        if ((uint64_t)data.size() != block.size || data.size() < (int)sizeof(threadID)) {
+            break;
+        }
+        memcpy(&threadID, data.constData(), sizeof(threadID));
+        const QByteArray tid = QByteArray::number(threadID);
+
+        int numEvents = (data.size() - sizeof(threadID)) / sizeof(BinaryEvent);
+        for (int i = 0; i < numEvents; ++i) {
+            BinaryEvent event;
+            memcpy(&event, data.constData() + sizeof(threadID) + i * sizeof(BinaryEvent), sizeof(event));
+
+            PendingEvent& pending = pendingEvents[threadID];
+            QByteArray& out = pending.json;
+            if (!out.isEmpty() && (event.name != pending.name || event.category != pending.category ||
+                                   event.timestamp != pending.timestamp || event.type != pending.type)) {
+                // the rest of the pending group was lost, so drop what there is of it
+                out.clear();
+                pending.hasArgs = false;
+            }
+            if (out.isEmpty()) {
+                pending.name = event.name;
+                pending.category = event.category;
+                pending.timestamp = event.timestamp;
+                pending.type = event.type;
+                out.append("{\"name\":");
+                appendName(out, names, event.name);
+                out.append(",\"cat\":");
+                appendName(out, names, event.category);
+                out.append(",\"ph\":\"");
+                out.append((char)event.type);
+                out.append("\",\"ts\":");
+                out.append(QByteArray::number((qulonglong)event.timestamp));
+                out.append(",\"pid\":");
+                out.append(pid);
+                out.append(",\"tid\":");
+                out.append(tid);
+                if (event.id != 0) {
+                    out.append(",\"id\":");
+                    appendName(out, names, event.id);
+                }
+                if (event.scope != 0) {
+                    out.append(",\"s\":\"");
+                    out.append(event.scope);
+                    out.append('"');
+                }
+            }
+            if (event.argType != ArgType::None) {
+                out.append(pending.hasArgs ? "," : ",\"args\":{");
+                appendArg(out, names, event);
+                pending.hasArgs = true;
+            }
+
+            if (!(event.flags & BinaryEvent::MoreArgs)) {
+                if (pending.hasArgs) {
+                    out.append('}');
+                }
+                out.append('}');
+                if (first) {
+                    first = false;
+                } else {
+                    json.append(",\n");
+                }
+                json.append(out);
+                out.clear();
+                pending.hasArgs = false;
+            }
+        }
+    }
+
+    if (!metadata.isEmpty()) {
+        if (!first) {
+            json.append(",\n");
+        }
+        json.append(metadata);
+    }
+    json.append("\n]");
+    return true;
 }
 
-void Tracer::traceEvent(const QLoggingCategory& category,
-    const QString& name, EventType type,
-    qint64 timestamp, qint64 processID, qint64 threadID,
-    const QString& id,
-    const QVariantMap& args, const QVariantMap& extra) {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
+bool Tracer::acquireSession(ThreadState& state) {
+    auto active = _activeSession.load(std::memory_order_acquire);
+    if (!active) {
+        return false;
+    }
+    if (state.session.get() == active) {
+        return true;
+    }
+
+    if (state.session) {
+        state.session->release(state);
+    }
+    std::lock_guard<std::mutex> guard(_sessionMutex);
+    state.session = _session;
+    state.knownNames.clear();
+    state.categories.clear();
+    return (bool)state.session;
+}
+
+void Tracer::intern(ThreadState& state, NameID id, const char* text) {
+    if (state.knownNames.insert(id).second) {
+        std::lock_guard<std::mutex> guard(_namesMutex);
+        if (!_names.contains(id)) {
+            _names.insert(id, QByteArray(text));
+        }
+    }
+}
+
+void Tracer::intern(ThreadState& state, const Name& name) {
+    if (name.id == 0 || !name.hasText() || state.knownNames.count(name.id)) {
+        return;
+    }
+    state.knownNames.insert(name.id);
+    std::lock_guard<std::mutex> guard(_namesMutex);
+    if (!_names.contains(name.id)) {
+        _names.insert(name.id, name.toUtf8());
+    }
+}
+
+void Tracer::record(ThreadState& state, const QLoggingCategory& category, const Name& name, EventType type, const Name& id,
+        const Arg& arg, char scope, uint8_t flags, uint64_t timestamp) {
+    Chunk* chunk = state.chunk;
+    if (!chunk || chunk->count.load(std::memory_order_relaxed) == EVENTS_PER_CHUNK) {
+        chunk = state.session->exchangeChunk(state);
+        if (!chunk) {
+            state.session->droppedEvents++;
+            return;
+        }
+    }
+
+    NameID categoryID = 0;
+    for (const auto& entry : state.categories) {
+        if (entry.first == &category) {
+            categoryID = entry.second;
+            break;
+        }
+    }
+    if (categoryID == 0) {
+        categoryID = hashName(category.categoryName());
+        state.categories.emplace_back(&category, categoryID);
+        intern(state, categoryID, category.categoryName());
+    }
+    intern(state, name);
+    intern(state, id);
+    intern(state, arg.name);
+
+    uint32_t count = chunk->count.load(std::memory_order_relaxed);
+    BinaryEvent& event = chunk->events[count];
+    event.timestamp = timestamp;
+    event.argValue = arg.bits;
+    event.category = categoryID;
+    event.name = name.id;
+    event.id = id.id;
+    event.argName = arg.name.id;
+    event.type = type;
+    event.argType = arg.type;
+    event.scope = scope;
+    event.flags = flags;
+    event.reserved = 0;
+    chunk->count.store(count + 1, std::memory_order_release);
+}
 
+void Tracer::traceEvent(const QLoggingCategory& category, const Name& name, EventType type, const Name& id, const Arg& arg, char scope) {
+    if (!isEnabled()) {
+        return;
+    }
+    auto& state = getThreadState();
+    if (acquireSession(state)) {
+        record(state, category, name, type, id, arg, scope, 0, now());
+    }
+}
+
+void Tracer::traceMetadataEvent(const QLoggingCategory& category, const Name& name, const Name& id,
+        const QVariantMap& args, const QVariantMap& extra) {
     // We always want to store metadata events even if tracing is not enabled so that when
     // tracing is enabled we will be able to associate that metadata with that trace.
     // Metadata events should be used sparingly - as of 12/30/16 the Chrome Tracing
     // spec only supports thread+process metadata, so we should only expect to see metadata
     // events created when a new thread or process is created.
-    if (!_enabled && type != Metadata) {
+    std::lock_guard<std::mutex> guard(_eventsMutex);
+    _metadataEvents.push_back({
+        QString::fromUtf8(id.toUtf8()),
+        QString::fromUtf8(name.toUtf8()),
+        Metadata,
+        (qint64)now(),
+        QCoreApplication::applicationPid(),
+        int64_t(QThread::currentThreadId()),
+        category,
+        args,
+        extra
+    });
+}
+
+void Tracer::traceEvent(const QLoggingCategory& category,
+    const Name& name, EventType type, const Name& id,
+    const QVariantMap& args, const QVariantMap& extra) {
+    if (type == Metadata) {
+        traceMetadataEvent(category, name, id, args, extra);
+        return;
+    }
+    if (!isEnabled()) {
         return;
     }
 
-    if (type == Metadata) {
-        _metadataEvents.push_back({
-            id,
-            name,
-            type,
-            timestamp,
-            processID,
-            threadID,
-            category,
-            args,
-            extra
-        });
-    } else {
-        _events.push_back({
-            id,
-            name,
-            type,
-            timestamp,
-            processID,
-            threadID,
-            category,
-            args,
-            extra
-        });
-    }
-}
-
-void Tracer::traceEvent(const QLoggingCategory& category, 
-    const QString& name, EventType type, const QString& id, 
-    const QVariantMap& args, const QVariantMap& extra) {
-    if (!_enabled && type != Metadata) {
+    auto& state = getThreadState();
+    if (!acquireSession(state)) {
         return;
     }
 
-    auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
-    auto processID = QCoreApplication::applicationPid();
-    auto threadID = int64_t(QThread::currentThreadId());
+    char scope = 0;
+    auto scopeIt = extra.find("s");
+    if (scopeIt != extra.end()) {
+        auto scopeText = scopeIt.value().toString();
+        scope = scopeText.isEmpty() ? 0 : scopeText[0].toLatin1();
+    }
+
+    auto timestamp = now();
+    if (args.empty()) {
+        record(state, category, name, type, id, Arg(), scope, 0, timestamp);
+        return;
+    }
 
-    traceEvent(category, name, type, timestamp, processID, threadID, id, args, extra);
+    // one event per argument, all but the last flagged so the converter merges them back together
+    for (auto it = args.begin(); it != args.end();) {
+        Arg arg;
+        arg.name = Name(it.key());
+        const QVariant& value = it.value();
+        switch ((int)value.type()) {
+            case QMetaType::Bool:
+                arg = Arg(arg.name, value.toBool());
+                break;
+            case QMetaType::Int:
+            case QMetaType::Long:
+            case QMetaType::LongLong:
+            case QMetaType::Short:
+                arg = Arg(arg.name, (int64_t)value.toLongLong());
+                break;
+            case QMetaType::UInt:
+            case QMetaType::ULong:
+            case QMetaType::ULongLong:
+            case QMetaType::UShort:
+                arg = Arg(arg.name, (uint64_t)value.toULongLong());
+                break;
+            case QMetaType::Float:
+            case QMetaType::Double:
+                arg = Arg(arg.name, value.toDouble());
+                break;
+            default: {
+                QString text;
+                if (value.canConvert<QString>()) {
+                    text = value.toString();
+                } else {
+                    auto jsonValue = QJsonValue::fromVariant(value);
+                    text = jsonValue.isObject() ? QJsonDocument(jsonValue.toObject()).toJson(QJsonDocument::Compact) :
+                        jsonValue.isArray() ? QJsonDocument(jsonValue.toArray()).toJson(QJsonDocument::Compact) : QString();
+                }
+                Name textName(text);
+                intern(state, textName);
+                arg.type = ArgType::Name;
+                arg.bits = textName.id;
+                break;
+            }
+        }
+        ++it;
+        record(state, category, name, type, id, arg, scope, it != args.end() ? BinaryEvent::MoreArgs : 0, timestamp);
+    }
 }
@@ -10,8 +10,13 @@
 #ifndef hifi_Trace_h
 #define hifi_Trace_h
 
+#include <atomic>
 #include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <type_traits>
 
 #include <QtCore/QString>
 #include <QtCore/QVariantMap>
@@ -27,6 +32,42 @@ bool enabled();
 
 using TraceTimestamp = uint64_t;
 
+// Names and categories are recorded as 32 bit FNV-1a hashes of their text. The hash is constexpr, so the compiler folds
+// it for string literals, and the text itself is only interned the first time each thread sees the name in a trace.
+using NameID = uint32_t;
+
+const NameID FNV_OFFSET_BASIS = 2166136261u;
+const NameID FNV_PRIME = 16777619u;
+
+constexpr NameID hashName(const char* text, NameID hash = FNV_OFFSET_BASIS) {
+    return *text ? hashName(text + 1, (hash ^ (NameID)(uint8_t)*text) * FNV_PRIME) : (hash == FNV_OFFSET_BASIS ? 0 : hash);
+}
+
+NameID hashName(const QString& text);
+
+// A name and the text it was hashed from. Converts implicitly from string literals, C strings and QStrings, so existing
+// call sites keep compiling. A Name may point at the caller's buffer and must not outlive the call it was passed to.
+struct Name {
+    NameID id { 0 };
+    const char* literal { nullptr };
+    QString string;
+
+    Name() {}
+    explicit Name(NameID id) : id(id) {}
+
+    template <size_t N>
+    Name(const char (&text)[N]) : id(hashName(text)), literal(text) {}
+
+    template <typename T, typename = typename std::enable_if<std::is_same<T, const char*>::value || std::is_same<T, char*>::value>::type>
+    Name(T text) : id(text ? hashName(text) : 0), literal(text) {}
+
+    Name(const QString& text) : id(hashName(text)), string(text) {}
+
+    bool isEmpty() const { return id == 0; }
+    bool hasText() const { return literal || !string.isNull(); }
+    QByteArray toUtf8() const { return literal ? QByteArray(literal) : string.toUtf8(); }
+};
+
 enum EventType : char {
     DurationBegin = 'B',
     DurationEnd = 'E',
@@ -62,6 +103,63 @@ enum EventType : char {
     ContextLeave = ')'
 };
 
+enum class ArgType : uint8_t {
+    None = 0,
+    Int,
+    UInt,
+    Double,
+    Bool,
+    Name // the value is a NameID, used for string arguments
+};
+
+// One argument of an event, stored without allocating.
+struct Arg {
+    Name name;
+    ArgType type { ArgType::None };
+    uint64_t bits { 0 };
+
+    Arg() {}
+
+    template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    Arg(const Name& name, T value) :
+        name(name),
+        type(std::is_same<T, bool>::value ? ArgType::Bool :
+            std::is_floating_point<T>::value ? ArgType::Double :
+            std::is_signed<T>::value ? ArgType::Int : ArgType::UInt),
+        bits(toBits(value, std::is_floating_point<T>())) {}
+
+private:
+    template <typename T>
+    static uint64_t toBits(T value, std::false_type) { return std::is_signed<T>::value ? (uint64_t)(int64_t)value : (uint64_t)value; }
+    template <typename T>
+    static uint64_t toBits(T value, std::true_type) {
+        double real = value;
+        uint64_t result;
+        memcpy(&result, &real, sizeof(result));
+        return result;
+    }
+};
+
+// The fixed size record written to the per-thread buffers and to the binary trace file.
+struct BinaryEvent {
+    enum Flags : uint8_t {
+        MoreArgs = 0x01 // the next event of this thread holds another argument of this one
+    };
+
+    uint64_t timestamp;
+    uint64_t argValue;
+    NameID category;
+    NameID name;
+    NameID id;
+    NameID argName;
+    EventType type;
+    ArgType argType;
+    char scope;
+    uint8_t flags;
+    uint32_t reserved;
+};
+static_assert(sizeof(BinaryEvent) == 40, "BinaryEvent is written to trace files as is");
+
 struct TraceEvent {
     QString id;
     QString name;
@@ -76,42 +174,81 @@ struct TraceEvent {
     void writeJson(QTextStream& out) const;
 };
 
+// While tracing, every thread appends BinaryEvents to its own chunk of a preallocated pool, without locking or
+// allocating. Full chunks are handed to a writer thread that streams them to a binary trace file, which serialize()
+// converts to the Chrome trace event format (or copies, if the path ends in .hftrace).
 class Tracer : public Dependency {
 public:
-    void traceEvent(const QLoggingCategory& category, 
-        const QString& name, EventType type,
-        const QString& id = "", 
+    static const int EVENTS_PER_CHUNK = 4096;
+    static const int NUM_CHUNKS = 128; // 20MB of events in flight before the writer falls behind and events are dropped
+
+    ~Tracer();
+
+    void traceEvent(const QLoggingCategory& category,
+        const Name& name, EventType type,
+        const Name& id = Name(),
         const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap());
 
+    // records an event with at most one argument, without touching the heap
+    void traceEvent(const QLoggingCategory& category, const Name& name, EventType type, const Name& id, const Arg& arg, char scope = 0);
+
     void startTracing();
     void stopTracing();
     void serialize(const QString& file);
-    bool isEnabled() const { return _enabled; }
+    bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    // events lost because every chunk was waiting on the writer, in the current or last trace
+    uint64_t getDroppedEventCount() const;
+
+    // converts a binary trace file to a JSON array of Chrome trace events
+    static bool convertToChromeTrace(const QString& binaryPath, QByteArray& json);
+
+    class Session;
+    struct ThreadState;
 
 private:
-    void traceEvent(const QLoggingCategory& category, 
-        const QString& name, EventType type,
-        qint64 timestamp, qint64 processID, qint64 threadID,
-        const QString& id = "",
-        const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap());
+    void traceMetadataEvent(const QLoggingCategory& category, const Name& name, const Name& id,
+        const QVariantMap& args, const QVariantMap& extra);
+    void record(ThreadState& state, const QLoggingCategory& category, const Name& name, EventType type, const Name& id,
+        const Arg& arg, char scope, uint8_t flags, uint64_t timestamp);
+    bool acquireSession(ThreadState& state);
+    void intern(ThreadState& state, const Name& name);
+    void intern(ThreadState& state, NameID id, const char* text);
+
+    std::atomic<bool> _enabled { false };
+    std::atomic<Session*> _activeSession { nullptr };
+    std::shared_ptr<Session> _session; // guarded by _sessionMutex
+    mutable std::mutex _sessionMutex;
+    QString _traceFilePath;
+    uint64_t _lastDroppedEvents { 0 };
+
+    std::mutex _namesMutex;
+    QHash<NameID, QByteArray> _names;
 
-    bool _enabled { false };
-    std::list<TraceEvent> _events;
     std::list<TraceEvent> _metadataEvents;
     std::mutex _eventsMutex;
 };
 
-inline void traceEvent(const QLoggingCategory& category, const QString& name, EventType type, const QString& id = "", const QVariantMap& args = {}, const QVariantMap& extra = {}) {
+inline void traceEvent(const QLoggingCategory& category, const Name& name, EventType type, const Name& id = Name(), const QVariantMap& args = {}, const QVariantMap& extra = {}) {
+    if (type != Metadata && !enabled()) {
+        return;
+    }
     const auto& tracer = DependencyManager::get<Tracer>();
     if (tracer) {
         tracer->traceEvent(category, name, type, id, args, extra);
     }
 }
 
-inline void traceEvent(const QLoggingCategory& category, const QString& name, EventType type, int id, const QVariantMap& args = {}, const QVariantMap& extra = {}) {
-    traceEvent(category, name, type, QString::number(id), args, extra);
+inline void traceEvent(const QLoggingCategory& category, const Name& name, EventType type, int id, const QVariantMap& args = {}, const QVariantMap& extra = {}) {
+    if (type != Metadata && !enabled()) {
+        return;
+    }
+    traceEvent(category, name, type, Name(QString::number(id)), args, extra);
 }
 
+// records on the tracer that is currently tracing, if any, without a dependency lookup
+void traceEvent(const QLoggingCategory& category, const Name& name, EventType type, const Name& id, const Arg& arg, char scope = 0);
+
 }
 
 #endif // hifi_Trace_h
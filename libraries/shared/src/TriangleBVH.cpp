@@ -0,0 +1,395 @@
+//
+//  TriangleBVH.cpp
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TriangleBVH.h"
+
+#include <algorithm>
+#include <limits>
+#include <string.h>
+
+#include "GLMHelpers.h"
+#include "NumericalConstants.h"
+
+static const int NUM_SAH_BINS = 12;
+static const float SAH_TRAVERSAL_COST = 1.0f; // relative to the cost of testing one triangle
+
+static inline float halfSurfaceArea(const glm::vec3& minimum, const glm::vec3& maximum) {
+    glm::vec3 extent = maximum - minimum;
+    return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+}
+
+static inline bool findRayNodeIntersection(const TriangleBVH::Node& node, const glm::vec3& origin,
+        const glm::vec3& inverseDirection, float bestDistance, float& nearDistance) {
+    glm::vec3 t1 = (node.minimum - origin) * inverseDirection;
+    glm::vec3 t2 = (node.maximum - origin) * inverseDirection;
+    glm::vec3 tMin = glm::min(t1, t2);
+    glm::vec3 tMax = glm::max(t1, t2);
+    float enter = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+    float exit = glm::min(glm::min(tMax.x, tMax.y), tMax.z);
+    nearDistance = enter;
+    return enter <= exit && enter < bestDistance;
+}
+
+static BoxFace faceFromNormal(const glm::vec3& normal) {
+    glm::vec3 magnitude = glm::abs(normal);
+    if (magnitude.x >= magnitude.y && magnitude.x >= magnitude.z) {
+        return normal.x > 0.0f ? MAX_X_FACE : MIN_X_FACE;
+    } else if (magnitude.y >= magnitude.z) {
+        return normal.y > 0.0f ? MAX_Y_FACE : MIN_Y_FACE;
+    }
+    return normal.z > 0.0f ? MAX_Z_FACE : MIN_Z_FACE;
+}
+
+void TriangleBVH::clear() {
+    _nodes.clear();
+    _packets.clear();
+    _normals.clear();
+}
+
+void TriangleBVH::build(const std::vector<Triangle>& triangles) {
+    clear();
+    if (triangles.empty()) {
+        return;
+    }
+
+    std::vector<BuildReference> references;
+    references.resize(triangles.size());
+    _normals.resize(triangles.size());
+    for (size_t i = 0; i < triangles.size(); i++) {
+        const Triangle& triangle = triangles[i];
+        BuildReference& reference = references[i];
+        reference.minimum = glm::min(triangle.v0, glm::min(triangle.v1, triangle.v2));
+        reference.maximum = glm::max(triangle.v0, glm::max(triangle.v1, triangle.v2));
+        reference.centroid = (reference.minimum + reference.maximum) * 0.5f;
+        reference.triangleIndex = (uint32_t)i;
+        _normals[i] = triangle.getNormal();
+    }
+
+    // a binary tree with at most one leaf per triangle never has more than 2n - 1 nodes
+    _nodes.reserve(2 * triangles.size());
+    _packets.reserve(triangles.size() / TRIANGLES_PER_PACKET + 1);
+
+    _buildTriangles = &triangles;
+    buildRecursive(references, 0, references.size(), 0);
+    _buildTriangles = nullptr;
+
+    _nodes.shrink_to_fit();
+    _packets.shrink_to_fit();
+}
+
+void TriangleBVH::buildRecursive(std::vector<BuildReference>& references, size_t begin, size_t end, int depth) {
+    glm::vec3 minimum(std::numeric_limits<float>::max());
+    glm::vec3 maximum(-std::numeric_limits<float>::max());
+    glm::vec3 centroidMinimum(std::numeric_limits<float>::max());
+    glm::vec3 centroidMaximum(-std::numeric_limits<float>::max());
+    for (size_t i = begin; i < end; i++) {
+        minimum = glm::min(minimum, references[i].minimum);
+        maximum = glm::max(maximum, references[i].maximum);
+        centroidMinimum = glm::min(centroidMinimum, references[i].centroid);
+        centroidMaximum = glm::max(centroidMaximum, references[i].centroid);
+    }
+
+    // note: we only ever refer to nodes by index here since recursion grows the node array
+    uint32_t nodeIndex = (uint32_t)_nodes.size();
+    _nodes.push_back(Node());
+    _nodes[nodeIndex].minimum = minimum;
+    _nodes[nodeIndex].maximum = maximum;
+
+    size_t count = end - begin;
+    if (count <= (size_t)MAX_LEAF_TRIANGLES || depth >= MAX_DEPTH) {
+        emitLeaf(_nodes[nodeIndex], references, begin, end);
+        return;
+    }
+
+    // find the cheapest split along any axis by binning the triangle centroids
+    float bestCost = std::numeric_limits<float>::max();
+    int bestAxis = -1;
+    int bestSplit = 0;
+    glm::vec3 centroidExtent = centroidMaximum - centroidMinimum;
+    for (int axis = 0; axis < 3; axis++) {
+        if (centroidExtent[axis] <= EPSILON) {
+            continue;
+        }
+        int binCounts[NUM_SAH_BINS] = { 0 };
+        glm::vec3 binMinimums[NUM_SAH_BINS];
+        glm::vec3 binMaximums[NUM_SAH_BINS];
+        for (int bin = 0; bin < NUM_SAH_BINS; bin++) {
+            binMinimums[bin] = glm::vec3(std::numeric_limits<float>::max());
+            binMaximums[bin] = glm::vec3(-std::numeric_limits<float>::max());
+        }
+
+        float binScale = (float)NUM_SAH_BINS / centroidExtent[axis];
+        for (size_t i = begin; i < end; i++) {
+            int bin = std::min(NUM_SAH_BINS - 1, (int)((references[i].centroid[axis] - centroidMinimum[axis]) * binScale));
+            binCounts[bin]++;
+            binMinimums[bin] = glm::min(binMinimums[bin], references[i].minimum);
+            binMaximums[bin] = glm::max(binMaximums[bin], references[i].maximum);
+        }
+
+        // sweep from the right to accumulate the cost of everything after each split plane
+        float rightCosts[NUM_SAH_BINS];
+        glm::vec3 rightMinimum(std::numeric_limits<float>::max());
+        glm::vec3 rightMaximum(-std::numeric_limits<float>::max());
+        int rightCount = 0;
+        for (int bin = NUM_SAH_BINS - 1; bin > 0; bin--) {
+            rightCount += binCounts[bin];
+            rightMinimum = glm::min(rightMinimum, binMinimums[bin]);
+            rightMaximum = glm::max(rightMaximum, binMaximums[bin]);
+            rightCosts[bin] = rightCount > 0 ? rightCount * halfSurfaceArea(rightMinimum, rightMaximum) : 0.0f;
+        }
+
+        glm::vec3 leftMinimum(std::numeric_limits<float>::max());
+        glm::vec3 leftMaximum(-std::numeric_limits<float>::max());
+        int leftCount = 0;
+        for (int split = 0; split < NUM_SAH_BINS - 1; split++) {
+            leftCount += binCounts[split];
+            leftMinimum = glm::min(leftMinimum, binMinimums[split]);
+            leftMaximum = glm::max(leftMaximum, binMaximums[split]);
+            if (leftCount == 0 || leftCount == (int)count) {
+                continue;
+            }
+            float cost = leftCount * halfSurfaceArea(leftMinimum, leftMaximum) + rightCosts[split + 1];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = split;
+            }
+        }
+    }
+
+    float nodeArea = halfSurfaceArea(minimum, maximum);
+    float leafCost = (float)count;
+    float splitCost = bestAxis >= 0 && nodeArea > 0.0f ?
+        SAH_TRAVERSAL_COST + bestCost / nodeArea : std::numeric_limits<float>::max();
+
+    size_t middle = begin;
+    if (bestAxis >= 0) {
+        if (splitCost >= leafCost) {
+            emitLeaf(_nodes[nodeIndex], references, begin, end);
+            return;
+        }
+        float binScale = (float)NUM_SAH_BINS / centroidExtent[bestAxis];
+        float axisMinimum = centroidMinimum[bestAxis];
+        auto splitIterator = std::partition(references.begin() + begin, references.begin() + end,
+            [&](const BuildReference& reference) {
+                int bin = std::min(NUM_SAH_BINS - 1, (int)((reference.centroid[bestAxis] - axisMinimum) * binScale));
+                return bin <= bestSplit;
+            });
+        middle = splitIterator - references.begin();
+    }
+
+    if (middle == begin || middle == end) {
+        // every centroid landed on the same side (or in the same spot), fall back to splitting the list in half
+        middle = begin + count / 2;
+    }
+
+    buildRecursive(references, begin, middle, depth + 1);
+    _nodes[nodeIndex].offset = (uint32_t)_nodes.size();
+    buildRecursive(references, middle, end, depth + 1);
+}
+
+void TriangleBVH::emitLeaf(Node& node, const std::vector<BuildReference>& references, size_t begin, size_t end) {
+    const std::vector<Triangle>& triangles = *_buildTriangles;
+    size_t count = end - begin;
+    size_t packetCount = (count + TRIANGLES_PER_PACKET - 1) / TRIANGLES_PER_PACKET;
+    node.offset = (uint32_t)_packets.size();
+    node.packetCount = (uint32_t)packetCount;
+
+    for (size_t packetIndex = 0; packetIndex < packetCount; packetIndex++) {
+        TrianglePacket packet;
+        memset(&packet, 0, sizeof(TrianglePacket));
+        for (int lane = 0; lane < TRIANGLES_PER_PACKET; lane++) {
+            size_t referenceIndex = begin + packetIndex * TRIANGLES_PER_PACKET + lane;
+            if (referenceIndex >= end) {
+                // unused lanes are left as degenerate triangles, which can never be hit
+                packet.triangleIndex[lane] = packet.triangleIndex[0];
+                continue;
+            }
+            uint32_t triangleIndex = references[referenceIndex].triangleIndex;
+            const Triangle& triangle = triangles[triangleIndex];
+            glm::vec3 edge1 = triangle.v1 - triangle.v0;
+            glm::vec3 edge2 = triangle.v2 - triangle.v0;
+            for (int axis = 0; axis < 3; axis++) {
+                packet.v0[axis][lane] = triangle.v0[axis];
+                packet.edge1[axis][lane] = edge1[axis];
+                packet.edge2[axis][lane] = edge2[axis];
+            }
+            packet.triangleIndex[lane] = triangleIndex;
+        }
+        _packets.push_back(packet);
+    }
+}
+
+// Moller-Trumbore against all four triangles of the packet. Returns the closest distance found that is
+// nearer than bestDistance, and sets hitLane to the lane that produced it (or -1 if nothing was hit).
+float TriangleBVH::intersectPacket(const TrianglePacket& packet, const glm::vec3& origin, const glm::vec3& direction,
+        float bestDistance, bool allowBackface, int& hitLane) const {
+    hitLane = -1;
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    __m128 dx = _mm_set1_ps(direction.x);
+    __m128 dy = _mm_set1_ps(direction.y);
+    __m128 dz = _mm_set1_ps(direction.z);
+
+    __m128 e1x = _mm_loadu_ps(packet.edge1[0]);
+    __m128 e1y = _mm_loadu_ps(packet.edge1[1]);
+    __m128 e1z = _mm_loadu_ps(packet.edge1[2]);
+    __m128 e2x = _mm_loadu_ps(packet.edge2[0]);
+    __m128 e2y = _mm_loadu_ps(packet.edge2[1]);
+    __m128 e2z = _mm_loadu_ps(packet.edge2[2]);
+
+    // p = direction x edge2
+    __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+    __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+    __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+    __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+
+    // s = origin - v0
+    __m128 sx = _mm_sub_ps(_mm_set1_ps(origin.x), _mm_loadu_ps(packet.v0[0]));
+    __m128 sy = _mm_sub_ps(_mm_set1_ps(origin.y), _mm_loadu_ps(packet.v0[1]));
+    __m128 sz = _mm_sub_ps(_mm_set1_ps(origin.z), _mm_loadu_ps(packet.v0[2]));
+
+    // q = s x edge1
+    __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+    __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+    __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+
+    __m128 inverseDet = _mm_div_ps(one, det);
+    __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inverseDet);
+    __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inverseDet);
+    __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inverseDet);
+
+    // a positive determinant means the ray is looking at the front of the triangle, and as in
+    // findRayTriangleIntersection() allowBackface only lets the origin be behind its plane
+    __m128 mask = _mm_cmpgt_ps(det, zero);
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+    mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), one));
+    if (!allowBackface) {
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(t, zero));
+    }
+    mask = _mm_and_ps(mask, _mm_cmplt_ps(t, _mm_set1_ps(bestDistance)));
+
+    int laneMask = _mm_movemask_ps(mask);
+    if (laneMask == 0) {
+        return bestDistance;
+    }
+
+    float distances[TRIANGLES_PER_PACKET];
+    _mm_storeu_ps(distances, t);
+    for (int lane = 0; lane < TRIANGLES_PER_PACKET; lane++) {
+        if ((laneMask & (1 << lane)) && distances[lane] < bestDistance) {
+            bestDistance = distances[lane];
+            hitLane = lane;
+        }
+    }
+#else
+    for (int lane = 0; lane < TRIANGLES_PER_PACKET; lane++) {
+        glm::vec3 edge1(packet.edge1[0][lane], packet.edge1[1][lane], packet.edge1[2][lane]);
+        glm::vec3 edge2(packet.edge2[0][lane], packet.edge2[1][lane], packet.edge2[2][lane]);
+        glm::vec3 p = glm::cross(direction, edge2);
+        float det = glm::dot(edge1, p);
+        if (det <= 0.0f) {
+            continue;
+        }
+        float inverseDet = 1.0f / det;
+        glm::vec3 s = origin - glm::vec3(packet.v0[0][lane], packet.v0[1][lane], packet.v0[2][lane]);
+        float u = glm::dot(s, p) * inverseDet;
+        if (u < 0.0f || u > 1.0f) {
+            continue;
+        }
+        glm::vec3 q = glm::cross(s, edge1);
+        float v = glm::dot(direction, q) * inverseDet;
+        if (v < 0.0f || u + v > 1.0f) {
+            continue;
+        }
+        float t = glm::dot(edge2, q) * inverseDet;
+        if ((allowBackface || t >= 0.0f) && t < bestDistance) {
+            bestDistance = t;
+            hitLane = lane;
+        }
+    }
+#endif
+
+    return bestDistance;
+}
+
+bool TriangleBVH::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance,
+        BoxFace& face, glm::vec3& surfaceNormal, int& trianglesTouched, bool allowBackface) const {
+    if (_nodes.empty()) {
+        return false;
+    }
+
+    glm::vec3 inverseDirection = 1.0f / direction;
+    float bestDistance = distance;
+    uint32_t bestTriangle = 0;
+    bool intersectedSomething = false;
+
+    // the tree depth is capped at MAX_DEPTH and we push at most one extra node per level
+    uint32_t stack[MAX_DEPTH + 2];
+    int stackSize = 0;
+    float nearDistance;
+    if (!findRayNodeIntersection(_nodes[0], origin, inverseDirection, bestDistance, nearDistance)) {
+        return false;
+    }
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = _nodes[stack[--stackSize]];
+
+        // the best distance may have shrunk since this node was pushed
+        if (!findRayNodeIntersection(node, origin, inverseDirection, bestDistance, nearDistance)) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            for (uint32_t i = 0; i < node.packetCount; i++) {
+                const TrianglePacket& packet = _packets[node.offset + i];
+                int hitLane;
+                trianglesTouched += TRIANGLES_PER_PACKET;
+                float packetDistance = intersectPacket(packet, origin, direction, bestDistance, allowBackface, hitLane);
+                if (hitLane >= 0) {
+                    bestDistance = packetDistance;
+                    bestTriangle = packet.triangleIndex[hitLane];
+                    intersectedSomething = true;
+                }
+            }
+            continue;
+        }
+
+        // visit the nearer child first so that its hits can cull the farther one
+        uint32_t firstChild = (uint32_t)(&node - &_nodes[0]) + 1;
+        uint32_t secondChild = node.offset;
+        float firstDistance, secondDistance;
+        bool hitFirst = findRayNodeIntersection(_nodes[firstChild], origin, inverseDirection, bestDistance, firstDistance);
+        bool hitSecond = findRayNodeIntersection(_nodes[secondChild], origin, inverseDirection, bestDistance, secondDistance);
+        if (hitFirst && hitSecond) {
+            if (firstDistance > secondDistance) {
+                std::swap(firstChild, secondChild);
+            }
+            stack[stackSize++] = secondChild;
+            stack[stackSize++] = firstChild;
+        } else if (hitFirst) {
+            stack[stackSize++] = firstChild;
+        } else if (hitSecond) {
+            stack[stackSize++] = secondChild;
+        }
+    }
+
+    if (intersectedSomething) {
+        distance = bestDistance;
+        surfaceNormal = _normals[bestTriangle];
+        face = faceFromNormal(surfaceNormal);
+    }
+    return intersectedSomething;
+}
@@ -0,0 +1,82 @@
+//
+//  TriangleBVH.h
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_TriangleBVH_h
+#define hifi_TriangleBVH_h
+
+#include <stdint.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "BoxBase.h"
+#include "GeometryUtil.h"
+
+// A bounding volume hierarchy over a fixed set of triangles, built with a binned surface area heuristic.
+//
+// Nodes are stored depth first in a flat array: the first child of an interior node immediately follows
+// it, and the node records the index of its second child. Leaf triangles are stored in packets of four
+// in structure-of-arrays form so that a ray can be tested against a whole packet at once with SSE.
+class TriangleBVH {
+public:
+    static const int TRIANGLES_PER_PACKET = 4;
+    static const int MAX_LEAF_TRIANGLES = 8;
+    static const int MAX_DEPTH = 64;
+
+    struct Node {
+        glm::vec3 minimum;
+        uint32_t offset { 0 }; // second child for interior nodes, first packet for leaves
+        glm::vec3 maximum;
+        uint32_t packetCount { 0 }; // zero for interior nodes
+
+        bool isLeaf() const { return packetCount > 0; }
+    };
+
+    struct TrianglePacket {
+        float v0[3][TRIANGLES_PER_PACKET];
+        float edge1[3][TRIANGLES_PER_PACKET];
+        float edge2[3][TRIANGLES_PER_PACKET];
+        uint32_t triangleIndex[TRIANGLES_PER_PACKET];
+    };
+
+    void build(const std::vector<Triangle>& triangles);
+    void clear();
+
+    bool isEmpty() const { return _nodes.empty(); }
+    size_t getNodeCount() const { return _nodes.size(); }
+    size_t getPacketCount() const { return _packets.size(); }
+
+    // Determine if the given ray intersects any triangle in the hierarchy. Only front facing triangles are
+    // considered; as in findRayTriangleIntersection(), allowBackface only lets the origin be behind a triangle's
+    // plane, which gives a negative distance. The normal of the triangle that was hit is returned.
+    bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance,
+        BoxFace& face, glm::vec3& surfaceNormal, int& trianglesTouched, bool allowBackface = false) const;
+
+private:
+    struct BuildReference {
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        glm::vec3 centroid;
+        uint32_t triangleIndex;
+    };
+
+    void buildRecursive(std::vector<BuildReference>& references, size_t begin, size_t end, int depth);
+    void emitLeaf(Node& node, const std::vector<BuildReference>& references, size_t begin, size_t end);
+    float intersectPacket(const TrianglePacket& packet, const glm::vec3& origin, const glm::vec3& direction,
+        float bestDistance, bool allowBackface, int& hitLane) const;
+
+    std::vector<Node> _nodes;
+    std::vector<TrianglePacket> _packets;
+    std::vector<glm::vec3> _normals;
+    const std::vector<Triangle>* _buildTriangles { nullptr };
+};
+
+#endif // hifi_TriangleBVH_h
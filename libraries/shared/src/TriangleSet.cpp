@@ -12,9 +12,29 @@
 #include "GLMHelpers.h"
 #include "TriangleSet.h"
 
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+
+std::atomic<bool> TriangleSet::_bvhEnabled { true };
+
+class TriangleSet::BVHBuilder : public QRunnable {
+public:
+    BVHBuilder(const std::shared_ptr<BVHState>& state, const std::vector<Triangle>& triangles) :
+        _state(state), _triangles(triangles) {}
+
+    void run() override {
+        _state->bvh.build(_triangles);
+        _state->ready = true;
+    }
+
+private:
+    std::shared_ptr<BVHState> _state;
+    std::vector<Triangle> _triangles;
+};
 
 void TriangleSet::insert(const Triangle& t) {
     _isBalanced = false;
+    _bvh.reset();
 
     _triangles.push_back(t);
     _bounds += t.v0;
@@ -26,6 +46,7 @@ void TriangleSet::clear() {
     _triangles.clear();
     _bounds.clear();
     _isBalanced = false;
+    _bvh.reset();
 
     _triangleOctree.clear();
 }
@@ -35,12 +56,23 @@ bool TriangleSet::findRayIntersection(const glm::vec3& origin, const glm::vec3&
 
     // reset our distance to be the max possible, lower level tests will store best distance here
     distance = std::numeric_limits<float>::max();
+    int trianglesTouched = 0;
+
+    if (precision && shouldUseBVH()) {
+        if (!_bvh) {
+            // the builder works on its own copy of the triangles, so the set is free to change while it runs
+            _bvh = std::make_shared<BVHState>();
+            QThreadPool::globalInstance()->start(new BVHBuilder(_bvh, _triangles));
+        }
+        if (_bvh->ready) {
+            return _bvh->bvh.findRayIntersection(origin, direction, distance, face, surfaceNormal, trianglesTouched, allowBackface);
+        }
+    }
 
     if (!_isBalanced) {
         balanceOctree();
     }
 
-    int trianglesTouched = 0;
     auto result = _triangleOctree.findRayIntersection(origin, direction, distance, face, surfaceNormal, precision, trianglesTouched, allowBackface);
 
     #if WANT_DEBUGGING
@@ -76,6 +108,12 @@ void TriangleSet::debugDump() {
     _triangleOctree.debugDump();
 }
 
+void TriangleSet::buildBVH() {
+    _bvh = std::make_shared<BVHState>();
+    _bvh->bvh.build(_triangles);
+    _bvh->ready = true;
+}
+
 void TriangleSet::balanceOctree() {
     _triangleOctree.reset(_bounds, 0);
 
@@ -9,10 +9,13 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <atomic>
+#include <memory>
 #include <vector>
 
 #include "AABox.h"
 #include "GeometryUtil.h"
+#include "TriangleBVH.h"
 
 class TriangleSet {
 
@@ -64,6 +67,16 @@ public:
 
     void balanceOctree();
 
+    // Precision picks against sets with at least BVH_MIN_TRIANGLES triangles use a TriangleBVH instead of the
+    // octree. The BVH is built on a worker thread the first time it is needed, and the octree is used until then.
+    static const size_t BVH_MIN_TRIANGLES = 256;
+    static void setBVHEnabled(bool enabled) { _bvhEnabled = enabled; }
+    static bool isBVHEnabled() { return _bvhEnabled; }
+
+    // builds the BVH on the calling thread, replacing any build that is still in flight
+    void buildBVH();
+    bool isBVHReady() const { return _bvh && _bvh->ready; }
+
     void reserve(size_t size) { _triangles.reserve(size); } // reserve space in the datastructure for size number of triangles
     size_t size() const { return _triangles.size(); }
     void clear();
@@ -81,6 +94,18 @@ public:
     const AABox& getBounds() const { return _bounds; }
 
 protected:
+    struct BVHState {
+        std::atomic<bool> ready { false };
+        TriangleBVH bvh;
+    };
+    class BVHBuilder;
+
+    bool shouldUseBVH() const { return _bvhEnabled && _triangles.size() >= BVH_MIN_TRIANGLES; }
+
+    static std::atomic<bool> _bvhEnabled;
+
+    // shared with the worker thread so that clearing or destroying the set doesn't have to wait for a build
+    std::shared_ptr<BVHState> _bvh;
 
     bool _isBalanced{ false };
     TriangleOctreeCell _triangleOctree;
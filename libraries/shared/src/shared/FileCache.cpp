@@ -13,23 +13,19 @@
 
 
 #include <unordered_set>
-#include <queue>
+#include <algorithm>
 #include <cassert>
 
+#include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
 #include <QtCore/QDir>
+#include <QtCore/QFile>
 #include <QtCore/QSaveFile>
 #include <QtCore/QStorageInfo>
 
 #include "../PathUtils.h"
 #include "../NumericalConstants.h"
 
-#ifdef Q_OS_WIN
-#include <sys/utime.h>
-#else
-#include <utime.h>
-#endif
-
 #ifdef NDEBUG
 Q_LOGGING_CATEGORY(file_cache, "hifi.file_cache", QtWarningMsg)
 #else
@@ -43,6 +39,37 @@ static const char EXT_SEP = '.';
 const size_t FileCache::DEFAULT_MAX_SIZE { GB_TO_BYTES(5) };
 const size_t FileCache::MAX_MAX_SIZE { GB_TO_BYTES(100) };
 const size_t FileCache::DEFAULT_MIN_FREE_STORAGE_SPACE { GB_TO_BYTES(1) };
+const char* FileCache::INDEX_FILENAME { "index.journal" };
+
+static const quint32 INDEX_MAGIC = 0x48464349; // "HFCI"
+static const quint32 INDEX_VERSION = 1;
+static const quint32 MAX_INDEX_KEY_LENGTH = 1024;
+
+// rewrite the index once it holds more than twice as many records as files, and at least this many
+static const size_t MIN_INDEX_RECORDS_TO_COMPACT = 1024;
+
+enum IndexRecordType : quint8 {
+    ADD_RECORD = 1,
+    ACCESS_RECORD,
+    REMOVE_RECORD
+};
+
+static QByteArray makeIndexRecord(quint8 type, const FileCache::Key& key, size_t length, int64_t lastAccess) {
+    QByteArray record;
+    QDataStream stream(&record, QIODevice::WriteOnly);
+    stream << type << (quint32)key.size();
+    stream.writeRawData(key.data(), (int)key.size());
+    if (type == ADD_RECORD) {
+        stream << (quint64)length << (qint64)lastAccess;
+    } else if (type == ACCESS_RECORD) {
+        stream << (qint64)lastAccess;
+    }
+    return record;
+}
+
+static int64_t now() {
+    return QDateTime::currentMSecsSinceEpoch();
+}
 
 
 std::string getCacheName(const std::string& dirname_str) {
@@ -83,6 +110,10 @@ FileCache::FileCache(const std::string& dirname, const std::string& ext, QObject
 }
 
 FileCache::~FileCache() {
+    _stopValidation = true;
+    if (_validationThread.joinable()) {
+        _validationThread.join();
+    }
     clear();
 }
 
@@ -96,22 +127,27 @@ void FileCache::initialize() {
     QDir dir(_dirpath.c_str());
 
     if (dir.exists()) {
-        auto nameFilters = QStringList(("*." + _ext).c_str());
-        auto filters = QDir::Filters(QDir::NoDotAndDotDot | QDir::Files);
-        auto sort = QDir::SortFlags(QDir::Time);
-        auto files = dir.entryList(nameFilters, filters, sort);
-
-        // load persisted files
-        foreach(QString filename, files) {
-            const Key key = filename.section('.', 0, 0).toStdString();
-            const std::string filepath = dir.filePath(filename).toStdString();
-            const size_t length = QFileInfo(filepath.c_str()).size();
-            addFile(Metadata(key, length), filepath);
+        std::vector<PersistedFile> persistedFiles;
+        bool hasIndex = loadIndex(persistedFiles);
+
+        // load persisted files, least recently used first
+        std::unordered_map<Key, size_t> indexedFiles;
+        indexedFiles.reserve(persistedFiles.size());
+        for (const auto& persistedFile : persistedFiles) {
+            addPersistedFile(persistedFile, false);
+            indexedFiles[persistedFile.key] = persistedFile.length;
         }
+        openIndex(!hasIndex || _numIndexRecords > std::max(2 * persistedFiles.size(), MIN_INDEX_RECORDS_TO_COMPACT));
 
-        qCDebug(file_cache, "[%s] Initialized %s", _dirname.c_str(), _dirpath.c_str());
+        _validationThread = std::thread([this, indexedFiles] { validate(indexedFiles); });
+
+        clean();
+        emit dirty();
+        qCDebug(file_cache, "[%s] Initialized %s with %d indexed files", _dirname.c_str(), _dirpath.c_str(),
+                (int)persistedFiles.size());
     } else {
         dir.mkpath(_dirpath.c_str());
+        openIndex(true);
         qCDebug(file_cache, "[%s] Created %s", _dirname.c_str(), _dirpath.c_str());
     }
 
@@ -129,6 +165,7 @@ FilePointer FileCache::addFile(Metadata&& metadata, const std::string& filepath)
         _numTotalFiles += 1;
         _totalFilesSize += file->getLength();
         file->_parent = shared_from_this();
+        file->_lastAccess = now();
         file->_locked = true;
         emit dirty();
 
@@ -137,6 +174,23 @@ FilePointer FileCache::addFile(Metadata&& metadata, const std::string& filepath)
     return file;
 }
 
+// Goes straight to the unused files, without the budget being checked for every one of them
+void FileCache::addPersistedFile(const PersistedFile& persistedFile, bool leastRecent) {
+    File* rawFile = createFile(Metadata(persistedFile.key, persistedFile.length), getFilepath(persistedFile.key)).release();
+    FilePointer file(rawFile, std::bind(&File::deleter, rawFile));
+    if (file) {
+        _numTotalFiles += 1;
+        _totalFilesSize += file->getLength();
+        file->_parent = shared_from_this();
+        file->_lastAccess = persistedFile.lastAccess;
+
+        _files[file->getKey()] = file;
+        linkUnusedFile(file, leastRecent);
+        _numUnusedFiles += 1;
+        _unusedFilesSize += file->getLength();
+    }
+}
+
 FilePointer FileCache::writeFile(const char* data, File::Metadata&& metadata, bool overwrite) {
     FilePointer file;
 
@@ -173,6 +227,7 @@ FilePointer FileCache::writeFile(const char* data, File::Metadata&& metadata, bo
         && saveFile.commit()) {
 
         file = addFile(std::move(metadata), filepath);
+        appendToIndex(ADD_RECORD, *file);
     } else {
         qCWarning(file_cache, "[%s] Failed to write %s", _dirname.c_str(), metadata.key.c_str());
     }
@@ -190,15 +245,17 @@ FilePointer FileCache::getFile(const Key& key) {
         return file;
     }
 
+    applyValidation();
+
     // check if file exists
     const auto it = _files.find(key);
     if (it != _files.cend()) {
         file = it->second.lock();
         if (file) {
-            file->touch();
             // if it exists, it is active - remove it from the cache
-            if (_unusedFiles.erase(file)) {
+            if (file->_self) {
                 assert(!file->_locked);
+                unlinkUnusedFile(file.get());
                 file->_locked = true;
                 _numUnusedFiles -= 1;
                 _unusedFilesSize -= file->getLength();
@@ -226,10 +283,12 @@ std::string FileCache::getFilepath(const Key& key) {
 void FileCache::addUnusedFile(const FilePointer& file) {
     assert(file->_locked);
     file->_locked = false;
+    file->_lastAccess = now();
     _files[file->getKey()] = file;
-    _unusedFiles.insert(file);
+    linkUnusedFile(file);
     _numUnusedFiles += 1;
     _unusedFilesSize += file->getLength();
+    appendToIndex(ACCESS_RECORD, *file);
     clean();
 
     emit dirty();
@@ -250,12 +309,44 @@ size_t FileCache::getOverbudgetAmount() const {
     return result;
 }
 
-namespace cache {
-    struct FilePointerComparator {
-        bool operator()(const FilePointer& a, const FilePointer& b) {
-            return a->_modified > b->_modified;
+void FileCache::linkUnusedFile(const FilePointer& file, bool leastRecent) {
+    assert(!file->_self);
+    file->_self = file;
+    if (leastRecent) {
+        file->_nextUnused = _leastRecentlyUsed;
+        if (_leastRecentlyUsed) {
+            _leastRecentlyUsed->_previousUnused = file.get();
+        } else {
+            _mostRecentlyUsed = file.get();
         }
-    };
+        _leastRecentlyUsed = file.get();
+    } else {
+        file->_previousUnused = _mostRecentlyUsed;
+        if (_mostRecentlyUsed) {
+            _mostRecentlyUsed->_nextUnused = file.get();
+        } else {
+            _leastRecentlyUsed = file.get();
+        }
+        _mostRecentlyUsed = file.get();
+    }
+}
+
+// The file is released along with the returned pointer, unless it is used elsewhere
+FilePointer FileCache::unlinkUnusedFile(File* file) {
+    assert(file->_self);
+    if (file->_previousUnused) {
+        file->_previousUnused->_nextUnused = file->_nextUnused;
+    } else {
+        _leastRecentlyUsed = file->_nextUnused;
+    }
+    if (file->_nextUnused) {
+        file->_nextUnused->_previousUnused = file->_previousUnused;
+    } else {
+        _mostRecentlyUsed = file->_previousUnused;
+    }
+    file->_previousUnused = nullptr;
+    file->_nextUnused = nullptr;
+    return std::move(file->_self);
 }
 
 // Take file pointer by value to insure it doesn't get destructed during the "erase()" calls
@@ -268,29 +359,19 @@ void FileCache::eject(FilePointer file) {
         _numTotalFiles -= 1;
         _totalFilesSize -= length;
     }
-    if (0 != _unusedFiles.erase(file)) {
+    if (file->_self) {
+        unlinkUnusedFile(file.get());
         _numUnusedFiles -= 1;
         _unusedFilesSize -= length;
     }
+    appendToIndex(REMOVE_RECORD, key);
 }
 
 void FileCache::clean() {
     size_t overbudgetAmount = getOverbudgetAmount();
 
-    // Avoid sorting the unused files by LRU if we're not over budget / under free space
-    if (0 == overbudgetAmount) {
-        return;
-    }
-
-    using Queue = std::priority_queue<FilePointer, std::vector<FilePointer>, FilePointerComparator>;
-    Queue queue;
-    for (const auto& file : _unusedFiles) {
-        queue.push(file);
-    }
-
-    while (!queue.empty() && overbudgetAmount > 0) {
-        auto file = queue.top();
-        queue.pop();
+    while (_leastRecentlyUsed && overbudgetAmount > 0) {
+        FilePointer file = _leastRecentlyUsed->_self;
         eject(file);
         auto length = file->getLength();
         overbudgetAmount -= std::min(length, overbudgetAmount);
@@ -299,8 +380,8 @@ void FileCache::clean() {
 
 void FileCache::wipe() {
     Lock lock(_mutex);
-    while (!_unusedFiles.empty()) {
-        eject(*_unusedFiles.begin());
+    while (_leastRecentlyUsed) {
+        eject(_leastRecentlyUsed->_self);
     }
 }
 
@@ -311,12 +392,15 @@ void FileCache::clear() {
     clean();
 
     // Mark everything remaining as persisted while effectively ejecting from the cache
-    for (auto& file : _unusedFiles) {
+    while (_leastRecentlyUsed) {
+        File* file = _leastRecentlyUsed;
         file->_shouldPersist = true;
         file->_parent.reset();
         qCDebug(file_cache, "[%s] Persisting %s", _dirname.c_str(), file->getKey().c_str());
+        unlinkUnusedFile(file);
     }
-    _unusedFiles.clear();
+
+    closeIndex();
 }
 
 void FileCache::releaseFile(File* file) {
@@ -328,6 +412,243 @@ void FileCache::releaseFile(File* file) {
     }
 }
 
+bool FileCache::loadIndex(std::vector<PersistedFile>& persistedFiles) {
+    QFile indexFile(QString::fromStdString(_dirpath + DIR_SEP + INDEX_FILENAME));
+    if (!indexFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QByteArray bytes = indexFile.readAll();
+    QDataStream stream(bytes);
+    quint32 magic { 0 };
+    quint32 version { 0 };
+    stream >> magic >> version;
+    if (stream.status() != QDataStream::Ok || magic != INDEX_MAGIC || version != INDEX_VERSION) {
+        qCWarning(file_cache, "[%s] Ignoring unknown index", _dirname.c_str());
+        return false;
+    }
+
+    struct Entry {
+        size_t length;
+        int64_t lastAccess;
+        size_t sequence;
+    };
+    std::unordered_map<Key, Entry> entries;
+
+    // a record cut short by a crash ends the index
+    _numIndexRecords = 0;
+    while (!stream.atEnd()) {
+        quint8 type { 0 };
+        quint32 keyLength { 0 };
+        stream >> type >> keyLength;
+        if (stream.status() != QDataStream::Ok || keyLength > MAX_INDEX_KEY_LENGTH) {
+            break;
+        }
+        Key key(keyLength, '\0');
+        if (stream.readRawData(&key[0], (int)keyLength) != (int)keyLength) {
+            break;
+        }
+
+        if (type == ADD_RECORD) {
+            quint64 length { 0 };
+            qint64 lastAccess { 0 };
+            stream >> length >> lastAccess;
+            if (stream.status() != QDataStream::Ok) {
+                break;
+            }
+            entries[key] = { (size_t)length, lastAccess, _numIndexRecords };
+        } else if (type == ACCESS_RECORD) {
+            qint64 lastAccess { 0 };
+            stream >> lastAccess;
+            if (stream.status() != QDataStream::Ok) {
+                break;
+            }
+            auto it = entries.find(key);
+            if (it != entries.end()) {
+                it->second.lastAccess = lastAccess;
+                it->second.sequence = _numIndexRecords;
+            }
+        } else if (type == REMOVE_RECORD) {
+            entries.erase(key);
+        } else {
+            break;
+        }
+        ++_numIndexRecords;
+    }
+
+    std::vector<std::pair<size_t, PersistedFile>> sortedFiles;
+    sortedFiles.reserve(entries.size());
+    for (const auto& entry : entries) {
+        sortedFiles.push_back({ entry.second.sequence, { entry.first, entry.second.length, entry.second.lastAccess } });
+    }
+    std::sort(sortedFiles.begin(), sortedFiles.end(), [](const std::pair<size_t, PersistedFile>& a, const std::pair<size_t, PersistedFile>& b) {
+        return a.second.lastAccess < b.second.lastAccess ||
+            (a.second.lastAccess == b.second.lastAccess && a.first < b.first);
+    });
+
+    persistedFiles.clear();
+    persistedFiles.reserve(sortedFiles.size());
+    for (auto& sortedFile : sortedFiles) {
+        persistedFiles.push_back(std::move(sortedFile.second));
+    }
+    return true;
+}
+
+void FileCache::openIndex(bool compact) {
+    QString indexPath = QString::fromStdString(_dirpath + DIR_SEP + INDEX_FILENAME);
+
+    // held until the index is reopened, so that releasing one of them can't append to the index mid-rewrite
+    std::vector<FilePointer> usedFiles;
+
+    if (compact) {
+        // the journal being replaced must be closed before the new one can take its place
+        closeIndex();
+
+        // a fresh index holding one record per file: the unused ones in least recently used order, then those in use
+        QByteArray bytes;
+        {
+            QDataStream stream(&bytes, QIODevice::WriteOnly);
+            stream << INDEX_MAGIC << INDEX_VERSION;
+        }
+        _numIndexRecords = 0;
+        for (File* file = _leastRecentlyUsed; file; file = file->_nextUnused) {
+            bytes.append(makeIndexRecord(ADD_RECORD, file->getKey(), file->getLength(), file->_lastAccess));
+            ++_numIndexRecords;
+        }
+        for (const auto& entry : _files) {
+            FilePointer file = entry.second.lock();
+            if (file && !file->_self) {
+                bytes.append(makeIndexRecord(ADD_RECORD, file->getKey(), file->getLength(), file->_lastAccess));
+                ++_numIndexRecords;
+                usedFiles.push_back(file);
+            }
+        }
+
+        // if the rewrite fails, the old journal is left in place and appended to as before
+        QSaveFile saveFile(indexPath);
+        if (!saveFile.open(QIODevice::WriteOnly) || saveFile.write(bytes) != bytes.size() || !saveFile.commit()) {
+            qCWarning(file_cache, "[%s] Failed to write index", _dirname.c_str());
+        }
+    }
+
+    _index.reset(new QFile(indexPath));
+    if (!_index->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(file_cache, "[%s] Failed to open index", _dirname.c_str());
+        _index.reset();
+    }
+}
+
+void FileCache::closeIndex() {
+    if (_index) {
+        _index->close();
+        _index.reset();
+    }
+}
+
+void FileCache::appendToIndex(quint8 type, const File& file) {
+    appendToIndex(type, file.getKey(), file.getLength(), file._lastAccess);
+}
+
+void FileCache::appendToIndex(quint8 type, const Key& key, size_t length, int64_t lastAccess) {
+    if (!_index) {
+        return;
+    }
+
+    QByteArray record = makeIndexRecord(type, key, length, lastAccess);
+    _index->write(record);
+    // losing access records only loses some recency, so they ride along with the next add or remove
+    if (type != ACCESS_RECORD) {
+        _index->flush();
+    }
+    ++_numIndexRecords;
+
+    if (_numIndexRecords > std::max(2 * _files.size(), MIN_INDEX_RECORDS_TO_COMPACT)) {
+        openIndex(true);
+    }
+}
+
+void FileCache::validate(std::unordered_map<Key, size_t> indexedFiles) {
+    QDir dir(_dirpath.c_str());
+    auto nameFilters = QStringList(("*." + _ext).c_str());
+    auto filters = QDir::Filters(QDir::NoDotAndDotDot | QDir::Files);
+    auto files = dir.entryList(nameFilters, filters, QDir::NoSort);
+
+    std::vector<Key> invalidFiles;
+    std::vector<PersistedFile> unindexedFiles;
+    foreach(QString filename, files) {
+        if (_stopValidation) {
+            return;
+        }
+
+        const Key key = filename.section('.', 0, 0).toStdString();
+        QFileInfo fileInfo(dir.filePath(filename));
+        auto it = indexedFiles.find(key);
+        if (it != indexedFiles.end()) {
+            if ((size_t)fileInfo.size() != it->second) {
+                invalidFiles.push_back(key);
+            }
+            indexedFiles.erase(it);
+        } else if (fileInfo.size() > 0) {
+            unindexedFiles.push_back({ key, (size_t)fileInfo.size(), fileInfo.lastRead().toMSecsSinceEpoch() });
+        }
+    }
+
+    // whatever is left was indexed but is gone
+    for (const auto& indexedFile : indexedFiles) {
+        invalidFiles.push_back(indexedFile.first);
+    }
+
+    std::sort(unindexedFiles.begin(), unindexedFiles.end(), [](const PersistedFile& a, const PersistedFile& b) {
+        return a.lastAccess < b.lastAccess;
+    });
+
+    Lock lock(_mutex);
+    _invalidFiles = std::move(invalidFiles);
+    _unindexedFiles = std::move(unindexedFiles);
+    _hasValidationResults = true;
+    qCDebug(file_cache, "[%s] Validated index, %d invalid and %d unindexed files", _dirname.c_str(),
+            (int)_invalidFiles.size(), (int)_unindexedFiles.size());
+}
+
+void FileCache::applyValidation() {
+    if (!_hasValidationResults) {
+        return;
+    }
+    _hasValidationResults = false;
+
+    // files still in use are left to whoever uses them
+    for (const auto& key : _invalidFiles) {
+        auto it = _files.find(key);
+        if (it == _files.end()) {
+            continue;
+        }
+        auto file = it->second.lock();
+        if (file && file->_self) {
+            eject(file);
+        }
+    }
+
+    // files the index didn't know of are older than any it did
+    for (auto it = _unindexedFiles.rbegin(); it != _unindexedFiles.rend(); ++it) {
+        auto existing = _files.find(it->key);
+        if (existing != _files.end() && !existing->second.expired()) {
+            continue;
+        }
+        // it may have been ejected or overwritten since it was found
+        QFileInfo fileInfo(QString::fromStdString(getFilepath(it->key)));
+        if (!fileInfo.exists() || (size_t)fileInfo.size() != it->length) {
+            continue;
+        }
+        addPersistedFile(*it, true);
+        appendToIndex(ADD_RECORD, it->key, it->length, it->lastAccess);
+    }
+
+    _invalidFiles.clear();
+    _unindexedFiles.clear();
+    clean();
+    emit dirty();
+}
+
 void File::deleter(File* file) {
     // If the cache shut down before the file was destroyed, then we should leave the file alone (prevents crash on shutdown)
     FileCachePointer cache = file->_parent.lock();
@@ -344,8 +665,7 @@ void File::deleter(File* file) {
 File::File(Metadata&& metadata, const std::string& filepath) :
     _key(std::move(metadata.key)),
     _length(metadata.length),
-    _filepath(filepath),
-    _modified(QFileInfo(_filepath.c_str()).lastRead().toMSecsSinceEpoch()) {
+    _filepath(filepath) {
 }
 
 File::~File() {
@@ -355,9 +675,3 @@ File::~File() {
         file.remove();
     }
 }
-
-void File::touch() {
-    utime(_filepath.c_str(), nullptr);
-    _modified = std::max<int64_t>(QFileInfo(_filepath.c_str()).lastRead().toMSecsSinceEpoch(), _modified);
-}
-
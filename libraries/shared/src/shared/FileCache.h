@@ -17,13 +17,16 @@
 #include <unordered_set>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include <QObject>
 #include <QLoggingCategory>
 
 Q_DECLARE_LOGGING_CATEGORY(file_cache)
 
+class QFile;
 class FileCacheTests;
 
 namespace cache {
@@ -44,6 +47,7 @@ class FileCache : public QObject, public std::enable_shared_from_this<FileCache>
     static const size_t DEFAULT_MAX_SIZE;
     static const size_t MAX_MAX_SIZE;
     static const size_t DEFAULT_MIN_FREE_STORAGE_SPACE;
+    static const char* INDEX_FILENAME;
 
     friend class ::FileCacheTests;
 
@@ -92,7 +96,9 @@ signals:
     void dirty();
 
 public:
-    /// must be called after construction to create the cache on the fs and restore persisted files
+    /// must be called after construction to create the cache on the fs and restore persisted files.
+    /// The files are restored from the index in the cache directory, which is checked against the directory
+    /// in the background. Files the index doesn't know of become available once that check is done.
     virtual void initialize();
 
     // Add file to the cache and return the cache entry.  
@@ -106,14 +112,21 @@ private:
     using Mutex = std::recursive_mutex;
     using Lock = std::unique_lock<Mutex>;
     using Map = std::unordered_map<Key, std::weak_ptr<File>>;
-    using Set = std::unordered_set<FilePointer>;
     using KeySet = std::unordered_set<Key>;
 
     friend class File;
 
+    // a file on disk, as the index or the directory knows it
+    struct PersistedFile {
+        Key key;
+        size_t length;
+        int64_t lastAccess; // msecs since epoch
+    };
+
     std::string getFilepath(const Key& key);
 
     FilePointer addFile(Metadata&& metadata, const std::string& filepath);
+    void addPersistedFile(const PersistedFile& persistedFile, bool leastRecent);
     void addUnusedFile(const FilePointer& file);
     void releaseFile(File* file);
     void clean();
@@ -123,6 +136,23 @@ private:
 
     size_t getOverbudgetAmount() const;
 
+    // The unused files in least recently used order, linked through the files themselves
+    void linkUnusedFile(const FilePointer& file, bool leastRecent = false);
+    FilePointer unlinkUnusedFile(File* file);
+
+    // The index is a journal of the files added, used and removed, replayed in one read on initialization
+    // and rewritten once it holds many more records than files
+    bool loadIndex(std::vector<PersistedFile>& persistedFiles);
+    void openIndex(bool compact);
+    void closeIndex();
+    void appendToIndex(quint8 type, const File& file);
+    void appendToIndex(quint8 type, const Key& key, size_t length = 0, int64_t lastAccess = 0);
+
+    // Runs on the validation thread, which never touches the files themselves: what it finds is applied
+    // by the next caller into the cache
+    void validate(std::unordered_map<Key, size_t> indexedFiles);
+    void applyValidation();
+
     // FIXME it might be desirable to have the min free space variable be static so it can be
     // shared among multiple instances of FileCache
     std::atomic<size_t> _minFreeSpaceSize { DEFAULT_MIN_FREE_STORAGE_SPACE };
@@ -139,7 +169,17 @@ private:
 
     Mutex _mutex;
     Map _files;
-    Set _unusedFiles;
+    File* _leastRecentlyUsed { nullptr };
+    File* _mostRecentlyUsed { nullptr };
+
+    std::unique_ptr<QFile> _index;
+    size_t _numIndexRecords { 0 };
+
+    std::thread _validationThread;
+    std::atomic<bool> _stopValidation { false };
+    std::atomic<bool> _hasValidationResults { false };
+    std::vector<Key> _invalidFiles;
+    std::vector<PersistedFile> _unindexedFiles;
 };
 
 class File {
@@ -161,18 +201,21 @@ protected:
 
 private:
     friend class FileCache;
-    friend struct FilePointerComparator;
     friend class ::FileCacheTests;
 
     const Key _key;
     const size_t _length;
     const std::string _filepath;
 
-    void touch();
     FileCacheWeakPointer _parent;
-    int64_t _modified { 0 };
+    int64_t _lastAccess { 0 }; // msecs since epoch
     bool _locked { false };
 
+    // set while the file is unused, so the cache's list of unused files keeps it alive
+    FilePointer _self;
+    File* _previousUnused { nullptr };
+    File* _nextUnused { nullptr };
+
     bool _shouldPersist { false };
 };
 
@@ -0,0 +1,362 @@
+//
+//  FrameTracer.cpp
+//  libraries/shared/src/shared
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FrameTracer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static inline int highestBit(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+LatencyHistogram& LatencyHistogram::operator=(const LatencyHistogram& other) {
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        _counts[i].store(other._counts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    return *this;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& count : _counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::add(const LatencyHistogram& other) {
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        auto sum = _counts[i].load(std::memory_order_relaxed) + other._counts[i].load(std::memory_order_relaxed);
+        _counts[i].store(sum, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::subtract(const LatencyHistogram& other) {
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        auto count = _counts[i].load(std::memory_order_relaxed);
+        auto otherCount = other._counts[i].load(std::memory_order_relaxed);
+        _counts[i].store(count > otherCount ? count - otherCount : 0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t LatencyHistogram::getCount() const {
+    uint64_t total = 0;
+    for (auto& count : _counts) {
+        total += count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t LatencyHistogram::getValueAtPercentile(float percentile) const {
+    uint64_t total = getCount();
+    if (total == 0) {
+        return 0;
+    }
+
+    percentile = std::min(std::max(percentile, 0.0f), 100.0f);
+    uint64_t target = std::max((uint64_t)std::ceil(total * (double)percentile / 100.0), (uint64_t)1);
+
+    uint64_t seen = 0;
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        seen += _counts[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            return highestValueInBucket(i);
+        }
+    }
+    return highestValueInBucket(NUM_BUCKETS - 1);
+}
+
+int LatencyHistogram::bucketForValue(uint64_t value) {
+    if (value < (uint64_t)SUB_BUCKETS) {
+        return (int)value;
+    }
+
+    // keep the top SUB_BUCKET_BITS bits of the value, whose leading bit is always set
+    int shift = highestBit(value) - SUB_BUCKET_BITS + 1;
+    if (shift > MAX_SHIFT) {
+        return NUM_BUCKETS - 1;
+    }
+    int top = (int)(value >> shift);
+    return SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS + (top - HALF_SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::highestValueInBucket(int bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return (uint64_t)bucket;
+    }
+
+    int offset = bucket - SUB_BUCKETS;
+    int shift = offset / HALF_SUB_BUCKETS + 1;
+    uint64_t top = (uint64_t)(offset % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS);
+    return ((top + 1) << shift) - 1;
+}
+
+FrameTracer::Scope::Scope(PhaseID phase, int slave, const QUuid& node) :
+    _phase(phase),
+    _slave(slave),
+    _node(node)
+{
+    auto& tracer = FrameTracer::getInstance();
+    _begin = tracer.now();
+    append(tracer.getThreadBuffer(), _phase, PhaseBegin, _begin, _slave, _node);
+}
+
+FrameTracer::Scope::~Scope() {
+    auto& tracer = FrameTracer::getInstance();
+    auto end = tracer.now();
+    auto& buffer = tracer.getThreadBuffer();
+    append(buffer, _phase, PhaseEnd, end, _slave, _node);
+    buffer.histograms[_phase].record(end - _begin);
+}
+
+FrameTracer& FrameTracer::getInstance() {
+    static FrameTracer instance;
+    return instance;
+}
+
+FrameTracer::FrameTracer() :
+    _epoch(p_high_resolution_clock::now())
+{
+}
+
+FrameTracer::PhaseID FrameTracer::registerPhase(const QString& name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    int numPhases = _numPhases.load();
+    for (int i = 0; i < numPhases; i++) {
+        if (_phaseNames[i] == name) {
+            return (PhaseID)i;
+        }
+    }
+
+    if (numPhases == MAX_PHASES) {
+        qWarning() << "FrameTracer has no room for phase" << name << "- it will be counted as" << _phaseNames.back();
+        return (PhaseID)(MAX_PHASES - 1);
+    }
+
+    _phaseNames[numPhases] = name;
+    _numPhases.store(numPhases + 1);
+    return (PhaseID)numPhases;
+}
+
+QString FrameTracer::getPhaseName(PhaseID phase) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return phase < MAX_PHASES ? _phaseNames[phase] : QString();
+}
+
+uint64_t FrameTracer::now() const {
+    auto elapsed = p_high_resolution_clock::now() - _epoch;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+void FrameTracer::record(PhaseID phase, EventType type, uint64_t timestamp, int slave, const QUuid& node) {
+    append(getThreadBuffer(), phase, type, timestamp, slave, node);
+}
+
+void FrameTracer::recordDuration(PhaseID phase, uint64_t usecs) {
+    getThreadBuffer().histograms[phase].record(usecs);
+}
+
+FrameTracer::ThreadBufferOwner::~ThreadBufferOwner() {
+    if (buffer) {
+        FrameTracer::getInstance().retireThreadBuffer(buffer);
+    }
+}
+
+FrameTracer::ThreadBuffer& FrameTracer::getThreadBuffer() {
+    static QThreadStorage<ThreadBufferOwner*> threadBuffers;
+
+    if (!threadBuffers.hasLocalData()) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        auto thread = QThread::currentThread();
+        buffer->threadName = thread ? thread->objectName() : QString();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        buffer->threadID = _nextThreadID++;
+        if (buffer->threadName.isEmpty()) {
+            buffer->threadName = QString("Thread %1").arg(buffer->threadID);
+        }
+        _threadBuffers.push_back(buffer);
+        threadBuffers.setLocalData(new ThreadBufferOwner { buffer });
+    }
+    return *threadBuffers.localData()->buffer;
+}
+
+void FrameTracer::retireThreadBuffer(const ThreadBufferPointer& buffer) {
+    // keep the exited thread's samples so the histograms never go backwards, but let its ring go
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (int i = 0; i < MAX_PHASES; i++) {
+        _retiredHistograms[i].add(buffer->histograms[i]);
+    }
+    _threadBuffers.erase(std::remove(_threadBuffers.begin(), _threadBuffers.end(), buffer), _threadBuffers.end());
+}
+
+void FrameTracer::append(ThreadBuffer& buffer, PhaseID phase, EventType type, uint64_t timestamp, int slave,
+                         const QUuid& node) {
+    // only the owning thread writes, readers use the index to tell which events may have been overwritten under them
+    auto index = buffer.writeIndex.load(std::memory_order_relaxed);
+    auto& event = buffer.events[index & (RING_SIZE - 1)];
+    event.timestamp = timestamp;
+    event.node = node;
+    event.phase = phase;
+    event.type = type;
+    event.slave = slave;
+    buffer.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+std::vector<FrameTracer::ThreadBufferPointer> FrameTracer::getThreadBuffers() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _threadBuffers;
+}
+
+std::vector<LatencyHistogram> FrameTracer::getHistograms() const {
+    std::vector<LatencyHistogram> histograms(_numPhases.load());
+    std::vector<ThreadBufferPointer> buffers;
+    {
+        // take the retired samples and the live buffers together, so a thread retiring in between isn't counted twice
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (size_t i = 0; i < histograms.size(); i++) {
+            histograms[i].add(_retiredHistograms[i]);
+        }
+        buffers = _threadBuffers;
+    }
+    for (auto& buffer : buffers) {
+        for (size_t i = 0; i < histograms.size(); i++) {
+            histograms[i].add(buffer->histograms[i]);
+        }
+    }
+    return histograms;
+}
+
+QJsonObject FrameTracer::takePhaseStats() {
+    auto histograms = getHistograms();
+
+    std::vector<LatencyHistogram> window = histograms;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (size_t i = 0; i < window.size() && i < _lastHistograms.size(); i++) {
+            window[i].subtract(_lastHistograms[i]);
+        }
+        _lastHistograms = std::move(histograms);
+    }
+
+    QJsonObject stats;
+    for (size_t i = 0; i < window.size(); i++) {
+        auto& histogram = window[i];
+        auto count = histogram.getCount();
+        if (count == 0) {
+            continue;
+        }
+
+        QJsonObject phaseStats;
+        phaseStats["count"] = (qint64)count;
+        phaseStats["p50_us"] = (qint64)histogram.getValueAtPercentile(50.0f);
+        phaseStats["p90_us"] = (qint64)histogram.getValueAtPercentile(90.0f);
+        phaseStats["p99_us"] = (qint64)histogram.getValueAtPercentile(99.0f);
+        phaseStats["p999_us"] = (qint64)histogram.getValueAtPercentile(99.9f);
+        phaseStats["max_us"] = (qint64)histogram.getMax();
+        stats[getPhaseName((PhaseID)i)] = phaseStats;
+    }
+    return stats;
+}
+
+QByteArray FrameTracer::toChromeTraceJSON() const {
+    QJsonArray traceEvents;
+    qint64 processID = QCoreApplication::applicationPid();
+
+    std::array<QString, MAX_PHASES> phaseNames;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        phaseNames = _phaseNames;
+    }
+
+    for (auto& buffer : getThreadBuffers()) {
+        QJsonObject threadName;
+        threadName["name"] = "thread_name";
+        threadName["ph"] = "M";
+        threadName["pid"] = processID;
+        threadName["tid"] = buffer->threadID;
+        threadName["args"] = QJsonObject { { "name", buffer->threadName } };
+        traceEvents.append(threadName);
+
+        // copy out what the ring holds, then drop anything the writer may have lapped while we copied
+        uint64_t end = buffer->writeIndex.load(std::memory_order_acquire);
+        uint64_t begin = end > (uint64_t)RING_SIZE ? end - RING_SIZE : 0;
+        std::vector<Event> events;
+        events.reserve(end - begin);
+        for (uint64_t i = begin; i < end; i++) {
+            events.push_back(buffer->events[i & (RING_SIZE - 1)]);
+        }
+        // the writer fills slot lapped before publishing it, so that slot may have been torn under us as well
+        uint64_t lapped = buffer->writeIndex.load(std::memory_order_acquire);
+        size_t firstValid = lapped >= begin + RING_SIZE ? (size_t)std::min(lapped - begin - RING_SIZE + 1, end - begin) : 0;
+
+        // pair begins with ends; phases nest on a thread, so anything left open by a dropped event is skipped over
+        std::vector<const Event*> open;
+        for (size_t i = firstValid; i < events.size(); i++) {
+            const Event& event = events[i];
+            if (event.type == PhaseBegin) {
+                open.push_back(&event);
+                continue;
+            }
+
+            auto match = std::find_if(open.rbegin(), open.rend(), [&](const Event* candidate) {
+                return candidate->phase == event.phase && candidate->slave == event.slave && candidate->node == event.node;
+            });
+            if (match == open.rend()) {
+                continue;
+            }
+            const Event& beginEvent = **match;
+            open.erase(std::prev(match.base()), open.end());
+
+            QJsonObject traceEvent;
+            traceEvent["name"] = phaseNames[event.phase];
+            traceEvent["cat"] = "frame";
+            traceEvent["ph"] = "X";
+            traceEvent["ts"] = (qint64)beginEvent.timestamp;
+            traceEvent["dur"] = (qint64)(event.timestamp - beginEvent.timestamp);
+            traceEvent["pid"] = processID;
+            traceEvent["tid"] = buffer->threadID;
+
+            QJsonObject args;
+            if (event.slave >= 0) {
+                args["slave"] = event.slave;
+            }
+            if (!event.node.isNull()) {
+                args["node"] = event.node.toString();
+            }
+            if (!args.isEmpty()) {
+                traceEvent["args"] = args;
+            }
+            traceEvents.append(traceEvent);
+        }
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
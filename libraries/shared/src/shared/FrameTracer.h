@@ -0,0 +1,157 @@
+//
+//  FrameTracer.h
+//  libraries/shared/src/shared
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Shared_FrameTracer_h
+#define hifi_Shared_FrameTracer_h
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+
+#include "../PortableHighResolutionClock.h"
+
+// Log-linear latency histogram in the style of HdrHistogram: values below 32us are exact, above that each power of two
+// is split into 16 buckets, so a percentile is never more than about 6% above the recorded value.
+// Only one thread may record into a histogram, but any thread may read it while it does.
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+    static const int MAX_SHIFT = 36;
+    static const int NUM_BUCKETS = SUB_BUCKETS + MAX_SHIFT * HALF_SUB_BUCKETS;
+
+    LatencyHistogram() { reset(); }
+    LatencyHistogram(const LatencyHistogram& other) { *this = other; }
+    LatencyHistogram& operator=(const LatencyHistogram& other);
+
+    void record(uint64_t usecs) {
+        auto& bucket = _counts[bucketForValue(usecs)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void reset();
+    void add(const LatencyHistogram& other);
+    void subtract(const LatencyHistogram& other); // other must be an earlier snapshot of this histogram
+
+    uint64_t getCount() const;
+
+    // upper bound of the bucket holding the value at the given percentile (0 - 100), 0 if empty
+    uint64_t getValueAtPercentile(float percentile) const;
+    uint64_t getMax() const { return getValueAtPercentile(100.0f); }
+
+    static int bucketForValue(uint64_t value);
+    static uint64_t highestValueInBucket(int bucket);
+
+private:
+    std::array<std::atomic<uint32_t>, NUM_BUCKETS> _counts;
+};
+
+// Always-on frame phase timing for the assignment-client mixers. Every thread appends fixed size binary events to its
+// own lock-free ring and records the phase duration into its own histograms, so the hot path never takes a lock or
+// allocates. The rings are only read when a trace is exported, the histograms when stats are sent.
+class FrameTracer {
+public:
+    using PhaseID = uint16_t;
+    static const int MAX_PHASES = 32;
+    static const int RING_SIZE = 1 << 15; // events per thread, must be a power of two
+
+    enum EventType : uint8_t {
+        PhaseBegin,
+        PhaseEnd
+    };
+
+    struct Event {
+        uint64_t timestamp; // usecs since the tracer started
+        QUuid node;
+        PhaseID phase;
+        EventType type;
+        int32_t slave;
+    };
+
+    // times one phase on the calling thread, from construction to destruction
+    class Scope {
+    public:
+        Scope(PhaseID phase, int slave = -1, const QUuid& node = QUuid());
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        PhaseID _phase;
+        int _slave;
+        QUuid _node;
+        uint64_t _begin;
+    };
+
+    static FrameTracer& getInstance();
+
+    // returns the ID for the named phase, registering it on first use; phases past MAX_PHASES share the last ID
+    PhaseID registerPhase(const QString& name);
+    QString getPhaseName(PhaseID phase) const;
+
+    uint64_t now() const;
+    void record(PhaseID phase, EventType type, uint64_t timestamp, int slave, const QUuid& node);
+    void recordDuration(PhaseID phase, uint64_t usecs);
+
+    // histograms of every phase merged across threads, indexed by PhaseID
+    std::vector<LatencyHistogram> getHistograms() const;
+
+    // count and percentiles for each phase seen since the previous call
+    QJsonObject takePhaseStats();
+
+    // the events still in the rings, paired into complete events, in the Chrome trace event format
+    QByteArray toChromeTraceJSON() const;
+
+private:
+    struct ThreadBuffer {
+        std::array<Event, RING_SIZE> events;
+        std::atomic<uint64_t> writeIndex { 0 };
+        std::array<LatencyHistogram, MAX_PHASES> histograms;
+        qint64 threadID { 0 };
+        QString threadName;
+    };
+    using ThreadBufferPointer = std::shared_ptr<ThreadBuffer>;
+
+    // held in thread local storage, hands the buffer back to the tracer when its thread exits
+    struct ThreadBufferOwner {
+        ThreadBufferPointer buffer;
+        ~ThreadBufferOwner();
+    };
+
+    FrameTracer();
+
+    ThreadBuffer& getThreadBuffer();
+    void retireThreadBuffer(const ThreadBufferPointer& buffer);
+    static void append(ThreadBuffer& buffer, PhaseID phase, EventType type, uint64_t timestamp, int slave,
+                       const QUuid& node);
+    std::vector<ThreadBufferPointer> getThreadBuffers() const;
+
+    p_high_resolution_clock::time_point _epoch;
+
+    mutable std::mutex _mutex;
+    std::vector<ThreadBufferPointer> _threadBuffers;
+    qint64 _nextThreadID { 1 };
+    std::array<LatencyHistogram, MAX_PHASES> _retiredHistograms; // samples from threads that have exited
+    std::array<QString, MAX_PHASES> _phaseNames;
+    std::atomic<int> _numPhases { 0 };
+    std::vector<LatencyHistogram> _lastHistograms;
+};
+
+#endif // hifi_Shared_FrameTracer_h
@@ -0,0 +1,97 @@
+//
+//  AudioTimeStretchTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioTimeStretchTests.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <AudioConstants.h>
+#include <AudioTimeStretch.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(AudioTimeStretchTests)
+
+static const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+
+// a 250Hz tone has a period of 96 frames at 24kHz, which fits twice in a network frame
+static const float TONE_FREQUENCY = 250.0f;
+static const float TONE_AMPLITUDE = 8000.0f;
+
+static std::vector<int16_t> makeTone(int numChannels) {
+    std::vector<int16_t> samples(NUM_FRAMES * numChannels);
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        float phase = TWO_PI * TONE_FREQUENCY * i / AudioConstants::SAMPLE_RATE;
+        for (int c = 0; c < numChannels; c++) {
+            samples[i * numChannels + c] = (int16_t)(TONE_AMPLITUDE * sinf(phase));
+        }
+    }
+    return samples;
+}
+
+// the largest jump between neighboring frames, a clean edit should not be any worse than the tone itself
+static int maxStep(const std::vector<int16_t>& samples, int numFrames, int numChannels) {
+    int result = 0;
+    for (int i = 1; i < numFrames; i++) {
+        for (int c = 0; c < numChannels; c++) {
+            result = std::max(result, abs(samples[i * numChannels + c] - samples[(i - 1) * numChannels + c]));
+        }
+    }
+    return result;
+}
+
+void AudioTimeStretchTests::testCompressPeriodic() {
+    const int numChannels = AudioConstants::STEREO;
+    AudioTimeStretch timeStretch(AudioConstants::SAMPLE_RATE, numChannels);
+
+    auto input = makeTone(numChannels);
+    std::vector<int16_t> output(input.size());
+    int outputFrames = timeStretch.compress(input.data(), output.data(), NUM_FRAMES);
+
+    const int period = (int)(AudioConstants::SAMPLE_RATE / TONE_FREQUENCY);
+    QCOMPARE(outputFrames, NUM_FRAMES - period);
+    QVERIFY(maxStep(output, outputFrames, numChannels) <= maxStep(input, NUM_FRAMES, numChannels) + 1);
+}
+
+void AudioTimeStretchTests::testExpandPeriodic() {
+    const int numChannels = AudioConstants::MONO;
+    AudioTimeStretch timeStretch(AudioConstants::SAMPLE_RATE, numChannels);
+
+    auto input = makeTone(numChannels);
+    std::vector<int16_t> output((NUM_FRAMES + timeStretch.getMaxLag(NUM_FRAMES)) * numChannels);
+    int outputFrames = timeStretch.expand(input.data(), output.data(), NUM_FRAMES);
+
+    const int period = (int)(AudioConstants::SAMPLE_RATE / TONE_FREQUENCY);
+    QCOMPARE(outputFrames, NUM_FRAMES + period);
+    QVERIFY(maxStep(output, outputFrames, numChannels) <= maxStep(input, NUM_FRAMES, numChannels) + 1);
+
+    // the start and end of the block are untouched, so it still joins up with its neighbors
+    QCOMPARE(output[0], input[0]);
+    QCOMPARE(output[outputFrames - 1], input[NUM_FRAMES - 1]);
+}
+
+void AudioTimeStretchTests::testNoisePassesThrough() {
+    const int numChannels = AudioConstants::MONO;
+    AudioTimeStretch timeStretch(AudioConstants::SAMPLE_RATE, numChannels);
+
+    // loud noise does not repeat itself, so there is nowhere to make an edit
+    srand(1);
+    std::vector<int16_t> input(NUM_FRAMES);
+    for (auto& sample : input) {
+        sample = (int16_t)((rand() % 32768) - 16384);
+    }
+
+    std::vector<int16_t> output((NUM_FRAMES + timeStretch.getMaxLag(NUM_FRAMES)) * numChannels);
+    QCOMPARE(timeStretch.compress(input.data(), output.data(), NUM_FRAMES), NUM_FRAMES);
+    QCOMPARE(timeStretch.expand(input.data(), output.data(), NUM_FRAMES), NUM_FRAMES);
+    QVERIFY(std::equal(input.begin(), input.end(), output.begin()));
+}
@@ -0,0 +1,67 @@
+//
+//  PositionalAudioStreamTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PositionalAudioStreamTests.h"
+
+#include <math.h>
+#include <vector>
+
+#include <AudioConstants.h>
+#include <NumericalConstants.h>
+#include <PositionalAudioStream.h>
+
+QTEST_MAIN(PositionalAudioStreamTests)
+
+// exposes what the mixer's streams do when parsing a packet, without building one
+class TestAudioStream : public PositionalAudioStream {
+public:
+    TestAudioStream(bool isStereo) : PositionalAudioStream(PositionalAudioStream::Microphone, isStereo) {}
+
+    using PositionalAudioStream::setIsStereo;
+
+    // writes to an empty buffer, which is below any desired frames, so a stretching write expands
+    void writeToEmptyBuffer(const std::vector<int16_t>& samples) {
+        clearBuffer();
+        writeSamplesToBuffer(reinterpret_cast<const char*>(samples.data()), (int)(samples.size() * sizeof(int16_t)));
+    }
+
+    std::vector<int16_t> readAll() {
+        std::vector<int16_t> samples(_ringBuffer.samplesAvailable());
+        _ringBuffer.readSamples(samples.data(), (int)samples.size());
+        return samples;
+    }
+};
+
+void PositionalAudioStreamTests::testStretchAfterChannelSwitch() {
+    TestAudioStream stream(false);
+    stream.setTimeStretchEnabled(true);
+    stream.setIsStereo(true);
+    QVERIFY(stream.isStereo());
+
+    // a tone on the left channel only, so anything the edit mixes across channels shows up on the right
+    const int numFrames = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    const float TONE_FREQUENCY = 250.0f;
+    std::vector<int16_t> input(numFrames * AudioConstants::STEREO, 0);
+    for (int i = 0; i < numFrames; i++) {
+        input[i * AudioConstants::STEREO] = (int16_t)(8000.0f * sinf(TWO_PI * TONE_FREQUENCY * i / AudioConstants::SAMPLE_RATE));
+    }
+
+    // only one of every two packets is stretched
+    stream.writeToEmptyBuffer(input);
+    stream.writeToEmptyBuffer(input);
+
+    auto output = stream.readAll();
+    QVERIFY(output.size() > input.size());
+    QCOMPARE(output.size() % AudioConstants::STEREO, (size_t)0);
+    for (size_t i = 1; i < output.size(); i += AudioConstants::STEREO) {
+        QCOMPARE(output[i], (int16_t)0);
+    }
+    QVERIFY(stream.getTimeStretchAddedMsecs() > 0.0f);
+}
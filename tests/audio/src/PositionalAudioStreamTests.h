@@ -0,0 +1,22 @@
+//
+//  PositionalAudioStreamTests.h
+//  tests/audio/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PositionalAudioStreamTests_h
+#define hifi_PositionalAudioStreamTests_h
+
+#include <QtTest/QtTest>
+
+class PositionalAudioStreamTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testStretchAfterChannelSwitch();
+};
+
+#endif // hifi_PositionalAudioStreamTests_h
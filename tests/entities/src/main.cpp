@@ -18,6 +18,9 @@
 
 #include <ShapeEntityItem.h>
 #include <EntityItemProperties.h>
+#include <EntityTree.h>
+#include <MovingEntitiesBatch.h>
+#include <MovingEntitiesOperator.h>
 #include <Octree.h>
 #include <PathUtils.h>
 
@@ -135,6 +138,88 @@ void testPropertyFlags() {
     testPropertyFlags(0xFFFF);
 }
 
+// Moves numMoving of numEntities boxes a small random amount per frame, and re-sorts them with the
+// root-down MovingEntitiesOperator and then with the bottom-up MovingEntitiesBatch.
+void benchmarkMovingEntities(int numEntities, int numMoving, int numFrames) {
+    const float WORLD_EXTENT = 1000.0f;
+    const float MAX_STEP = 2.0f;
+
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+
+    std::vector<EntityItemPointer> entities;
+    entities.reserve(numEntities);
+    tree->withWriteLock([&] {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setDimensions(glm::vec3(0.5f));
+        for (int i = 0; i < numEntities; ++i) {
+            properties.setPosition((glm::vec3(randFloat(), randFloat(), randFloat()) - 0.5f) * WORLD_EXTENT);
+            auto entity = tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+            if (entity) {
+                entities.push_back(entity);
+            }
+        }
+    });
+
+    auto moveEntities = [&](std::function<void(const EntityItemPointer&, const AACube&)> addMove) {
+        for (int i = 0; i < numMoving; ++i) {
+            auto& entity = entities[randIntInRange(0, (int)entities.size() - 1)];
+            glm::vec3 step = (glm::vec3(randFloat(), randFloat(), randFloat()) - 0.5f) * MAX_STEP;
+            entity->setWorldPosition(entity->getWorldPosition() + step);
+            entity->updateQueryAACube();
+            bool success;
+            AACube newCube = entity->getQueryAACube(success);
+            if (success) {
+                addMove(entity, newCube);
+            }
+        }
+    };
+
+    StopWatch operatorWatch;
+    for (int frame = 0; frame < numFrames; ++frame) {
+        tree->withWriteLock([&] {
+            MovingEntitiesOperator moveOperator;
+            moveEntities([&](const EntityItemPointer& entity, const AACube& newCube) {
+                moveOperator.addEntityToMoveList(entity, newCube);
+            });
+            operatorWatch.start();
+            if (moveOperator.hasMovingEntities()) {
+                tree->recurseTreeWithOperator(&moveOperator);
+            }
+            operatorWatch.stop();
+        });
+    }
+
+    StopWatch batchWatch;
+    for (int frame = 0; frame < numFrames; ++frame) {
+        tree->withWriteLock([&] {
+            MovingEntitiesBatch moveBatch(tree);
+            moveEntities([&](const EntityItemPointer& entity, const AACube& newCube) {
+                moveBatch.addEntityToMoveList(entity, newCube);
+            });
+            batchWatch.start();
+            moveBatch.apply();
+            batchWatch.stop();
+        });
+    }
+
+    int misplaced = 0;
+    for (const auto& entity : entities) {
+        bool success;
+        AACube cube = entity->getQueryAACube(success);
+        if (!entity->getElement() || !entity->getElement()->bestFitBounds(cube)) {
+            ++misplaced;
+        }
+    }
+
+    qDebug() << "moving" << numMoving << "of" << entities.size() << "entities per frame:"
+        << "operator" << operatorWatch.getAverage() << "usecs/frame,"
+        << "batch" << batchWatch.getAverage() << "usecs/frame,"
+        << misplaced << "misplaced";
+    Q_ASSERT(misplaced == 0);
+}
+
 int main(int argc, char** argv) {
     QCoreApplication app(argc, argv);
     {
@@ -165,6 +250,11 @@ int main(int argc, char** argv) {
     }
     float duration = (usecTimestampNow() - start);
     qDebug() << (duration / 1000.0f);
+
+    const int MOVING_ENTITIES_FRAMES = 100;
+    benchmarkMovingEntities(10000, 100, MOVING_ENTITIES_FRAMES);
+    benchmarkMovingEntities(10000, 1000, MOVING_ENTITIES_FRAMES);
+    benchmarkMovingEntities(50000, 5000, MOVING_ENTITIES_FRAMES);
     return 0;
 }
 
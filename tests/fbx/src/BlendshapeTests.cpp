@@ -0,0 +1,169 @@
+//
+//  BlendshapeTests.cpp
+//  tests/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BlendshapeTests.h"
+
+#include <vector>
+
+#include <CompactBlendshapes.h>
+#include <FBX.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include <../GLMTestUtils.h>
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(BlendshapeTests)
+
+const float EPSILON = 0.0001f;
+
+// A face sized mesh whose blendshapes each move a few patches of vertices, listed out of order
+// and with some vertices listed twice, as exported blendshapes sometimes are
+static FBXMesh makeMesh(int numVertices, int numBlendshapes) {
+    FBXMesh mesh;
+    for (int i = 0; i < numVertices; i++) {
+        mesh.vertices.push_back(glm::vec3((float)(i % 100), (float)(i / 100), 0.0f));
+        mesh.normals.push_back(glm::vec3(0.0f, 0.0f, 1.0f));
+    }
+    for (int i = 0; i < numBlendshapes; i++) {
+        FBXBlendshape blendshape;
+        const int NUM_PATCHES = 4;
+        const int PATCH_SIZE = 50;
+        for (int j = 0; j < NUM_PATCHES; j++) {
+            int firstIndex = ((i * 7919 + j * 104729) % (numVertices - PATCH_SIZE));
+            for (int k = PATCH_SIZE - 1; k >= 0; k -= (k % 5 == 0 ? 2 : 1)) {
+                blendshape.indices.push_back(firstIndex + k);
+                blendshape.vertices.push_back(glm::vec3(0.01f * k, 0.02f * j, 0.001f * i));
+                blendshape.normals.push_back(glm::vec3(0.1f, 0.0f, -0.1f));
+            }
+        }
+        blendshape.indices.push_back(blendshape.indices.front());
+        blendshape.vertices.push_back(glm::vec3(0.5f));
+        blendshape.normals.push_back(glm::vec3(0.5f));
+        mesh.blendshapes.push_back(blendshape);
+    }
+    return mesh;
+}
+
+// Blends the way Model did before blendshapes were compacted, one vertex at a time
+static void blendReference(const FBXMesh& mesh, const QVector<float>& coefficients,
+        QVector<glm::vec3>& vertices, QVector<glm::vec3>& normals) {
+    vertices = mesh.vertices;
+    normals = mesh.normals;
+    const float NORMAL_COEFFICIENT_SCALE = 0.01f;
+    for (int i = 0, n = qMin(coefficients.size(), mesh.blendshapes.size()); i < n; i++) {
+        float vertexCoefficient = coefficients.at(i);
+        if (vertexCoefficient < EPSILON) {
+            continue;
+        }
+        float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
+        const FBXBlendshape& blendshape = mesh.blendshapes.at(i);
+        for (int j = 0; j < blendshape.indices.size(); j++) {
+            int index = blendshape.indices.at(j);
+            vertices[index] += blendshape.vertices.at(j) * vertexCoefficient;
+            normals[index] += blendshape.normals.at(j) * normalCoefficient;
+        }
+    }
+}
+
+static QVector<float> makeCoefficients(int numBlendshapes, int frame) {
+    QVector<float> coefficients;
+    for (int i = 0; i < numBlendshapes; i++) {
+        // leave most blendshapes off, as faces mostly are
+        coefficients.push_back(i % 4 == frame % 4 ? 0.5f + 0.5f * sinf(0.1f * (frame + i)) : 0.0f);
+    }
+    return coefficients;
+}
+
+void BlendshapeTests::testCompaction() {
+    FBXMesh mesh = makeMesh(1000, 1);
+    CompactBlendshape blendshape(mesh.blendshapes.at(0), mesh.vertices.size());
+
+    QVERIFY(!blendshape.isEmpty());
+    uint32_t previousEnd = 0;
+    for (const auto& run : blendshape.getRuns()) {
+        QVERIFY(run.numIndices > 0);
+        QVERIFY(run.firstIndex + run.numIndices <= (uint32_t)mesh.vertices.size());
+        if (run.firstIndex != blendshape.getRuns().front().firstIndex) {
+            QVERIFY(run.firstIndex > previousEnd + CompactBlendshape::MAX_RUN_GAP);
+        }
+        previousEnd = run.firstIndex + run.numIndices;
+    }
+
+    // out of range indices and zero deltas are dropped
+    FBXBlendshape sparse;
+    sparse.indices = { 5, 2000, 7 };
+    sparse.vertices = { glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(0.0f) };
+    sparse.normals = { glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(0.0f) };
+    QVERIFY(CompactBlendshape(sparse, mesh.vertices.size()).isEmpty());
+}
+
+void BlendshapeTests::testBlend() {
+    FBXGeometry geometry;
+    geometry.meshes.push_back(makeMesh(2000, 20));
+    geometry.meshes.push_back(FBXMesh()); // without blendshapes
+    geometry.meshes.back().vertices.push_back(glm::vec3(1.0f));
+    geometry.meshes.push_back(makeMesh(500, 8));
+
+    CompactBlendedMeshes meshes(geometry);
+    QCOMPARE((int)meshes.getMeshes().size(), 2);
+    QCOMPARE(meshes.getNumVertices(), 2500);
+
+    std::vector<glm::vec3> vertices(meshes.getNumVertices());
+    std::vector<glm::vec3> normals(meshes.getNumVertices());
+    for (int frame = 0; frame < 4; frame++) {
+        QVector<float> coefficients = makeCoefficients(20, frame);
+        meshes.blend(coefficients, vertices.data(), normals.data());
+
+        for (const auto& mesh : meshes.getMeshes()) {
+            QVector<glm::vec3> expectedVertices, expectedNormals;
+            blendReference(geometry.meshes.at(mesh.meshIndex), coefficients, expectedVertices, expectedNormals);
+            for (int i = 0; i < expectedVertices.size(); i++) {
+                QCOMPARE_WITH_ABS_ERROR(vertices[mesh.firstVertex + i], expectedVertices.at(i), EPSILON);
+                QCOMPARE_WITH_ABS_ERROR(normals[mesh.firstVertex + i], expectedNormals.at(i), EPSILON);
+            }
+        }
+    }
+}
+
+void BlendshapeTests::benchmark() {
+    const int NUM_VERTICES = 20000;
+    const int NUM_BLENDSHAPES = 50;
+    const int NUM_FRAMES = 1000;
+
+    FBXGeometry geometry;
+    geometry.meshes.push_back(makeMesh(NUM_VERTICES, NUM_BLENDSHAPES));
+    const FBXMesh& mesh = geometry.meshes.front();
+    CompactBlendedMeshes meshes(geometry);
+
+    std::vector<QVector<float>> frames;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        frames.push_back(makeCoefficients(NUM_BLENDSHAPES, frame));
+    }
+
+    QVector<glm::vec3> referenceVertices, referenceNormals;
+    auto start = usecTimestampNow();
+    for (const auto& coefficients : frames) {
+        blendReference(mesh, coefficients, referenceVertices, referenceNormals);
+    }
+    auto referenceUsecs = usecTimestampNow() - start;
+
+    std::vector<glm::vec3> vertices(meshes.getNumVertices());
+    std::vector<glm::vec3> normals(meshes.getNumVertices());
+    start = usecTimestampNow();
+    for (const auto& coefficients : frames) {
+        meshes.blend(coefficients, vertices.data(), normals.data());
+    }
+    auto compactUsecs = usecTimestampNow() - start;
+
+    qDebug() << NUM_VERTICES << "vertices," << NUM_BLENDSHAPES << "blendshapes";
+    qDebug() << "reference blend usecs:" << (float)referenceUsecs / NUM_FRAMES;
+    qDebug() << "compact blend usecs:" << (float)compactUsecs / NUM_FRAMES;
+}
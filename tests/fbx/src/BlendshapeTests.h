@@ -0,0 +1,24 @@
+//
+//  BlendshapeTests.h
+//  tests/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BlendshapeTests_h
+#define hifi_BlendshapeTests_h
+
+#include <QtTest/QtTest>
+
+class BlendshapeTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testCompaction();
+    void testBlend();
+    void benchmark();
+};
+
+#endif // hifi_BlendshapeTests_h
@@ -0,0 +1,129 @@
+//
+//  TexturePipelineTests.cpp
+//  tests/model-networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TexturePipelineTests.h"
+
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <DependencyManager.h>
+#include <StatTracker.h>
+#include <model-networking/TexturePipeline.h>
+
+QTEST_MAIN(TexturePipelineTests)
+
+using TicketPointer = TexturePipeline::TicketPointer;
+
+static TicketPointer makeTicket(float priority) {
+    auto ticket = std::make_shared<TexturePipeline::Ticket>();
+    ticket->priority = priority;
+    return ticket;
+}
+
+static QVariantMap getStageStats(const TexturePipeline& pipeline, TexturePipeline::Stage stage) {
+    return pipeline.getStats()[TexturePipeline::getStageName(stage)].toMap();
+}
+
+void TexturePipelineTests::initTestCase() {
+    DependencyManager::set<StatTracker>();
+}
+
+void TexturePipelineTests::testPriorityOrder() {
+    TexturePipeline pipeline;
+    std::vector<int> order;
+
+    // Handoffs queued from the pipeline's thread wait for its event loop, so they are all queued before any runs
+    auto low = makeTicket(1.0f);
+    auto high = makeTicket(3.0f);
+    auto middle = makeTicket(2.0f);
+    pipeline.submit(TexturePipeline::HANDOFF, low, [&] { order.push_back(1); });
+    pipeline.submit(TexturePipeline::HANDOFF, high, [&] { order.push_back(3); });
+    pipeline.submit(TexturePipeline::HANDOFF, middle, [&] { order.push_back(2); });
+
+    // Priorities may change while queued
+    low->priority = 4.0f;
+
+    QTRY_COMPARE(order.size(), (size_t)3);
+    QCOMPARE(order, (std::vector<int> { 1, 3, 2 }));
+}
+
+void TexturePipelineTests::testCanceledTicketsDropped() {
+    TexturePipeline pipeline;
+    std::vector<int> ran;
+
+    auto canceled = makeTicket(2.0f);
+    auto kept = makeTicket(1.0f);
+    pipeline.submit(TexturePipeline::HANDOFF, canceled, [&] { ran.push_back(1); });
+    pipeline.submit(TexturePipeline::HANDOFF, kept, [&] { ran.push_back(2); });
+    pipeline.cancel(canceled);
+
+    QTRY_COMPARE(ran.size(), (size_t)1);
+    QCOMPARE(ran.front(), 2);
+    QCOMPARE(getStageStats(pipeline, TexturePipeline::HANDOFF)["canceled"].toInt(), 1);
+
+    // Work submitted for a canceled ticket is dropped straight away
+    pipeline.submit(TexturePipeline::HANDOFF, canceled, [&] { ran.push_back(1); });
+    QCOMPARE(getStageStats(pipeline, TexturePipeline::HANDOFF)["queueDepth"].toInt(), 0);
+    QCoreApplication::processEvents();
+    QCOMPARE(ran.size(), (size_t)1);
+}
+
+void TexturePipelineTests::testCapacityWait() {
+    TexturePipeline pipeline;
+    std::atomic<int> ran { 0 };
+
+    // Hold the only write worker, so nothing leaves the write queue
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    pipeline.submit(TexturePipeline::WRITE, makeTicket(0.0f), [&, released] {
+        started.set_value();
+        released.wait();
+        ++ran;
+    });
+    started.get_future().wait();
+
+    // Fill the queue past the stage's capacity from the pipeline's thread, which never waits for room
+    static const int NUM_QUEUED = 16;
+    for (int i = 0; i < NUM_QUEUED; ++i) {
+        pipeline.submit(TexturePipeline::WRITE, makeTicket(0.0f), [&] { ++ran; });
+    }
+    QCOMPARE(getStageStats(pipeline, TexturePipeline::WRITE)["queueDepth"].toInt(), NUM_QUEUED);
+
+    // Any other thread waits for room
+    auto waiting = makeTicket(0.0f);
+    std::atomic<bool> returned { false };
+    std::thread submitter([&] {
+        pipeline.submit(TexturePipeline::WRITE, waiting, [&] { ++ran; });
+        returned = true;
+    });
+    QThread::msleep(100);
+    QVERIFY(!returned);
+
+    // Canceling its ticket lets it go without queueing anything
+    pipeline.cancel(waiting);
+    QTRY_VERIFY(returned);
+    submitter.join();
+
+    // Once the worker is released there is room again
+    returned = false;
+    std::thread lateSubmitter([&] {
+        pipeline.submit(TexturePipeline::WRITE, makeTicket(0.0f), [&] { ++ran; });
+        returned = true;
+    });
+    release.set_value();
+    QTRY_VERIFY(returned);
+    lateSubmitter.join();
+
+    // The blocker, what filled the queue and the late submission
+    QTRY_COMPARE(ran.load(), NUM_QUEUED + 2);
+}
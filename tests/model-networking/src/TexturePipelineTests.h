@@ -0,0 +1,25 @@
+//
+//  TexturePipelineTests.h
+//  tests/model-networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TexturePipelineTests_h
+#define hifi_TexturePipelineTests_h
+
+#include <QtTest/QtTest>
+
+class TexturePipelineTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testPriorityOrder();
+    void testCanceledTicketsDropped();
+    void testCapacityWait();
+};
+
+#endif // hifi_TexturePipelineTests_h
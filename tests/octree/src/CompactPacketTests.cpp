@@ -0,0 +1,166 @@
+//
+//  CompactPacketTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CompactPacketTests.h"
+
+#include <OctreePacketData.h>
+#include <OctreeStringDictionary.h>
+
+QTEST_MAIN(CompactPacketTests)
+
+static const QString MODEL_URL = "https://example.com/models/chair.fbx";
+
+// Finalizes the sending packet data and loads it into a receiving one, as the client would
+static void transfer(OctreePacketData& sent, OctreePacketData& received) {
+    QByteArray section((const char*)sent.getFinalizedData(), sent.getFinalizedSize());
+    received.loadFinalizedContent((const unsigned char*)section.constData(), section.size());
+}
+
+// Reads the strings of the received packet data, with the client's dictionary
+static QStringList readStrings(OctreePacketData& received, OctreeStringDictionary* dictionary, int count,
+                               uint16_t connectionID = 0) {
+    OctreeStringDictionary::ReadingScope readingScope(dictionary, connectionID);
+    QStringList strings;
+    const unsigned char* dataAt = received.getUncompressedData();
+    for (int i = 0; i < count; i++) {
+        QString string;
+        dataAt += OctreePacketData::unpackDataFromBytes(dataAt, string);
+        strings << string;
+    }
+    return strings;
+}
+
+void CompactPacketTests::testSectionEncodings() {
+    OctreePacketData sent(true, MAX_OCTREE_PACKET_DATA_SIZE, true);
+    OctreePacketData received(true, MAX_OCTREE_PACKET_DATA_SIZE, true);
+
+    // a few bytes that zlib can't shrink are sent as they are
+    sent.appendValue((uint32_t)0x12345678);
+    QCOMPARE(sent.getFinalizedData()[0], SECTION_IS_RAW);
+    QCOMPARE(sent.getFinalizedSize(), (int)(sizeof(OCTREE_PACKET_SECTION_ENCODING) + sizeof(uint32_t)));
+    transfer(sent, received);
+    uint32_t value;
+    OctreePacketData::unpackDataFromBytes(received.getUncompressedData(), value);
+    QCOMPARE(value, (uint32_t)0x12345678);
+
+    // repetitive content is compressed
+    sent.reset();
+    for (int i = 0; i < 100; i++) {
+        sent.appendValue((uint32_t)i % 4);
+    }
+    QCOMPARE(sent.getFinalizedData()[0], SECTION_IS_ZLIB);
+    QVERIFY(sent.getFinalizedSize() < sent.getUncompressedSize());
+    transfer(sent, received);
+    QCOMPARE(received.getUncompressedSize(), 100 * (int)sizeof(uint32_t));
+    OctreePacketData::unpackDataFromBytes(received.getUncompressedData(10 * sizeof(uint32_t)), value);
+    QCOMPARE(value, (uint32_t)2);
+}
+
+void CompactPacketTests::testDictionaryStrings() {
+    auto serverDictionary = std::make_shared<OctreeStringDictionary>();
+    OctreeStringDictionary clientDictionary;
+
+    OctreePacketData sent(true, MAX_OCTREE_PACKET_DATA_SIZE, true);
+    OctreePacketData received(true, MAX_OCTREE_PACKET_DATA_SIZE, true);
+    sent.setStringDictionary(serverDictionary);
+
+    // the first time it is sent inline, the second time it is also defined, until the client says it has it
+    sent.appendValue(MODEL_URL);
+    sent.appendValue(MODEL_URL);
+    sent.appendValue(QString("short"));
+    int inlineBytes = sizeof(uint16_t) + MODEL_URL.size() + 1;
+    QCOMPARE(sent.getUncompressedSize(), inlineBytes + (int)sizeof(uint16_t) + inlineBytes + (int)sizeof(uint16_t) + 6);
+    QCOMPARE(serverDictionary->size(), 1);
+
+    transfer(sent, received);
+    QCOMPARE(readStrings(received, &clientDictionary, 3), QStringList({ MODEL_URL, MODEL_URL, "short" }));
+    QCOMPARE(clientDictionary.getContiguousCount(), 1);
+
+    // once acknowledged, it is sent by index alone
+    serverDictionary->acknowledge(clientDictionary.getContiguousCount());
+    sent.reset();
+    sent.appendValue(MODEL_URL);
+    QCOMPARE(sent.getUncompressedSize(), (int)sizeof(uint16_t));
+
+    transfer(sent, received);
+    QCOMPARE(readStrings(received, &clientDictionary, 1), QStringList({ MODEL_URL }));
+    QVERIFY(!clientDictionary.isOutOfSync());
+}
+
+void CompactPacketTests::testDiscardedDefinitions() {
+    auto serverDictionary = std::make_shared<OctreeStringDictionary>();
+    OctreePacketData sent(true, MAX_OCTREE_PACKET_DATA_SIZE, true);
+    sent.setStringDictionary(serverDictionary);
+
+    sent.appendValue(MODEL_URL);
+    sent.getFinalizedData();
+
+    // an entry added in a level that didn't fit is taken back with it
+    LevelDetails level = sent.startLevel();
+    sent.appendValue(MODEL_URL);
+    QCOMPARE(serverDictionary->size(), 1);
+    sent.discardLevel(level);
+    QCOMPARE(serverDictionary->size(), 0);
+
+    // and so is one in content that was reset without being sent
+    sent.appendValue(MODEL_URL);
+    QCOMPARE(serverDictionary->size(), 1);
+    sent.reset();
+    QCOMPARE(serverDictionary->size(), 0);
+}
+
+void CompactPacketTests::testMissingEntry() {
+    auto serverDictionary = std::make_shared<OctreeStringDictionary>();
+    OctreeStringDictionary clientDictionary;
+
+    OctreePacketData sent(true, MAX_OCTREE_PACKET_DATA_SIZE, true);
+    OctreePacketData received(true, MAX_OCTREE_PACKET_DATA_SIZE, true);
+    sent.setStringDictionary(serverDictionary);
+
+    // the packet defining the entry is lost, but the server is told the client has it
+    sent.appendValue(MODEL_URL);
+    sent.appendValue(MODEL_URL);
+    sent.getFinalizedData();
+    serverDictionary->acknowledge(1);
+
+    sent.reset();
+    sent.appendValue(MODEL_URL);
+    transfer(sent, received);
+    QCOMPARE(readStrings(received, &clientDictionary, 1), QStringList({ QString() }));
+    QVERIFY(clientDictionary.isOutOfSync());
+
+    clientDictionary.startConnection(1);
+    QVERIFY(!clientDictionary.isOutOfSync());
+}
+
+void CompactPacketTests::testStaleConnection() {
+    auto serverDictionary = std::make_shared<OctreeStringDictionary>();
+    OctreeStringDictionary clientDictionary;
+
+    OctreePacketData sent(true, MAX_OCTREE_PACKET_DATA_SIZE, true);
+    OctreePacketData received(true, MAX_OCTREE_PACKET_DATA_SIZE, true);
+    sent.setStringDictionary(serverDictionary);
+
+    // a definition written for the old connection arrives after the client has started a new one
+    sent.appendValue(MODEL_URL);
+    sent.appendValue(MODEL_URL);
+    transfer(sent, received);
+    clientDictionary.startConnection(1);
+    readStrings(received, &clientDictionary, 2, 0);
+    QCOMPARE(clientDictionary.getContiguousCount(), 0);
+
+    // and a reference to it doesn't mark the new dictionary out of sync
+    serverDictionary->acknowledge(1);
+    sent.reset();
+    sent.appendValue(MODEL_URL);
+    transfer(sent, received);
+    QCOMPARE(readStrings(received, &clientDictionary, 1, 0), QStringList({ QString() }));
+    QVERIFY(!clientDictionary.isOutOfSync());
+}
@@ -0,0 +1,26 @@
+//
+//  CompactPacketTests.h
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CompactPacketTests_h
+#define hifi_CompactPacketTests_h
+
+#include <QtTest/QtTest>
+
+class CompactPacketTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testSectionEncodings();
+    void testDictionaryStrings();
+    void testDiscardedDefinitions();
+    void testMissingEntry();
+    void testStaleConnection();
+};
+
+#endif // hifi_CompactPacketTests_h
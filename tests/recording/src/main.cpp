@@ -79,6 +79,53 @@ void testFilePersist() {
     QVERIFY(readClip->duration() == 5.0f);
 }
 
+void testChunkedFilePersist() {
+    QTemporaryFile file;
+    QString fileName;
+    if (file.open()) {
+        fileName = file.fileName();
+        file.close();
+    }
+
+    // enough frames for several chunks, with same sized frames that differ in a few bytes like avatar joints do
+    static const int NUM_FRAMES = 1000;
+    auto writeClip = Clip::newClip();
+    for (int i = 0; i < NUM_FRAMES; ++i) {
+        QByteArray data(200, 'a');
+        data[i % data.size()] = (char)i;
+        if (i % 100 == 0) {
+            data.append("resized");
+        }
+        writeClip->addFrame(std::make_shared<Frame>(TEST_FRAME_TYPE, (float)i * 0.01f, data));
+    }
+    QVERIFY(writeClip->frameCount() == NUM_FRAMES);
+
+    Clip::toFile(fileName, writeClip, Clip::Format::Chunked);
+    auto readClip = Clip::fromFile(fileName);
+    QVERIFY(readClip != Clip::Pointer());
+    QVERIFY(readClip->frameCount() == NUM_FRAMES);
+    QVERIFY(readClip->duration() == writeClip->duration());
+
+    readClip->seek(0);
+    writeClip->seek(0);
+    size_t count = 0;
+    for (auto readFrame = readClip->nextFrame(), writeFrame = writeClip->nextFrame(); readFrame && writeFrame;
+        readFrame = readClip->nextFrame(), writeFrame = writeClip->nextFrame(), ++count) {
+        QVERIFY(readFrame->type == writeFrame->type);
+        QVERIFY(readFrame->timeOffset == writeFrame->timeOffset);
+        QVERIFY(readFrame->data == writeFrame->data);
+    }
+    QVERIFY(readClip->frameCount() == count);
+
+    // seeking lands on the same frame in both formats, in the middle of a chunk or not
+    for (float position : { 0.0f, 2.555f, 5.12f, 9.99f }) {
+        readClip->seek(position);
+        writeClip->seek(position);
+        QVERIFY(readClip->positionFrameTime() == writeClip->positionFrameTime());
+        QVERIFY(readClip->peekFrame()->data == writeClip->peekFrame()->data);
+    }
+}
+
 void testClipOrdering() {
     auto writeClip = Clip::newClip();
     // simulate our of order addition of frames
@@ -110,5 +157,6 @@ int main(int, const char**) {
 #endif
     testFrameTypeRegistration();
     testFilePersist();
+    testChunkedFilePersist();
     testClipOrdering();
 }
\ No newline at end of file
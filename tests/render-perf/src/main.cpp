@@ -651,6 +651,10 @@ protected:
                 toggleCulling();
                 return;
 
+            case Qt::Key_F10:
+                toggleConcurrentRecording();
+                return;
+
             case Qt::Key_Home:
                 gpu::Texture::setAllowedGPUMemoryUsage(0);
                 return;
@@ -685,6 +689,7 @@ private:
     }
 
     uint16_t _fps;
+    int _instancedShapes { 0 };
     void draw() {
         if (!_ready) {
             return;
@@ -744,8 +749,9 @@ private:
         // Final framebuffer that will be handled to the display-plugin
         render(&renderArgs);
 
-        if (_fps != _renderThread._fps) {
+        if (_fps != _renderThread._fps || _instancedShapes != renderArgs._details._instancedShapes) {
             _fps = _renderThread._fps;
+            _instancedShapes = renderArgs._details._instancedShapes;
             updateText();
         }
     }
@@ -770,11 +776,14 @@ private:
     };
 
     void updateText() {
-        QString title = QString("FPS %1 Culling %2 TextureMemory GPU %3 CPU %4 Max GPU %5")
+        QString title = QString("FPS %1 Culling %2 TextureMemory GPU %3 CPU %4 Max GPU %5 Engine CPU %6ms Concurrent recording %7 Instanced %8")
             .arg(_fps).arg(_cullingEnabled)
             .arg(toHumanSize(gpu::Context::getTextureGPUMemSize(), 2))
             .arg(toHumanSize(gpu::Texture::getTextureCPUMemSize(), 2))
-            .arg(toHumanSize(gpu::Texture::getAllowedGPUMemoryUsage(), 2));
+            .arg(toHumanSize(gpu::Texture::getAllowedGPUMemoryUsage(), 2))
+            .arg(_renderEngine->getConfiguration()->getCPURunTime(), 0, 'f', 2)
+            .arg(_concurrentRecording)
+            .arg(_instancedShapes);
         setTitle(title);
 #if 0
         {
@@ -1077,6 +1086,16 @@ private:
         _cullingEnabled = !_cullingEnabled;
     }
 
+    void toggleConcurrentRecording() {
+        _concurrentRecording = !_concurrentRecording;
+        auto config = _renderEngine->getConfiguration()->getConfig<DrawStateSortDeferred>("DrawOpaqueDeferred");
+        if (config) {
+            config->concurrentRecording = _concurrentRecording;
+            emit config->dirty();
+        }
+        updateText();
+    }
+
     void cycleMode() {
         static auto defaultProjection = SimpleCamera().matrices.perspective;
         _renderMode = (RenderMode)((_renderMode + 1) % RENDER_MODE_COUNT);
@@ -1127,6 +1146,7 @@ private:
 
     //TextOverlay* _textOverlay;
     static bool _cullingEnabled;
+    bool _concurrentRecording { false };
 
     enum RenderMode {
         NORMAL = 0,
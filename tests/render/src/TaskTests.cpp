@@ -0,0 +1,217 @@
+//
+//  TaskTests.cpp
+//  tests/render/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TaskTests.h"
+
+#include <atomic>
+
+#include <task/JobGraph.h>
+#include <task/Task.h>
+
+QTEST_MAIN(TaskTests)
+
+namespace test {
+
+static const unsigned long JOB_MSECS = 10;
+
+// shared by the copies of the context the concurrent jobs get
+struct Stats {
+    std::atomic<int> inFlight { 0 };
+    std::atomic<int> maxInFlight { 0 };
+    std::atomic<int> numDone { 0 };
+};
+
+class TestContext : public task::JobContext {
+public:
+    std::shared_ptr<Stats> stats { std::make_shared<Stats>() };
+};
+using TestContextPointer = std::shared_ptr<TestContext>;
+
+Task_DeclareTypeAliases(TestContext)
+
+static void work(const TestContextPointer& context) {
+    auto& stats = *context->stats;
+    int inFlight = ++stats.inFlight;
+    int maxInFlight = stats.maxInFlight;
+    while (inFlight > maxInFlight && !stats.maxInFlight.compare_exchange_weak(maxInFlight, inFlight)) {}
+
+    QThread::msleep(JOB_MSECS);
+
+    --stats.inFlight;
+    ++stats.numDone;
+}
+
+class Produce {
+public:
+    using JobModel = Job::ModelO<Produce, int>;
+    static const bool IsConcurrent = true;
+
+    Produce(int value = 0) : _value(value) {}
+
+    void run(const TestContextPointer& context, int& output) {
+        work(context);
+        output = _value;
+    }
+
+    int _value;
+};
+
+class Sum {
+public:
+    using Inputs = VaryingSet2<int, int>;
+    using JobModel = Job::ModelIO<Sum, Inputs, int>;
+    static const bool IsConcurrent = true;
+
+    void run(const TestContextPointer& context, const Inputs& inputs, int& output) {
+        work(context);
+        output = inputs.get0() + inputs.get1();
+    }
+};
+
+// not concurrent, so it runs once every job before it is done and before any job after it
+class Barrier {
+public:
+    using JobModel = Job::ModelIO<Barrier, Sum::Inputs, int>;
+
+    void run(const TestContextPointer& context, const Sum::Inputs& inputs, int& output) {
+        output = context->stats->numDone;
+        QCOMPARE(context->stats->inFlight.load(), 0);
+    }
+};
+
+class TestTask {
+public:
+    using Output = VaryingSet4<int, int, int, int>;
+    using JobModel = Task::ModelO<TestTask, Output>;
+
+    void build(JobModel& task, const Varying& input, Varying& output) {
+        const auto a = task.addJob<Produce>("produceA", 1);
+        const auto b = task.addJob<Produce>("produceB", 2);
+        const auto c = task.addJob<Produce>("produceC", 3);
+        const auto d = task.addJob<Produce>("produceD", 4);
+
+        const auto sumAB = task.addJob<Sum>("sumAB", Sum::Inputs(a, b).asVarying());
+        const auto sumCD = task.addJob<Sum>("sumCD", Sum::Inputs(c, d).asVarying());
+
+        const auto numDoneBefore = task.addJob<Barrier>("barrier", Sum::Inputs(sumAB, sumCD).asVarying());
+
+        const auto total = task.addJob<Sum>("total", Sum::Inputs(sumAB, sumCD).asVarying());
+
+        output = Output(sumAB, sumCD, numDoneBefore, total);
+    }
+};
+
+static std::shared_ptr<Task> createTask(bool concurrent) {
+    auto task = std::make_shared<Task>("Test", TestTask::JobModel::create());
+    task->getConfiguration()->setConcurrent(concurrent);
+    return task;
+}
+
+static std::vector<int> getResults(const Task& task) {
+    const auto& output = task.getOutput().get<TestTask::Output>();
+    return { output.get0(), output.get1(), output.get2(), output.get3() };
+}
+
+}
+
+using namespace test;
+
+void TaskTests::testGraphDependencies() {
+    Varying a { 0 };
+    Varying b { 0 };
+    Varying c { 0 };
+    Varying d { 0 };
+    Varying e { 0 };
+
+    std::vector<task::JobGraph::JobIO> jobs {
+        { Varying(), a, true },
+        { Varying(), b, true },
+        { Sum::Inputs(a, b).asVarying(), c, true },
+        { c, d, false },
+        { c, e, true },
+        { a, e, true }
+    };
+
+    task::JobGraph graph;
+    graph.build(jobs);
+    QCOMPARE(graph.size(), jobs.size());
+
+    const auto& segments = graph.getSegments();
+    QCOMPARE(segments.size(), (size_t)3);
+    QCOMPARE(segments[0], task::JobGraph::Segment(0, 3));
+    QCOMPARE(segments[1], task::JobGraph::Segment(3, 4));
+    QCOMPARE(segments[2], task::JobGraph::Segment(4, 6));
+
+    // the sum reads both outputs before it
+    QCOMPARE(graph.getNumDependencies(0), 0);
+    QCOMPARE(graph.getNumDependencies(1), 0);
+    QCOMPARE(graph.getNumDependencies(2), 2);
+
+    // the last two write the same varying, so they stay in order, and nothing crosses the barrier
+    QCOMPARE(graph.getNumDependencies(4), 0);
+    QCOMPARE(graph.getNumDependencies(5), 1);
+    QCOMPARE(graph.getDependents(4), std::vector<size_t>({ 5 }));
+}
+
+void TaskTests::testConcurrentMatchesSequential() {
+    auto sequential = createTask(false);
+    auto sequentialContext = std::make_shared<TestContext>();
+    sequential->run(sequentialContext);
+
+    auto concurrent = createTask(true);
+    auto concurrentContext = std::make_shared<TestContext>();
+    concurrent->run(concurrentContext);
+
+    QCOMPARE(getResults(*concurrent), getResults(*sequential));
+    QCOMPARE(getResults(*concurrent), std::vector<int>({ 3, 7, 6, 10 }));
+    QCOMPARE(concurrentContext->stats->numDone.load(), sequentialContext->stats->numDone.load());
+    QCOMPARE(sequentialContext->stats->maxInFlight.load(), 1);
+
+    // running it again gives the same results from the same graph
+    concurrent->run(concurrentContext);
+    QCOMPARE(getResults(*concurrent), std::vector<int>({ 3, 7, 6, 10 }));
+}
+
+void TaskTests::testIndependentJobsOverlap() {
+    if (QThread::idealThreadCount() < 2) {
+        QSKIP("needs more than one core");
+    }
+
+    auto task = createTask(true);
+    auto context = std::make_shared<TestContext>();
+    task->run(context);
+
+    QVERIFY(context->stats->maxInFlight.load() > 1);
+}
+
+void TaskTests::testBarrierOrdering() {
+    auto task = createTask(true);
+    auto context = std::make_shared<TestContext>();
+    for (int i = 0; i < 10; ++i) {
+        context->stats->numDone = 0;
+        task->run(context);
+
+        // every one of the 4 produce and 2 sum jobs is done before the barrier
+        QCOMPARE(getResults(*task)[2], 6);
+        QCOMPARE(context->stats->numDone.load(), 7);
+    }
+}
+
+void TaskTests::testCPURunTime() {
+    auto task = createTask(true);
+    task->run(std::make_shared<TestContext>());
+
+    auto config = task->getConfiguration();
+    for (auto name : { "produceA", "produceB", "sumAB", "sumCD", "total" }) {
+        auto jobConfig = config->getConfig<task::TConfigProxy>(name);
+        QVERIFY(jobConfig);
+        QVERIFY(jobConfig->getCPURunTime() >= (double)(JOB_MSECS - 1));
+    }
+}
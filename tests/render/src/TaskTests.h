@@ -0,0 +1,26 @@
+//
+//  TaskTests.h
+//  tests/render/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TaskTests_h
+#define hifi_TaskTests_h
+
+#include <QtTest/QtTest>
+
+class TaskTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testGraphDependencies();
+    void testConcurrentMatchesSequential();
+    void testIndependentJobsOverlap();
+    void testBarrierOrdering();
+    void testCPURunTime();
+};
+
+#endif // hifi_TaskTests_h
@@ -156,6 +156,67 @@ void FileCacheTests::testWipe() {
     QCOMPARE(getCacheDirectorySize(), (size_t)0);
 }
 
+void FileCacheTests::testUnindexedFiles() {
+    // A file the index doesn't know of, as left by an older cache
+    std::string key = getFileKey(200);
+    {
+        QFile file(QDir(_testDir.path()).absoluteFilePath(QString::fromStdString(key) + ".tmp"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(TEST_DATA), (qint64)TEST_DATA.size());
+    }
+
+    // The directory is validated in the background, so the file shows up shortly after initialization
+    auto cache = makeFileCache(_testDir.path());
+    FilePointer file;
+    for (int i = 0; i < 500 && !file; ++i) {
+        file = cache->getFile(key);
+        if (!file) {
+            QThread::msleep(10);
+        }
+    }
+    QVERIFY(file.get());
+    QCOMPARE(file->getLength(), (size_t)TEST_DATA.size());
+    QCOMPARE(cache->getNumTotalFiles(), (size_t)1);
+    file.reset();
+
+    // Once indexed, it is there as soon as the cache is
+    cache = makeFileCache(_testDir.path());
+    QVERIFY(cache->getFile(key).get());
+    cache->wipe();
+    QCOMPARE(getCacheDirectorySize(), (size_t)0);
+}
+
+void FileCacheTests::testIndexCompaction() {
+    static const QByteArray SMALL_DATA { 16, '1' };
+    static const int NUM_USES = 5000;
+    std::string usedKey = getFileKey(201);
+    std::string unusedKey = getFileKey(202);
+
+    auto cache = makeFileCache(_testDir.path());
+    auto usedFile = cache->writeFile(SMALL_DATA.data(), FileCache::Metadata(usedKey, SMALL_DATA.size()));
+    QVERIFY(usedFile.get());
+    QVERIFY(cache->writeFile(SMALL_DATA.data(), FileCache::Metadata(unusedKey, SMALL_DATA.size())).get());
+
+    // Every use is journalled, but the journal is rewritten long before it holds a record for each of them
+    for (int i = 0; i < NUM_USES; ++i) {
+        QVERIFY(cache->getFile(unusedKey).get());
+    }
+    cache.reset();
+    usedFile.reset();
+
+    QFileInfo indexInfo(QDir(_testDir.path()).absoluteFilePath(FileCache::INDEX_FILENAME));
+    QVERIFY(indexInfo.exists());
+    // each use record holds at least the key and the access time
+    QVERIFY(indexInfo.size() < NUM_USES * (qint64)(unusedKey.size() + sizeof(qint64)));
+
+    // The rewritten journal still knows of the file that was in use while it was rewritten
+    cache = makeFileCache(_testDir.path());
+    QCOMPARE(cache->getNumTotalFiles(), (size_t)2);
+    QVERIFY(cache->getFile(usedKey).get());
+    QVERIFY(cache->getFile(unusedKey).get());
+    cache->wipe();
+    QCOMPARE(getCacheDirectorySize(), (size_t)0);
+}
 
 void FileCacheTests::cleanupTestCase() {
 }
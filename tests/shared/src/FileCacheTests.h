@@ -21,6 +21,8 @@ private slots:
     void testFreeSpacePreservation();
     void cleanupTestCase();
     void testWipe();
+    void testUnindexedFiles();
+    void testIndexCompaction();
 
 private:
     size_t getFreeSpace() const;
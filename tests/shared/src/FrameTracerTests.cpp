@@ -0,0 +1,122 @@
+//
+//  FrameTracerTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FrameTracerTests.h"
+
+#include <limits>
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+
+#include <shared/FrameTracer.h>
+
+QTEST_MAIN(FrameTracerTests)
+
+static QJsonArray traceEventsNamed(const QString& name) {
+    auto document = QJsonDocument::fromJson(FrameTracer::getInstance().toChromeTraceJSON());
+    QJsonArray matching;
+    for (auto value : document.object()["traceEvents"].toArray()) {
+        auto event = value.toObject();
+        if (event["ph"].toString() == "X" && event["name"].toString() == name) {
+            matching.append(event);
+        }
+    }
+    return matching;
+}
+
+void FrameTracerTests::testHistogramBuckets() {
+    int lastBucket = -1;
+    for (uint64_t value = 0; value < 100000; value++) {
+        int bucket = LatencyHistogram::bucketForValue(value);
+        QVERIFY(bucket >= lastBucket);
+        QVERIFY(bucket < LatencyHistogram::NUM_BUCKETS);
+
+        // a bucket never reports more than 1/16th above the values it holds
+        uint64_t highest = LatencyHistogram::highestValueInBucket(bucket);
+        QVERIFY(highest >= value);
+        QVERIFY(highest <= value + value / 16);
+        lastBucket = bucket;
+    }
+
+    QCOMPARE(LatencyHistogram::bucketForValue(std::numeric_limits<uint64_t>::max()), LatencyHistogram::NUM_BUCKETS - 1);
+}
+
+void FrameTracerTests::testHistogramPercentiles() {
+    LatencyHistogram histogram;
+    QCOMPARE(histogram.getValueAtPercentile(99.0f), (uint64_t)0);
+
+    for (uint64_t value = 1; value <= 1000; value++) {
+        histogram.record(value);
+    }
+    QCOMPARE(histogram.getCount(), (uint64_t)1000);
+
+    uint64_t median = histogram.getValueAtPercentile(50.0f);
+    QVERIFY(median >= 500 && median <= 500 + 500 / 16);
+    uint64_t p99 = histogram.getValueAtPercentile(99.0f);
+    QVERIFY(p99 >= 990 && p99 <= 990 + 990 / 16);
+    QVERIFY(histogram.getMax() >= 1000 && histogram.getMax() <= 1000 + 1000 / 16);
+
+    // only the values recorded after a snapshot remain once it is subtracted
+    LatencyHistogram snapshot = histogram;
+    histogram.record(20000);
+    histogram.subtract(snapshot);
+    QCOMPARE(histogram.getCount(), (uint64_t)1);
+    QVERIFY(histogram.getValueAtPercentile(1.0f) >= 20000);
+}
+
+void FrameTracerTests::testChromeTrace() {
+    auto& tracer = FrameTracer::getInstance();
+    auto outerPhase = tracer.registerPhase("outer");
+    auto innerPhase = tracer.registerPhase("inner");
+    QCOMPARE(tracer.registerPhase("outer"), outerPhase);
+
+    QUuid node = QUuid::createUuid();
+    {
+        FrameTracer::Scope outer(outerPhase);
+        FrameTracer::Scope inner(innerPhase, 3, node);
+        QThread::usleep(100);
+    }
+
+    auto outerEvents = traceEventsNamed("outer");
+    auto innerEvents = traceEventsNamed("inner");
+    QCOMPARE(outerEvents.size(), 1);
+    QCOMPARE(innerEvents.size(), 1);
+
+    auto outer = outerEvents[0].toObject();
+    auto inner = innerEvents[0].toObject();
+    QCOMPARE(inner["tid"].toInt(), outer["tid"].toInt());
+    QVERIFY(inner["ts"].toDouble() >= outer["ts"].toDouble());
+    QVERIFY(inner["ts"].toDouble() + inner["dur"].toDouble() <= outer["ts"].toDouble() + outer["dur"].toDouble());
+    QVERIFY(inner["dur"].toDouble() >= 100.0);
+    QCOMPARE(inner["args"].toObject()["slave"].toInt(), 3);
+    QCOMPARE(inner["args"].toObject()["node"].toString(), node.toString());
+
+    auto stats = tracer.takePhaseStats();
+    QCOMPARE(stats["inner"].toObject()["count"].toInt(), 1);
+    QVERIFY(stats["inner"].toObject()["p99_us"].toInt() >= 100);
+
+    // the next window starts empty
+    QVERIFY(!tracer.takePhaseStats().contains("inner"));
+}
+
+void FrameTracerTests::testRingWrap() {
+    auto& tracer = FrameTracer::getInstance();
+    auto wrapPhase = tracer.registerPhase("wrap");
+
+    const int NUM_SCOPES = FrameTracer::RING_SIZE;
+    for (int i = 0; i < NUM_SCOPES; i++) {
+        FrameTracer::Scope scope(wrapPhase);
+    }
+
+    // the ring keeps the newest events, two per scope, less the oldest slot the writer could be reusing, and every
+    // histogram sample survives
+    QCOMPARE(traceEventsNamed("wrap").size(), FrameTracer::RING_SIZE / 2 - 1);
+    QCOMPARE(tracer.takePhaseStats()["wrap"].toObject()["count"].toInt(), NUM_SCOPES);
+}
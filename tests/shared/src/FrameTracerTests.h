@@ -0,0 +1,25 @@
+//
+//  FrameTracerTests.h
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FrameTracerTests_h
+#define hifi_FrameTracerTests_h
+
+#include <QtTest/QtTest>
+
+class FrameTracerTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testHistogramBuckets();
+    void testHistogramPercentiles();
+    void testChromeTrace();
+    void testRingWrap();
+};
+
+#endif // hifi_FrameTracerTests_h
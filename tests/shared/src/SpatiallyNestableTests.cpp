@@ -0,0 +1,173 @@
+//
+//  SpatiallyNestableTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SpatiallyNestableTests.h"
+
+#include <DependencyManager.h>
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <SpatialParentFinder.h>
+#include <SpatiallyNestable.h>
+
+#include <../GLMTestUtils.h>
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(SpatiallyNestableTests)
+
+static const float EPSILON = 0.0001f;
+
+class TestNestable : public SpatiallyNestable {
+public:
+    TestNestable() : SpatiallyNestable(NestableType::Entity, QUuid::createUuid()) {}
+};
+using TestNestablePointer = std::shared_ptr<TestNestable>;
+
+// finds parents among the nestables the test has created
+class TestParentFinder : public SpatialParentFinder {
+public:
+    SpatiallyNestableWeakPointer find(QUuid parentID, bool& success, SpatialParentTree* entityTree = nullptr) const override {
+        SpatiallyNestableWeakPointer parent = _nestables.value(parentID);
+        success = parentID.isNull() || !parent.expired();
+        return parent;
+    }
+
+    void add(const SpatiallyNestablePointer& nestable) { _nestables[nestable->getID()] = nestable; }
+    void clear() { _nestables.clear(); }
+
+private:
+    QHash<QUuid, SpatiallyNestableWeakPointer> _nestables;
+};
+
+static TestNestablePointer makeNestable(const SpatiallyNestablePointer& parent = nullptr) {
+    auto nestable = std::make_shared<TestNestable>();
+    DependencyManager::get<TestParentFinder>()->add(nestable);
+    if (parent) {
+        nestable->setParentID(parent->getID());
+    }
+    return nestable;
+}
+
+// a parent at depth 0 with each link offset and turned a little from the last
+static std::vector<TestNestablePointer> makeChain(int depth) {
+    std::vector<TestNestablePointer> chain;
+    for (int i = 0; i < depth; i++) {
+        chain.push_back(makeNestable(chain.empty() ? nullptr : chain.back()));
+        chain.back()->setLocalPosition(glm::vec3(1.0f, 0.0f, 0.0f));
+        chain.back()->setLocalOrientation(glm::angleAxis(0.1f, Vectors::UNIT_Y));
+    }
+    return chain;
+}
+
+void SpatiallyNestableTests::initTestCase() {
+    DependencyManager::registerInheritance<SpatialParentFinder, TestParentFinder>();
+    DependencyManager::set<TestParentFinder>();
+}
+
+void SpatiallyNestableTests::testCachedChildFollowsParent() {
+    auto chain = makeChain(3);
+    auto& root = chain[0];
+    auto& leaf = chain[2];
+
+    // read once to fill the caches, then move the root and read again
+    glm::vec3 before = leaf->getWorldPosition();
+    glm::vec3 offset(10.0f, 0.0f, 0.0f);
+    root->setWorldPosition(root->getWorldPosition() + offset);
+    glm::vec3 after = leaf->getWorldPosition();
+    QCOMPARE_WITH_ABS_ERROR(after, before + offset, EPSILON);
+
+    root->setWorldOrientation(glm::angleAxis(PI, Vectors::UNIT_Y));
+    glm::vec3 cached = leaf->getWorldPosition();
+    glm::quat cachedOrientation = leaf->getWorldOrientation();
+
+    SpatiallyNestable::setWorldTransformCacheEnabled(false);
+    glm::vec3 uncached = leaf->getWorldPosition();
+    glm::quat uncachedOrientation = leaf->getWorldOrientation();
+    SpatiallyNestable::setWorldTransformCacheEnabled(true);
+
+    QCOMPARE_WITH_ABS_ERROR(cached, uncached, EPSILON);
+    QCOMPARE_WITH_ABS_ERROR(cachedOrientation, uncachedOrientation, EPSILON);
+
+    DependencyManager::get<TestParentFinder>()->clear();
+}
+
+void SpatiallyNestableTests::testCachedReparent() {
+    auto first = makeNestable();
+    auto second = makeNestable();
+    first->setWorldPosition(glm::vec3(1.0f, 0.0f, 0.0f));
+    second->setWorldPosition(glm::vec3(0.0f, 5.0f, 0.0f));
+
+    auto child = makeNestable(first);
+    child->setLocalPosition(glm::vec3(0.0f, 0.0f, 1.0f));
+    QCOMPARE_WITH_ABS_ERROR(child->getWorldPosition(), glm::vec3(1.0f, 0.0f, 1.0f), EPSILON);
+
+    child->setParentID(second->getID());
+    QCOMPARE_WITH_ABS_ERROR(child->getWorldPosition(), glm::vec3(0.0f, 5.0f, 1.0f), EPSILON);
+
+    // the old parent moving should no longer matter, the new one should
+    first->setWorldPosition(glm::vec3(-3.0f, 0.0f, 0.0f));
+    QCOMPARE_WITH_ABS_ERROR(child->getWorldPosition(), glm::vec3(0.0f, 5.0f, 1.0f), EPSILON);
+    second->setWorldPosition(glm::vec3(0.0f, 6.0f, 0.0f));
+    QCOMPARE_WITH_ABS_ERROR(child->getWorldPosition(), glm::vec3(0.0f, 6.0f, 1.0f), EPSILON);
+
+    child->setParentID(QUuid());
+    QCOMPARE_WITH_ABS_ERROR(child->getWorldPosition(), glm::vec3(0.0f, 0.0f, 1.0f), EPSILON);
+
+    DependencyManager::get<TestParentFinder>()->clear();
+}
+
+// reads per second of every nestable's world position, with the cache off and then on
+static void benchmarkReads(const std::vector<TestNestablePointer>& nestables, int numFrames, const char* label) {
+    auto& root = nestables[0];
+    glm::vec3 sum;
+    auto runReads = [&](bool moveRoot) -> float {
+        auto start = usecTimestampNow();
+        for (int frame = 0; frame < numFrames; frame++) {
+            if (moveRoot) {
+                // a moving root invalidates everything below it every frame
+                root->setWorldPosition(glm::vec3((float)frame, 0.0f, 0.0f));
+            }
+            for (const auto& nestable : nestables) {
+                sum += nestable->getWorldPosition();
+            }
+        }
+        auto elapsed = usecTimestampNow() - start;
+        return (float)(numFrames * nestables.size()) * USECS_PER_SECOND / (float)std::max<quint64>(elapsed, 1);
+    };
+
+    SpatiallyNestable::setWorldTransformCacheEnabled(false);
+    qDebug() << label << "uncached reads/sec:" << runReads(false);
+    qDebug() << label << "uncached reads/sec with moving root:" << runReads(true);
+    SpatiallyNestable::setWorldTransformCacheEnabled(true);
+    qDebug() << label << "cached reads/sec:" << runReads(false);
+    qDebug() << label << "cached reads/sec with moving root:" << runReads(true);
+    QVERIFY(!isNaN(sum));
+}
+
+void SpatiallyNestableTests::benchmarkDeepChain() {
+    const int CHAIN_DEPTH = 30;
+    const int NUM_FRAMES = 1000;
+    auto chain = makeChain(CHAIN_DEPTH);
+    benchmarkReads(chain, NUM_FRAMES, "deep chain:");
+    DependencyManager::get<TestParentFinder>()->clear();
+}
+
+void SpatiallyNestableTests::benchmarkWideFanOut() {
+    const int NUM_CHILDREN = 10000;
+    const int NUM_FRAMES = 100;
+    std::vector<TestNestablePointer> nestables;
+    nestables.push_back(makeNestable());
+    for (int i = 0; i < NUM_CHILDREN; i++) {
+        nestables.push_back(makeNestable(nestables[0]));
+        nestables.back()->setLocalPosition(randVector());
+    }
+    benchmarkReads(nestables, NUM_FRAMES, "wide fan-out:");
+    DependencyManager::get<TestParentFinder>()->clear();
+}
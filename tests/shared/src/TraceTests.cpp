@@ -8,8 +8,15 @@
 
 #include "TraceTests.h"
 
+#include <cstring>
+#include <thread>
+#include <vector>
+
 #include <QtTest/QtTest>
 #include <QtGui/QDesktopServices>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 
 #include <Profile.h>
 
@@ -45,3 +52,174 @@ void TraceTests::testTraceSerialization() {
     qDebug() << "Done";
 }
 
+
+void TraceTests::testBinaryTraceConversion() {
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->startTracing();
+    {
+        PROFILE_RANGE(test, "Outer")
+        PROFILE_COUNTER(test, "TestCounter", { { "a", 1 }, { "b", 2.5 } })
+        PROFILE_INSTANT(test, "TestInstant")
+        {
+            QString dynamicName = QString("Dynamic%1").arg(7);
+            PROFILE_RANGE(test, dynamicName)
+        }
+    }
+    std::thread otherThread([] {
+        PROFILE_RANGE(test, "OtherThread")
+    });
+    otherThread.join();
+    tracer->stopTracing();
+
+    const QString path = QDir::temp().filePath("testBinaryTrace.json");
+    tracer->serialize(path);
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonParseError error;
+    auto document = QJsonDocument::fromJson(file.readAll(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QVERIFY(document.isArray());
+
+    QSet<QString> names;
+    int begins = 0;
+    int ends = 0;
+    QSet<qint64> threads;
+    QJsonObject counterArgs;
+    for (const auto& value : document.array()) {
+        auto event = value.toObject();
+        auto type = event["ph"].toString();
+        if (type == "M") {
+            continue;
+        }
+        QCOMPARE(event["cat"].toString(), QString("trace.test"));
+        names.insert(event["name"].toString());
+        threads.insert((qint64)event["tid"].toDouble());
+        if (type == "B") {
+            ++begins;
+        } else if (type == "E") {
+            ++ends;
+        } else if (type == "C") {
+            counterArgs = event["args"].toObject();
+        } else if (type == "i") {
+            QCOMPARE(event["s"].toString(), QString("t"));
+        }
+    }
+
+    QVERIFY(names.contains("Outer"));
+    QVERIFY(names.contains("Dynamic7"));
+    QVERIFY(names.contains("OtherThread"));
+    QVERIFY(names.contains("TestInstant"));
+    QCOMPARE(begins, 3);
+    QCOMPARE(ends, 3);
+    QCOMPARE(threads.size(), 2);
+    QCOMPARE(counterArgs["a"].toInt(), 1);
+    QCOMPARE(counterArgs["b"].toDouble(), 2.5);
+    QCOMPARE(tracer->getDroppedEventCount(), (uint64_t)0);
+}
+
+void TraceTests::testIncompleteArgsDropped() {
+    using namespace tracing;
+
+    // A counter whose second argument was lost to a full buffer, followed by an instant and a complete counter
+    auto makeEvent = [](EventType type, NameID name, uint64_t timestamp, NameID argName, uint8_t flags) {
+        BinaryEvent event;
+        memset(&event, 0, sizeof(event));
+        event.type = type;
+        event.name = name;
+        event.timestamp = timestamp;
+        event.argName = argName;
+        event.argType = argName ? ArgType::Int : ArgType::None;
+        event.argValue = 1;
+        event.flags = flags;
+        return event;
+    };
+    const NameID LOST = hashName("Lost");
+    const NameID INSTANT = hashName("Instant");
+    const NameID COMPLETE = hashName("Complete");
+    const NameID A = hashName("a");
+    const NameID B = hashName("b");
+    std::vector<BinaryEvent> events {
+        makeEvent(EventType::Counter, LOST, 100, A, BinaryEvent::MoreArgs),
+        makeEvent(EventType::Instant, INSTANT, 200, 0, 0),
+        makeEvent(EventType::Counter, COMPLETE, 300, A, BinaryEvent::MoreArgs),
+        makeEvent(EventType::Counter, COMPLETE, 300, B, 0)
+    };
+
+    // Written in the layout Tracer::serialize uses: a file header, then blocks of one thread's events
+    const char MAGIC[8] = { 'H', 'F', 'T', 'R', 'A', 'C', 'E', '\0' };
+    const uint32_t VERSION = 1;
+    const uint32_t EVENTS_BLOCK = 1;
+    const qint64 THREAD_ID = 1;
+    QByteArray bytes;
+    bytes.append(MAGIC, sizeof(MAGIC));
+    uint32_t versionAndSize[2] = { VERSION, (uint32_t)sizeof(BinaryEvent) };
+    bytes.append(reinterpret_cast<const char*>(versionAndSize), sizeof(versionAndSize));
+    int64_t processID = 1;
+    bytes.append(reinterpret_cast<const char*>(&processID), sizeof(processID));
+    uint32_t blockType[2] = { EVENTS_BLOCK, 0 };
+    uint64_t blockSize = sizeof(THREAD_ID) + events.size() * sizeof(BinaryEvent);
+    bytes.append(reinterpret_cast<const char*>(blockType), sizeof(blockType));
+    bytes.append(reinterpret_cast<const char*>(&blockSize), sizeof(blockSize));
+    bytes.append(reinterpret_cast<const char*>(&THREAD_ID), sizeof(THREAD_ID));
+    bytes.append(reinterpret_cast<const char*>(events.data()), (int)(events.size() * sizeof(BinaryEvent)));
+
+    const QString path = QDir::temp().filePath("testIncompleteArgs.hftrace");
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(bytes), (qint64)bytes.size());
+    }
+
+    QByteArray json;
+    QVERIFY(Tracer::convertToChromeTrace(path, json));
+    QJsonParseError error;
+    auto document = QJsonDocument::fromJson(json, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    // The incomplete counter is dropped rather than merged with the instant after it
+    auto array = document.array();
+    QCOMPARE(array.size(), 2);
+    auto instant = array[0].toObject();
+    QCOMPARE(instant["ph"].toString(), QString("i"));
+    QCOMPARE(instant["ts"].toInt(), 200);
+    QVERIFY(!instant.contains("args"));
+    auto complete = array[1].toObject();
+    QCOMPARE(complete["ph"].toString(), QString("C"));
+    QCOMPARE(complete["args"].toObject().size(), 2);
+}
+
+void TraceTests::testTraceBenchmark() {
+    // fits in the chunk pool, so no events are dropped however slowly the writer runs
+    const int NUM_RANGES = 100000;
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+
+    auto start = usecTimestampNow();
+    for (int i = 0; i < NUM_RANGES; ++i) {
+        PROFILE_RANGE(test, "BenchmarkRange")
+    }
+    auto disabledDuration = usecTimestampNow() - start;
+
+    tracer->startTracing();
+    start = usecTimestampNow();
+    for (int i = 0; i < NUM_RANGES; ++i) {
+        PROFILE_RANGE(test, "BenchmarkRange")
+    }
+    auto enabledDuration = usecTimestampNow() - start;
+    tracer->stopTracing();
+
+    const float numEvents = 2.0f * NUM_RANGES;
+    qDebug() << "Tracing disabled:" << (float)(disabledDuration * NSECS_PER_USEC) / numEvents << "ns per event";
+    qDebug() << "Tracing enabled:" << (float)(enabledDuration * NSECS_PER_USEC) / numEvents << "ns per event";
+    QCOMPARE(tracer->getDroppedEventCount(), (uint64_t)0);
+
+    {
+        const QString path = QDir::temp().filePath("testTraceBenchmark.hftrace");
+        tracer->serialize(path);
+        QByteArray json;
+        start = usecTimestampNow();
+        QVERIFY(tracing::Tracer::convertToChromeTrace(path, json));
+        auto duration = usecTimestampNow() - start;
+        duration /= USECS_PER_MSEC;
+        qDebug() << "Conversion took " << duration << "ms";
+    }
+}
@@ -15,6 +15,9 @@ class TraceTests : public QObject {
     Q_OBJECT
 private slots:
     void testTraceSerialization();
+    void testBinaryTraceConversion();
+    void testIncompleteArgsDropped();
+    void testTraceBenchmark();
 };
 
 #endif // hifi_TraceTests_h
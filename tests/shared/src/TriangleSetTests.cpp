@@ -0,0 +1,151 @@
+//
+//  TriangleSetTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TriangleSetTests.h"
+
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <TriangleSet.h>
+
+#include <../GLMTestUtils.h>
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(TriangleSetTests)
+
+static const float SPHERE_RADIUS = 2.0f;
+static const int SPHERE_SEGMENTS = 256; // 2 * 256 * 256 = 131072 triangles
+
+// a tessellated sphere with outward facing triangles, centered on the origin
+static void buildSphere(TriangleSet& triangleSet, int segments) {
+    triangleSet.clear();
+    triangleSet.reserve(2 * segments * segments);
+    auto pointOnSphere = [&](int latitude, int longitude) {
+        float theta = PI * (float)latitude / (float)segments;
+        float phi = TWO_PI * (float)longitude / (float)segments;
+        return SPHERE_RADIUS * glm::vec3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi));
+    };
+    auto insertOutward = [&](const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+        Triangle triangle { a, b, c };
+        if (glm::dot(glm::cross(b - a, c - a), a + b + c) < 0.0f) {
+            std::swap(triangle.v1, triangle.v2);
+        }
+        triangleSet.insert(triangle);
+    };
+    for (int latitude = 0; latitude < segments; latitude++) {
+        for (int longitude = 0; longitude < segments; longitude++) {
+            glm::vec3 p00 = pointOnSphere(latitude, longitude);
+            glm::vec3 p01 = pointOnSphere(latitude, longitude + 1);
+            glm::vec3 p10 = pointOnSphere(latitude + 1, longitude);
+            glm::vec3 p11 = pointOnSphere(latitude + 1, longitude + 1);
+            insertOutward(p00, p10, p11);
+            insertOutward(p00, p11, p01);
+        }
+    }
+}
+
+static void randomRay(glm::vec3& origin, glm::vec3& direction) {
+    // start outside the sphere and aim somewhere near its center
+    origin = glm::normalize(randVector()) * (SPHERE_RADIUS * 3.0f);
+    glm::vec3 target = randVector() * (SPHERE_RADIUS * 0.5f);
+    direction = glm::normalize(target - origin);
+}
+
+void TriangleSetTests::testBVHMatchesOctree() {
+    TriangleSet octreeSet;
+    buildSphere(octreeSet, 64);
+    TriangleSet bvhSet;
+    buildSphere(bvhSet, 64);
+    bvhSet.buildBVH();
+    QVERIFY(bvhSet.isBVHReady());
+
+    const int NUM_RAYS = 1000;
+    for (bool allowBackface : { false, true }) {
+        for (int i = 0; i < NUM_RAYS; i++) {
+            glm::vec3 origin, direction;
+            randomRay(origin, direction);
+
+            float octreeDistance, bvhDistance;
+            BoxFace octreeFace, bvhFace;
+            glm::vec3 octreeNormal, bvhNormal;
+            TriangleSet::setBVHEnabled(false);
+            bool octreeHit = octreeSet.findRayIntersection(origin, direction, octreeDistance, octreeFace, octreeNormal,
+                true, allowBackface);
+            TriangleSet::setBVHEnabled(true);
+            bool bvhHit = bvhSet.findRayIntersection(origin, direction, bvhDistance, bvhFace, bvhNormal, true, allowBackface);
+
+            QCOMPARE(bvhHit, octreeHit);
+            if (octreeHit) {
+                QCOMPARE_WITH_ABS_ERROR(bvhDistance, octreeDistance, 0.001f);
+                QCOMPARE_WITH_ABS_ERROR(bvhNormal, octreeNormal, 0.001f);
+            }
+        }
+    }
+    TriangleSet::setBVHEnabled(true);
+}
+
+void TriangleSetTests::testBVHMisses() {
+    TriangleSet triangleSet;
+    buildSphere(triangleSet, 32);
+    triangleSet.buildBVH();
+
+    float distance;
+    BoxFace face;
+    glm::vec3 normal;
+
+    // pointing away from the sphere
+    QVERIFY(!triangleSet.findRayIntersection(glm::vec3(0.0f, 0.0f, 10.0f), Vectors::UNIT_Z, distance, face, normal, true));
+
+    // from the inside, only back faces are ahead, and allowing back faces only lets the origin be behind a front face
+    QVERIFY(!triangleSet.findRayIntersection(Vectors::ZERO, Vectors::UNIT_Z, distance, face, normal, true));
+    QVERIFY(!triangleSet.findRayIntersection(Vectors::ZERO, Vectors::UNIT_Z, distance, face, normal, true, true));
+}
+
+void TriangleSetTests::benchmarkPrecisionPicks() {
+    TriangleSet triangleSet;
+    buildSphere(triangleSet, SPHERE_SEGMENTS);
+
+    const int NUM_RAYS = 20000;
+    std::vector<glm::vec3> origins(NUM_RAYS);
+    std::vector<glm::vec3> directions(NUM_RAYS);
+    for (int i = 0; i < NUM_RAYS; i++) {
+        randomRay(origins[i], directions[i]);
+    }
+
+    int hits = 0;
+    auto runPicks = [&]() -> float {
+        float distance;
+        BoxFace face;
+        glm::vec3 normal;
+        hits = 0;
+        auto start = usecTimestampNow();
+        for (int i = 0; i < NUM_RAYS; i++) {
+            if (triangleSet.findRayIntersection(origins[i], directions[i], distance, face, normal, true)) {
+                hits++;
+            }
+        }
+        auto elapsed = usecTimestampNow() - start;
+        return (float)NUM_RAYS * USECS_PER_SECOND / (float)std::max<quint64>(elapsed, 1);
+    };
+
+    TriangleSet::setBVHEnabled(false);
+    auto start = usecTimestampNow();
+    triangleSet.balanceOctree();
+    qDebug() << "octree build:" << (usecTimestampNow() - start) / USECS_PER_MSEC << "msecs for" << triangleSet.size() << "triangles";
+    qDebug() << "octree picks/sec:" << runPicks();
+    QCOMPARE(hits, NUM_RAYS);
+
+    TriangleSet::setBVHEnabled(true);
+    start = usecTimestampNow();
+    triangleSet.buildBVH();
+    qDebug() << "bvh build:" << (usecTimestampNow() - start) / USECS_PER_MSEC << "msecs for" << triangleSet.size() << "triangles";
+    qDebug() << "bvh picks/sec:" << runPicks();
+    QCOMPARE(hits, NUM_RAYS);
+}
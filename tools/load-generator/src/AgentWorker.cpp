@@ -0,0 +1,52 @@
+//
+//  AgentWorker.cpp
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AgentWorker.h"
+
+#include <AudioConstants.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+AgentWorker::AgentWorker(const AgentConfig& config, LoadStats& stats) :
+    _config(config),
+    _stats(stats),
+    _updateTimer(new QTimer(this))
+{
+    // the timer is a child, so it moves to the worker's thread along with us
+    _updateTimer->setTimerType(Qt::PreciseTimer);
+    _updateTimer->setInterval((int)(AudioConstants::NETWORK_FRAME_USECS / USECS_PER_MSEC));
+    connect(_updateTimer, &QTimer::timeout, this, &AgentWorker::update);
+}
+
+void AgentWorker::start() {
+    _updateTimer->start();
+}
+
+void AgentWorker::addAgent(int index) {
+    _agents.emplace_back(new SimulatedAgent(index, _config, _stats));
+    _stats.agentsStarted++;
+}
+
+void AgentWorker::stop() {
+    _updateTimer->stop();
+    for (auto& agent : _agents) {
+        agent->disconnect();
+    }
+    _stats.agentsStarted -= (int)_agents.size();
+    _agents.clear();
+}
+
+void AgentWorker::update() {
+    quint64 start = usecTimestampNow();
+    for (auto& agent : _agents) {
+        agent->update(start);
+    }
+    _stats.workerUpdate.add(usecTimestampNow() - start);
+}
@@ -0,0 +1,46 @@
+//
+//  AgentWorker.h
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AgentWorker_h
+#define hifi_AgentWorker_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include "SimulatedAgent.h"
+
+// Owns the simulated agents on one thread and updates all of them once per audio frame. Each agent's socket lives on
+// this thread too, so its packets are handled here without any locking.
+class AgentWorker : public QObject {
+    Q_OBJECT
+public:
+    AgentWorker(const AgentConfig& config, LoadStats& stats);
+
+public slots:
+    void start();
+    void addAgent(int index);
+
+    // disconnects and destroys the agents, the app calls this with a blocking connection before stopping the thread
+    void stop();
+
+private slots:
+    void update();
+
+private:
+    const AgentConfig& _config;
+    LoadStats& _stats;
+    QTimer* _updateTimer;
+    std::vector<std::unique_ptr<SimulatedAgent>> _agents;
+};
+
+#endif // hifi_AgentWorker_h
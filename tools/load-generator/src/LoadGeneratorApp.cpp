@@ -0,0 +1,287 @@
+//
+//  LoadGeneratorApp.cpp
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LoadGeneratorApp.h"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDebug>
+#include <QtCore/QLoggingCategory>
+
+#include <DomainHandler.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <shared/NetworkUtils.h>
+#include <plugins/PluginManager.h>
+
+static const int DEFAULT_NUM_AGENTS = 10;
+static const float DEFAULT_RAMP_UP_SECONDS = 10.0f;
+static const float DEFAULT_REPORT_INTERVAL_SECONDS = 5.0f;
+
+static QString formatRate(quint64 count, float seconds) {
+    return QString::number(count / seconds, 'f', 1);
+}
+
+static QString formatKbps(quint64 bytes, float seconds) {
+    return QString::number(bytes * BITS_IN_BYTE / (BYTES_PER_KILOBYTE * seconds), 'f', 1);
+}
+
+static QString formatMsecs(double usecs) {
+    return QString::number(usecs / USECS_PER_MSEC, 'f', 2);
+}
+
+static QString formatPercent(quint64 part, quint64 whole) {
+    return QString::number(whole > 0 ? 100.0 * part / whole : 0.0, 'f', 2) + "%";
+}
+
+LoadGeneratorApp::LoadGeneratorApp(int argc, char* argv[]) :
+    QCoreApplication(argc, argv)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity load generator, runs many simulated agents against one domain");
+
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption verboseOutput("v", "verbose output");
+    parser.addOption(verboseOutput);
+
+    const QCommandLineOption domainAddressOption("d", "domain-server address", "host[:port]", "127.0.0.1");
+    parser.addOption(domainAddressOption);
+
+    const QCommandLineOption numAgentsOption("n", "number of simulated agents", "count",
+                                             QString::number(DEFAULT_NUM_AGENTS));
+    parser.addOption(numAgentsOption);
+
+    const QCommandLineOption threadsOption("threads", "number of threads the agents are spread over", "count",
+                                           QString::number(QThread::idealThreadCount()));
+    parser.addOption(threadsOption);
+
+    const QCommandLineOption rampUpOption("ramp-up", "seconds over which the agents connect", "seconds",
+                                          QString::number(DEFAULT_RAMP_UP_SECONDS));
+    parser.addOption(rampUpOption);
+
+    const QCommandLineOption durationOption("duration", "seconds to run for, 0 runs until killed", "seconds", "0");
+    parser.addOption(durationOption);
+
+    const QCommandLineOption reportIntervalOption("report-interval", "seconds between reports", "seconds",
+                                                  QString::number(DEFAULT_REPORT_INTERVAL_SECONDS));
+    parser.addOption(reportIntervalOption);
+
+    const QCommandLineOption recordingOption("recording", "recording whose avatar motion and audio every agent replays",
+                                             "path");
+    parser.addOption(recordingOption);
+
+    const QCommandLineOption avatarURLOption("avatar-url", "skeleton model URL, defaults to the recording's", "url");
+    parser.addOption(avatarURLOption);
+
+    const QCommandLineOption spacingOption("spacing", "metres between neighbouring agents", "metres", "2");
+    parser.addOption(spacingOption);
+
+    const QCommandLineOption avatarRateOption("avatar-rate", "AvatarData packets per second per agent", "hz", "45");
+    parser.addOption(avatarRateOption);
+
+    const QCommandLineOption noAudioOption("no-audio", "don't send microphone audio");
+    parser.addOption(noAudioOption);
+
+    const QCommandLineOption noCodecsOption("no-codecs", "send raw PCM even if codec plugins are available");
+    parser.addOption(noCodecsOption);
+
+    const QCommandLineOption talkRatioOption("talk-ratio", "fraction of the time the synthetic voice is not silent",
+                                             "ratio", "0.6");
+    parser.addOption(talkRatioOption);
+
+    const QCommandLineOption entitiesOption("entities", "temporary entities each agent adds", "count", "0");
+    parser.addOption(entitiesOption);
+
+    const QCommandLineOption editRateOption("edit-rate", "entity edits per second per agent", "hz", "0");
+    parser.addOption(editRateOption);
+
+    const QCommandLineOption queryRateOption("query-rate", "EntityQuery packets per second per agent", "hz", "0");
+    parser.addOption(queryRateOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (!parser.isSet(verboseOutput)) {
+        // hundreds of agents make the libraries' debug output unreadable
+        QLoggingCategory::setFilterRules("hifi.*.debug=false\nhifi.*.info=false\nqt.network.ssl.warning=false");
+    }
+
+    QStringList domainPieces = parser.value(domainAddressOption).split(":");
+    quint16 domainPort = domainPieces.size() > 1 ? domainPieces[1].toUShort() : DEFAULT_DOMAIN_SERVER_PORT;
+    _config.domainServer = HifiSockAddr(domainPieces[0], domainPort, true);
+    if (_config.domainServer.getAddress().isNull()) {
+        qCritical() << "Could not resolve domain-server address" << parser.value(domainAddressOption);
+        ::exit(1);
+    }
+
+    // servers on this box reach us on loopback, anything else needs our LAN address
+    QHostAddress localAddress = getGuessedLocalAddress();
+    _config.localSocket = HifiSockAddr(localAddress, 0);
+    _config.publicSocket = HifiSockAddr(_config.domainServer.getAddress().isLoopback() ? QHostAddress(QHostAddress::LocalHost)
+                                                                                       : localAddress, 0);
+
+    if (parser.isSet(recordingOption)) {
+        _config.clip = ReplayClip::fromFile(parser.value(recordingOption));
+        if (!_config.clip) {
+            ::exit(1);
+        }
+        _config.skeletonModelURL = _config.clip->getSkeletonModelURL();
+    }
+    if (parser.isSet(avatarURLOption)) {
+        _config.skeletonModelURL = parser.value(avatarURLOption);
+    }
+
+    _config.crowdSpacing = parser.value(spacingOption).toFloat();
+    _config.avatarSendRate = parser.value(avatarRateOption).toFloat();
+    _config.sendAudio = !parser.isSet(noAudioOption);
+    _config.useCodecs = !parser.isSet(noCodecsOption);
+    _config.talkRatio = std::min(std::max(parser.value(talkRatioOption).toFloat(), 0.0f), 1.0f);
+    _config.entitiesPerAgent = std::max(parser.value(entitiesOption).toInt(), 0);
+    _config.entityEditRate = parser.value(editRateOption).toFloat();
+    _config.entityQueryRate = parser.value(queryRateOption).toFloat();
+
+    if (_config.sendAudio && _config.useCodecs) {
+        // load the plugins here, rather than racing to do it from every worker
+        qDebug() << "Found" << PluginManager::getInstance()->getCodecPlugins().size() << "codec plugins";
+    }
+
+    _numAgents = std::max(parser.value(numAgentsOption).toInt(), 1);
+    int numThreads = std::max(std::min(parser.value(threadsOption).toInt(), _numAgents), 1);
+    for (int i = 0; i < numThreads; i++) {
+        auto thread = new QThread(this);
+        thread->setObjectName(QString("Load Agents %1").arg(i));
+
+        auto worker = new AgentWorker(_config, _stats);
+        worker->moveToThread(thread);
+        connect(thread, &QThread::started, worker, &AgentWorker::start);
+        connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+        thread->start();
+
+        _threads.push_back(thread);
+        _workers.push_back(worker);
+    }
+
+    qDebug() << "Starting" << _numAgents << "agents on" << numThreads << "threads against" << _config.domainServer;
+
+    float rampUpSeconds = std::max(parser.value(rampUpOption).toFloat(), 0.0f);
+    connect(&_rampUpTimer, &QTimer::timeout, this, &LoadGeneratorApp::startNextAgent);
+    _rampUpTimer.start((int)(rampUpSeconds * MSECS_PER_SECOND / _numAgents));
+
+    float reportIntervalSeconds = std::max(parser.value(reportIntervalOption).toFloat(), 1.0f);
+    connect(&_reportTimer, &QTimer::timeout, this, &LoadGeneratorApp::report);
+    _reportTimer.start((int)(reportIntervalSeconds * MSECS_PER_SECOND));
+
+    float durationSeconds = parser.value(durationOption).toFloat();
+    if (durationSeconds > 0.0f) {
+        QTimer::singleShot((int)(durationSeconds * MSECS_PER_SECOND), this, &LoadGeneratorApp::stopAgents);
+    }
+
+    _startTime = usecTimestampNow();
+    _lastReportTime = _startTime;
+}
+
+LoadGeneratorApp::~LoadGeneratorApp() {
+    for (auto thread : _threads) {
+        thread->quit();
+        thread->wait();
+    }
+}
+
+void LoadGeneratorApp::startNextAgent() {
+    if (_numAgentsStarted >= _numAgents) {
+        _rampUpTimer.stop();
+        return;
+    }
+
+    int index = _numAgentsStarted++;
+    QMetaObject::invokeMethod(_workers[index % _workers.size()], "addAgent", Qt::QueuedConnection, Q_ARG(int, index));
+}
+
+void LoadGeneratorApp::stopAgents() {
+    _rampUpTimer.stop();
+    report();
+
+    for (auto worker : _workers) {
+        QMetaObject::invokeMethod(worker, "stop", Qt::BlockingQueuedConnection);
+    }
+    quit();
+}
+
+void LoadGeneratorApp::report() {
+    quint64 now = usecTimestampNow();
+    float seconds = (float)(now - _lastReportTime) / USECS_PER_SECOND;
+    _lastReportTime = now;
+    if (seconds <= 0.0f) {
+        return;
+    }
+
+    auto workerUpdate = _stats.workerUpdate.take();
+    qDebug().noquote() << QString("[%1s] %2 of %3 agents connected (%4 denied, %5 version mismatches), "
+                                  "worker update avg %6 ms max %7 ms")
+        .arg((now - _startTime) / USECS_PER_SECOND)
+        .arg(_stats.agentsConnected.load()).arg(_stats.agentsStarted.load())
+        .arg(_stats.connectionsDenied.load()).arg(_stats.versionMismatches.exchange(0))
+        .arg(formatMsecs(workerUpdate.averageUsecs)).arg(formatMsecs((double)workerUpdate.maxUsecs));
+
+    for (int i = 0; i < LoadStats::NUM_TARGETS; i++) {
+        auto& target = _stats.targets[i];
+        quint64 packetsSent = target.packetsSent.exchange(0);
+        quint64 bytesSent = target.bytesSent.exchange(0);
+        quint64 packetsReceived = target.packetsReceived.exchange(0);
+        quint64 bytesReceived = target.bytesReceived.exchange(0);
+        auto roundTrip = target.pingRoundTrip.take();
+        if (packetsSent == 0 && packetsReceived == 0) {
+            continue;
+        }
+
+        qDebug().noquote() << QString("  %1 out %2 pps %3 kbps, in %4 pps %5 kbps, rtt avg %6 ms max %7 ms")
+            .arg(loadTargetName((LoadTarget)i), -15)
+            .arg(formatRate(packetsSent, seconds)).arg(formatKbps(bytesSent, seconds))
+            .arg(formatRate(packetsReceived, seconds)).arg(formatKbps(bytesReceived, seconds))
+            .arg(formatMsecs(roundTrip.averageUsecs)).arg(formatMsecs((double)roundTrip.maxUsecs));
+    }
+
+    quint64 micFramesSent = _stats.micFramesSent.exchange(0);
+    quint64 micFramesExpected = _stats.micFramesExpectedByMixer.exchange(0);
+    quint64 micFramesLost = _stats.micFramesLostAtMixer.exchange(0);
+    quint64 mixedFramesReceived = _stats.mixedFramesReceived.exchange(0);
+    quint64 mixedFramesLost = _stats.mixedFramesLost.exchange(0);
+    auto jitterBuffer = _stats.mixerJitterBuffer.take();
+    qDebug().noquote() << QString("  audio: sent %1 fps, %2 lost at the mixer, %3 mixer starves, mixer buffer avg %4 ms; "
+                                  "received %5 mixed fps, %6 lost")
+        .arg(formatRate(micFramesSent, seconds)).arg(formatPercent(micFramesLost, micFramesExpected))
+        .arg(_stats.mixerStarves.exchange(0)).arg(formatMsecs(jitterBuffer.averageUsecs))
+        .arg(formatRate(mixedFramesReceived, seconds))
+        .arg(formatPercent(mixedFramesLost, mixedFramesReceived + mixedFramesLost));
+
+    qDebug().noquote() << QString("  avatars: sent %1 pps, received %2 bulk pps")
+        .arg(formatRate(_stats.avatarPacketsSent.exchange(0), seconds))
+        .arg(formatRate(_stats.bulkAvatarPacketsReceived.exchange(0), seconds));
+
+    quint64 entityPacketsReceived = _stats.entityPacketsReceived.exchange(0);
+    quint64 entityPacketsLost = _stats.entityPacketsLost.exchange(0);
+    auto flightTime = _stats.entityFlightTime.take();
+    qDebug().noquote() << QString("  entities: %1 adds, %2 edits/s, %3 queries/s; received %4 pps, %5 lost, "
+                                  "flight avg %6 ms max %7 ms")
+        .arg(_stats.entityAddsSent.exchange(0))
+        .arg(formatRate(_stats.entityEditsSent.exchange(0), seconds))
+        .arg(formatRate(_stats.entityQueriesSent.exchange(0), seconds))
+        .arg(formatRate(entityPacketsReceived, seconds))
+        .arg(formatPercent(entityPacketsLost, entityPacketsReceived + entityPacketsLost))
+        .arg(formatMsecs(flightTime.averageUsecs)).arg(formatMsecs((double)flightTime.maxUsecs));
+}
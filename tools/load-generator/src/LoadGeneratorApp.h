@@ -0,0 +1,52 @@
+//
+//  LoadGeneratorApp.h
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LoadGeneratorApp_h
+#define hifi_LoadGeneratorApp_h
+
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include "AgentWorker.h"
+#include "LoadStats.h"
+#include "SimulatedAgent.h"
+
+// Runs a crowd of simulated agents against one domain and prints what the servers' traffic looked like from the
+// clients' side: round trip times, loss and throughput for each server, every report interval.
+class LoadGeneratorApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    LoadGeneratorApp(int argc, char* argv[]);
+    ~LoadGeneratorApp();
+
+private slots:
+    void startNextAgent();
+    void report();
+    void stopAgents();
+
+private:
+    AgentConfig _config;
+    LoadStats _stats;
+
+    std::vector<QThread*> _threads;
+    std::vector<AgentWorker*> _workers;
+
+    int _numAgents { 0 };
+    int _numAgentsStarted { 0 };
+    QTimer _rampUpTimer;
+    QTimer _reportTimer;
+    quint64 _startTime { 0 };
+    quint64 _lastReportTime { 0 };
+};
+
+#endif // hifi_LoadGeneratorApp_h
@@ -0,0 +1,78 @@
+//
+//  LoadStats.cpp
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LoadStats.h"
+
+LoadTarget loadTargetForNodeType(NodeType_t nodeType) {
+    switch (nodeType) {
+        case NodeType::DomainServer:
+            return LoadTarget::DomainServer;
+        case NodeType::AudioMixer:
+            return LoadTarget::AudioMixer;
+        case NodeType::AvatarMixer:
+            return LoadTarget::AvatarMixer;
+        case NodeType::EntityServer:
+            return LoadTarget::EntityServer;
+        case NodeType::MessagesMixer:
+            return LoadTarget::MessagesMixer;
+        default:
+            return LoadTarget::Other;
+    }
+}
+
+QString loadTargetName(LoadTarget target) {
+    switch (target) {
+        case LoadTarget::DomainServer:
+            return "domain-server";
+        case LoadTarget::AudioMixer:
+            return "audio-mixer";
+        case LoadTarget::AvatarMixer:
+            return "avatar-mixer";
+        case LoadTarget::EntityServer:
+            return "entity-server";
+        case LoadTarget::MessagesMixer:
+            return "messages-mixer";
+        default:
+            return "other";
+    }
+}
+
+void LoadStats::Latency::add(quint64 usecs) {
+    sumUsecs += usecs;
+    count++;
+
+    quint64 previousMax = maxUsecs.load();
+    while (usecs > previousMax && !maxUsecs.compare_exchange_weak(previousMax, usecs)) {
+    }
+}
+
+LoadStats::Latency::Sample LoadStats::Latency::take() {
+    // agents may add between these exchanges, which at worst moves one sample into the next interval's average
+    Sample sample;
+    quint64 sum = sumUsecs.exchange(0);
+    sample.count = count.exchange(0);
+    sample.maxUsecs = maxUsecs.exchange(0);
+    sample.averageUsecs = sample.count > 0 ? (double)sum / sample.count : 0.0;
+    return sample;
+}
+
+void LoadStats::addSent(LoadTarget target, qint64 bytes) {
+    if (bytes > 0) {
+        auto& counters = targets[(int)target];
+        counters.packetsSent++;
+        counters.bytesSent += bytes;
+    }
+}
+
+void LoadStats::addReceived(LoadTarget target, qint64 bytes) {
+    auto& counters = targets[(int)target];
+    counters.packetsReceived++;
+    counters.bytesReceived += bytes;
+}
@@ -0,0 +1,96 @@
+//
+//  LoadStats.h
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LoadStats_h
+#define hifi_LoadStats_h
+
+#include <atomic>
+
+#include <QtCore/QString>
+
+#include <NodeType.h>
+
+// The servers a simulated agent talks to, used to index the per-server counters
+enum class LoadTarget : int {
+    DomainServer = 0,
+    AudioMixer,
+    AvatarMixer,
+    EntityServer,
+    MessagesMixer,
+    Other,
+    NumTargets
+};
+
+LoadTarget loadTargetForNodeType(NodeType_t nodeType);
+QString loadTargetName(LoadTarget target);
+
+// Counters shared by every simulated agent. Agents on any thread add to them, and the app drains them with take()
+// once per report interval.
+class LoadStats {
+public:
+    static const int NUM_TARGETS = (int)LoadTarget::NumTargets;
+
+    struct Latency {
+        std::atomic<quint64> sumUsecs { 0 };
+        std::atomic<quint64> count { 0 };
+        std::atomic<quint64> maxUsecs { 0 };
+
+        void add(quint64 usecs);
+
+        struct Sample {
+            quint64 count;
+            double averageUsecs;
+            quint64 maxUsecs;
+        };
+        Sample take();
+    };
+
+    struct Target {
+        std::atomic<quint64> packetsSent { 0 };
+        std::atomic<quint64> bytesSent { 0 };
+        std::atomic<quint64> packetsReceived { 0 };
+        std::atomic<quint64> bytesReceived { 0 };
+        Latency pingRoundTrip;
+    };
+
+    void addSent(LoadTarget target, qint64 bytes);
+    void addReceived(LoadTarget target, qint64 bytes);
+
+    Target targets[NUM_TARGETS];
+
+    std::atomic<int> agentsStarted { 0 };
+    std::atomic<int> agentsConnected { 0 };
+    Latency workerUpdate; // time spent updating every agent on one worker, long updates mean we are the bottleneck
+    std::atomic<quint64> connectionsDenied { 0 };
+    std::atomic<quint64> versionMismatches { 0 };
+
+    // audio we sent, as seen by the audio-mixer in its stream stats
+    std::atomic<quint64> micFramesSent { 0 };
+    std::atomic<quint64> micFramesExpectedByMixer { 0 };
+    std::atomic<quint64> micFramesLostAtMixer { 0 };
+    std::atomic<quint64> mixerStarves { 0 };
+    Latency mixerJitterBuffer; // the audio-mixer's buffered audio for our streams, in usecs
+
+    // audio the mixer sent back to us
+    std::atomic<quint64> mixedFramesReceived { 0 };
+    std::atomic<quint64> mixedFramesLost { 0 };
+
+    std::atomic<quint64> avatarPacketsSent { 0 };
+    std::atomic<quint64> bulkAvatarPacketsReceived { 0 };
+
+    std::atomic<quint64> entityAddsSent { 0 };
+    std::atomic<quint64> entityEditsSent { 0 };
+    std::atomic<quint64> entityQueriesSent { 0 };
+    std::atomic<quint64> entityPacketsReceived { 0 };
+    std::atomic<quint64> entityPacketsLost { 0 };
+    Latency entityFlightTime; // from the entity-server's send stamp until we read the packet
+};
+
+#endif // hifi_LoadStats_h
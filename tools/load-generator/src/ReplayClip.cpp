@@ -0,0 +1,76 @@
+//
+//  ReplayClip.cpp
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReplayClip.h"
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+#include <QtCore/QJsonDocument>
+
+#include <AudioConstants.h>
+#include <AvatarData.h>
+#include <recording/Clip.h>
+#include <recording/Frame.h>
+
+// the key AvatarData::toJson stores the skeleton under
+static const QString JSON_AVATAR_BODY_MODEL = QStringLiteral("bodyModel");
+
+ReplayClip::ConstPointer ReplayClip::fromFile(const QString& filePath) {
+    using namespace recording;
+
+    auto clip = Clip::fromFile(filePath);
+    if (!clip) {
+        qWarning() << "Could not read recording" << filePath;
+        return ConstPointer();
+    }
+
+    static const FrameType AVATAR_FRAME_TYPE = Frame::registerFrameType(AvatarData::FRAME_NAME);
+    static const FrameType AUDIO_FRAME_TYPE = Frame::registerFrameType(AudioConstants::getAudioFrameName());
+
+    auto result = std::make_shared<ReplayClip>();
+    clip->seekFrameTime(0);
+    for (auto frame = clip->nextFrame(); frame; frame = clip->nextFrame()) {
+        if (frame->type == AVATAR_FRAME_TYPE) {
+            QJsonObject data = QJsonDocument::fromBinaryData(frame->data).object();
+            if (result->_skeletonModelURL.isEmpty()) {
+                result->_skeletonModelURL = data[JSON_AVATAR_BODY_MODEL].toString();
+            }
+            result->_avatarFrames.push_back({ frame->timeOffset, data });
+        } else if (frame->type == AUDIO_FRAME_TYPE && frame->data.size() == AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL) {
+            result->_audioFrames.push_back(frame->data);
+        }
+    }
+
+    if (result->_avatarFrames.empty()) {
+        qWarning() << "Recording" << filePath << "has no avatar frames";
+        return ConstPointer();
+    }
+
+    // frames are stored in time order, but be safe since the lookups rely on it
+    std::stable_sort(result->_avatarFrames.begin(), result->_avatarFrames.end(),
+        [](const AvatarFrame& a, const AvatarFrame& b) {
+            return a.time < b.time;
+        });
+    result->_durationMsecs = std::max(result->_avatarFrames.back().time, (quint32)1);
+
+    qDebug() << "Loaded" << result->_avatarFrames.size() << "avatar frames and" << result->_audioFrames.size()
+        << "audio frames from" << filePath << "lasting" << result->_durationMsecs << "msecs";
+    return result;
+}
+
+const ReplayClip::AvatarFrame& ReplayClip::getAvatarFrame(quint64 time) const {
+    quint32 clipTime = (quint32)(time % _durationMsecs);
+    auto next = std::upper_bound(_avatarFrames.begin(), _avatarFrames.end(), clipTime,
+        [](quint32 t, const AvatarFrame& frame) {
+            return t < frame.time;
+        });
+    return next == _avatarFrames.begin() ? *next : *(next - 1);
+}
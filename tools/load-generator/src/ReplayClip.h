@@ -0,0 +1,52 @@
+//
+//  ReplayClip.h
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ReplayClip_h
+#define hifi_ReplayClip_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+
+// The avatar and audio frames of a recording::Clip, decoded once and then shared read-only by every simulated agent.
+// Each agent plays it from its own time offset, so that a single recording can drive a whole crowd.
+class ReplayClip {
+public:
+    using ConstPointer = std::shared_ptr<const ReplayClip>;
+
+    struct AvatarFrame {
+        quint32 time; // msecs from the start of the clip
+        QJsonObject data;
+    };
+
+    // returns nullptr if the clip can not be read or does not hold any avatar frames
+    static ConstPointer fromFile(const QString& filePath);
+
+    quint32 getDurationMsecs() const { return _durationMsecs; }
+    const QString& getSkeletonModelURL() const { return _skeletonModelURL; }
+    int getNumAvatarFrames() const { return (int)_avatarFrames.size(); }
+    int getNumAudioFrames() const { return (int)_audioFrames.size(); }
+
+    // the last avatar frame at or before time, which wraps around the end of the clip
+    const AvatarFrame& getAvatarFrame(quint64 time) const;
+    // one network frame of mono PCM, the index wraps around the end of the clip
+    const QByteArray& getAudioFrame(int index) const { return _audioFrames[index % _audioFrames.size()]; }
+
+private:
+    std::vector<AvatarFrame> _avatarFrames;
+    std::vector<QByteArray> _audioFrames;
+    quint32 _durationMsecs { 0 };
+    QString _skeletonModelURL;
+};
+
+#endif // hifi_ReplayClip_h
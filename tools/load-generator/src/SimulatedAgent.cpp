@@ -0,0 +1,784 @@
+//
+//  SimulatedAgent.cpp
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SimulatedAgent.h"
+
+#include <math.h>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <AudioConstants.h>
+#include <AudioStreamStats.h>
+#include <AvatarData.h>
+#include <EntityItemProperties.h>
+#include <GLMHelpers.h>
+#include <LimitedNodeList.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <OctreePacketData.h>
+#include <PositionalAudioStream.h>
+#include <SharedUtil.h>
+#include <plugins/PluginManager.h>
+#include <udt/PacketHeaders.h>
+
+static const quint64 CHECK_IN_INTERVAL_USECS = DOMAIN_SERVER_CHECK_IN_MSECS * USECS_PER_MSEC;
+static const quint64 PING_INTERVAL_USECS = USECS_PER_SECOND;
+
+// never send more than this many audio frames in one update to catch up, past that we skip ahead instead
+static const int MAX_AUDIO_FRAMES_PER_UPDATE = 5;
+
+// sequence gaps larger than this are taken to be reordering or a restarted sender rather than loss
+static const quint16 MAX_SEQUENCE_GAP = 1000;
+
+// agents without a recording walk in a circle around their spot in the crowd
+static const float CIRCLE_RADIUS = 1.0f;
+static const float CIRCLE_ANGULAR_SPEED = 0.5f; // radians per second
+
+// the synthetic voice alternates between a tone and silence over this cycle
+static const quint64 TALK_CYCLE_MSECS = 5000;
+static const float TONE_AMPLITUDE = 3000.0f;
+
+static const float ENTITY_SIZE = 0.25f;
+static const float ENTITY_SPREAD = 3.0f;
+static const float ENTITY_BOB_HEIGHT = 0.5f;
+static const float ENTITY_LIFETIME_SECONDS = 3600.0f; // long enough for any run, short enough to clean up after a crash
+static const float EYE_HEIGHT = 1.6f;
+
+// the angle between neighbours on a Vogel spiral, which spreads any number of agents evenly over a disc
+static const float GOLDEN_ANGLE = 2.39996f;
+
+static const NodeSet SERVER_TYPES_OF_INTEREST = NodeSet() << NodeType::AudioMixer << NodeType::AvatarMixer
+    << NodeType::EntityServer << NodeType::MessagesMixer;
+
+static quint64 intervalForRate(float ratePerSecond) {
+    return (quint64)(USECS_PER_SECOND / ratePerSecond);
+}
+
+static bool isSourced(PacketType type) {
+    static const auto NON_SOURCED_PACKETS = PacketTypeEnum::getNonSourcedPackets();
+    return !NON_SOURCED_PACKETS.contains(type);
+}
+
+static bool isVerified(PacketType type) {
+    static const auto NON_VERIFIED_PACKETS = PacketTypeEnum::getNonVerifiedPackets();
+    return isSourced(type) && !NON_VERIFIED_PACKETS.contains(type);
+}
+
+SimulatedAgent::SimulatedAgent(int index, const AgentConfig& config, LoadStats& stats) :
+    _index(index),
+    _config(config),
+    _stats(stats),
+    _machineFingerprint(QUuid::createUuid()),
+    _startTime(usecTimestampNow()),
+    _avatar(new AvatarData()),
+    _toneFrequency(200.0f + (index % 16) * 25.0f)
+{
+    _socket.bind(QHostAddress::AnyIPv4);
+    _publicSocket = HifiSockAddr(config.publicSocket.getAddress(), _socket.localPort());
+    _localSocket = HifiSockAddr(config.localSocket.getAddress(), _socket.localPort());
+
+    _socket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) {
+        handlePacket(std::move(packet));
+    });
+    _socket.setMessageHandler([this](std::unique_ptr<udt::Packet> packet) {
+        handleMessagePacket(std::move(packet));
+    });
+
+    float radius = config.crowdSpacing * sqrtf((float)index);
+    float angle = GOLDEN_ANGLE * index;
+    _crowdPosition = glm::vec3(radius * cosf(angle), 0.0f, radius * sinf(angle));
+
+    // start every agent at a different point in the recording so that the crowd doesn't move in lockstep
+    _clipOffsetMsecs = config.clip ? ((quint64)index * 997) % config.clip->getDurationMsecs() : (quint64)index * 997;
+
+    if (!config.skeletonModelURL.isEmpty()) {
+        _avatar->setSkeletonModelURL(QUrl(config.skeletonModelURL));
+    }
+    if (!config.clip) {
+        // a recording brings its own display name
+        _avatar->setDisplayName(QString("load-agent-%1").arg(index));
+    }
+
+    _nextCheckIn = _startTime;
+    _nextPing = _startTime;
+    _nextAvatarSend = _startTime;
+    _nextAudioSend = _startTime;
+    _nextEntitySend = _startTime;
+    _nextQuery = _startTime;
+}
+
+SimulatedAgent::~SimulatedAgent() {
+    releaseEncoder();
+}
+
+void SimulatedAgent::update(quint64 now) {
+    if (now >= _nextCheckIn) {
+        sendDomainCheckIn();
+        _nextCheckIn = now + CHECK_IN_INTERVAL_USECS;
+    }
+
+    if (!_isConnected) {
+        return;
+    }
+
+    if (now >= _nextPing) {
+        sendPings(now);
+        _nextPing = now + PING_INTERVAL_USECS;
+    }
+
+    if (_config.avatarSendRate > 0.0f && now >= _nextAvatarSend) {
+        if (auto avatarMixer = findActiveServer(NodeType::AvatarMixer)) {
+            updateAvatar(now);
+            sendAvatarData(*avatarMixer);
+            if (_identitySentTo != avatarMixer->uuid) {
+                sendAvatarIdentity(*avatarMixer);
+            }
+        }
+        // if we fell behind then send late rather than in a burst
+        _nextAvatarSend = std::max(_nextAvatarSend + intervalForRate(_config.avatarSendRate), now);
+    }
+
+    if (_config.sendAudio) {
+        if (auto audioMixer = findActiveServer(NodeType::AudioMixer)) {
+            if (_audioFormatNegotiatedWith != audioMixer->uuid) {
+                negotiateAudioFormat(*audioMixer);
+            }
+
+            int numFramesSent = 0;
+            while (now >= _nextAudioSend && numFramesSent < MAX_AUDIO_FRAMES_PER_UPDATE) {
+                sendAudioFrame(*audioMixer, now);
+                _nextAudioSend += AudioConstants::NETWORK_FRAME_USECS;
+                numFramesSent++;
+            }
+        }
+        if (now >= _nextAudioSend) {
+            _nextAudioSend = now + AudioConstants::NETWORK_FRAME_USECS;
+        }
+    }
+
+    if (auto entityServer = findActiveServer(NodeType::EntityServer)) {
+        bool canRez = _permissions.can(NodePermissions::Permission::canRezTemporaryEntities) ||
+            _permissions.can(NodePermissions::Permission::canRezPermanentEntities);
+
+        if (canRez && (int)_entities.size() < _config.entitiesPerAgent) {
+            sendEntityAdd(*entityServer);
+        } else if (!_entities.empty() && _config.entityEditRate > 0.0f && now >= _nextEntitySend) {
+            sendEntityEdit(*entityServer, now);
+            _nextEntitySend = std::max(_nextEntitySend + intervalForRate(_config.entityEditRate), now);
+        }
+
+        if (_config.entityQueryRate > 0.0f && now >= _nextQuery) {
+            sendEntityQuery(*entityServer);
+            _nextQuery = std::max(_nextQuery + intervalForRate(_config.entityQueryRate), now);
+        }
+    }
+}
+
+void SimulatedAgent::disconnect() {
+    if (!_isConnected) {
+        return;
+    }
+
+    if (auto entityServer = findActiveServer(NodeType::EntityServer)) {
+        for (const auto& entityID : _entities) {
+            sendEntityErase(*entityServer, entityID);
+        }
+    }
+    _entities.clear();
+    _entityPositions.clear();
+
+    sendPacket(NLPacket::create(PacketType::DomainDisconnectRequest, 0), nullptr, _config.domainServer);
+
+    clearServers();
+    _isConnected = false;
+    _stats.agentsConnected--;
+}
+
+void SimulatedAgent::handlePacket(std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+    if (nlPacket->getVersion() != versionForPacketType(nlPacket->getType())) {
+        _stats.versionMismatches++;
+        return;
+    }
+
+    Server* server = findServerForPacket(*nlPacket);
+    LoadTarget target = server ? loadTargetForNodeType(server->type) :
+        (nlPacket->getSenderSockAddr() == _config.domainServer ? LoadTarget::DomainServer : LoadTarget::Other);
+    _stats.addReceived(target, nlPacket->getDataSize());
+
+    switch (nlPacket->getType()) {
+        case PacketType::DomainList:
+            processDomainList(*nlPacket);
+            break;
+        case PacketType::DomainServerAddedNode: {
+            QByteArray payload = QByteArray::fromRawData(nlPacket->getPayload(), nlPacket->getPayloadSize());
+            QDataStream stream(payload);
+            parseServer(stream);
+            break;
+        }
+        case PacketType::DomainServerRemovedNode:
+            _servers.remove(QUuid::fromRfc4122(nlPacket->read(NUM_BYTES_RFC4122_UUID)));
+            break;
+        case PacketType::DomainConnectionDenied:
+            if (_stats.connectionsDenied++ == 0) {
+                qWarning() << "The domain-server refused a connection, check that anonymous users may connect";
+            }
+            break;
+        case PacketType::Ping:
+            processPing(*nlPacket, server);
+            break;
+        case PacketType::PingReply:
+            processPingReply(*nlPacket, server);
+            break;
+        case PacketType::SelectedAudioFormat:
+            processSelectedAudioFormat(*nlPacket);
+            break;
+        case PacketType::MixedAudio:
+        case PacketType::SilentAudioFrame:
+            processMixedAudio(*nlPacket);
+            break;
+        case PacketType::AudioStreamStats:
+            processAudioStreamStats(*nlPacket);
+            break;
+        case PacketType::BulkAvatarData:
+            _stats.bulkAvatarPacketsReceived++;
+            break;
+        case PacketType::EntityData:
+            processEntityData(*nlPacket);
+            break;
+        default:
+            break;
+    }
+}
+
+void SimulatedAgent::handleMessagePacket(std::unique_ptr<udt::Packet> packet) {
+    // nothing we need arrives as a multi-packet message, so these only count towards throughput
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+    Server* server = findServerForPacket(*nlPacket);
+    _stats.addReceived(server ? loadTargetForNodeType(server->type) : LoadTarget::Other, nlPacket->getDataSize());
+}
+
+void SimulatedAgent::processDomainList(NLPacket& packet) {
+    // the list arrives as separate packets, each starting with the same header
+    QByteArray payload = QByteArray::fromRawData(packet.getPayload(), packet.getPayloadSize());
+    QDataStream stream(payload);
+
+    QUuid domainUUID;
+    QUuid sessionUUID;
+    NodePermissions permissions;
+    QUuid domainConnectionSecret; // only needed to verify packets the domain-server signs, which we never get
+    stream >> domainUUID >> sessionUUID >> permissions >> domainConnectionSecret;
+
+    if (_isConnected && domainUUID != _domainUUID) {
+        return;
+    }
+
+    if (!_isConnected) {
+        _isConnected = true;
+        _domainUUID = domainUUID;
+        _stats.agentsConnected++;
+    }
+
+    if (sessionUUID != _sessionUUID) {
+        // the servers know us by our session, so everything we told them before is lost
+        clearServers();
+        _sessionUUID = sessionUUID;
+        _avatar->setSessionUUID(sessionUUID);
+    }
+    _permissions = permissions;
+
+    while (!stream.atEnd() && stream.status() == QDataStream::Ok) {
+        parseServer(stream);
+    }
+}
+
+void SimulatedAgent::parseServer(QDataStream& stream) {
+    qint8 nodeType;
+    QUuid uuid;
+    HifiSockAddr publicSocket;
+    HifiSockAddr localSocket;
+    NodePermissions permissions;
+    bool isReplicated;
+    QUuid connectionSecret;
+    stream >> nodeType >> uuid >> publicSocket >> localSocket >> permissions >> isReplicated >> connectionSecret;
+
+    if (stream.status() != QDataStream::Ok || !SERVER_TYPES_OF_INTEREST.contains((NodeType_t)nodeType)) {
+        return;
+    }
+
+    // a public socket of 0 means the server is reachable at the domain-server's address
+    if (publicSocket.getAddress().isNull()) {
+        publicSocket.setAddress(_config.domainServer.getAddress());
+    }
+
+    auto it = _servers.find(uuid);
+    if (it == _servers.end() || it->publicSocket != publicSocket || it->localSocket != localSocket) {
+        Server server;
+        server.type = (NodeType_t)nodeType;
+        server.uuid = uuid;
+        server.publicSocket = publicSocket;
+        server.localSocket = localSocket;
+        server.connectionSecret = connectionSecret;
+        _servers.insert(uuid, server);
+    } else {
+        it->connectionSecret = connectionSecret;
+    }
+}
+
+void SimulatedAgent::processPing(NLPacket& packet, const Server* server) {
+    if (!server) {
+        return;
+    }
+
+    // servers ping the sockets we gave the domain-server until we answer, that is what makes us active to them
+    PingType_t pingType;
+    quint64 timeFromOriginalPing;
+    packet.readPrimitive(&pingType);
+    packet.readPrimitive(&timeFromOriginalPing);
+
+    auto replyPacket = NLPacket::create(PacketType::PingReply, sizeof(PingType_t) + sizeof(quint64) + sizeof(quint64));
+    replyPacket->writePrimitive(pingType);
+    replyPacket->writePrimitive(timeFromOriginalPing);
+    replyPacket->writePrimitive(usecTimestampNow());
+    sendPacket(std::move(replyPacket), server, packet.getSenderSockAddr());
+}
+
+void SimulatedAgent::processPingReply(NLPacket& packet, Server* server) {
+    if (!server) {
+        return;
+    }
+
+    PingType_t pingType;
+    quint64 timeFromOriginalPing;
+    packet.readPrimitive(&pingType);
+    packet.readPrimitive(&timeFromOriginalPing);
+
+    if (server->activeSocket.isNull()) {
+        server->activeSocket = packet.getSenderSockAddr();
+    }
+
+    quint64 now = usecTimestampNow();
+    if (now > timeFromOriginalPing) {
+        _stats.targets[(int)loadTargetForNodeType(server->type)].pingRoundTrip.add(now - timeFromOriginalPing);
+    }
+}
+
+void SimulatedAgent::processSelectedAudioFormat(NLPacket& packet) {
+    selectCodec(packet.readString());
+}
+
+void SimulatedAgent::processMixedAudio(NLPacket& packet) {
+    quint16 sequence;
+    packet.readPrimitive(&sequence);
+
+    if (_hasMixedSequence) {
+        quint16 gap = sequence - _lastMixedSequence - 1;
+        if (gap < MAX_SEQUENCE_GAP) {
+            _stats.mixedFramesLost += gap;
+        }
+    }
+    _hasMixedSequence = true;
+    _lastMixedSequence = sequence;
+    _stats.mixedFramesReceived++;
+}
+
+void SimulatedAgent::processAudioStreamStats(NLPacket& packet) {
+    quint8 appendFlag;
+    quint16 numStreamStats;
+    packet.readPrimitive(&appendFlag);
+    packet.readPrimitive(&numStreamStats);
+
+    for (int i = 0; i < numStreamStats; i++) {
+        AudioStreamStats streamStats;
+        if (packet.readPrimitive(&streamStats) != sizeof(AudioStreamStats)) {
+            break;
+        }
+        if (streamStats._streamType != PositionalAudioStream::Microphone) {
+            continue;
+        }
+
+        // the mixer reports running totals, which start over if it recreates our stream
+        const auto& packetStats = streamStats._packetStreamStats;
+        if (packetStats._expectedReceived < _lastMicExpected || packetStats._lost < _lastMicLost ||
+                streamStats._starveCount < _lastMicStarves) {
+            _lastMicExpected = 0;
+            _lastMicLost = 0;
+            _lastMicStarves = 0;
+        }
+        _stats.micFramesExpectedByMixer += packetStats._expectedReceived - _lastMicExpected;
+        _stats.micFramesLostAtMixer += packetStats._lost - _lastMicLost;
+        _stats.mixerStarves += streamStats._starveCount - _lastMicStarves;
+        _stats.mixerJitterBuffer.add(streamStats._unplayedMs * USECS_PER_MSEC);
+
+        _lastMicExpected = packetStats._expectedReceived;
+        _lastMicLost = packetStats._lost;
+        _lastMicStarves = streamStats._starveCount;
+    }
+}
+
+void SimulatedAgent::processEntityData(NLPacket& packet) {
+    OCTREE_PACKET_FLAGS flags;
+    OCTREE_PACKET_SEQUENCE sequence;
+    OCTREE_PACKET_SENT_TIME sentTime;
+    packet.readPrimitive(&flags);
+    packet.readPrimitive(&sequence);
+    packet.readPrimitive(&sentTime);
+
+    // the server stamps its own clock, so this is only a flight time when both run on the same box
+    quint64 now = usecTimestampNow();
+    if (now > sentTime) {
+        _stats.entityFlightTime.add(now - sentTime);
+    }
+
+    if (_hasEntitySequence) {
+        quint16 gap = sequence - _lastEntitySequence - 1;
+        if (gap < MAX_SEQUENCE_GAP) {
+            _stats.entityPacketsLost += gap;
+        }
+    }
+    _hasEntitySequence = true;
+    _lastEntitySequence = sequence;
+    _stats.entityPacketsReceived++;
+}
+
+void SimulatedAgent::sendDomainCheckIn() {
+    // the same layout NodeList::sendDomainServerCheckIn uses, for an anonymous user who isn't using ICE
+    auto packetType = _isConnected ? PacketType::DomainListRequest : PacketType::DomainConnectRequest;
+    auto packet = NLPacket::create(packetType);
+    QDataStream packetStream(packet.get());
+
+    if (!_isConnected) {
+        packetStream << QUuid();
+
+        QByteArray protocolVersionSig = protocolVersionsSignature();
+        packetStream.writeBytes(protocolVersionSig.constData(), protocolVersionSig.size());
+
+        // no hardware address, and a fingerprint of our own so the domain-server sees distinct machines
+        packetStream << QString() << _machineFingerprint;
+    }
+
+    packetStream << NodeType::Agent << _publicSocket << _localSocket << SERVER_TYPES_OF_INTEREST.toList();
+    packetStream << QString(); // place name
+
+    if (!_isConnected) {
+        packetStream << QString(); // username
+    }
+
+    sendPacket(std::move(packet), nullptr, _config.domainServer);
+}
+
+void SimulatedAgent::sendPings(quint64 now) {
+    for (auto& server : _servers) {
+        auto makePing = [&](PingType_t pingType) {
+            auto pingPacket = NLPacket::create(PacketType::Ping, sizeof(PingType_t) + sizeof(quint64));
+            pingPacket->writePrimitive(pingType);
+            pingPacket->writePrimitive(now);
+            return pingPacket;
+        };
+
+        if (server.activeSocket.isNull()) {
+            // whichever socket answers first becomes the one we use
+            sendPacket(makePing(PingType::Public), &server, server.publicSocket);
+            if (server.localSocket != server.publicSocket) {
+                sendPacket(makePing(PingType::Local), &server, server.localSocket);
+            }
+        } else {
+            sendPacket(makePing(PingType::Agnostic), &server, server.activeSocket);
+        }
+    }
+}
+
+void SimulatedAgent::updateAvatar(quint64 now) {
+    quint64 elapsedMsecs = (now - _startTime) / USECS_PER_MSEC;
+
+    if (_config.clip) {
+        const auto& frame = _config.clip->getAvatarFrame(elapsedMsecs + _clipOffsetMsecs);
+        _avatar->fromJson(frame.data, false);
+
+        // every agent plays the same recording, so move each one to its own spot in the crowd
+        _avatar->setWorldPosition(_avatar->getWorldPosition() + _crowdPosition);
+    } else {
+        float angle = CIRCLE_ANGULAR_SPEED * (float)elapsedMsecs / MSECS_PER_SECOND + _index;
+        glm::vec3 offset(cosf(angle), 0.0f, sinf(angle));
+        _avatar->setWorldPosition(_crowdPosition + CIRCLE_RADIUS * offset);
+        _avatar->setWorldOrientation(glm::angleAxis(-angle, Vectors::UNIT_Y));
+    }
+}
+
+void SimulatedAgent::sendAvatarData(const Server& avatarMixer) {
+    // the same mix of full and culled updates that AvatarData::sendAvatarDataPacket sends
+    bool sendAll = randFloat() < AVATAR_SEND_FULL_UPDATE_RATIO;
+    QByteArray avatarByteArray = _avatar->toByteArrayStateful(sendAll ? AvatarData::SendAllData : AvatarData::CullSmallData);
+
+    int maximumByteArraySize = NLPacket::maxPayloadSize(PacketType::AvatarData) - sizeof(AvatarDataSequenceNumber);
+    if (avatarByteArray.size() > maximumByteArraySize) {
+        avatarByteArray = _avatar->toByteArrayStateful(AvatarData::MinimumData, true);
+        if (avatarByteArray.size() > maximumByteArraySize) {
+            return;
+        }
+    }
+    _avatar->doneEncoding(sendAll);
+
+    auto avatarPacket = NLPacket::create(PacketType::AvatarData, avatarByteArray.size() + sizeof(_avatarSequenceNumber));
+    avatarPacket->writePrimitive(_avatarSequenceNumber++);
+    avatarPacket->write(avatarByteArray);
+    sendPacket(std::move(avatarPacket), &avatarMixer, avatarMixer.activeSocket);
+    _stats.avatarPacketsSent++;
+}
+
+void SimulatedAgent::sendAvatarIdentity(const Server& avatarMixer) {
+    _avatar->pushIdentitySequenceNumber();
+
+    // small enough for a single reliable packet, so we don't need a packet list
+    auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, -1, true);
+    identityPacket->write(_avatar->identityByteArray());
+    sendPacket(std::move(identityPacket), &avatarMixer, avatarMixer.activeSocket);
+    _identitySentTo = avatarMixer.uuid;
+}
+
+void SimulatedAgent::negotiateAudioFormat(const Server& audioMixer) {
+    auto negotiateFormatPacket = NLPacket::create(PacketType::NegotiateAudioFormat);
+    if (_config.useCodecs) {
+        auto codecPlugins = PluginManager::getInstance()->getCodecPlugins();
+        negotiateFormatPacket->writePrimitive((quint8)codecPlugins.size());
+        for (auto& plugin : codecPlugins) {
+            negotiateFormatPacket->writeString(plugin->getName());
+        }
+    } else {
+        negotiateFormatPacket->writePrimitive((quint8)0);
+    }
+    sendPacket(std::move(negotiateFormatPacket), &audioMixer, audioMixer.activeSocket);
+    _audioFormatNegotiatedWith = audioMixer.uuid;
+}
+
+void SimulatedAgent::selectCodec(const QString& codecName) {
+    if (codecName == _selectedCodecName && (_encoder || codecName.isEmpty())) {
+        return;
+    }
+
+    releaseEncoder();
+    _selectedCodecName = codecName;
+
+    // an unknown or empty codec name means raw PCM
+    for (auto& plugin : PluginManager::getInstance()->getCodecPlugins()) {
+        if (plugin->getName() == codecName) {
+            _codec = plugin;
+            _encoder = plugin->createEncoder(AudioConstants::SAMPLE_RATE, AudioConstants::MONO);
+            break;
+        }
+    }
+}
+
+void SimulatedAgent::releaseEncoder() {
+    if (_codec && _encoder) {
+        _codec->releaseEncoder(_encoder);
+    }
+    _encoder = nullptr;
+    _codec.reset();
+}
+
+void SimulatedAgent::sendAudioFrame(const Server& audioMixer, quint64 now) {
+    QByteArray pcm;
+    bool isSilent = false;
+
+    if (_config.clip && _config.clip->getNumAudioFrames() > 0) {
+        pcm = _config.clip->getAudioFrame(_audioFrameIndex++);
+    } else {
+        // talk in bursts, so that the mixer sees the mix of silent and voiced streams a real crowd produces
+        quint64 cycleMsecs = ((now - _startTime) / USECS_PER_MSEC + _clipOffsetMsecs) % TALK_CYCLE_MSECS;
+        isSilent = cycleMsecs >= _config.talkRatio * TALK_CYCLE_MSECS;
+
+        // a codec needs a frame of silence to flush before we switch to silent packets
+        pcm = QByteArray(AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL, 0);
+        if (!isSilent) {
+            int16_t* samples = reinterpret_cast<int16_t*>(pcm.data());
+            float phaseStep = TWO_PI * _toneFrequency / AudioConstants::SAMPLE_RATE;
+            for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+                samples[i] = (int16_t)(TONE_AMPLITUDE * sinf(_tonePhase));
+                _tonePhase += phaseStep;
+            }
+            _tonePhase = fmodf(_tonePhase, TWO_PI);
+        }
+    }
+
+    bool sendSilentPacket = isSilent && _wasSilent;
+    _wasSilent = isSilent;
+
+    auto audioPacket = NLPacket::create(sendSilentPacket ? PacketType::SilentAudioFrame : PacketType::MicrophoneAudioNoEcho);
+    audioPacket->writePrimitive(_audioSequenceNumber++);
+    audioPacket->writeString(_selectedCodecName);
+    if (sendSilentPacket) {
+        audioPacket->writePrimitive((quint16)AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    } else {
+        audioPacket->writePrimitive((quint8)0); // mono
+    }
+
+    glm::vec3 position = _avatar->getWorldPosition();
+    audioPacket->writePrimitive(position);
+    audioPacket->writePrimitive(_avatar->getHeadOrientation());
+    audioPacket->writePrimitive(position);
+    audioPacket->writePrimitive(glm::vec3(0.0f));
+
+    if (!sendSilentPacket) {
+        if (_encoder) {
+            QByteArray encoded;
+            _encoder->encode(pcm, encoded);
+            audioPacket->write(encoded);
+        } else {
+            audioPacket->write(pcm);
+        }
+    }
+
+    sendPacket(std::move(audioPacket), &audioMixer, audioMixer.activeSocket);
+    _stats.micFramesSent++;
+}
+
+void SimulatedAgent::sendEntityAdd(const Server& entityServer) {
+    EntityItemID entityID(QUuid::createUuid());
+    glm::vec3 position = _crowdPosition + glm::vec3(randFloatInRange(-ENTITY_SPREAD, ENTITY_SPREAD),
+        randFloatInRange(0.0f, EYE_HEIGHT), randFloatInRange(-ENTITY_SPREAD, ENTITY_SPREAD));
+
+    EntityItemProperties properties;
+    properties.setType(EntityTypes::Box);
+    properties.setPosition(position);
+    properties.setDimensions(glm::vec3(ENTITY_SIZE));
+    properties.setColor({ (unsigned char)randIntInRange(0, 255), (unsigned char)randIntInRange(0, 255),
+        (unsigned char)randIntInRange(0, 255) });
+    properties.setLifetime(ENTITY_LIFETIME_SECONDS);
+    properties.setLastEdited(usecTimestampNow());
+
+    // the same header OctreeEditPacketSender puts in front of each edit
+    const int EDIT_HEADER_SIZE = sizeof(_editSequenceNumber) + sizeof(quint64);
+    QByteArray buffer(NLPacket::maxPayloadSize(PacketType::EntityAdd) - EDIT_HEADER_SIZE, 0);
+    EntityPropertyFlags didntFitProperties;
+    auto result = EntityItemProperties::encodeEntityEditPacket(PacketType::EntityAdd, entityID, properties, buffer,
+        properties.getChangedProperties(), didntFitProperties);
+    if (result != OctreeElement::COMPLETED) {
+        return;
+    }
+
+    auto addPacket = NLPacket::create(PacketType::EntityAdd, -1, true);
+    addPacket->writePrimitive(_editSequenceNumber++);
+    addPacket->writePrimitive(usecTimestampNow());
+    addPacket->write(buffer);
+    sendPacket(std::move(addPacket), &entityServer, entityServer.activeSocket);
+
+    _entities.push_back(entityID);
+    _entityPositions.push_back(position);
+    _stats.entityAddsSent++;
+}
+
+void SimulatedAgent::sendEntityEdit(const Server& entityServer, quint64 now) {
+    int entityIndex = _nextEditedEntity++ % _entities.size();
+    float seconds = (float)(now - _startTime) / USECS_PER_SECOND;
+
+    EntityItemProperties properties;
+    properties.setPosition(_entityPositions[entityIndex] + glm::vec3(0.0f, ENTITY_BOB_HEIGHT * sinf(seconds + entityIndex), 0.0f));
+    properties.setLastEdited(usecTimestampNow());
+
+    const int EDIT_HEADER_SIZE = sizeof(_editSequenceNumber) + sizeof(quint64);
+    QByteArray buffer(NLPacket::maxPayloadSize(PacketType::EntityEdit) - EDIT_HEADER_SIZE, 0);
+    EntityPropertyFlags didntFitProperties;
+    auto result = EntityItemProperties::encodeEntityEditPacket(PacketType::EntityEdit, _entities[entityIndex], properties,
+        buffer, properties.getChangedProperties(), didntFitProperties);
+    if (result != OctreeElement::COMPLETED) {
+        return;
+    }
+
+    auto editPacket = NLPacket::create(PacketType::EntityEdit);
+    editPacket->writePrimitive(_editSequenceNumber++);
+    editPacket->writePrimitive(usecTimestampNow());
+    editPacket->write(buffer);
+    sendPacket(std::move(editPacket), &entityServer, entityServer.activeSocket);
+    _stats.entityEditsSent++;
+}
+
+void SimulatedAgent::sendEntityErase(const Server& entityServer, const EntityItemID& entityID) {
+    QByteArray buffer(NLPacket::maxPayloadSize(PacketType::EntityErase), 0);
+    if (!EntityItemProperties::encodeEraseEntityMessage(entityID, buffer)) {
+        return;
+    }
+
+    // unreliable since we are about to close the socket, the lifetime cleans up anything that is lost
+    auto erasePacket = NLPacket::create(PacketType::EntityErase);
+    erasePacket->writePrimitive(_editSequenceNumber++);
+    erasePacket->writePrimitive(usecTimestampNow());
+    erasePacket->write(buffer);
+    sendPacket(std::move(erasePacket), &entityServer, entityServer.activeSocket);
+}
+
+void SimulatedAgent::sendEntityQuery(const Server& entityServer) {
+    _entityQuery.setCameraPosition(_avatar->getWorldPosition() + glm::vec3(0.0f, EYE_HEIGHT, 0.0f));
+    _entityQuery.setCameraOrientation(_avatar->getWorldOrientation());
+
+    auto queryPacket = NLPacket::create(PacketType::EntityQuery);
+    int querySize = _entityQuery.getBroadcastData(reinterpret_cast<unsigned char*>(queryPacket->getPayload()));
+    queryPacket->setPayloadSize(querySize);
+    sendPacket(std::move(queryPacket), &entityServer, entityServer.activeSocket);
+    _stats.entityQueriesSent++;
+}
+
+void SimulatedAgent::clearServers() {
+    _servers.clear();
+    _identitySentTo = QUuid();
+    _audioFormatNegotiatedWith = QUuid();
+    _hasMixedSequence = false;
+    _hasEntitySequence = false;
+    _lastMicExpected = 0;
+    _lastMicLost = 0;
+    _lastMicStarves = 0;
+}
+
+SimulatedAgent::Server* SimulatedAgent::findServer(const QUuid& uuid) {
+    auto it = _servers.find(uuid);
+    return it != _servers.end() ? &it.value() : nullptr;
+}
+
+SimulatedAgent::Server* SimulatedAgent::findActiveServer(NodeType_t type) {
+    for (auto& server : _servers) {
+        if (server.type == type && !server.activeSocket.isNull()) {
+            return &server;
+        }
+    }
+    return nullptr;
+}
+
+SimulatedAgent::Server* SimulatedAgent::findServerForPacket(const NLPacket& packet) {
+    if (isSourced(packet.getType())) {
+        return findServer(packet.getSourceID());
+    }
+
+    const HifiSockAddr& sender = packet.getSenderSockAddr();
+    for (auto& server : _servers) {
+        if (sender == server.activeSocket || sender == server.publicSocket || sender == server.localSocket) {
+            return &server;
+        }
+    }
+    return nullptr;
+}
+
+qint64 SimulatedAgent::sendPacket(std::unique_ptr<NLPacket> packet, const Server* server, const HifiSockAddr& address) {
+    // the same header LimitedNodeList::fillPacketHeader writes
+    PacketType type = packet->getType();
+    if (isSourced(type)) {
+        packet->writeSourceID(_sessionUUID);
+    }
+    if (server && !server->connectionSecret.isNull() && isVerified(type)) {
+        packet->writeVerificationHashGivenSecret(server->connectionSecret);
+    }
+
+    LoadTarget target = server ? loadTargetForNodeType(server->type) : LoadTarget::DomainServer;
+    qint64 bytesWritten = _socket.writePacket(std::move(packet), address);
+    _stats.addSent(target, bytesWritten);
+    return bytesWritten;
+}
@@ -0,0 +1,171 @@
+//
+//  SimulatedAgent.h
+//  tools/load-generator/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SimulatedAgent_h
+#define hifi_SimulatedAgent_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QUuid>
+
+#include <glm/glm.hpp>
+
+#include <EntityItemID.h>
+#include <HifiSockAddr.h>
+#include <NLPacket.h>
+#include <NodePermissions.h>
+#include <NodeType.h>
+#include <OctreeQuery.h>
+#include <plugins/CodecPlugin.h>
+#include <udt/Socket.h>
+
+#include "LoadStats.h"
+#include "ReplayClip.h"
+
+class AvatarData;
+
+struct AgentConfig {
+    HifiSockAddr domainServer;
+    HifiSockAddr publicSocket; // the address the servers should reach us on, the port is filled in per agent
+    HifiSockAddr localSocket;
+
+    ReplayClip::ConstPointer clip; // when null, agents walk in circles
+    QString skeletonModelURL;
+    float crowdSpacing { 2.0f }; // metres between neighbouring agents
+
+    float avatarSendRate { 45.0f }; // AvatarData packets per second
+    bool sendAudio { true };
+    bool useCodecs { true };
+    float talkRatio { 0.6f }; // fraction of the time a synthetic voice is not silent
+
+    int entitiesPerAgent { 0 };
+    float entityEditRate { 0.0f }; // edits per second, spread over the agent's entities
+    float entityQueryRate { 0.0f }; // EntityQuery packets per second
+};
+
+// One lightweight client. It runs its own domain-server handshake on its own udt::Socket, keeps a small table of the
+// servers it was told about, and drives avatar, audio and entity traffic from update(), which its AgentWorker calls
+// at the audio frame rate.
+class SimulatedAgent {
+public:
+    SimulatedAgent(int index, const AgentConfig& config, LoadStats& stats);
+    ~SimulatedAgent();
+
+    void update(quint64 now);
+
+    // erases our entities and tells the domain-server we are leaving
+    void disconnect();
+
+    bool isConnected() const { return _isConnected; }
+
+private:
+    struct Server {
+        NodeType_t type { NodeType::Unassigned };
+        QUuid uuid;
+        HifiSockAddr publicSocket;
+        HifiSockAddr localSocket;
+        HifiSockAddr activeSocket; // null until one of the other two answers a ping
+        QUuid connectionSecret;
+    };
+
+    void handlePacket(std::unique_ptr<udt::Packet> packet);
+    void handleMessagePacket(std::unique_ptr<udt::Packet> packet);
+
+    void processDomainList(NLPacket& packet);
+    void parseServer(QDataStream& stream);
+    void processPing(NLPacket& packet, const Server* server);
+    void processPingReply(NLPacket& packet, Server* server);
+    void processSelectedAudioFormat(NLPacket& packet);
+    void processMixedAudio(NLPacket& packet);
+    void processAudioStreamStats(NLPacket& packet);
+    void processEntityData(NLPacket& packet);
+
+    void sendDomainCheckIn();
+    void sendPings(quint64 now);
+    void sendAvatarData(const Server& avatarMixer);
+    void sendAvatarIdentity(const Server& avatarMixer);
+    void negotiateAudioFormat(const Server& audioMixer);
+    void sendAudioFrame(const Server& audioMixer, quint64 now);
+    void sendEntityAdd(const Server& entityServer);
+    void sendEntityEdit(const Server& entityServer, quint64 now);
+    void sendEntityErase(const Server& entityServer, const EntityItemID& entityID);
+    void sendEntityQuery(const Server& entityServer);
+
+    void updateAvatar(quint64 now);
+    void selectCodec(const QString& codecName);
+    void releaseEncoder();
+    void clearServers();
+
+    Server* findServer(const QUuid& uuid);
+    Server* findActiveServer(NodeType_t type);
+    Server* findServerForPacket(const NLPacket& packet);
+    qint64 sendPacket(std::unique_ptr<NLPacket> packet, const Server* server, const HifiSockAddr& address);
+
+    int _index;
+    const AgentConfig& _config;
+    LoadStats& _stats;
+
+    udt::Socket _socket;
+    HifiSockAddr _publicSocket;
+    HifiSockAddr _localSocket;
+    QUuid _machineFingerprint;
+
+    bool _isConnected { false };
+    QUuid _domainUUID;
+    QUuid _sessionUUID;
+    NodePermissions _permissions;
+    QHash<QUuid, Server> _servers;
+
+    quint64 _startTime;
+    quint64 _nextCheckIn { 0 };
+    quint64 _nextPing { 0 };
+    quint64 _nextAvatarSend { 0 };
+    quint64 _nextAudioSend { 0 };
+    quint64 _nextEntitySend { 0 };
+    quint64 _nextQuery { 0 };
+
+    // avatar
+    std::unique_ptr<AvatarData> _avatar;
+    glm::vec3 _crowdPosition;
+    quint64 _clipOffsetMsecs;
+    quint16 _avatarSequenceNumber { 0 };
+    QUuid _identitySentTo;
+
+    // audio we send
+    quint16 _audioSequenceNumber { 0 };
+    int _audioFrameIndex { 0 };
+    float _tonePhase { 0.0f };
+    float _toneFrequency;
+    bool _wasSilent { true };
+    QUuid _audioFormatNegotiatedWith;
+    QString _selectedCodecName;
+    CodecPluginPointer _codec;
+    Encoder* _encoder { nullptr };
+
+    // audio we receive
+    bool _hasMixedSequence { false };
+    quint16 _lastMixedSequence { 0 };
+    quint32 _lastMicExpected { 0 };
+    quint32 _lastMicLost { 0 };
+    quint32 _lastMicStarves { 0 };
+
+    // entities
+    std::vector<EntityItemID> _entities;
+    std::vector<glm::vec3> _entityPositions;
+    int _nextEditedEntity { 0 };
+    quint16 _editSequenceNumber { 0 };
+    OctreeQuery _entityQuery;
+    bool _hasEntitySequence { false };
+    quint16 _lastEntitySequence { 0 };
+};
+
+#endif // hifi_SimulatedAgent_h